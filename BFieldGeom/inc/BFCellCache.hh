@@ -0,0 +1,98 @@
+#ifndef BFieldGeom_BFCellCache_hh
+#define BFieldGeom_BFCellCache_hh
+//
+// A "last cell" cache on top of BFCacheManager, for clients that evaluate the field at
+// a long sequence of nearby points, such as the Geant4 stepper.
+//
+// The cache remembers the grid cell used by the previous call and the field at its 8
+// corners.  While the points stay in that cell only the trilinear weights are computed;
+// for an inner map even the map lookup is skipped, since inner maps do not overlap.
+// The result is bit for bit the same as BFieldManager::getBField(point, cacheManager).
+// Maps that are not grid maps with trilinear interpolation are passed through.
+//
+// An instance is not thread safe: each thread must have its own, as each Geant4 worker
+// thread has its own Mu2eG4GlobalMagneticField.  The hit counters of all instances in
+// the process can be read at any time from any thread, with statistics().
+//
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "CLHEP/Vector/ThreeVector.h"
+
+#include "Offline/BFieldGeom/inc/BFCacheManager.hh"
+#include "Offline/BFieldGeom/inc/BFGridMap.hh"
+
+namespace mu2e {
+
+    class BFieldManager;
+
+    class BFCellCache {
+       public:
+        explicit BFCellCache(BFieldManager const& bfmgr);
+        ~BFCellCache();
+
+        // Holds a position in the counter registry; not copyable.
+        BFCellCache(BFCellCache const&) = delete;
+        BFCellCache& operator=(BFCellCache const&) = delete;
+
+        // Same as BFieldManager::getBFieldWithStatus(point, cacheManager, result).
+        bool getBFieldWithStatus(const CLHEP::Hep3Vector& point, CLHEP::Hep3Vector& result);
+
+        // Zero for points outside of all maps.
+        CLHEP::Hep3Vector getBField(const CLHEP::Hep3Vector& point) {
+            CLHEP::Hep3Vector result;
+            getBFieldWithStatus(point, result);
+            return result;
+        }
+
+        // Calls and cell cache hits for one map, summed over all instances that exist or
+        // have existed in this process.  The map key is empty for points outside all maps.
+        struct MapStatistics {
+            std::string key;
+            unsigned long long calls = 0;
+            unsigned long long hits = 0;
+        };
+        static std::vector<MapStatistics> statistics();
+        static void printStatistics(std::ostream& os);
+
+       private:
+        // Counters of one map.  Only the owning thread writes them; any thread may read.
+        struct Counter {
+            std::atomic<unsigned long long> calls{0};
+            std::atomic<unsigned long long> hits{0};
+        };
+
+        static void increment(std::atomic<unsigned long long>& c) {
+            c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        // Make the map found by the cache manager the current one.
+        void setMap(BFMap const* map);
+
+        BFCacheManager _cm;
+
+        // All maps, inner ones first; the counters have one more entry, for points
+        // outside of all maps.
+        std::vector<BFMap const*> _maps;
+        std::vector<std::string> _keys;
+        std::size_t _nInner;
+        std::unique_ptr<Counter[]> _counters;
+
+        // The map of the previous call and its position in _maps; _grid is null unless
+        // the map can use the cell.
+        BFMap const* _map;
+        BFGridMap const* _grid;
+        std::size_t _index;
+        BFGridMap::Cell _cell;
+
+        friend struct BFCellCacheRegistry;
+    };
+
+}  // namespace mu2e
+
+#endif /* BFieldGeom_BFCellCache_hh */
@@ -10,12 +10,17 @@
 // Rewritten in part by Krzysztof Genser to save execution time
 // Rewritten again by Brian Pollack to separate out Grid-like maps from other map types
 //
+// The field values are either held in memory (_field) or, for maps read from the
+// mapped binary format, in a read-only BFMappedGrid shared by all processes on a node.
+//
 
 //#include <iosfwd>
+#include <memory>
 #include <ostream>
 #include <string>
 #include "Offline/BFieldGeom/inc/BFInterpolationStyle.hh"
 #include "Offline/BFieldGeom/inc/BFMap.hh"
+#include "Offline/BFieldGeom/inc/BFMappedGrid.hh"
 #include "Offline/BFieldGeom/inc/BFMapType.hh"
 #include "Offline/BFieldGeom/inc/Container3D.hh"
 #include "CLHEP/Vector/ThreeVector.h"
@@ -67,14 +72,49 @@ namespace mu2e {
               _allDefined(false),
               _interpStyle(style){};
 
+        // A map whose field values live in a memory-mapped file; no copy is made.
+        BFGridMap(std::string filename,
+                  std::shared_ptr<const BFMappedGrid> grid,
+                  BFMapType::enum_type atype,
+                  double scale,
+                  BFInterpolationStyle style,
+                  bool warnIfOutside = false);
+
         ~BFGridMap(){};
 
         virtual bool getBFieldWithStatus(const CLHEP::Hep3Vector&, CLHEP::Hep3Vector&) const;
 
+        // Same as getBFieldWithStatus but with an explicit interpolation style:
+        //   trilinear - linear in each direction within the cell (8 grid points);
+        //   fit       - Lagrange quadratic on the 3x3x3 grid points around the nearest one;
+        //   tricubic  - Lagrange cubic on the 4x4x4 grid points around the cell.
+        bool getBFieldWithStyle(const CLHEP::Hep3Vector&,
+                                CLHEP::Hep3Vector&,
+                                BFInterpolationStyle style) const;
+
+        BFInterpolationStyle interpolationStyle() const { return _interpStyle; }
+
+        // Field and the exact gradient of the trilinear interpolation; see BFMap.
+        // Both come from the same 8 corners.  The gradient jumps at cell boundaries.
+        virtual bool getBFieldAndGradient(const CLHEP::Hep3Vector& point,
+                                          CLHEP::Hep3Vector& result,
+                                          CLHEP::Hep3Vector grad[3]) const;
+
+        // Vectorized trilinear interpolation at many points; see BFMap.
+        virtual void getBFieldBatch(std::size_t n,
+                                    const double* x,
+                                    const double* y,
+                                    const double* z,
+                                    double* bx,
+                                    double* by,
+                                    double* bz,
+                                    bool* status) const;
+
         // Validity checker
         virtual bool isValid(const CLHEP::Hep3Vector& point) const;
+        // Checked against the grid dimensions, since _field is empty for mapped maps.
         bool isValid(const GridPoint& ipoint) const {
-            return _field.isValid(ipoint.ix, ipoint.iy, ipoint.iz);
+            return ipoint.ix < _nx && ipoint.iy < _ny && ipoint.iz < _nz;
         }
 
         int nx() const { return _nx; }
@@ -91,6 +131,37 @@ namespace mu2e {
 
         GridPoint point2grid(const CLHEP::Hep3Vector& pos) const;
 
+        // Field value at a grid point, before scaling, whatever the storage.
+        // Without safety features.
+        CLHEP::Hep3Vector fieldAt(unsigned ix, unsigned iy, unsigned iz) const {
+            return _mapped ? _mapped->field(ix, iy, iz) : _field(ix, iy, iz);
+        }
+
+        // One cell of the grid and the field at its 8 corners, before scaling; for callers
+        // that evaluate the field at many nearby points.  See BFCellCache.
+        struct Cell {
+            int i = -1, j = -1, k = -1;
+            CLHEP::Hep3Vector c[8];
+        };
+
+        // Fill cell with the cell that contains point.  Returns false if outside the map.
+        bool loadCell(const CLHEP::Hep3Vector& point, Cell& cell) const;
+
+        // Trilinear interpolation inside a loaded cell; bit for bit the same result as
+        // getBFieldWithStyle(point, result, trilinear).  Returns false, and leaves result
+        // unchanged, if the point is not inside the cell.
+        bool interpolateInCell(const CLHEP::Hep3Vector& point,
+                               const Cell& cell,
+                               CLHEP::Hep3Vector& result) const;
+
+        // A copy of this map keeping every stride'th grid point in each direction, held in
+        // memory.  Used to study the accuracy of the interpolation styles on coarser grids.
+        std::shared_ptr<BFGridMap> coarsened(unsigned stride) const;
+
+        // True if the field values come from a memory-mapped file.
+        bool isMapped() const { return _mapped != nullptr; }
+        std::shared_ptr<const BFMappedGrid> const& mappedGrid() const { return _mapped; }
+
         // returns vector from ipos to pos normalized to grid spacing
         CLHEP::Hep3Vector cellFraction(const CLHEP::Hep3Vector& pos, const GridPoint& ipos) const;
 
@@ -115,6 +186,9 @@ namespace mu2e {
         // If all grid points are valid then _isDefined is not needed.
         bool _allDefined;
 
+        // Field values for maps read from the mapped binary format; _field is then empty.
+        std::shared_ptr<const BFMappedGrid> _mapped;
+
         // Flag to flip Y component for maps that assume XZ-plane symmetry.
         bool _flipy = true;
 
@@ -123,6 +197,10 @@ namespace mu2e {
 
         // Functions used internally and by the code that populates the maps.
 
+        bool isDefined(unsigned ix, unsigned iy, unsigned iz) const {
+            return _allDefined || _isDefined(ix, iy, iz);
+        }
+
         // method to store the neighbors
         bool getNeighbors(int ix, int iy, int iz, CLHEP::Hep3Vector neighborsBF[3][3][3]) const;
 
@@ -142,6 +220,62 @@ namespace mu2e {
 
         bool interpolateTriLinear(const CLHEP::Hep3Vector&, CLHEP::Hep3Vector&) const;
 
+        // Higher order interpolation; see getBFieldWithStyle.
+        bool interpolateQuadratic(const CLHEP::Hep3Vector&, CLHEP::Hep3Vector&) const;
+        bool interpolateTriCubic(const CLHEP::Hep3Vector&, CLHEP::Hep3Vector&) const;
+
+        // Find the cell containing a point (after the y reflection, if any) and the
+        // fractional position t = (p - corner)/d in it.  Returns false if outside the map;
+        // locateCell also issues the warning requested by _warnIfOutside, findCell does not.
+        bool findCell(const CLHEP::Hep3Vector& p,
+                      int& i,
+                      int& j,
+                      int& k,
+                      double& tx,
+                      double& ty,
+                      double& tz) const;
+        bool locateCell(const CLHEP::Hep3Vector& p,
+                        int& i,
+                        int& j,
+                        int& k,
+                        double& tx,
+                        double& ty,
+                        double& tz) const;
+
+        // Load the field at the 8 corners of cell (i,j,k); bit 0 of the index is x,
+        // bit 1 is y and bit 2 is z.
+        void getCorners(int i, int j, int k, CLHEP::Hep3Vector c[8]) const {
+            c[0] = fieldAt(i, j, k);
+            c[1] = fieldAt(i + 1, j, k);
+            c[2] = fieldAt(i, j + 1, k);
+            c[3] = fieldAt(i + 1, j + 1, k);
+            c[4] = fieldAt(i, j, k + 1);
+            c[5] = fieldAt(i + 1, j, k + 1);
+            c[6] = fieldAt(i, j + 1, k + 1);
+            c[7] = fieldAt(i + 1, j + 1, k + 1);
+        }
+
+        // Trilinear weighted sum of the corners at fractional position (tx,ty,tz), before
+        // the y reflection and the scale factor.
+        CLHEP::Hep3Vector trilinearSum(const CLHEP::Hep3Vector c[8],
+                                       double tx,
+                                       double ty,
+                                       double tz) const;
+
+        // Number of points processed together by getBFieldBatch; sets the size of the
+        // structure-of-arrays scratch blocks on the stack.
+        static constexpr std::size_t batchBlockSize = 64;
+
+        // One block of at most batchBlockSize points.
+        void interpolateTriLinearBlock(std::size_t n,
+                                       const double* x,
+                                       const double* y,
+                                       const double* z,
+                                       double* bx,
+                                       double* by,
+                                       double* bz,
+                                       bool* status) const;
+
     };
 
     inline BFGridMap::GridPoint BFGridMap::point2grid(const CLHEP::Hep3Vector& pos) const {
@@ -14,7 +14,7 @@ namespace mu2e {
 
     class BFInterpolationStyleDetail {
        public:
-        enum enum_type { unknown, unused, trilinear, fit };
+        enum enum_type { unknown, unused, trilinear, fit, tricubic };
 
         static std::string const& typeName();
 
@@ -11,6 +11,7 @@
 // Rewritten again by Brian Pollack to become pure-virtual base class for all types of BFMaps
 //
 
+#include <cstddef>
 #include <ostream>
 #include <string>
 #include "Offline/BFieldGeom/inc/BFInterpolationStyle.hh"
@@ -49,6 +50,44 @@ namespace mu2e {
         // Accessors
         virtual bool getBFieldWithStatus(const CLHEP::Hep3Vector&, CLHEP::Hep3Vector&) const = 0;
 
+        // Field at n points given as structure-of-arrays.  status[i] is set false, and the
+        // field to zero, for points outside the map.  Grid maps override this with a
+        // vectorized kernel; the default loops over getBFieldWithStatus.
+        virtual void getBFieldBatch(std::size_t n,
+                                    const double* x,
+                                    const double* y,
+                                    const double* z,
+                                    double* bx,
+                                    double* by,
+                                    double* bz,
+                                    bool* status) const {
+            CLHEP::Hep3Vector b;
+            for (std::size_t i = 0; i < n; ++i) {
+                status[i] = getBFieldWithStatus(CLHEP::Hep3Vector(x[i], y[i], z[i]), b);
+                bx[i] = b.x();
+                by[i] = b.y();
+                bz[i] = b.z();
+            }
+        }
+
+        // Field and its gradient at one point: grad[j] = dB/dx_j, in tesla/mm.
+        // Grid maps compute both from the same interpolation cell; the default uses
+        // central differences with a step of gradientStep.
+        virtual bool getBFieldAndGradient(const CLHEP::Hep3Vector& point,
+                                          CLHEP::Hep3Vector& result,
+                                          CLHEP::Hep3Vector grad[3]) const {
+            bool retval = getBFieldWithStatus(point, result);
+            for (int j = 0; j < 3; ++j) {
+                CLHEP::Hep3Vector step(0., 0., 0.);
+                step[j] = gradientStep;
+                CLHEP::Hep3Vector bplus, bminus;
+                getBFieldWithStatus(point + step, bplus);
+                getBFieldWithStatus(point - step, bminus);
+                grad[j] = (bplus - bminus) / (2. * gradientStep);
+            }
+            return retval;
+        }
+
         // Validity checker
         virtual bool isValid(const CLHEP::Hep3Vector& point) const = 0;
 
@@ -65,6 +104,9 @@ namespace mu2e {
 
         virtual void print(std::ostream& os) const = 0;
 
+        // Step, in mm, of the default finite-difference gradient.
+        static constexpr double gradientStep = 1.0;
+
        protected:
         // Filename, database key or other id information that describes
         // where this map came from.
@@ -0,0 +1,89 @@
+#ifndef BFieldGeom_BFMappedGrid_hh
+#define BFieldGeom_BFMappedGrid_hh
+//
+// Read-only view of the field values of one grid map, stored in a self-describing
+// binary file that is mmap'ed into memory.  All processes on a node that use the
+// same file share a single copy of the data in the page cache.
+//
+// File layout:
+//   Header (padded to payloadOffset, a multiple of the page size)
+//   Payload: nx*ny*nz*3 values, either float or double, in the same order as
+//            Container3D: index = ix*ny*nz + iy*nz + iz; (Bx,By,Bz) per point.
+// Field values are stored before the scale factor is applied.
+//
+// The files are written by BFieldManagerMaker::writeMappedBinary.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "CLHEP/Vector/ThreeVector.h"
+
+namespace mu2e {
+
+    class BFMappedGrid {
+       public:
+        // On-disk header; only fixed size types.
+        struct Header {
+            char magic[8];         // "MU2EBFM"
+            uint32_t endian;       // 0xDEADBEEF
+            uint32_t version;      // of this layout
+            uint32_t bytesPerValue;  // 4 (float) or 8 (double)
+            uint32_t flipy;        // the map covers y>0 only; By changes sign for y<0
+            uint32_t nx, ny, nz;
+            uint32_t pad;
+            double xmin, ymin, zmin;
+            double dx, dy, dz;
+            uint64_t payloadOffset;  // bytes from the start of the file
+            uint64_t payloadBytes;
+        };
+
+        static constexpr uint32_t currentVersion = 1;
+        static constexpr uint32_t endianMarker = 0xDEADBEEF;
+        static constexpr uint64_t payloadAlignment = 4096;
+
+        // Fill the identification fields of a header; the caller fills the rest.
+        static Header makeHeader(uint32_t bytesPerValue);
+
+        // Map the file; throws on any inconsistency.
+        explicit BFMappedGrid(std::string const& filename);
+        ~BFMappedGrid();
+
+        // The mapping is owned; not copyable.
+        BFMappedGrid(BFMappedGrid const&) = delete;
+        BFMappedGrid& operator=(BFMappedGrid const&) = delete;
+
+        Header const& header() const { return _header; }
+        std::string const& filename() const { return _filename; }
+        bool singlePrecision() const { return _fvals != nullptr; }
+
+        // Field value at a grid point, without safety features.
+        CLHEP::Hep3Vector field(unsigned ix, unsigned iy, unsigned iz) const {
+            std::size_t i = 3 * index(ix, iy, iz);
+            if (_fvals) {
+                return CLHEP::Hep3Vector(_fvals[i], _fvals[i + 1], _fvals[i + 2]);
+            }
+            return CLHEP::Hep3Vector(_dvals[i], _dvals[i + 1], _dvals[i + 2]);
+        }
+
+       private:
+        std::string _filename;
+        Header _header;
+
+        // The mapped region, the whole file.
+        void* _addr;
+        std::size_t _size;
+
+        // Exactly one of these points into the payload.
+        float const* _fvals;
+        double const* _dvals;
+
+        std::size_t index(unsigned ix, unsigned iy, unsigned iz) const {
+            return (std::size_t(ix) * _header.ny + iy) * _header.nz + iz;
+        }
+    };
+
+}  // namespace mu2e
+
+#endif /* BFieldGeom_BFMappedGrid_hh */
@@ -60,13 +60,26 @@ namespace mu2e {
         // to trigger the map-writing hack inside the BFieldManagerMaker code.
         bool writeBinaries() const { return writeBinaries_; }
 
+        // Write each G4BL map in the memory-mappable format, optionally as float32.
+        bool writeMappedBinaries() const { return writeMappedBinaries_; }
+        bool mappedSinglePrecision() const { return mappedSinglePrecision_; }
+
+        // Prefer a .bfmap file found next to a configured .header file.
+        bool useMappedMaps() const { return useMappedMaps_; }
+
         int verbosityLevel() const { return verbosityLevel_; }
 
         bool flipBFieldMaps() const { return flipBFieldMaps_; }
 
        private:
         BFieldConfig()
-            : scaleFactor_(1.), writeBinaries_(false), verbosityLevel_(1), flipBFieldMaps_(false) {}
+            : scaleFactor_(1.),
+              writeBinaries_(false),
+              writeMappedBinaries_(false),
+              mappedSinglePrecision_(false),
+              useMappedMaps_(false),
+              verbosityLevel_(1),
+              flipBFieldMaps_(false) {}
 
         // G4BL, PARAM or possible future types.
         BFMapType mapType_;
@@ -89,6 +102,9 @@ namespace mu2e {
         CLHEP::Hep3Vector dsGradientValue_;
 
         bool writeBinaries_;
+        bool writeMappedBinaries_;
+        bool mappedSinglePrecision_;
+        bool useMappedMaps_;
         int verbosityLevel_;
         bool flipBFieldMaps_;
     };
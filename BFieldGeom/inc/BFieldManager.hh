@@ -44,6 +44,39 @@ namespace mu2e {
                                  BFCacheManager const&,
                                  CLHEP::Hep3Vector&) const;
 
+        // Get the field and its gradient, grad[j] = dB/dx_j in tesla/mm, at a point.
+        // Zero field and gradient for points outside of all maps.
+        bool getBFieldAndGradient(const CLHEP::Hep3Vector&,
+                                  CLHEP::Hep3Vector&,
+                                  CLHEP::Hep3Vector grad[3]) const;
+        bool getBFieldAndGradient(const CLHEP::Hep3Vector&,
+                                  BFCacheManager const&,
+                                  CLHEP::Hep3Vector&,
+                                  CLHEP::Hep3Vector grad[3]) const;
+
+        // Get the field at n points given as structure-of-arrays (x[i],y[i],z[i]).
+        // Runs of consecutive points that fall in the same map are passed to that map's
+        // batch kernel in one call.  If status is not null, status[i] tells whether point i
+        // was inside any map; the field is zero for points that are not.
+        // Returns true if all points were inside a map.
+        bool getBFieldBatch(std::size_t n,
+                            const double* x,
+                            const double* y,
+                            const double* z,
+                            double* bx,
+                            double* by,
+                            double* bz,
+                            bool* status = nullptr) const;
+        bool getBFieldBatch(std::size_t n,
+                            const double* x,
+                            const double* y,
+                            const double* z,
+                            BFCacheManager const&,
+                            double* bx,
+                            double* by,
+                            double* bz,
+                            bool* status = nullptr) const;
+
         // Just return zero for out of range.
         CLHEP::Hep3Vector getBField(const CLHEP::Hep3Vector& pos) const {
             // Default c'tor sets all components to zero - which is what we need here.
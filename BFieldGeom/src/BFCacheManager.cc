@@ -5,8 +5,8 @@
 namespace mu2e {
 
     BFCacheManager::BFCacheManager():
-    innerForLastInner(0),
-    innerForLastOuter(0),
+    innerForLastInner(nullptr),
+    innerForLastOuter(nullptr),
     counter(0)
     {
         outerCache.insert( std::make_pair<std::shared_ptr<const BFMap>>(0, CacheElement(0, MapList())) );
@@ -15,6 +15,31 @@ namespace mu2e {
         innerForLastOuter = &p->second;
     }
 
+    BFCacheManager::BFCacheManager(const BFCacheManager& other):
+    innerForLastInner(nullptr),
+    innerForLastOuter(nullptr),
+    counter(0)
+    {
+        *this = other;
+    }
+
+    BFCacheManager& BFCacheManager::operator=(const BFCacheManager& other) {
+        if (this == &other) return *this;
+        outer = other.outer;
+        innerCache = other.innerCache;
+        outerCache = other.outerCache;
+        counter = other.counter;
+        // the hints must refer to the elements of this instance's caches
+        const CacheElement* lastInner = other.innerForLastInner.load(std::memory_order_relaxed);
+        const CacheElement* lastOuter = other.innerForLastOuter.load(std::memory_order_relaxed);
+        CacheType::const_iterator pi = lastInner ? innerCache.find(lastInner->myMap) : innerCache.end();
+        innerForLastInner.store(pi != innerCache.end() ? &pi->second : nullptr, std::memory_order_relaxed);
+        CacheType::const_iterator po = outerCache.find(lastOuter ? lastOuter->myMap : nullptr);
+        assert(po != outerCache.end());
+        innerForLastOuter.store(&po->second, std::memory_order_relaxed);
+        return *this;
+    }
+
     void BFCacheManager::setMaps(const MapContainerType& innerMaps,
                                  const MapContainerType& outerMaps) {
         typedef MapContainerType::const_iterator Iter;
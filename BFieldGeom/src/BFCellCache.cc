@@ -0,0 +1,145 @@
+//
+// A "last cell" cache on top of BFCacheManager.
+//
+
+// C++ includes
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <set>
+
+// Mu2e includes
+#include "Offline/BFieldGeom/inc/BFCellCache.hh"
+#include "Offline/BFieldGeom/inc/BFieldManager.hh"
+
+namespace mu2e {
+
+    // The instances that exist, and the counts of those that no longer do.
+    struct BFCellCacheRegistry {
+        std::mutex mutex;
+        std::set<BFCellCache const*> live;
+        std::map<std::string, BFCellCache::MapStatistics> retired;
+
+        static BFCellCacheRegistry& instance() {
+            static BFCellCacheRegistry registry;
+            return registry;
+        }
+
+        // Add the counts of one instance to a table; the caller holds the mutex.
+        static void add(BFCellCache const& cache,
+                        std::map<std::string, BFCellCache::MapStatistics>& table) {
+            for (std::size_t i = 0; i < cache._keys.size(); ++i) {
+                auto& s = table[cache._keys[i]];
+                s.key = cache._keys[i];
+                s.calls += cache._counters[i].calls.load(std::memory_order_relaxed);
+                s.hits += cache._counters[i].hits.load(std::memory_order_relaxed);
+            }
+        }
+    };
+
+    BFCellCache::BFCellCache(BFieldManager const& bfmgr)
+        : _cm(bfmgr.cacheManager()),
+          _nInner(bfmgr.getInnerMaps().size()),
+          _map(nullptr),
+          _grid(nullptr),
+          _index(0) {
+        for (auto const* maps : {&bfmgr.getInnerMaps(), &bfmgr.getOuterMaps()}) {
+            for (auto const& m : *maps) {
+                _maps.push_back(m.get());
+                _keys.push_back(m->getKey());
+            }
+        }
+        _keys.push_back("");
+        _counters.reset(new Counter[_keys.size()]);
+        _index = _maps.size();
+
+        auto& registry = BFCellCacheRegistry::instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.live.insert(this);
+    }
+
+    BFCellCache::~BFCellCache() {
+        auto& registry = BFCellCacheRegistry::instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        BFCellCacheRegistry::add(*this, registry.retired);
+        registry.live.erase(this);
+    }
+
+    bool BFCellCache::getBFieldWithStatus(const CLHEP::Hep3Vector& point,
+                                          CLHEP::Hep3Vector& result) {
+        // Still in the cell of the last call to an inner map: nothing else can claim the
+        // point, so the map lookup is not needed.
+        bool cellTested = _grid && _index < _nInner;
+        if (cellTested && _grid->interpolateInCell(point, _cell, result)) {
+            increment(_counters[_index].calls);
+            increment(_counters[_index].hits);
+            return true;
+        }
+
+        auto m = _cm.findMap(point);
+        if (m.get() != _map) {
+            setMap(m.get());
+            cellTested = false;
+        }
+        increment(_counters[_index].calls);
+
+        if (!_map) {
+            result = CLHEP::Hep3Vector(0., 0., 0.);
+            return false;
+        }
+        if (!_grid) {
+            return _map->getBFieldWithStatus(point, result);
+        }
+        if (!cellTested && _grid->interpolateInCell(point, _cell, result)) {
+            increment(_counters[_index].hits);
+            return true;
+        }
+        if (_grid->loadCell(point, _cell) && _grid->interpolateInCell(point, _cell, result)) {
+            return true;
+        }
+        return _map->getBFieldWithStatus(point, result);
+    }
+
+    void BFCellCache::setMap(BFMap const* map) {
+        _map = map;
+        _index = _maps.size();
+        for (std::size_t i = 0; i < _maps.size(); ++i) {
+            if (_maps[i] == map) {
+                _index = i;
+                break;
+            }
+        }
+        auto grid = dynamic_cast<BFGridMap const*>(map);
+        _grid = (grid && grid->interpolationStyle() == BFInterpolationStyle::trilinear)
+                    ? grid
+                    : nullptr;
+        _cell = BFGridMap::Cell();
+    }
+
+    std::vector<BFCellCache::MapStatistics> BFCellCache::statistics() {
+        auto& registry = BFCellCacheRegistry::instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        auto table = registry.retired;
+        for (auto const* cache : registry.live) {
+            BFCellCacheRegistry::add(*cache, table);
+        }
+        std::vector<MapStatistics> result;
+        for (auto const& entry : table) {
+            result.push_back(entry.second);
+        }
+        return result;
+    }
+
+    void BFCellCache::printStatistics(std::ostream& os) {
+        os << "BFCellCache: field calls and cell cache hits per map\n";
+        for (auto const& s : statistics()) {
+            if (s.calls == 0) continue;
+            os << "  " << std::setw(24) << std::left << (s.key.empty() ? "(no map)" : s.key)
+               << std::right << " calls: " << std::setw(14) << s.calls
+               << "  hits: " << std::setw(14) << s.hits << "  hit rate: " << std::fixed
+               << std::setprecision(4) << double(s.hits) / s.calls << std::defaultfloat
+               << "\n";
+        }
+    }
+
+}  // namespace mu2e
@@ -9,6 +9,7 @@
 // methods.
 
 // C++ includes
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 
@@ -28,6 +29,35 @@ using namespace std;
 
 namespace mu2e {
 
+    BFGridMap::BFGridMap(std::string filename,
+                         std::shared_ptr<const BFMappedGrid> grid,
+                         BFMapType::enum_type atype,
+                         double scale,
+                         BFInterpolationStyle style,
+                         bool warnIfOutside)
+        : BFMap(filename,
+                grid->header().xmin,
+                grid->header().xmin + (grid->header().nx - 1) * grid->header().dx,
+                grid->header().ymin,
+                grid->header().ymin + (grid->header().ny - 1) * grid->header().dy,
+                grid->header().zmin,
+                grid->header().zmin + (grid->header().nz - 1) * grid->header().dz,
+                atype,
+                scale,
+                warnIfOutside),
+          _nx(grid->header().nx),
+          _ny(grid->header().ny),
+          _nz(grid->header().nz),
+          _dx(grid->header().dx),
+          _dy(grid->header().dy),
+          _dz(grid->header().dz),
+          _field(),
+          _isDefined(),
+          _allDefined(true),
+          _mapped(grid),
+          _flipy(grid->header().flipy != 0),
+          _interpStyle(style) {}
+
     // function to determine if the point is in the map; take into account Y-symmetry
     bool BFGridMap::isValid(CLHEP::Hep3Vector const& point) const {
         if (point.x() < _xmin || point.x() > _xmax) {
@@ -68,9 +98,9 @@ namespace mu2e {
                 unsigned int yindex = iy + j - 1;
                 for (int k = 0; k != 3; ++k) {
                     unsigned int zindex = iz + k - 1;
-                    if (!_isDefined(xindex, yindex, zindex))
+                    if (!isDefined(xindex, yindex, zindex))
                         return false;
-                    neighborsBF[i][j][k] = _field(xindex, yindex, zindex);
+                    neighborsBF[i][j][k] = fieldAt(xindex, yindex, zindex);
                     /*
                               cout << "Neighbor(" << xindex << "," << yindex << "," << zindex
                               << ") = (" << neighborsBF(i,j,k).x() << ","
@@ -148,27 +178,168 @@ namespace mu2e {
 
     bool BFGridMap::getBFieldWithStatus(const CLHEP::Hep3Vector& testpoint,
                                         CLHEP::Hep3Vector& result) const {
+        return getBFieldWithStyle(testpoint, result, _interpStyle);
+    }
+
+    bool BFGridMap::getBFieldWithStyle(const CLHEP::Hep3Vector& testpoint,
+                                       CLHEP::Hep3Vector& result,
+                                       BFInterpolationStyle style) const {
         bool retval(false);
 
-        if (_interpStyle == BFInterpolationStyle::trilinear) {
+        if (style == BFInterpolationStyle::trilinear) {
             retval = interpolateTriLinear(testpoint, result);
 
+        } else if (style == BFInterpolationStyle::fit) {
+            retval = interpolateQuadratic(testpoint, result);
+
+        } else if (style == BFInterpolationStyle::tricubic) {
+            retval = interpolateTriCubic(testpoint, result);
+
         } else {
             throw cet::exception("GEOM")
-                << "Unrecognized option for interpolation into the BField: " << _interpStyle
+                << "Unrecognized option for interpolation into the BField: " << style
                 << "\n";
         }
         result *= _scaleFactor;
         return retval;
     }
 
-    // The algorithm is:
-    // Find the grid cube in which the point lives - this defines eight corner points.
-    // Assign a weight to each corner that is the "distance" to each corner - see below for
-    // its precise definition.  The field value at the test point is the weighted sum of
-    // each of the 8 corner points.
-    bool BFGridMap::interpolateTriLinear(const CLHEP::Hep3Vector& p,
+    // Quadratic interpolation on the 3x3x3 neighbourhood of the grid point nearest to the
+    // requested point, using the Lagrange formula in gmcpoly2 along each direction.
+    bool BFGridMap::interpolateQuadratic(const CLHEP::Hep3Vector& p,
                                          CLHEP::Hep3Vector& result) const {
+        result = CLHEP::Hep3Vector(0., 0., 0.);
+        if (_nx < 3 || _ny < 3 || _nz < 3) {
+            throw cet::exception("GEOM")
+                << "Quadratic interpolation needs at least 3 grid points in each direction; map "
+                << _key << " has " << _nx << " x " << _ny << " x " << _nz << "\n";
+        }
+        if (!isValid(p)) {
+            if (_warnIfOutside) {
+                mf::LogWarning("GEOM")
+                    << "Point is outside of the valid region of the map: " << _key << "\n"
+                    << "Point in input coordinates: " << p << "\n";
+            }
+            return false;
+        }
+        const double px = p.x();
+        const double py = _flipy ? std::abs(p.y()) : p.y();
+        const double pz = p.z();
+
+        // Nearest grid point, kept one point away from the edges of the map.
+        int ix = std::clamp(int((px - _xmin) / _dx + 0.5), 1, int(_nx) - 2);
+        int iy = std::clamp(int((py - _ymin) / _dy + 0.5), 1, int(_ny) - 2);
+        int iz = std::clamp(int((pz - _zmin) / _dz + 0.5), 1, int(_nz) - 2);
+
+        CLHEP::Hep3Vector neighborsBF[3][3][3];
+        if (!getNeighbors(ix, iy, iz, neighborsBF)) {
+            if (_warnIfOutside) {
+                mf::LogWarning("GEOM")
+                    << "Point's neighboring field is not defined in the map: " << _key << "\n"
+                    << "Point in input coordinates: " << p << "\n";
+            }
+            return false;
+        }
+
+        // Position measured from the first of the three neighbours, in grid units.
+        CLHEP::Hep3Vector frac((px - _xmin) / _dx - (ix - 1), (py - _ymin) / _dy - (iy - 1),
+                               (pz - _zmin) / _dz - (iz - 1));
+        result = interpolate(neighborsBF, frac);
+
+        if (_flipy && p.y() < 0)
+            result.setY(-result.y());
+        return true;
+    }
+
+    namespace {
+        // Lagrange weights for 4 points at 0,1,2,3, evaluated at u.
+        void lagrangeCubicWeights(double u, double w[4]) {
+            const double u0 = u, u1 = u - 1.0, u2 = u - 2.0, u3 = u - 3.0;
+            w[0] = -u1 * u2 * u3 / 6.0;
+            w[1] = u0 * u2 * u3 / 2.0;
+            w[2] = -u0 * u1 * u3 / 2.0;
+            w[3] = u0 * u1 * u2 / 6.0;
+        }
+    }  // namespace
+
+    // Cubic interpolation on the 4x4x4 grid points around the cell that contains the point.
+    // Near the edges of the map the stencil is shifted inwards.  The weights are separable,
+    // so they are computed once per direction (4+4+4 numbers) rather than stored per cell.
+    bool BFGridMap::interpolateTriCubic(const CLHEP::Hep3Vector& p,
+                                        CLHEP::Hep3Vector& result) const {
+        if (_nx < 4 || _ny < 4 || _nz < 4) {
+            throw cet::exception("GEOM")
+                << "Tricubic interpolation needs at least 4 grid points in each direction; map "
+                << _key << " has " << _nx << " x " << _ny << " x " << _nz << "\n";
+        }
+        int i, j, k;
+        double tx, ty, tz;
+        if (!locateCell(p, i, j, k, tx, ty, tz)) {
+            result = CLHEP::Hep3Vector(0., 0., 0.);
+            return false;
+        }
+
+        // First grid point of the stencil in each direction.
+        const int i0 = std::clamp(i - 1, 0, int(_nx) - 4);
+        const int j0 = std::clamp(j - 1, 0, int(_ny) - 4);
+        const int k0 = std::clamp(k - 1, 0, int(_nz) - 4);
+
+        double wx[4], wy[4], wz[4];
+        lagrangeCubicWeights(tx + (i - i0), wx);
+        lagrangeCubicWeights(ty + (j - j0), wy);
+        lagrangeCubicWeights(tz + (k - k0), wz);
+
+        CLHEP::Hep3Vector sum(0., 0., 0.);
+        for (int a = 0; a != 4; ++a) {
+            for (int b = 0; b != 4; ++b) {
+                // The innermost direction is contiguous in memory.
+                CLHEP::Hep3Vector line(0., 0., 0.);
+                for (int c = 0; c != 4; ++c) {
+                    line += wz[c] * fieldAt(i0 + a, j0 + b, k0 + c);
+                }
+                sum += (wx[a] * wy[b]) * line;
+            }
+        }
+
+        if (_flipy && p.y() < 0)
+            sum.setY(-sum.y());
+        result = sum;
+        return true;
+    }
+
+    std::shared_ptr<BFGridMap> BFGridMap::coarsened(unsigned stride) const {
+        if (stride == 0) {
+            throw cet::exception("GEOM") << "BFGridMap::coarsened: stride must be positive\n";
+        }
+        const unsigned nx = (_nx - 1) / stride + 1;
+        const unsigned ny = (_ny - 1) / stride + 1;
+        const unsigned nz = (_nz - 1) / stride + 1;
+        auto m = std::make_shared<BFGridMap>(_key + "_coarse" + std::to_string(stride),
+                                             nx, _xmin, _dx * stride,
+                                             ny, _ymin, _dy * stride,
+                                             nz, _zmin, _dz * stride,
+                                             _type.id(), _scaleFactor, _interpStyle,
+                                             _warnIfOutside);
+        m->_flipy = _flipy;
+        for (unsigned ix = 0; ix < nx; ++ix) {
+            for (unsigned iy = 0; iy < ny; ++iy) {
+                for (unsigned iz = 0; iz < nz; ++iz) {
+                    m->_field.set(ix, iy, iz, fieldAt(ix * stride, iy * stride, iz * stride));
+                    m->_isDefined.set(ix, iy, iz,
+                                      isDefined(ix * stride, iy * stride, iz * stride));
+                }
+            }
+        }
+        return m;
+    }
+
+    bool BFGridMap::findCell(const CLHEP::Hep3Vector& p,
+                             int& i,
+                             int& j,
+                             int& k,
+                             double& tx,
+                             double& ty,
+                             double& tz) const {
         double px = p.x();
         double py = p.y();
         if (_flipy)
@@ -176,33 +347,83 @@ namespace mu2e {
         double pz = p.z();
 
         // Indicies into each dimension;
-        int i = floor((px - _xmin) / _dx);
-        int j = floor((py - _ymin) / _dy);
-        int k = floor((pz - _zmin) / _dz);
+        i = floor((px - _xmin) / _dx);
+        j = floor((py - _ymin) / _dy);
+        k = floor((pz - _zmin) / _dz);
+
+        // Check that we are inside the map; the index test alone would accept points up
+        // to one cell beyond the upper faces.
+        if (i < 0 || i >= int(_nx) || j < 0 || j >= int(_ny) || k < 0 || k >= int(_nz) ||
+            px > _xmax || py > _ymax || pz > _zmax) {
+            return false;
+        }
+
+        // A point on the upper face of the map belongs to the last cell; this keeps the
+        // corner lookups inside the grid (and inside a mapped file).
+        if (i == int(_nx) - 1) --i;
+        if (j == int(_ny) - 1) --j;
+        if (k == int(_nz) - 1) --k;
+
+        tx = (px - _xmin - i * _dx) / _dx;
+        ty = (py - _ymin - j * _dy) / _dy;
+        tz = (pz - _zmin - k * _dz) / _dz;
+        return true;
+    }
 
-        // Check that we are inside the map.
-        if (i < 0 || i >= int(_nx) || j < 0 || j >= int(_ny) || k < 0 || k >= int(_nz)) {
+    bool BFGridMap::locateCell(const CLHEP::Hep3Vector& p,
+                               int& i,
+                               int& j,
+                               int& k,
+                               double& tx,
+                               double& ty,
+                               double& tz) const {
+        if (!findCell(p, i, j, k, tx, ty, tz)) {
             if (_warnIfOutside) {
                 mf::LogWarning("GEOM")
                     << "Point is outside of the valid region of the map: " << _key << "\n"
                     << "Point in input coordinates: " << p << "\n";
             }
-            result = CLHEP::Hep3Vector(0., 0., 0.);
             return false;
         }
+        return true;
+    }
+
+    bool BFGridMap::loadCell(const CLHEP::Hep3Vector& p, Cell& cell) const {
+        double tx, ty, tz;
+        if (!locateCell(p, cell.i, cell.j, cell.k, tx, ty, tz)) {
+            cell.i = cell.j = cell.k = -1;
+            return false;
+        }
+        getCorners(cell.i, cell.j, cell.k, cell.c);
+        return true;
+    }
 
-        // Trilinear fractional weighting factors.
-        double fx = 1.0 - (px - _xmin - i * _dx) / _dx;
-        double fy = 1.0 - (py - _ymin - j * _dy) / _dy;
-        double fz = 1.0 - (pz - _zmin - k * _dz) / _dz;
+    // The cell test repeats the index computation of locateCell, rather than comparing
+    // against the cell boundaries, so that the fractions, and hence the field, are exactly
+    // those of interpolateTriLinear.
+    bool BFGridMap::interpolateInCell(const CLHEP::Hep3Vector& p,
+                                      const Cell& cell,
+                                      CLHEP::Hep3Vector& result) const {
+        int i, j, k;
+        double tx, ty, tz;
+        if (!findCell(p, i, j, k, tx, ty, tz) || i != cell.i || j != cell.j || k != cell.k) {
+            return false;
+        }
+        result = trilinearSum(cell.c, tx, ty, tz);
+        if (_flipy && p.y() < 0)
+            result.setY(-result.y());
+        result *= _scaleFactor;
+        return true;
+    }
 
-        // Field values at the 8 corner points.
-        // Guess that a copy is faster than a pointer for reasons of locality
-        // of reference in the downstream code?
-        CLHEP::Hep3Vector c[8] = {_field(i, j, k),         _field(i + 1, j, k),
-                                  _field(i, j + 1, k),     _field(i + 1, j + 1, k),
-                                  _field(i, j, k + 1),     _field(i + 1, j, k + 1),
-                                  _field(i, j + 1, k + 1), _field(i + 1, j + 1, k + 1)};
+    CLHEP::Hep3Vector BFGridMap::trilinearSum(const CLHEP::Hep3Vector c[8],
+                                              double tx,
+                                              double ty,
+                                              double tz) const {
+        // Trilinear fractional weighting factors.
+        double fx = 1.0 - tx;
+        double fy = 1.0 - ty;
+        double fz = 1.0 - tz;
 
         double bx = c[0].x() * fx * fy * fz + c[1].x() * (1.0 - fx) * fy * fz +
                     c[2].x() * fx * (1.0 - fy) * fz + c[3].x() * (1.0 - fx) * (1.0 - fy) * fz +
@@ -222,15 +443,201 @@ namespace mu2e {
                     c[6].z() * fx * (1.0 - fy) * (1.0 - fz) +
                     c[7].z() * (1.0 - fx) * (1.0 - fy) * (1.0 - fz);
 
+        return CLHEP::Hep3Vector(bx, by, bz);
+    }
+
+    // The algorithm is:
+    // Find the grid cube in which the point lives - this defines eight corner points.
+    // Assign a weight to each corner that is the "distance" to each corner - see below for
+    // its precise definition.  The field value at the test point is the weighted sum of
+    // each of the 8 corner points.
+    bool BFGridMap::interpolateTriLinear(const CLHEP::Hep3Vector& p,
+                                         CLHEP::Hep3Vector& result) const {
+        int i, j, k;
+        double tx, ty, tz;
+        if (!locateCell(p, i, j, k, tx, ty, tz)) {
+            result = CLHEP::Hep3Vector(0., 0., 0.);
+            return false;
+        }
+
+        // Field values at the 8 corner points.
+        // Guess that a copy is faster than a pointer for reasons of locality
+        // of reference in the downstream code?
+        CLHEP::Hep3Vector c[8];
+        getCorners(i, j, k, c);
+
+        result = trilinearSum(c, tx, ty, tz);
+
         // Need the signed value of p.y() here - the variable py will not do.
         if (_flipy && p.y() < 0)
-            by = -by;
+            result.setY(-result.y());
+
+        return true;
+    }
+
+    // Differentiate the trilinear interpolation analytically, using the same 8 corners as
+    // the field value.  With the y reflection B(x,y,z) = S*B'(x,|y|,z), where S flips By,
+    // so for y<0 the y derivative also changes sign.
+    bool BFGridMap::getBFieldAndGradient(const CLHEP::Hep3Vector& p,
+                                         CLHEP::Hep3Vector& result,
+                                         CLHEP::Hep3Vector grad[3]) const {
+        if (_interpStyle != BFInterpolationStyle::trilinear) {
+            return BFMap::getBFieldAndGradient(p, result, grad);
+        }
+
+        int i, j, k;
+        double tx, ty, tz;
+        if (!locateCell(p, i, j, k, tx, ty, tz)) {
+            result = CLHEP::Hep3Vector(0., 0., 0.);
+            grad[0] = grad[1] = grad[2] = CLHEP::Hep3Vector(0., 0., 0.);
+            return false;
+        }
 
-        result = CLHEP::Hep3Vector(bx, by, bz);
+        CLHEP::Hep3Vector c[8];
+        getCorners(i, j, k, c);
+
+        const double hx = 1.0 - tx, hy = 1.0 - ty, hz = 1.0 - tz;
+
+        // Interpolate along x on the 4 cell edges parallel to x ...
+        CLHEP::Hep3Vector e00 = hx * c[0] + tx * c[1];
+        CLHEP::Hep3Vector e10 = hx * c[2] + tx * c[3];
+        CLHEP::Hep3Vector e01 = hx * c[4] + tx * c[5];
+        CLHEP::Hep3Vector e11 = hx * c[6] + tx * c[7];
+        // ... then along y on the 2 faces of constant z.
+        CLHEP::Hep3Vector f0 = hy * e00 + ty * e10;
+        CLHEP::Hep3Vector f1 = hy * e01 + ty * e11;
+
+        CLHEP::Hep3Vector b = hz * f0 + tz * f1;
+        CLHEP::Hep3Vector dbdz = (f1 - f0) / _dz;
+        CLHEP::Hep3Vector dbdy = (hz * (e10 - e00) + tz * (e11 - e01)) / _dy;
+        CLHEP::Hep3Vector dbdx =
+            (hz * (hy * (c[1] - c[0]) + ty * (c[3] - c[2])) +
+             tz * (hy * (c[5] - c[4]) + ty * (c[7] - c[6]))) / _dx;
+
+        if (_flipy && p.y() < 0) {
+            b.setY(-b.y());
+            dbdx.setY(-dbdx.y());
+            dbdz.setY(-dbdz.y());
+            dbdy = -dbdy;
+            dbdy.setY(-dbdy.y());
+        }
 
+        result = b * _scaleFactor;
+        grad[0] = dbdx * _scaleFactor;
+        grad[1] = dbdy * _scaleFactor;
+        grad[2] = dbdz * _scaleFactor;
         return true;
     }
 
+    void BFGridMap::getBFieldBatch(std::size_t n,
+                                   const double* x,
+                                   const double* y,
+                                   const double* z,
+                                   double* bx,
+                                   double* by,
+                                   double* bz,
+                                   bool* status) const {
+        if (_interpStyle != BFInterpolationStyle::trilinear) {
+            BFMap::getBFieldBatch(n, x, y, z, bx, by, bz, status);
+            return;
+        }
+        for (std::size_t i0 = 0; i0 < n; i0 += batchBlockSize) {
+            std::size_t nb = std::min(batchBlockSize, n - i0);
+            interpolateTriLinearBlock(nb, x + i0, y + i0, z + i0, bx + i0, by + i0, bz + i0,
+                                      status + i0);
+        }
+    }
+
+    // Same algorithm as interpolateTriLinear, split in three passes so that the
+    // arithmetic runs over contiguous arrays and can be vectorized by the compiler:
+    //  1) cell indices and fractional positions for all points;
+    //  2) gather of the 8 corner values into a structure-of-arrays block;
+    //  3) the weighted sums.
+    // Only pass 2 touches the grid.
+    void BFGridMap::interpolateTriLinearBlock(std::size_t n,
+                                              const double* x,
+                                              const double* y,
+                                              const double* z,
+                                              double* bx,
+                                              double* by,
+                                              double* bz,
+                                              bool* status) const {
+        constexpr std::size_t B = batchBlockSize;
+        double tx[B], ty[B], tz[B], ysign[B];
+        int ci[B], cj[B], ck[B];
+
+        // Pass 1: cell indices and fractions.
+        const int nx(_nx), ny(_ny), nz(_nz);
+        for (std::size_t l = 0; l < n; ++l) {
+            double py = _flipy ? std::abs(y[l]) : y[l];
+            ysign[l] = (_flipy && y[l] < 0) ? -1.0 : 1.0;
+            double ux = (x[l] - _xmin) / _dx;
+            double uy = (py - _ymin) / _dy;
+            double uz = (z[l] - _zmin) / _dz;
+            int i = std::floor(ux);
+            int j = std::floor(uy);
+            int k = std::floor(uz);
+            // Same test as findCell: the index test alone would accept points up to one
+            // cell beyond the upper faces.
+            bool inside = i >= 0 && i < nx && j >= 0 && j < ny && k >= 0 && k < nz &&
+                          x[l] <= _xmax && py <= _ymax && z[l] <= _zmax;
+            // Points on the upper face belong to the last cell.
+            i = std::min(i, nx - 2);
+            j = std::min(j, ny - 2);
+            k = std::min(k, nz - 2);
+            tx[l] = ux - i;
+            ty[l] = uy - j;
+            tz[l] = uz - k;
+            status[l] = inside;
+            ci[l] = inside ? i : 0;
+            cj[l] = inside ? j : 0;
+            ck[l] = inside ? k : 0;
+        }
+
+        if (_warnIfOutside) {
+            for (std::size_t l = 0; l < n; ++l) {
+                if (!status[l]) {
+                    mf::LogWarning("GEOM")
+                        << "Point is outside of the valid region of the map: " << _key << "\n"
+                        << "Point in input coordinates: "
+                        << CLHEP::Hep3Vector(x[l], y[l], z[l]) << "\n";
+                }
+            }
+        }
+
+        // Pass 2: gather the corners; c[corner][component][point].
+        // Corner numbering is the same as in interpolateTriLinear: bit 0 is x, bit 1 is y,
+        // bit 2 is z.
+        double c[8][3][B];
+        for (std::size_t l = 0; l < n; ++l) {
+            for (int corner = 0; corner < 8; ++corner) {
+                CLHEP::Hep3Vector b = fieldAt(ci[l] + (corner & 1), cj[l] + ((corner >> 1) & 1),
+                                              ck[l] + ((corner >> 2) & 1));
+                c[corner][0][l] = b.x();
+                c[corner][1][l] = b.y();
+                c[corner][2][l] = b.z();
+            }
+        }
+
+        // Pass 3: trilinear weights and sums.
+        double* out[3] = {bx, by, bz};
+        for (int comp = 0; comp < 3; ++comp) {
+            double* o = out[comp];
+            for (std::size_t l = 0; l < n; ++l) {
+                const double gx = tx[l], gy = ty[l], gz = tz[l];
+                const double hx = 1.0 - gx, hy = 1.0 - gy, hz = 1.0 - gz;
+                double b = hz * (hy * (hx * c[0][comp][l] + gx * c[1][comp][l]) +
+                                 gy * (hx * c[2][comp][l] + gx * c[3][comp][l])) +
+                           gz * (hy * (hx * c[4][comp][l] + gx * c[5][comp][l]) +
+                                 gy * (hx * c[6][comp][l] + gx * c[7][comp][l]));
+                double scale = status[l] ? _scaleFactor : 0.0;
+                if (comp == 1) {
+                    scale *= ysign[l];
+                }
+                o[l] = b * scale;
+            }
+        }
+    }
 
     bool BFGridMap::getNeighborPointBF(const CLHEP::Hep3Vector& testpoint,
                                        CLHEP::Hep3Vector neighborPoints[3],
@@ -281,7 +688,7 @@ namespace mu2e {
 
         // check if the point had a field defined
 
-        if (!_isDefined(ix, iy, iz)) {
+        if (!isDefined(ix, iy, iz)) {
             if (_warnIfOutside) {
                 mf::LogWarning("GEOM")
                     << "Point's field is not defined in the map: " << _key << "\n"
@@ -299,7 +706,7 @@ namespace mu2e {
                 unsigned int yindex = iy + j - 1;
                 for (int k = 0; k != 3; ++k) {
                     unsigned int zindex = iz + k - 1;
-                    if (!_isDefined(xindex, yindex, zindex)) {
+                    if (!isDefined(xindex, yindex, zindex)) {
                         if (_warnIfOutside) {
                             mf::LogWarning("GEOM")
                                 << "Point's neighboring field is not defined in the map: " << _key
@@ -310,7 +717,7 @@ namespace mu2e {
                         }
                         return false;
                     }
-                    neighborBF[i][j][k] = _field(xindex, yindex, zindex);
+                    neighborBF[i][j][k] = fieldAt(xindex, yindex, zindex);
                     // Reassign y sign
                     if (_flipy && sign == -1) {
                         neighborBF[i][j][k].setY(-neighborBF[i][j][k].y());
@@ -340,11 +747,16 @@ namespace mu2e {
              << endl;
         cout << "Distance:       " << _dx << " " << _dy << " " << _dz << endl;
 
-        cout << "Field at the edges: " << _field(0, 0, 0) << ", " << _field(_nx - 1, 0, 0) << ", "
-             << _field(0, _ny - 1, 0) << ", " << _field(0, 0, _nz - 1) << ", "
-             << _field(_nx - 1, _ny - 1, 0) << ", " << _field(_nx - 1, _ny - 1, _nz - 1) << endl;
+        cout << "Field at the edges: " << fieldAt(0, 0, 0) << ", " << fieldAt(_nx - 1, 0, 0) << ", "
+             << fieldAt(0, _ny - 1, 0) << ", " << fieldAt(0, 0, _nz - 1) << ", "
+             << fieldAt(_nx - 1, _ny - 1, 0) << ", " << fieldAt(_nx - 1, _ny - 1, _nz - 1) << endl;
 
-        cout << "Field in the middle: " << _field(_nx / 2, _ny / 2, _nz / 2) << endl;
+        cout << "Field in the middle: " << fieldAt(_nx / 2, _ny / 2, _nz / 2) << endl;
+
+        if (_mapped) {
+            cout << "Field values mapped from: " << _mapped->filename() << " ("
+                 << (_mapped->singlePrecision() ? "float" : "double") << ")" << endl;
+        }
 
         if (_warnIfOutside) {
             cout << "Will warn if outside of the valid region." << endl;
@@ -0,0 +1,130 @@
+//
+// Read-only view of a memory-mapped grid field map.
+//
+
+// C++ includes
+#include <cstring>
+
+// Includes from C ( needed for mmap ).
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+// Framework includes
+#include "cetlib_except/exception.h"
+
+// Mu2e includes
+#include "Offline/BFieldGeom/inc/BFMappedGrid.hh"
+
+namespace mu2e {
+
+    namespace {
+        const char mappedGridMagic[8] = "MU2EBFM";
+    }
+
+    BFMappedGrid::Header BFMappedGrid::makeHeader(uint32_t bytesPerValue) {
+        Header h;
+        std::memset(&h, 0, sizeof(h));
+        std::memcpy(h.magic, mappedGridMagic, sizeof(h.magic));
+        h.endian = endianMarker;
+        h.version = currentVersion;
+        h.bytesPerValue = bytesPerValue;
+        h.payloadOffset = payloadAlignment;
+        return h;
+    }
+
+    BFMappedGrid::BFMappedGrid(std::string const& filename)
+        : _filename(filename), _addr(nullptr), _size(0), _fvals(nullptr), _dvals(nullptr) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            int errsave = errno;
+            throw cet::exception("GEOM") << "BFMappedGrid: Error opening " << filename
+                                         << "  errno: " << errsave << " " << strerror(errsave)
+                                         << "\n";
+        }
+
+        struct stat info;
+        if (fstat(fd, &info)) {
+            int errsave = errno;
+            close(fd);
+            throw cet::exception("GEOM") << "BFMappedGrid: Error doing fstat() on " << filename
+                                         << "  errno: " << errsave << " " << strerror(errsave)
+                                         << "\n";
+        }
+        _size = info.st_size;
+        if (_size < sizeof(Header)) {
+            close(fd);
+            throw cet::exception("GEOM")
+                << "BFMappedGrid: file " << filename << " is too short to hold a header\n";
+        }
+
+        // MAP_SHARED on a read-only mapping: the pages come straight from the page cache
+        // and are shared with every other process that maps the same file.
+        _addr = mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+        int errsave = errno;
+        close(fd);
+        if (_addr == MAP_FAILED) {
+            _addr = nullptr;
+            throw cet::exception("GEOM") << "BFMappedGrid: Error doing mmap() on " << filename
+                                         << "  errno: " << errsave << " " << strerror(errsave)
+                                         << "\n";
+        }
+
+        std::memcpy(&_header, _addr, sizeof(Header));
+
+        // From here on, release the mapping if any check fails.
+        try {
+            if (std::memcmp(_header.magic, mappedGridMagic, sizeof(_header.magic)) != 0) {
+                throw cet::exception("GEOM")
+                    << "BFMappedGrid: " << filename << " is not a mapped field map file\n";
+            }
+            if (_header.endian != endianMarker) {
+                throw cet::exception("GEOM")
+                    << "BFMappedGrid: endian mismatch in " << filename << "  returned value: "
+                    << std::hex << _header.endian << "  expected value: " << endianMarker
+                    << std::dec << "\n";
+            }
+            if (_header.version != currentVersion) {
+                throw cet::exception("GEOM")
+                    << "BFMappedGrid: " << filename << " has version " << _header.version
+                    << "; this code reads version " << currentVersion << "\n";
+            }
+            if (_header.bytesPerValue != sizeof(float) &&
+                _header.bytesPerValue != sizeof(double)) {
+                throw cet::exception("GEOM")
+                    << "BFMappedGrid: " << filename << " has unsupported value size "
+                    << _header.bytesPerValue << "\n";
+            }
+            const uint64_t npoints = uint64_t(_header.nx) * _header.ny * _header.nz;
+            if (npoints == 0 || _header.payloadBytes != 3 * npoints * _header.bytesPerValue ||
+                _header.payloadOffset % _header.bytesPerValue != 0 ||
+                _header.payloadOffset + _header.payloadBytes != _size) {
+                throw cet::exception("GEOM")
+                    << "BFMappedGrid: the size = " << _size << " of the file " << filename
+                    << " does not match its header: " << _header.nx << " x " << _header.ny
+                    << " x " << _header.nz << " points of " << _header.bytesPerValue
+                    << " bytes at offset " << _header.payloadOffset << "\n";
+            }
+        } catch (...) {
+            munmap(_addr, _size);
+            throw;
+        }
+
+        const char* payload = static_cast<const char*>(_addr) + _header.payloadOffset;
+        if (_header.bytesPerValue == sizeof(float)) {
+            _fvals = reinterpret_cast<const float*>(payload);
+        } else {
+            _dvals = reinterpret_cast<const double*>(payload);
+        }
+    }
+
+    BFMappedGrid::~BFMappedGrid() {
+        if (_addr) {
+            munmap(_addr, _size);
+        }
+    }
+
+}  // namespace mu2e
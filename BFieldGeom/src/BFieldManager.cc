@@ -41,6 +41,78 @@ namespace mu2e {
         return (m != 0);
     }
 
+    bool BFieldManager::getBFieldAndGradient(const CLHEP::Hep3Vector& point,
+                                             CLHEP::Hep3Vector& result,
+                                             CLHEP::Hep3Vector grad[3]) const {
+        return getBFieldAndGradient(point, cm_, result, grad);
+    }
+
+    bool BFieldManager::getBFieldAndGradient(const CLHEP::Hep3Vector& point,
+                                             BFCacheManager const& cmgr,
+                                             CLHEP::Hep3Vector& result,
+                                             CLHEP::Hep3Vector grad[3]) const {
+        auto m = cmgr.findMap(point);
+
+        if (m) {
+            m->getBFieldAndGradient(point, result, grad);
+        } else {
+            result = CLHEP::Hep3Vector(0., 0., 0.);
+            grad[0] = grad[1] = grad[2] = CLHEP::Hep3Vector(0., 0., 0.);
+        }
+
+        return (m != 0);
+    }
+
+    bool BFieldManager::getBFieldBatch(std::size_t n,
+                                       const double* x,
+                                       const double* y,
+                                       const double* z,
+                                       double* bx,
+                                       double* by,
+                                       double* bz,
+                                       bool* status) const {
+        return getBFieldBatch(n, x, y, z, cm_, bx, by, bz, status);
+    }
+
+    // Map selection is done point by point, exactly as for a single point, so overlapping
+    // inner and outer maps are resolved in the same way; with the cache this costs one
+    // isValid call per point while the points stay in one map.
+    bool BFieldManager::getBFieldBatch(std::size_t n,
+                                       const double* x,
+                                       const double* y,
+                                       const double* z,
+                                       BFCacheManager const& cmgr,
+                                       double* bx,
+                                       double* by,
+                                       double* bz,
+                                       bool* status) const {
+        // Scratch for the per-map status when the caller does not want it.
+        constexpr std::size_t nlocal = 64;
+        bool localStatus[nlocal];
+
+        bool allFound(true);
+        std::size_t i = 0;
+        while (i < n) {
+            auto m = cmgr.findMap(CLHEP::Hep3Vector(x[i], y[i], z[i]));
+            std::size_t j = i + 1;
+            while (j < n && (status != nullptr || j - i < nlocal) &&
+                   cmgr.findMap(CLHEP::Hep3Vector(x[j], y[j], z[j])) == m) {
+                ++j;
+            }
+            bool* st = status ? status + i : localStatus;
+            if (m) {
+                m->getBFieldBatch(j - i, x + i, y + i, z + i, bx + i, by + i, bz + i, st);
+            } else {
+                for (std::size_t k = 0; k < j - i; ++k) {
+                    bx[i + k] = by[i + k] = bz[i + k] = 0.;
+                    st[k] = false;
+                }
+            }
+            allFound = allFound && (m != nullptr);
+            i = j;
+        }
+        return allFound;
+    }
 
   BFieldManager::BFieldManager(MapContainerType const& innerMaps,
                                MapContainerType const& outerMaps):
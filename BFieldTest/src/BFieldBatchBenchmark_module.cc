@@ -0,0 +1,223 @@
+//
+// Microbenchmark of BFieldManager::getBFieldBatch against the one-point-at-a-time
+// BFieldManager::getBFieldWithStatus.
+//
+// Points are drawn along straight segments inside the volume of one named map,
+// mimicking a fit or an extrapolation that samples the field along a trajectory:
+// each segment starts at a random point of the map and takes batchSize steps of
+// stepLength in a random direction.  Both paths are timed over the same points
+// and the largest difference between the two results is reported.
+//
+// Before timing, the two paths are compared on points just inside and just
+// outside each face of the map, where they must agree on whether the point is
+// inside the map; an exception is thrown if they do not.
+//
+// The work is done in the beginRun member function, as in BFieldSymmetry.
+//
+
+#include "Offline/BFieldGeom/inc/BFGridMap.hh"
+#include "Offline/BFieldGeom/inc/BFieldManager.hh"
+#include "Offline/GeometryService/inc/GeomHandle.hh"
+#include "Offline/SeedService/inc/SeedService.hh"
+
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Run.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+#include "CLHEP/Random/RandFlat.h"
+#include "CLHEP/Units/PhysicalConstants.h"
+#include "CLHEP/Vector/ThreeVector.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mu2e {
+
+    class BFieldBatchBenchmark : public art::EDAnalyzer {
+       public:
+        explicit BFieldBatchBenchmark(const fhicl::ParameterSet& pset);
+
+        void beginRun(const art::Run& run) override;
+        void analyze(const art::Event&) override {}
+
+       private:
+        // Compare the batched and the scalar evaluation of one map near its faces.
+        void checkFaces(const BFMap& map);
+
+        // Name of the map in which points are drawn.
+        std::string mapName_;
+
+        // Number of trajectory segments, points per segment (= points per batch call)
+        // and the distance between consecutive points.
+        int nSegments_;
+        int batchSize_;
+        double stepLength_;
+
+        // Number of times each timing loop is repeated.
+        int nRepeat_;
+
+        // Uniform flat random distribution.
+        CLHEP::RandFlat flat_;
+    };
+
+}  // namespace mu2e
+
+mu2e::BFieldBatchBenchmark::BFieldBatchBenchmark(const fhicl::ParameterSet& pset)
+    : art::EDAnalyzer(pset),
+      mapName_(pset.get<std::string>("mapName", "DSMap")),
+      nSegments_(pset.get<int>("nSegments", 10000)),
+      batchSize_(pset.get<int>("batchSize", 32)),
+      stepLength_(pset.get<double>("stepLength", 10.)),
+      nRepeat_(pset.get<int>("nRepeat", 10)),
+      flat_(createEngine(art::ServiceHandle<mu2e::SeedService>()->getSeed())) {}
+
+void mu2e::BFieldBatchBenchmark::beginRun(const art::Run& run) {
+    GeomHandle<BFieldManager> bfmgr;
+
+    // Find the named map; it defines the volume in which points are drawn.
+    std::shared_ptr<const BFMap> map;
+    for (auto const* maps : {&bfmgr->getInnerMaps(), &bfmgr->getOuterMaps()}) {
+        for (auto const& m : *maps) {
+            if (m->getKey() == mapName_) map = m;
+        }
+    }
+    if (!map) {
+        throw cet::exception("GEOM") << "BFieldBatchBenchmark: cannot find the map named: "
+                                     << mapName_ << "\n";
+    }
+    checkFaces(*map);
+
+    // Draw the points in structure-of-arrays form.
+    const size_t npoints = size_t(nSegments_) * batchSize_;
+    std::vector<double> x, y, z;
+    x.reserve(npoints);
+    y.reserve(npoints);
+    z.reserve(npoints);
+    for (int iseg = 0; iseg < nSegments_; ++iseg) {
+        CLHEP::Hep3Vector p(flat_.fire(map->xmin(), map->xmax()),
+                            flat_.fire(map->ymin(), map->ymax()),
+                            flat_.fire(map->zmin(), map->zmax()));
+        double cost = flat_.fire(-1., 1.);
+        double phi = flat_.fire(0., CLHEP::twopi);
+        double sint = std::sqrt(1. - cost * cost);
+        CLHEP::Hep3Vector step(stepLength_ * sint * std::cos(phi),
+                               stepLength_ * sint * std::sin(phi), stepLength_ * cost);
+        for (int i = 0; i < batchSize_; ++i, p += step) {
+            x.push_back(p.x());
+            y.push_back(p.y());
+            z.push_back(p.z());
+        }
+    }
+
+    std::vector<double> sx(npoints), sy(npoints), sz(npoints);
+    std::vector<double> bx(npoints), by(npoints), bz(npoints);
+    std::unique_ptr<bool[]> status(new bool[batchSize_]);
+
+    // The scalar path, one point per call.
+    BFCacheManager cm(bfmgr->cacheManager());
+    auto t0 = std::chrono::steady_clock::now();
+    for (int irep = 0; irep < nRepeat_; ++irep) {
+        CLHEP::Hep3Vector b;
+        for (size_t i = 0; i < npoints; ++i) {
+            bfmgr->getBFieldWithStatus(CLHEP::Hep3Vector(x[i], y[i], z[i]), cm, b);
+            sx[i] = b.x();
+            sy[i] = b.y();
+            sz[i] = b.z();
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    // The batched path, one call per segment.
+    for (int irep = 0; irep < nRepeat_; ++irep) {
+        for (size_t i = 0; i < npoints; i += batchSize_) {
+            bfmgr->getBFieldBatch(batchSize_, &x[i], &y[i], &z[i], cm, &bx[i], &by[i], &bz[i],
+                                  status.get());
+        }
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    double maxDiff(0.);
+    for (size_t i = 0; i < npoints; ++i) {
+        maxDiff = std::max({maxDiff, std::abs(bx[i] - sx[i]), std::abs(by[i] - sy[i]),
+                            std::abs(bz[i] - sz[i])});
+    }
+
+    const double nevals = double(npoints) * nRepeat_;
+    const double tScalar = std::chrono::duration<double, std::nano>(t1 - t0).count() / nevals;
+    const double tBatch = std::chrono::duration<double, std::nano>(t2 - t1).count() / nevals;
+
+    mf::LogInfo("BFieldBatchBenchmark")
+        << "Map " << mapName_ << ": " << npoints << " points in batches of " << batchSize_
+        << ", step " << stepLength_ << " mm, " << nRepeat_ << " repetitions\n"
+        << "  scalar: " << tScalar << " ns/point\n"
+        << "  batch:  " << tBatch << " ns/point  (speedup " << tScalar / tBatch << ")\n"
+        << "  largest |B(batch) - B(scalar)|: " << maxDiff << " T\n";
+}
+
+void mu2e::BFieldBatchBenchmark::checkFaces(const BFMap& map) {
+    // Offsets from each face, in units of the grid spacing (1 mm for other maps):
+    // negative is inside the map, positive outside.
+    const std::vector<double> offsets = {-0.5, -1.e-6, 0., 1.e-6, 0.01, 0.5, 0.99, 1.5};
+    double dx(1.), dy(1.), dz(1.);
+    if (auto const* grid = dynamic_cast<const BFGridMap*>(&map)) {
+        dx = grid->dx();
+        dy = grid->dy();
+        dz = grid->dz();
+    }
+    const double lo[3] = {map.xmin(), map.ymin(), map.zmin()};
+    const double hi[3] = {map.xmax(), map.ymax(), map.zmax()};
+    const double step[3] = {dx, dy, dz};
+
+    // Points on each of the six faces, at a random position within the face.
+    std::vector<double> x, y, z;
+    for (int axis = 0; axis < 3; ++axis) {
+        for (int upper = 0; upper < 2; ++upper) {
+            for (double offset : offsets) {
+                double p[3];
+                for (int a = 0; a < 3; ++a) p[a] = flat_.fire(lo[a], hi[a]);
+                p[axis] = upper ? hi[axis] + offset * step[axis] : lo[axis] - offset * step[axis];
+                x.push_back(p[0]);
+                y.push_back(p[1]);
+                z.push_back(p[2]);
+            }
+        }
+    }
+
+    const size_t n = x.size();
+    std::vector<double> bx(n), by(n), bz(n);
+    std::unique_ptr<bool[]> status(new bool[n]);
+    map.getBFieldBatch(n, x.data(), y.data(), z.data(), bx.data(), by.data(), bz.data(),
+                       status.get());
+
+    int nbad(0);
+    for (size_t i = 0; i < n; ++i) {
+        CLHEP::Hep3Vector p(x[i], y[i], z[i]), b;
+        bool inside = map.getBFieldWithStatus(p, b);
+        bool same = inside == status[i];
+        if (same && inside) {
+            same = std::abs(bx[i] - b.x()) < 1.e-9 && std::abs(by[i] - b.y()) < 1.e-9 &&
+                   std::abs(bz[i] - b.z()) < 1.e-9;
+        }
+        if (!same) {
+            ++nbad;
+            mf::LogError("BFieldBatchBenchmark")
+                << "Batch and scalar field differ at " << p << ": scalar " << inside << " " << b
+                << ", batch " << status[i] << " " << CLHEP::Hep3Vector(bx[i], by[i], bz[i]);
+        }
+    }
+    if (nbad > 0) {
+        throw cet::exception("GEOM") << "BFieldBatchBenchmark: batch and scalar field differ at "
+                                     << nbad << " of " << n << " points near the faces of map "
+                                     << mapName_ << "\n";
+    }
+    mf::LogInfo("BFieldBatchBenchmark")
+        << "Map " << mapName_ << ": batch and scalar field agree at " << n
+        << " points near the faces";
+}
+
+DEFINE_ART_MODULE(mu2e::BFieldBatchBenchmark)
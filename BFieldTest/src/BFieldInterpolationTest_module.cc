@@ -0,0 +1,156 @@
+//
+// Compare the accuracy and the speed of the BFGridMap interpolation styles.
+//
+// For each named grid map a coarser copy is made, keeping every stride'th grid point.
+// Accuracy: each style is evaluated on the coarse map at grid points of the full map
+// that were dropped from the coarse one; at those points the true value is known.
+// Speed: each style is timed on both maps over the same random points.
+//
+// The work is done in the beginRun member function, as in BFieldSymmetry.
+//
+
+#include "Offline/BFieldGeom/inc/BFGridMap.hh"
+#include "Offline/BFieldGeom/inc/BFieldManager.hh"
+#include "Offline/GeometryService/inc/GeomHandle.hh"
+#include "Offline/SeedService/inc/SeedService.hh"
+
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Run.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+#include "CLHEP/Random/RandFlat.h"
+#include "CLHEP/Vector/ThreeVector.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace mu2e {
+
+    class BFieldInterpolationTest : public art::EDAnalyzer {
+       public:
+        explicit BFieldInterpolationTest(const fhicl::ParameterSet& pset);
+
+        void beginRun(const art::Run& run) override;
+        void analyze(const art::Event&) override {}
+
+       private:
+        std::vector<std::string> mapNames_;
+        std::vector<std::string> styles_;
+
+        // Keep every stride'th point of the full map in the coarse map.
+        unsigned stride_;
+
+        // Number of points for the accuracy test and for the timing.
+        int nAccuracyPoints_;
+        int nTimingPoints_;
+
+        CLHEP::RandFlat flat_;
+
+        // Mean time per evaluation, in ns, of one style on one map.
+        double timeStyle(BFGridMap const& map,
+                         BFInterpolationStyle style,
+                         std::vector<CLHEP::Hep3Vector> const& points) const;
+    };
+
+}  // namespace mu2e
+
+mu2e::BFieldInterpolationTest::BFieldInterpolationTest(const fhicl::ParameterSet& pset)
+    : art::EDAnalyzer(pset),
+      mapNames_(pset.get<std::vector<std::string>>("mapNames")),
+      styles_(pset.get<std::vector<std::string>>("styles")),
+      stride_(pset.get<unsigned>("stride", 2)),
+      nAccuracyPoints_(pset.get<int>("nAccuracyPoints", 100000)),
+      nTimingPoints_(pset.get<int>("nTimingPoints", 1000000)),
+      flat_(createEngine(art::ServiceHandle<mu2e::SeedService>()->getSeed())) {}
+
+double mu2e::BFieldInterpolationTest::timeStyle(
+    BFGridMap const& map,
+    BFInterpolationStyle style,
+    std::vector<CLHEP::Hep3Vector> const& points) const {
+    CLHEP::Hep3Vector b, sum;
+    auto t0 = std::chrono::steady_clock::now();
+    for (auto const& p : points) {
+        map.getBFieldWithStyle(p, b, style);
+        sum += b;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    // Keep the compiler from dropping the loop.
+    if (sum.mag2() < 0.) {
+        mf::LogInfo("BFieldInterpolationTest") << sum;
+    }
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / points.size();
+}
+
+void mu2e::BFieldInterpolationTest::beginRun(const art::Run& run) {
+    GeomHandle<BFieldManager> bfmgr;
+
+    for (auto const& name : mapNames_) {
+        // Find the named grid map.
+        BFGridMap const* map(nullptr);
+        for (auto const* maps : {&bfmgr->getInnerMaps(), &bfmgr->getOuterMaps()}) {
+            for (auto const& m : *maps) {
+                if (m->getKey() == name) map = dynamic_cast<BFGridMap const*>(m.get());
+            }
+        }
+        if (!map) {
+            throw cet::exception("GEOM")
+                << "BFieldInterpolationTest: cannot find the grid map named: " << name << "\n";
+        }
+        auto coarse = map->coarsened(stride_);
+
+        // Grid points of the full map that are not on the coarse grid; stay one coarse cell
+        // away from the edges so that every style uses a centred stencil.
+        std::vector<CLHEP::Hep3Vector> dropped;
+        dropped.reserve(nAccuracyPoints_);
+        const int margin = stride_;
+        while (int(dropped.size()) < nAccuracyPoints_) {
+            int ix = margin + int(flat_.fire() * (map->nx() - 2 * margin));
+            int iy = margin + int(flat_.fire() * (map->ny() - 2 * margin));
+            int iz = margin + int(flat_.fire() * (map->nz() - 2 * margin));
+            if (ix % stride_ == 0 && iy % stride_ == 0 && iz % stride_ == 0) continue;
+            dropped.push_back(map->grid2point(ix, iy, iz));
+        }
+
+        // Random points for the timing.
+        std::vector<CLHEP::Hep3Vector> points;
+        points.reserve(nTimingPoints_);
+        for (int i = 0; i < nTimingPoints_; ++i) {
+            points.emplace_back(flat_.fire(map->xmin(), map->xmax()),
+                                flat_.fire(map->ymin(), map->ymax()),
+                                flat_.fire(map->zmin(), map->zmax()));
+        }
+
+        mf::LogInfo log("BFieldInterpolationTest");
+        log << "Map " << name << ": " << map->nx() << " x " << map->ny() << " x " << map->nz()
+            << " points; coarse map with stride " << stride_ << ": " << coarse->nx() << " x "
+            << coarse->ny() << " x " << coarse->nz() << " points\n";
+
+        for (auto const& sname : styles_) {
+            BFInterpolationStyle style(sname);
+
+            // Accuracy on the coarse map against the true values of the dropped points.
+            // Trilinear interpolation at a grid point returns the stored value.
+            const BFInterpolationStyle exact(BFInterpolationStyle::trilinear);
+            double sum2(0.), maxDiff(0.);
+            CLHEP::Hep3Vector truth, b;
+            for (auto const& p : dropped) {
+                map->getBFieldWithStyle(p, truth, exact);
+                coarse->getBFieldWithStyle(p, b, style);
+                double d = (b - truth).mag();
+                sum2 += d * d;
+                maxDiff = std::max(maxDiff, d);
+            }
+
+            log << "  " << sname << ": coarse-map |dB| rms " << std::sqrt(sum2 / dropped.size())
+                << " T, max " << maxDiff << " T;  time full map "
+                << timeStyle(*map, style, points) << " ns/point, coarse map "
+                << timeStyle(*coarse, style, points) << " ns/point\n";
+        }
+    }
+}
+
+DEFINE_ART_MODULE(mu2e::BFieldInterpolationTest)
@@ -11,13 +11,30 @@ namespace mu2eCrv
 class MakeCrvRecoPulses
 {
   public:
+  //TF1Fit:         ROOT fit of a TF1 to a TGraph of the fit range of every pulse
+  //GaussNewtonFit: Gauss-Newton fit of the same function to the same points without any ROOT objects,
+  //                starting from the closed-form estimate of a parabola through the logarithm of the peak
+  enum FitMethod {TF1Fit, GaussNewtonFit};
+
   MakeCrvRecoPulses(float minADCdifference, float defaultBeta, float minBeta, float maxBeta,
                     float maxTimeDifference, float minPulseHeightRatio, float maxPulseHeightRatio,
-                    float LEtimeFactor, float pulseThreshold, float pulseAreaThreshold, float doublePulseSeparation);
+                    float LEtimeFactor, float pulseThreshold, float pulseAreaThreshold, float doublePulseSeparation,
+                    FitMethod fitMethod=GaussNewtonFit);
+  //finds and fits the pulses of one waveform
   void         SetWaveform(const std::vector<int16_t> &waveform, uint16_t startTDC,
                            float digitizationPeriod, float pedestal, float calibrationFactor,
                            float calibrationFactorPulseHeight);
 
+  //batch mode: AddWaveform only finds the pulses of a waveform (and does the no-fit option),
+  //FitPulses fits all pulses added since the last call in one pass.
+  //the vectors below collect the pulses of all waveforms added since Clear(),
+  //in the order of the waveforms. AddWaveform returns the number of pulses of this waveform.
+  void         Clear();
+  size_t       AddWaveform(const std::vector<int16_t> &waveform, uint16_t startTDC,
+                           float digitizationPeriod, float pedestal, float calibrationFactor,
+                           float calibrationFactorPulseHeight);
+  void         FitPulses();
+
   const std::vector<float>  &GetPEs() const            {return _PEs;}
   const std::vector<float>  &GetPEsPulseHeight() const {return _PEsPulseHeight;}
   const std::vector<double> &GetPulseTimes() const     {return _pulseTimes;}
@@ -30,13 +47,25 @@ class MakeCrvRecoPulses
 
   private:
   MakeCrvRecoPulses();
-  void FillGraphAndFindPeaks(const std::vector<int16_t> &waveform, uint16_t startTDC,
-                             float digitizationPeriod, float pedestal,
-                             TGraph &g, std::vector<std::pair<size_t,size_t> > &peaks);
+  void FindPeaks(const std::vector<int16_t> &waveform, float pedestal, std::vector<std::pair<size_t,size_t> > &peaks);
   void RangeFinder(const std::vector<int16_t> &waveform, const size_t peakStart, const size_t peakEnd, size_t &start, size_t &end);
   bool FailedFit(TFitResultPtr fr);
 
+  //a pulse waiting to be fitted; its fit points are in _fitTimes/_fitADCs
+  struct PulseFitInput
+  {
+    size_t firstPoint, nPoints;
+    size_t peakPoint, peakWidth;  //position of the first peak point among the fit points, and number of additional peak points
+    double peakStartTime, peakEndTime, peakTime;
+    float  peakADC;
+    float  calibrationFactor, calibrationFactorPulseHeight;
+  };
+  void InitialParameters(const PulseFitInput &input, double *par, double *lower, double *upper) const;
+  bool FitTF1(const PulseFitInput &input, double *par, const double *lower, const double *upper, float &chi2, int &ndf);
+  bool FitGaussNewton(const PulseFitInput &input, double *par, const double *lower, const double *upper, float &chi2, int &ndf) const;
+
   TF1    _f1;
+  FitMethod _fitMethod;
   float  _minADCdifference;
   float  _defaultBeta;
   float  _minBeta, _maxBeta;
@@ -52,6 +81,9 @@ class MakeCrvRecoPulses
   std::vector<float>  _pulseHeights, _pulseBetas, _pulseFitChi2s;
   std::vector<bool>   _zeroNdf, _failedFits, _duplicateNoFitPulses, _separatedDoublePulses;
 
+  std::vector<PulseFitInput> _fitInputs;
+  std::vector<double>        _fitTimes, _fitADCs;
+
   public:
   const std::vector<float>  &GetPEsNoFit() const        {return _PEsNoFit;}
   const std::vector<double> &GetPulseTimesNoFit() const {return _pulseTimesNoFit;}
@@ -25,6 +25,8 @@
 
 #include <string>
 #include <array>
+#include <algorithm>
+#include <limits>
 
 namespace mu2e
 {
@@ -166,11 +168,25 @@ namespace mu2e
     void clusterProperties(int crvSectorType, const std::vector<std::vector<CrvHit> > &clusters,
                            std::unique_ptr<CrvCoincidenceClusterCollection> &crvCoincidenceClusterCollection,
                            const art::Handle<CrvRecoPulseCollection> &crvRecoPulseCollection);
-    void filterHits(const std::vector<CrvHit> &hits, std::list<CrvHit> &hitsFiltered);
-    void findClusters(std::list<CrvHit> &hits, std::vector<std::vector<CrvHit> > &clusters,
+    void filterHits(const std::vector<CrvHit> &hits, std::vector<CrvHit> &hitsFiltered);
+    void findClusters(const std::vector<CrvHit> &hits, std::vector<std::vector<CrvHit> > &clusters,
                       double clusterMaxTimeDifference, double clusterMinOverlapTime);
-    void checkCoincidence(const std::vector<CrvHit> &hits, std::list<CrvHit> &coincidenceHits);
+    void checkCoincidence(const std::vector<CrvHit> &hits, std::vector<CrvHit> &coincidenceHits);
+    void findCombinations(const int layers[], int n, int depth, size_t hitIndices[], double time1, double time2);
     bool checkCombination(std::vector<CrvHit>::const_iterator layerIterators[], int n);
+    double sortTime(const CrvHit &hit) const {return _usePulseOverlaps?hit._timePulseStart:hit._time;}
+
+    //hits of one coincidence check, used by the sweep-line search of checkCoincidence.
+    //kept between calls to reuse the memory
+    struct CoincidenceSearch
+    {
+      std::vector<CrvHit> hitsLayers[CRVId::nLayers];        //sorted by sortTime
+      std::vector<char>   coincidenceFlags[CRVId::nLayers];  //hits that are part of a coincidence
+      double maxPulseLength[CRVId::nLayers];                 //longest pulse of each layer (for pulse overlaps)
+      //loosest coincidence criteria of all hits, used to limit the search
+      double maxTimeDifference, minOverlapTime, minSlope, maxSlope;
+    };
+    CoincidenceSearch _search;
 
   };
 
@@ -348,7 +364,7 @@ namespace mu2e
       const std::vector<CrvHit> &hitsUnfiltered = sectorTypeMapIter->second;
 
       //filter hits, i.e. remove all hits below PE threshold
-      std::list<CrvHit> hitsFiltered;
+      std::vector<CrvHit> hitsFiltered;
       filterHits(hitsUnfiltered, hitsFiltered);
 
       //distribute the hits into clusters
@@ -356,8 +372,8 @@ namespace mu2e
       std::vector<std::vector<CrvHit> > clusters;
       findClusters(hitsFiltered, clusters, _initialClusterMaxTimeDifference, _initialClusterMinOverlapTime);
 
-      //all hits belonging to a coincidence group are collected in a new list
-      std::list<CrvHit> coincidenceHits;
+      //all hits belonging to a coincidence group are collected in a new vector
+      std::vector<CrvHit> coincidenceHits;
 
       //loop through all clusters
       for(size_t iCluster=0; iCluster<clusters.size(); ++iCluster)
@@ -587,13 +603,20 @@ namespace mu2e
 
 
   //remove hits below the threshold
-  void CrvCoincidenceFinder::filterHits(const std::vector<CrvHit> &hits, std::list<CrvHit> &hitsFiltered)
+  void CrvCoincidenceFinder::filterHits(const std::vector<CrvHit> &hits, std::vector<CrvHit> &hitsFiltered)
   {
+    //only hits of the same and the adjacent counters of the same layer contribute to the PEs of a hit.
+    //sort the hits by layer and counter (keeping their order within a counter)
+    //so that these hits can be found without looping over all hits.
+    auto counterLess = [](const CrvHit &a, const CrvHit &b)
+                       {return a._layer<b._layer || (a._layer==b._layer && a._counter<b._counter);};
+    std::vector<CrvHit> hitsByCounter(hits);
+    std::stable_sort(hitsByCounter.begin(), hitsByCounter.end(), counterLess);
+
+    hitsFiltered.reserve(hits.size());
     std::vector<CrvHit>::const_iterator iterHit;
     for(iterHit=hits.begin(); iterHit!=hits.end(); ++iterHit)
     {
-      int    layer=iterHit->_layer;
-      int    counter=iterHit->_counter;  //counter number in one layer counted from the beginning of the counter type
       double time=iterHit->_time;
       double timePulseStart=iterHit->_timePulseStart;
       double timePulseEnd=iterHit->_timePulseEnd;
@@ -603,52 +626,51 @@ namespace mu2e
       double minOverlapTimeAdjacentPulses=iterHit->_minOverlapTimeAdjacentPulses;
 
       //check other SiPM and the SiPMs at the adjacent counters
-      double PEs_thisCounter=0;
-      double PEs_adjacentCounter1=0;
-      double PEs_adjacentCounter2=0;
-      std::vector<CrvHit>::const_iterator iterHitAdjacent;
-      for(iterHitAdjacent=hits.begin(); iterHitAdjacent!=hits.end(); ++iterHitAdjacent)
+      //PEs[0]: adjacent counter 1, PEs[1]: this counter (i.e. the "other" SiPM, and the current pulse), PEs[2]: adjacent counter 2
+      //only hits within a certain time window (5ns) are added
+      double PEs[3]={0,0,0};
+      for(int counterDiff=-1; counterDiff<=1; ++counterDiff)
       {
-        //use hits of the same layer only
-        if(iterHitAdjacent->_layer!=layer) continue;
-
-        //use hits within a certain time window only
-        if(!_usePulseOverlaps)
+        CrvHit adjacent(*iterHit);
+        adjacent._counter+=counterDiff;
+        auto range=std::equal_range(hitsByCounter.cbegin(), hitsByCounter.cend(), adjacent, counterLess);
+        for(auto iterHitAdjacent=range.first; iterHitAdjacent!=range.second; ++iterHitAdjacent)
         {
-          if(fabs(iterHitAdjacent->_time-time)>maxTimeDifferenceAdjacentPulses) continue;
-        }
-        else
-        {
-          double overlapTime=std::min(iterHitAdjacent->_timePulseEnd,timePulseEnd)-std::max(iterHitAdjacent->_timePulseStart,timePulseStart);
-          if(overlapTime<minOverlapTimeAdjacentPulses) continue; //no overlap or overlap time too short
+          //use hits within a certain time window only
+          if(!_usePulseOverlaps)
+          {
+            if(fabs(iterHitAdjacent->_time-time)>maxTimeDifferenceAdjacentPulses) continue;
+          }
+          else
+          {
+            double overlapTime=std::min(iterHitAdjacent->_timePulseEnd,timePulseEnd)-std::max(iterHitAdjacent->_timePulseStart,timePulseStart);
+            if(overlapTime<minOverlapTimeAdjacentPulses) continue; //no overlap or overlap time too short
+          }
+          PEs[counterDiff+1]+=iterHitAdjacent->_PEs;
         }
-
-        //collect all PEs of this and the adjacent counters
-        int counterDiff=iterHitAdjacent->_counter-counter;
-        if(counterDiff==0) PEs_thisCounter+=iterHitAdjacent->_PEs;   //add PEs from the same counter (i.e. the "other" SiPM),
-                                                                     //if the "other" hit is within a certain time window (5ns)
-                                                                     //this will include PEs from the current pulse
-        if(counterDiff==-1) PEs_adjacentCounter1+=iterHitAdjacent->_PEs;  //add PEs from an adjacent counter,
-                                                                          //if these hits are within a certain time window (5ns)
-        if(counterDiff==1) PEs_adjacentCounter2+=iterHitAdjacent->_PEs;   //add PEs from an adjacent counter,
-                                                                          //if these hits are within a certain time window (5ns)
       }
 
       //if the number of PEs of this hit (plus the number of PEs of the same or one of the adjacent counter, if their time
       //difference is small enough) is above the PE threshold, add this hit to vector of filtered hits
-      if(PEs_thisCounter+PEs_adjacentCounter1>=PEthreshold || PEs_thisCounter+PEs_adjacentCounter2>=PEthreshold)
+      if(PEs[1]+PEs[0]>=PEthreshold || PEs[1]+PEs[2]>=PEthreshold)
          hitsFiltered.push_back(*iterHit);
     }
   } //end filter hits
 
 
-  void CrvCoincidenceFinder::findClusters(std::list<CrvHit> &hits, std::vector<std::vector<CrvHit> > &clusters,
+  void CrvCoincidenceFinder::findClusters(const std::vector<CrvHit> &hits, std::vector<std::vector<CrvHit> > &clusters,
                                           double clusterMaxTimeDifference, double clusterMinOverlapTime)
   {
-    while(!hits.empty()) //run through clustering processes until all hits are distributed into clusters
+    std::vector<char> distributed(hits.size(),false);
+    for(size_t firstHit=0; firstHit<hits.size(); ++firstHit) //run through clustering processes until all hits are distributed into clusters
     {
-      clusters.resize(clusters.size()+1); //add a new cluster
+      if(distributed[firstHit]) continue;
+
+      //first undistributed hit starts a new cluster
+      clusters.resize(clusters.size()+1);
       std::vector<CrvHit> &cluster = clusters.back();
+      cluster.push_back(hits[firstHit]);
+      distributed[firstHit]=true;
 
       //need to loop several times to check the unused hits until the cluster size remains stable
       size_t lastClusterSize=0;
@@ -656,85 +678,81 @@ namespace mu2e
       {
         lastClusterSize=cluster.size();
 
-        for(auto hitsIter=hits.begin(); hitsIter!=hits.end(); )
+        for(size_t iHit=firstHit+1; iHit<hits.size(); ++iHit)
         {
-          if(cluster.empty())
-          {
-            //first element of current cluster
-            //gets moved from list of hits to the current cluster
-            cluster.push_back(*hitsIter);
-            hitsIter=hits.erase(hitsIter);
-          }
-          else
+          if(distributed[iHit]) continue;
+          const CrvHit &hit=hits[iHit];
+
+          //check whether current hit satisfies time and distance condition w.r.t. to any hit of current cluster
+          for(auto clusterIter=cluster.begin(); clusterIter!=cluster.end(); ++clusterIter)
           {
-            //check whether current hit satisfies time and distance condition w.r.t. to any hit of current cluster
-            bool erasedHit=false;
-            for(auto clusterIter=cluster.begin(); clusterIter!=cluster.end(); ++clusterIter)
+            double maxDistance = std::max(hit._maxDistance,clusterIter->_maxDistance);
+            bool close=false;
+            if(_usePulseOverlaps)
             {
-              double maxDistance = std::max(hitsIter->_maxDistance,clusterIter->_maxDistance);
-              if(_usePulseOverlaps)
-              {
-                if((std::fabs(hitsIter->_x-clusterIter->_x)<=maxDistance) &&
-                   (hitsIter->_timePulseEnd-clusterIter->_timePulseStart>clusterMinOverlapTime) &&
-                   (clusterIter->_timePulseEnd-hitsIter->_timePulseStart>clusterMinOverlapTime))
-                {
-                  //this hit satisfied the conditions
-                  //move it from list of hits to the current cluster
-                  cluster.push_back(*hitsIter);
-                  hitsIter=hits.erase(hitsIter);
-                  erasedHit=true;
-                  break;  //no need for more comparisons with other hits in current cluster, go to the next hit in list of hits
-                }
-              }
-              else
-              {
-                if((std::fabs(hitsIter->_x-clusterIter->_x)<=maxDistance) &&
-                   (std::fabs(hitsIter->_time-clusterIter->_time)<clusterMaxTimeDifference))
-                {
-                  //this hit satisfied the conditions
-                  //move it from list of hits to the current cluster
-                  cluster.push_back(*hitsIter);
-                  hitsIter=hits.erase(hitsIter);
-                  erasedHit=true;
-                  break;  //no need for more comparisons with other hits in current cluster, go to the next hit in list of hits
-                }
-              }
-            } //loop over all hits in the cluster (for comparison with current hit)
-
-            if(!erasedHit) ++hitsIter;
-
-          } //cluster not empty
+              close=(std::fabs(hit._x-clusterIter->_x)<=maxDistance) &&
+                    (hit._timePulseEnd-clusterIter->_timePulseStart>clusterMinOverlapTime) &&
+                    (clusterIter->_timePulseEnd-hit._timePulseStart>clusterMinOverlapTime);
+            }
+            else
+            {
+              close=(std::fabs(hit._x-clusterIter->_x)<=maxDistance) &&
+                    (std::fabs(hit._time-clusterIter->_time)<clusterMaxTimeDifference);
+            }
+            if(close)
+            {
+              //this hit satisfied the conditions
+              //move it to the current cluster
+              cluster.push_back(hit);  //invalidates clusterIter
+              distributed[iHit]=true;
+              break;  //no need for more comparisons with other hits in current cluster, go to the next hit
+            }
+          } //loop over all hits in the cluster (for comparison with current hit)
         } //loop over all undistributed hits
 
       } while(lastClusterSize!=cluster.size()); //loop until cluster does not change anymore
 
-    } //loop until all hits in list of hits are distributed into clusters
+    } //loop until all hits are distributed into clusters
   } //end finder clusters
 
 
-  void CrvCoincidenceFinder::checkCoincidence(const std::vector<CrvHit> &hits, std::list<CrvHit> &coincidenceHits)
+  void CrvCoincidenceFinder::checkCoincidence(const std::vector<CrvHit> &hits, std::vector<CrvHit> &coincidenceHits)
   {
     if(hits.empty()) return;
 
-    std::vector<CrvHit> hitsLayers[CRVId::nLayers];  //separated by layers
-    std::vector<CrvHit>::const_iterator iterHit;
-    for(iterHit=hits.begin(); iterHit!=hits.end(); ++iterHit)
-    {
-      int    layer=iterHit->_layer;
-      hitsLayers[layer].push_back(*iterHit);
-    }
-
-    //we want to collect all hits belonging to coincidence groups,
-    //but avoid collecting hits multiple times, if they belong to different coincidence groups.
-    //can be done by placing the hit interator into a set.
-    auto setComp = [](const std::vector<CrvHit>::const_iterator &a, const std::vector<CrvHit>::const_iterator &b) {return a->_crvRecoPulse < b->_crvRecoPulse;};
-    std::set<std::vector<CrvHit>::const_iterator,decltype(setComp)> coincidenceHitSet(setComp);
-
     int minCoincidenceLayers = std::min_element(hits.begin(),hits.end(),
                                [](const CrvHit &a, const CrvHit &b){return a._coincidenceLayers < b._coincidenceLayers;})->_coincidenceLayers;
     int maxCoincidenceLayers = std::max_element(hits.begin(),hits.end(),
                                [](const CrvHit &a, const CrvHit &b){return a._coincidenceLayers < b._coincidenceLayers;})->_coincidenceLayers;
 
+    //separate the hits by layers, and sort them by time (or pulse start, if pulse overlaps are used)
+    for(size_t iLayer=0; iLayer<CRVId::nLayers; ++iLayer)
+    {
+      _search.hitsLayers[iLayer].clear();
+      _search.maxPulseLength[iLayer]=0;
+    }
+    _search.maxTimeDifference=hits.front()._maxTimeDifference;
+    _search.minOverlapTime=hits.front()._minOverlapTime;
+    _search.minSlope=hits.front()._minSlope;
+    _search.maxSlope=hits.front()._maxSlope;
+    for(auto iterHit=hits.begin(); iterHit!=hits.end(); ++iterHit)
+    {
+      int layer=iterHit->_layer;
+      _search.hitsLayers[layer].push_back(*iterHit);
+      _search.maxPulseLength[layer]=std::max(_search.maxPulseLength[layer],iterHit->_timePulseEnd-iterHit->_timePulseStart);
+      _search.maxTimeDifference=std::max(_search.maxTimeDifference,iterHit->_maxTimeDifference);
+      _search.minOverlapTime=std::min(_search.minOverlapTime,iterHit->_minOverlapTime);
+      _search.minSlope=std::min(_search.minSlope,iterHit->_minSlope);
+      _search.maxSlope=std::max(_search.maxSlope,iterHit->_maxSlope);
+    }
+    for(size_t iLayer=0; iLayer<CRVId::nLayers; ++iLayer)
+    {
+      std::vector<CrvHit> &layerHits=_search.hitsLayers[iLayer];
+      std::sort(layerHits.begin(),layerHits.end(),[this](const CrvHit &a, const CrvHit &b)
+                {return sortTime(a)<sortTime(b) || (sortTime(a)==sortTime(b) && a._x<b._x);});
+      _search.coincidenceFlags[iLayer].assign(layerHits.size(),false);
+    }
+
     if(hits.size()>_bigClusterThreshold)
     {
       //this cluster has so many hits that it makes no sense anymore to search for individual coincidences.
@@ -742,7 +760,7 @@ namespace mu2e
       int nonEmptyLayers=0;
       for(size_t iLayer=0; iLayer<CRVId::nLayers; ++iLayer)
       {
-        if(!hitsLayers[iLayer].empty()) ++nonEmptyLayers;
+        if(!_search.hitsLayers[iLayer].empty()) ++nonEmptyLayers;
       }
       if(nonEmptyLayers>=minCoincidenceLayers)
       {
@@ -751,118 +769,125 @@ namespace mu2e
       }
     }
 
-    //***************************************************
-    //find coincidences using 2/4 coincidence requirement
-    if(minCoincidenceLayers==2)
+    //find coincidences using 2/4, 3/4, and 4/4 coincidence requirements
+    //for all combinations of 2, 3, and 4 layers
+    for(int n=2; n<=static_cast<int>(CRVId::nLayers); ++n)
     {
-      std::vector<CrvHit>::const_iterator layerIterators[2];
+      if(n==2 && minCoincidenceLayers!=2) continue;
+      if(n==3 && (minCoincidenceLayers>3 || maxCoincidenceLayers<3)) continue;
+      if(n==4 && maxCoincidenceLayers!=4) continue;
 
-      for(int layer1=0; layer1<4; ++layer1)
-      for(int layer2=layer1+1; layer2<4; ++layer2)
+      for(int layerMask=0; layerMask<(1<<CRVId::nLayers); ++layerMask)
       {
-        const std::vector<CrvHit> &layer1Hits=hitsLayers[layer1];
-        const std::vector<CrvHit> &layer2Hits=hitsLayers[layer2];
-        std::vector<CrvHit>::const_iterator layer1Iter;
-        std::vector<CrvHit>::const_iterator layer2Iter;
-
-        //it will loop only, if both layers have hits
-        //loops will exit, if all three hits require a 3/4 or 4/4 coincidence
-        for(layer1Iter=layer1Hits.begin(); layer1Iter!=layer1Hits.end(); ++layer1Iter)
-        for(layer2Iter=layer2Hits.begin(); layer2Iter!=layer2Hits.end(); ++layer2Iter)
+        int layers[CRVId::nLayers];
+        int nLayersInMask=0;
+        for(size_t iLayer=0; iLayer<CRVId::nLayers; ++iLayer)
         {
-          if(layer1Iter->_coincidenceLayers>2 && layer2Iter->_coincidenceLayers>2) continue; //all hits require at least a 3/4 coincidence
-
-          //add all both hits into one array
-          layerIterators[0]=layer1Iter;
-          layerIterators[1]=layer2Iter;
-          if(checkCombination(layerIterators,2))
-          {
-            coincidenceHitSet.insert(layer1Iter);
-            coincidenceHitSet.insert(layer2Iter);
-          }
+          if(layerMask & (1<<iLayer)) layers[nLayersInMask++]=iLayer;
         }
+        if(nLayersInMask!=n) continue;
+
+        size_t hitIndices[CRVId::nLayers];
+        findCombinations(layers, n, 0, hitIndices, 0, 0);
       }
-    }  //two layer coincidences
+    }
 
-    //***************************************************
-    //find coincidences using 3/4 coincidence requirement
-    if(minCoincidenceLayers<=3 && maxCoincidenceLayers>=3)
+    //collect all hits belonging to coincidence groups.
+    //hits that belong to several coincidence groups are collected only once.
+    //they are ordered by reco pulse, as before.
+    size_t firstCoincidenceHit=coincidenceHits.size();
+    for(size_t iLayer=0; iLayer<CRVId::nLayers; ++iLayer)
     {
-      std::vector<CrvHit>::const_iterator layerIterators[3];
-
-      for(int layer1=0; layer1<4; ++layer1)
-      for(int layer2=layer1+1; layer2<4; ++layer2)
-      for(int layer3=layer2+1; layer3<4; ++layer3)
+      for(size_t iHit=0; iHit<_search.hitsLayers[iLayer].size(); ++iHit)
       {
-        const std::vector<CrvHit> &layer1Hits=hitsLayers[layer1];
-        const std::vector<CrvHit> &layer2Hits=hitsLayers[layer2];
-        const std::vector<CrvHit> &layer3Hits=hitsLayers[layer3];
-        std::vector<CrvHit>::const_iterator layer1Iter;
-        std::vector<CrvHit>::const_iterator layer2Iter;
-        std::vector<CrvHit>::const_iterator layer3Iter;
-
-        //it will loop only, if all 3 layers have hits
-        //loops will exit, if all three hits require a 4/4 coincidence
-        for(layer1Iter=layer1Hits.begin(); layer1Iter!=layer1Hits.end(); ++layer1Iter)
-        for(layer2Iter=layer2Hits.begin(); layer2Iter!=layer2Hits.end(); ++layer2Iter)
-        for(layer3Iter=layer3Hits.begin(); layer3Iter!=layer3Hits.end(); ++layer3Iter)
-        {
-          if(layer1Iter->_coincidenceLayers>3 && layer2Iter->_coincidenceLayers>3 && layer3Iter->_coincidenceLayers>3) continue; //all hits require at 4/4 coincidence
+        if(_search.coincidenceFlags[iLayer][iHit]) coincidenceHits.push_back(_search.hitsLayers[iLayer][iHit]);
+      }
+    }
+    std::sort(coincidenceHits.begin()+firstCoincidenceHit, coincidenceHits.end(),
+              [](const CrvHit &a, const CrvHit &b) {return a._crvRecoPulse < b._crvRecoPulse;});
 
-          //add all 3 hits into one array
-          layerIterators[0]=layer1Iter;
-          layerIterators[1]=layer2Iter;
-          layerIterators[2]=layer3Iter;
-          if(checkCombination(layerIterators,3))
-          {
-            coincidenceHitSet.insert(layer1Iter);
-            coincidenceHitSet.insert(layer2Iter);
-            coincidenceHitSet.insert(layer3Iter);
-          }
-        }
+  } //end check coincidence
+
+  //sweep-line search for the combinations of one hit in each of the layers[0...n-1].
+  //the hits of each layer are sorted by time (or pulse start), so that the hits that can still
+  //form a coincidence with the hits already selected (hitIndices[0...depth-1]) are in a window
+  //given by time1 and time2:
+  //-peak times: time1/time2 are the earliest/latest times of the selected hits
+  //-pulse overlaps: time1/time2 are the latest pulse start / earliest pulse end of the selected hits
+  //the slopes between subsequent layers are checked as soon as a hit is added.
+  //the window and slopes use the loosest criteria of all hits,
+  //every combination that is found is checked with its own criteria by checkCombination.
+  void CrvCoincidenceFinder::findCombinations(const int layers[], int n, int depth, size_t hitIndices[], double time1, double time2)
+  {
+    const int layer=layers[depth];
+    const std::vector<CrvHit> &layerHits=_search.hitsLayers[layer];
+
+    std::vector<CrvHit>::const_iterator windowStart=layerHits.begin();
+    double windowEnd=std::numeric_limits<double>::max();
+    if(depth>0)
+    {
+      double windowStartTime;
+      if(!_usePulseOverlaps)
+      {
+        windowStartTime=time2-_search.maxTimeDifference;
+        windowEnd=time1+_search.maxTimeDifference;
+      }
+      else
+      {
+        windowStartTime=time1+_search.minOverlapTime-_search.maxPulseLength[layer];
+        windowEnd=time2-_search.minOverlapTime;
       }
-    }  //three layer coincidences
+      windowStart=std::lower_bound(layerHits.begin(),layerHits.end(),windowStartTime,
+                                   [this](const CrvHit &hit, double t){return sortTime(hit)<t;});
+    }
 
-    //***************************************************
-    //find coincidences using 4/4 coincidence requirement
-    if(maxCoincidenceLayers==4)
+    for(auto hit=windowStart; hit!=layerHits.end() && sortTime(*hit)<=windowEnd; ++hit)
     {
-      std::vector<CrvHit>::const_iterator layerIterators[4];
-
-      const std::vector<CrvHit> &layer0Hits=hitsLayers[0];
-      const std::vector<CrvHit> &layer1Hits=hitsLayers[1];
-      const std::vector<CrvHit> &layer2Hits=hitsLayers[2];
-      const std::vector<CrvHit> &layer3Hits=hitsLayers[3];
-      std::vector<CrvHit>::const_iterator layer0Iter;
-      std::vector<CrvHit>::const_iterator layer1Iter;
-      std::vector<CrvHit>::const_iterator layer2Iter;
-      std::vector<CrvHit>::const_iterator layer3Iter;
-
-      //it will loop only, if all 4 layers have hits
-      for(layer0Iter=layer0Hits.begin(); layer0Iter!=layer0Hits.end(); ++layer0Iter)
-      for(layer1Iter=layer1Hits.begin(); layer1Iter!=layer1Hits.end(); ++layer1Iter)
-      for(layer2Iter=layer2Hits.begin(); layer2Iter!=layer2Hits.end(); ++layer2Iter)
-      for(layer3Iter=layer3Hits.begin(); layer3Iter!=layer3Hits.end(); ++layer3Iter)
+      double newTime1, newTime2;
+      if(!_usePulseOverlaps)
       {
-        //add all 4 hits into one array
-        layerIterators[0]=layer0Iter;
-        layerIterators[1]=layer1Iter;
-        layerIterators[2]=layer2Iter;
-        layerIterators[3]=layer3Iter;
-        if(checkCombination(layerIterators,4))
-        {
-          coincidenceHitSet.insert(layer0Iter);
-          coincidenceHitSet.insert(layer1Iter);
-          coincidenceHitSet.insert(layer2Iter);
-          coincidenceHitSet.insert(layer3Iter);
-        }
+        newTime1=(depth>0?std::min(time1,hit->_time):hit->_time);
+        newTime2=(depth>0?std::max(time2,hit->_time):hit->_time);
+        if(newTime2-newTime1>_search.maxTimeDifference) continue;
+      }
+      else
+      {
+        newTime1=(depth>0?std::max(time1,hit->_timePulseStart):hit->_timePulseStart);
+        newTime2=(depth>0?std::min(time2,hit->_timePulseEnd):hit->_timePulseEnd);
+        if(newTime2-newTime1<_search.minOverlapTime) continue;
       }
-    } // four layer coincidences
 
-    //move the set of coincidence hit iterators to a list of hits
-    for(auto iterHit=coincidenceHitSet.begin(); iterHit!=coincidenceHitSet.end(); ++iterHit) coincidenceHits.push_back(**iterHit);
+      if(depth>0)
+      {
+        //slope = width direction / thickness direction (same as in checkCombination)
+        const CrvHit &previousHit=_search.hitsLayers[layers[depth-1]][hitIndices[depth-1]];
+        double slope=(hit->_x-previousHit._x)/(hit->_y-previousHit._y);
+        if(slope<_search.minSlope || slope>_search.maxSlope) continue;
+      }
 
-  } //end check coincidence
+      hitIndices[depth]=hit-layerHits.begin();
+      if(depth+1<n)
+      {
+        findCombinations(layers, n, depth+1, hitIndices, newTime1, newTime2);
+        continue;
+      }
+
+      //a complete combination
+      std::vector<CrvHit>::const_iterator layerIterators[CRVId::nLayers];
+      bool allRequireMoreLayers=true;
+      for(int i=0; i<n; ++i)
+      {
+        layerIterators[i]=_search.hitsLayers[layers[i]].begin()+hitIndices[i];
+        if(layerIterators[i]->_coincidenceLayers<=n) allRequireMoreLayers=false;
+      }
+      if(allRequireMoreLayers) continue; //all hits require a coincidence of more layers
+
+      if(checkCombination(layerIterators,n))
+      {
+        for(int i=0; i<n; ++i) _search.coincidenceFlags[layers[i]][hitIndices[i]]=true;
+      }
+    }
+  } //end find combinations
 
   bool CrvCoincidenceFinder::checkCombination(std::vector<CrvHit>::const_iterator layerIterators[], int n)
   {
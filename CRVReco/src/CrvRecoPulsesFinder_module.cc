@@ -34,8 +34,12 @@
 #include "fhiclcpp/types/Table.h"
 #include "CLHEP/Units/GlobalSystemOfUnits.h"
 
+#include <chrono>
+#include <iostream>
 #include <string>
 
+#include <TH1F.h>
+#include <TH2F.h>
 #include <TMath.h>
 
 namespace mu2e
@@ -66,6 +70,9 @@ namespace mu2e
       fhicl::Atom<float> timeOffsetCutoffHigh{Name("timeOffsetCutoffHigh"), Comment("upper cutoff of time offsets (for random values - otherwise set to maximum value)")}; //+3.0ns
       fhicl::Atom<bool> useTimeOffsetDB{Name("useTimeOffsetDB"), Comment("apply time offsets from the DB")}; //true
       fhicl::Atom<bool> ignoreChannels{Name("ignoreChannels"), Comment("ignore channels that have status 2 (bit 1) in CRVstatus DB")}; //true
+      fhicl::Atom<std::string> fitMethod{Name("fitMethod"), Comment("pulse fit: GaussNewton (no ROOT objects) or TF1 (ROOT fit)"), "GaussNewton"};
+      fhicl::Atom<bool> batchFits{Name("batchFits"), Comment("find the pulses of all SiPMs of an event first, then fit them together"), true};
+      fhicl::Atom<bool> compareFits{Name("compareFits"), Comment("also fit every pulse with the TF1 fit, and histogram the differences to the selected fit"), false};
     };
 
     typedef art::EDProducer::Table<Config> Parameters;
@@ -77,7 +84,22 @@ namespace mu2e
     void endJob() override;
 
     private:
+    //the digis of one SiPM that form a continuous waveform
+    struct Waveform
+    {
+      std::vector<int16_t>    ADCs;
+      std::vector<size_t>     waveformIndices;
+      CRSScintillatorBarIndex barIndex;
+      int                     SiPM;
+      uint16_t                startTDC;
+      double                  pedestal, calibPulseArea, calibPulseHeight, timeOffset;
+      size_t                  firstPulse, nPulses;
+    };
+
+    void CompareFits(const Waveform &waveform);
+
     boost::shared_ptr<mu2eCrv::MakeCrvRecoPulses> _makeCrvRecoPulses;
+    boost::shared_ptr<mu2eCrv::MakeCrvRecoPulses> _makeCrvRecoPulsesTF1;  //for compareFits
 
     std::string _crvDigiModuleLabel;
     art::InputTag _protonBunchTimeTag;
@@ -88,6 +110,17 @@ namespace mu2e
     bool  _useTimeOffsetDB;
 
     bool  _ignoreChannels;
+    bool  _batchFits;
+    bool  _compareFits;
+
+    std::vector<Waveform> _waveforms;  //kept between events to reuse the memory
+    size_t                _nWaveforms;
+
+    //comparison with the TF1 fit
+    TH1F  *_hDeltaPEs{nullptr}, *_hDeltaTime{nullptr}, *_hDeltaBeta{nullptr};
+    TH2F  *_hChi2{nullptr}, *_hFailedFits{nullptr};
+    double _fitTime{0}, _fitTimeTF1{0};  //s
+    size_t _nCompared{0}, _nDifferentFailed{0};
 
     ProditionsHandle<CRVCalib>  _calib;
     ProditionsHandle<CRVStatus> _sipmStatus;
@@ -102,9 +135,18 @@ namespace mu2e
     _timeOffsetCutoffLow(conf().timeOffsetCutoffLow()),
     _timeOffsetCutoffHigh(conf().timeOffsetCutoffHigh()),
     _useTimeOffsetDB(conf().useTimeOffsetDB()),
-    _ignoreChannels(conf().ignoreChannels())
+    _ignoreChannels(conf().ignoreChannels()),
+    _batchFits(conf().batchFits()),
+    _compareFits(conf().compareFits()),
+    _nWaveforms(0)
   {
     produces<CrvRecoPulseCollection>();
+
+    mu2eCrv::MakeCrvRecoPulses::FitMethod fitMethod;
+    if(conf().fitMethod()=="GaussNewton") fitMethod=mu2eCrv::MakeCrvRecoPulses::GaussNewtonFit;
+    else if(conf().fitMethod()=="TF1") fitMethod=mu2eCrv::MakeCrvRecoPulses::TF1Fit;
+    else throw cet::exception("RECO")<<"mu2e::CrvRecoPulsesFinder: unknown fitMethod "<<conf().fitMethod()<<" (use GaussNewton or TF1)"<<std::endl;
+
     _makeCrvRecoPulses=boost::shared_ptr<mu2eCrv::MakeCrvRecoPulses>(new mu2eCrv::MakeCrvRecoPulses(conf().minADCdifference(),
                                                                                                     conf().defaultBeta(),
                                                                                                     conf().minBeta(),
@@ -115,15 +157,76 @@ namespace mu2e
                                                                                                     conf().LEtimeFactor(),
                                                                                                     conf().pulseThreshold(),
                                                                                                     conf().pulseAreaThreshold(),
-                                                                                                    conf().doublePulseSeparation()));
+                                                                                                    conf().doublePulseSeparation(),
+                                                                                                    fitMethod));
+    if(_compareFits)
+    {
+      _makeCrvRecoPulsesTF1=boost::shared_ptr<mu2eCrv::MakeCrvRecoPulses>(new mu2eCrv::MakeCrvRecoPulses(conf().minADCdifference(),
+                                                                                                         conf().defaultBeta(),
+                                                                                                         conf().minBeta(),
+                                                                                                         conf().maxBeta(),
+                                                                                                         conf().maxTimeDifference(),
+                                                                                                         conf().minPulseHeightRatio(),
+                                                                                                         conf().maxPulseHeightRatio(),
+                                                                                                         conf().LEtimeFactor(),
+                                                                                                         conf().pulseThreshold(),
+                                                                                                         conf().pulseAreaThreshold(),
+                                                                                                         conf().doublePulseSeparation(),
+                                                                                                         mu2eCrv::MakeCrvRecoPulses::TF1Fit));
+    }
   }
 
   void CrvRecoPulsesFinder::beginJob()
   {
+    if(_compareFits)
+    {
+      art::ServiceHandle<art::TFileService> tfs;
+      art::TFileDirectory tfdir = tfs->mkdir("compareFits");
+      _hDeltaPEs   = tfdir.make<TH1F>("DeltaPEs","relative PE difference to TF1 fit;(PEs-PEs_{TF1})/PEs_{TF1}",200,-0.05,0.05);
+      _hDeltaTime  = tfdir.make<TH1F>("DeltaTime","pulse time difference to TF1 fit;t-t_{TF1} [ns]",200,-1.0,1.0);
+      _hDeltaBeta  = tfdir.make<TH1F>("DeltaBeta","beta difference to TF1 fit;#beta-#beta_{TF1} [ns]",200,-1.0,1.0);
+      _hChi2       = tfdir.make<TH2F>("Chi2","fit #chi^{2}/ndf;TF1 fit;selected fit",100,0,100,100,0,100);
+      _hFailedFits = tfdir.make<TH2F>("FailedFits","failed fits;TF1 fit;selected fit",2,-0.5,1.5,2,-0.5,1.5);
+    }
   }
 
   void CrvRecoPulsesFinder::endJob()
   {
+    if(_compareFits)
+    {
+      std::cout<<"CrvRecoPulsesFinder: compared "<<_nCompared<<" pulses with the TF1 fit, "
+               <<_nDifferentFailed<<" with a different fit status"<<std::endl;
+      std::cout<<"  PE difference    mean "<<_hDeltaPEs->GetMean()<<" rms "<<_hDeltaPEs->GetRMS()<<std::endl;
+      std::cout<<"  time difference  mean "<<_hDeltaTime->GetMean()<<" rms "<<_hDeltaTime->GetRMS()<<" ns"<<std::endl;
+      std::cout<<"  pulse finding and fit time: selected fit "<<_fitTime<<" s, TF1 fit "<<_fitTimeTF1<<" s"<<std::endl;
+    }
+  }
+
+  //fits the pulses of a waveform again with the TF1 fit.
+  //both find the same peaks, so the pulses are in the same order.
+  void CrvRecoPulsesFinder::CompareFits(const Waveform &waveform)
+  {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    _makeCrvRecoPulsesTF1->SetWaveform(waveform.ADCs, waveform.startTDC, CRVDigitizationPeriod, waveform.pedestal,
+                                       waveform.calibPulseArea, waveform.calibPulseHeight);
+    _fitTimeTF1+=std::chrono::duration<double>(std::chrono::high_resolution_clock::now()-startTime).count();
+
+    for(size_t j=0; j<waveform.nPulses; ++j)
+    {
+      size_t i=waveform.firstPulse+j;
+      bool failedFit    = _makeCrvRecoPulses->GetFailedFits().at(i);
+      bool failedFitTF1 = _makeCrvRecoPulsesTF1->GetFailedFits().at(j);
+      ++_nCompared;
+      _hFailedFits->Fill(failedFitTF1,failedFit);
+      if(failedFit!=failedFitTF1) {++_nDifferentFailed; continue;}
+      if(failedFit) continue;
+
+      float PEsTF1 = _makeCrvRecoPulsesTF1->GetPEs().at(j);
+      if(PEsTF1!=0) _hDeltaPEs->Fill((_makeCrvRecoPulses->GetPEs().at(i)-PEsTF1)/PEsTF1);
+      _hDeltaTime->Fill(_makeCrvRecoPulses->GetPulseTimes().at(i)-_makeCrvRecoPulsesTF1->GetPulseTimes().at(j));
+      _hDeltaBeta->Fill(_makeCrvRecoPulses->GetPulseBetas().at(i)-_makeCrvRecoPulsesTF1->GetPulseBetas().at(j));
+      _hChi2->Fill(_makeCrvRecoPulsesTF1->GetPulseFitChi2s().at(j),_makeCrvRecoPulses->GetPulseFitChi2s().at(i));
+    }
   }
 
   void CrvRecoPulsesFinder::beginRun(art::Run &run)
@@ -145,15 +248,21 @@ namespace mu2e
     auto const& calib = _calib.get(event.id());
     auto const& sipmStatus = _sipmStatus.get(event.id());
 
+    //collect the waveforms
+    _nWaveforms = 0;
     size_t waveformIndex = 0;
     while(waveformIndex<crvDigiCollection->size())
     {
       const CrvDigi &digi = crvDigiCollection->at(waveformIndex);
-      const CRSScintillatorBarIndex &barIndex = digi.GetScintillatorBarIndex();
-      int SiPM = digi.GetSiPMNumber();
-      uint16_t startTDC = digi.GetStartTDC();
-      std::vector<int16_t> ADCs;
-      std::vector<size_t> waveformIndices;
+      if(_waveforms.size()==_nWaveforms) _waveforms.emplace_back();
+      Waveform &waveform = _waveforms[_nWaveforms];
+      waveform.barIndex = digi.GetScintillatorBarIndex();
+      waveform.SiPM = digi.GetSiPMNumber();
+      waveform.startTDC = digi.GetStartTDC();
+      std::vector<int16_t> &ADCs = waveform.ADCs;
+      std::vector<size_t> &waveformIndices = waveform.waveformIndices;
+      ADCs.clear();
+      waveformIndices.clear();
       for(size_t i=0; i<CrvDigi::NSamples; ++i) ADCs.push_back(digi.GetADCs()[i]);
       waveformIndices.push_back(waveformIndex);
 
@@ -162,14 +271,14 @@ namespace mu2e
       while(++waveformIndex<crvDigiCollection->size())
       {
         const CrvDigi &nextDigi = crvDigiCollection->at(waveformIndex);
-        if(barIndex!=nextDigi.GetScintillatorBarIndex()) break;
-        if(SiPM!=nextDigi.GetSiPMNumber()) break;
-        if(startTDC+ADCs.size()!=nextDigi.GetStartTDC()) break;
+        if(waveform.barIndex!=nextDigi.GetScintillatorBarIndex()) break;
+        if(waveform.SiPM!=nextDigi.GetSiPMNumber()) break;
+        if(waveform.startTDC+ADCs.size()!=nextDigi.GetStartTDC()) break;
         for(size_t i=0; i<CrvDigi::NSamples; ++i) ADCs.push_back(nextDigi.GetADCs()[i]);
         waveformIndices.push_back(waveformIndex);
       }
 
-      size_t channel = barIndex.asUint()*CRVId::nChanPerBar + SiPM;
+      size_t channel = waveform.barIndex.asUint()*CRVId::nChanPerBar + waveform.SiPM;
 
       if(_ignoreChannels)
       {
@@ -177,9 +286,9 @@ namespace mu2e
         if(status.test(CRVStatus::Flags::ignoreChannel)) continue; //ignore this channel (bit 1)
       }
 
-      double pedestal = calib.pedestal(channel);
-      double calibPulseArea = calib.pulseArea(channel);
-      double calibPulseHeight = calib.pulseHeight(channel);
+      waveform.pedestal = calib.pedestal(channel);
+      waveform.calibPulseArea = calib.pulseArea(channel);
+      waveform.calibPulseHeight = calib.pulseHeight(channel);
       double timeOffset = 0.0;
       if(_useTimeOffsetDB)
       {
@@ -188,11 +297,33 @@ namespace mu2e
         if(timeOffset<_timeOffsetCutoffLow)  timeOffset=_timeOffsetCutoffLow;  //random time offsets can be cutoff at some limit
         if(timeOffset>_timeOffsetCutoffHigh) timeOffset=_timeOffsetCutoffHigh;
       }
+      waveform.timeOffset = timeOffset;
+      ++_nWaveforms;
+    }
 
-      _makeCrvRecoPulses->SetWaveform(ADCs, startTDC, CRVDigitizationPeriod, pedestal, calibPulseArea, calibPulseHeight);
+    //find the pulses of all waveforms, and fit them.
+    //in batch mode, all pulses of the event are fitted in one pass.
+    _makeCrvRecoPulses->Clear();
+    auto startTime = std::chrono::high_resolution_clock::now();
+    size_t nPulses = 0;
+    for(size_t iWaveform=0; iWaveform<_nWaveforms; ++iWaveform)
+    {
+      Waveform &waveform = _waveforms[iWaveform];
+      waveform.firstPulse = nPulses;
+      waveform.nPulses = _makeCrvRecoPulses->AddWaveform(waveform.ADCs, waveform.startTDC, CRVDigitizationPeriod,
+                                                         waveform.pedestal, waveform.calibPulseArea, waveform.calibPulseHeight);
+      nPulses += waveform.nPulses;
+      if(!_batchFits) _makeCrvRecoPulses->FitPulses();
+    }
+    if(_batchFits) _makeCrvRecoPulses->FitPulses();
+    _fitTime+=std::chrono::duration<double>(std::chrono::high_resolution_clock::now()-startTime).count();
 
-      size_t n = _makeCrvRecoPulses->GetPEs().size();
-      for(size_t j=0; j<n; ++j)
+    crvRecoPulseCollection->reserve(nPulses);
+    for(size_t iWaveform=0; iWaveform<_nWaveforms; ++iWaveform)
+    {
+      const Waveform &waveform = _waveforms[iWaveform];
+      double timeOffset = waveform.timeOffset;
+      for(size_t j=waveform.firstPulse; j<waveform.firstPulse+waveform.nPulses; ++j)
       {
         //the TDC times were recorded with respect to the event window start.
         //need to shift the times back to the original time scale (i.e. microbunch time)
@@ -219,14 +350,15 @@ namespace mu2e
         double pulseStart        = _makeCrvRecoPulses->GetPulseStarts().at(j) + TDC0time + timeOffset;
         double pulseEnd          = _makeCrvRecoPulses->GetPulseEnds().at(j) + TDC0time + timeOffset;
 
-        if(calibPulseArea<=0) {PEs=0; PEsNoFit=0; flags.set(CrvRecoPulseFlagEnums::noCalibConstPulseArea);}
-        if(calibPulseHeight<=0) {PEsPulseHeight=0; flags.set(CrvRecoPulseFlagEnums::noCalibConstPulseHeight);}
+        if(waveform.calibPulseArea<=0) {PEs=0; PEsNoFit=0; flags.set(CrvRecoPulseFlagEnums::noCalibConstPulseArea);}
+        if(waveform.calibPulseHeight<=0) {PEsPulseHeight=0; flags.set(CrvRecoPulseFlagEnums::noCalibConstPulseHeight);}
 
         crvRecoPulseCollection->emplace_back(PEs, PEsPulseHeight, pulseTime, pulseHeight, pulseBeta, pulseFitChi2, LEtime, flags,
                                              PEsNoFit, pulseTimeNoFit, pulseStart, pulseEnd,
-                                             waveformIndices, barIndex, SiPM);
+                                             waveform.waveformIndices, waveform.barIndex, waveform.SiPM);
       }
 
+      if(_compareFits) CompareFits(waveform);
     }
 
     event.put(std::move(crvRecoPulseCollection));
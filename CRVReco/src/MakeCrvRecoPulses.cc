@@ -5,6 +5,8 @@
 #include <TFitResult.h>
 #include <TFitResultPtr.h>
 #include <TMath.h>
+#include <algorithm>
+#include <cmath>
 
 namespace
 {
@@ -13,6 +15,76 @@ namespace
     double const x = xs[0];
     return par[0]*(TMath::Exp(-(x-par[1])/par[2]-TMath::Exp(-(x-par[1])/par[2])));
   }
+
+  //the same function, and its derivatives with respect to the parameters
+  double GumbelAndDerivatives(double t, const double *par, double *d)
+  {
+    double z = (t-par[1])/par[2];
+    if(z<-30.0) {d[0]=d[1]=d[2]=0; return 0;}  //far before the peak
+    double ez = std::exp(-z);
+    double g = std::exp(-z-ez);
+    double f = par[0]*g;
+    d[0] = g;
+    d[1] = f*(1.0-ez)/par[2];
+    d[2] = d[1]*z;
+    return f;
+  }
+
+  double Chi2(const double *t, const double *y, size_t n, const double *par)
+  {
+    double d[3];
+    double chi2=0;
+    for(size_t i=0; i<n; ++i)
+    {
+      double r = y[i]-GumbelAndDerivatives(t[i],par,d);
+      chi2+=r*r;
+    }
+    return chi2;
+  }
+
+  //solves the 3x3 normal equations M*x=v by a Cholesky decomposition of M scaled to a unit diagonal
+  //(the parameters have very different scales). returns false, if M is not positive definite.
+  bool SolveNormalEquations(const double M[3][3], const double *v, double *x)
+  {
+    double s[3], L[3][3]={}, w[3];
+    for(int i=0; i<3; ++i)
+    {
+      if(!(M[i][i]>0)) return false;
+      s[i]=1.0/std::sqrt(M[i][i]);
+    }
+    for(int i=0; i<3; ++i)
+    {
+      for(int j=0; j<=i; ++j)
+      {
+        double sum=M[i][j]*s[i]*s[j];
+        for(int k=0; k<j; ++k) sum-=L[i][k]*L[j][k];
+        if(i==j)
+        {
+          if(sum<=1e-12) return false;
+          L[i][i]=std::sqrt(sum);
+        }
+        else L[i][j]=sum/L[j][j];
+      }
+    }
+    for(int i=0; i<3; ++i)
+    {
+      double sum=v[i]*s[i];
+      for(int k=0; k<i; ++k) sum-=L[i][k]*w[k];
+      w[i]=sum/L[i][i];
+    }
+    for(int i=2; i>=0; --i)
+    {
+      double sum=w[i];
+      for(int k=i+1; k<3; ++k) sum-=L[k][i]*x[k];
+      x[i]=sum/L[i][i];
+    }
+    for(int i=0; i<3; ++i) x[i]*=s[i];
+    return true;
+  }
+
+  const int    maxGaussNewtonIterations=10;
+  const int    maxStepHalvings=8;
+  const double boundTolerance=0.01;  //as for the TF1 fit: a parameter this close to a limit indicates a failed fit
 }
 
 namespace mu2eCrv
@@ -20,8 +92,10 @@ namespace mu2eCrv
 
 MakeCrvRecoPulses::MakeCrvRecoPulses(float minADCdifference, float defaultBeta, float minBeta, float maxBeta,
                                      float maxTimeDifference, float minPulseHeightRatio, float maxPulseHeightRatio,
-                                     float LEtimeFactor, float pulseThreshold, float pulseAreaThreshold, float doublePulseSeparation) :
+                                     float LEtimeFactor, float pulseThreshold, float pulseAreaThreshold, float doublePulseSeparation,
+                                     FitMethod fitMethod) :
                                      _f1("peakfitter",Gumbel,0,0,3),
+                                     _fitMethod(fitMethod),
                                      _minADCdifference(minADCdifference),
                                      _defaultBeta(defaultBeta), _minBeta(minBeta), _maxBeta(maxBeta),
                                      _maxTimeDifference(maxTimeDifference),
@@ -33,18 +107,14 @@ MakeCrvRecoPulses::MakeCrvRecoPulses(float minADCdifference, float defaultBeta,
                                      _doublePulseSeparation(doublePulseSeparation)
 {}
 
-void MakeCrvRecoPulses::FillGraphAndFindPeaks(const std::vector<int16_t> &waveform, uint16_t startTDC,
-                                              float digitizationPeriod, float pedestal,
-                                              TGraph &g, std::vector<std::pair<size_t,size_t> > &peaks)
+void MakeCrvRecoPulses::FindPeaks(const std::vector<int16_t> &waveform, float pedestal,
+                                  std::vector<std::pair<size_t,size_t> > &peaks)
 {
   size_t nBins = waveform.size();
   size_t peakStartBin=0;
   size_t peakEndBin=0;
-  for(size_t bin=0; bin<nBins; ++bin)
+  for(size_t bin=1; bin<nBins; ++bin)  //don't search for peaks at bin 0
   {
-    g.SetPoint(bin,(startTDC+bin)*digitizationPeriod,waveform[bin]-pedestal);
-
-    if(bin<1) continue; //don't search for peaks here
 
     if(waveform[bin-1]<waveform[bin]) //rising edge
     {
@@ -219,9 +289,116 @@ void MakeCrvRecoPulses::NoFitOption(const std::vector<int16_t> &waveform, const
   }
 }
 
-void MakeCrvRecoPulses::SetWaveform(const std::vector<int16_t> &waveform,
-                                    uint16_t startTDC, float digitizationPeriod, float pedestal,
-                                    float calibrationFactor, float calibrationFactorPulseHeight)
+void MakeCrvRecoPulses::InitialParameters(const PulseFitInput &input, double *par, double *lower, double *upper) const
+{
+  par[0] = input.peakADC*TMath::E();
+  par[1] = input.peakTime;
+  par[2] = _defaultBeta;
+  lower[0] = input.peakADC*TMath::E()*_minPulseHeightRatio;
+  upper[0] = input.peakADC*TMath::E()*_maxPulseHeightRatio;
+  lower[1] = input.peakStartTime-_maxTimeDifference;
+  upper[1] = input.peakEndTime+_maxTimeDifference;
+  lower[2] = _minBeta;
+  upper[2] = _maxBeta;
+}
+
+bool MakeCrvRecoPulses::FitTF1(const PulseFitInput &input, double *par, const double *lower, const double *upper, float &chi2, int &ndf)
+{
+  const double *t = &_fitTimes[input.firstPoint];
+  const double *y = &_fitADCs[input.firstPoint];
+  TGraph g(input.nPoints, t, y);
+
+  for(int i=0; i<3; ++i)
+  {
+    _f1.SetParameter(i, par[i]);
+    _f1.SetParLimits(i, lower[i], upper[i]);
+  }
+  _f1.SetRange(t[0],t[input.nPoints-1]);
+
+  TFitResultPtr fr = g.Fit(&_f1,"NQSR");
+  for(int i=0; i<3; ++i) par[i] = fr->Parameter(i);
+  ndf  = fr->Ndf();
+  chi2 = (ndf>0?fr->Chi2()/ndf:-1);
+  return FailedFit(fr);
+}
+
+//least squares fit of the Gumbel function to the fit points (with unit errors, as the TGraph fit)
+//-start from a parabola through the logarithm of the peak and its two neighbors:
+// around its maximum, ln(Gumbel) = ln(A/e) - (t-mu)^2/(2*beta^2) + O((t-mu)^3)
+//-Gauss-Newton steps, halved until the chi2 decreases, parameters kept within their limits
+bool MakeCrvRecoPulses::FitGaussNewton(const PulseFitInput &input, double *par, const double *lower, const double *upper, float &chi2, int &ndf) const
+{
+  const double *t = &_fitTimes[input.firstPoint];
+  const double *y = &_fitADCs[input.firstPoint];
+  const size_t  n = input.nPoints;
+  ndf = static_cast<int>(n)-3;
+
+  size_t i0=input.peakPoint-1, i2=input.peakPoint+input.peakWidth+1;  //RangeFinder includes these points
+  double y0=y[i0], y1=input.peakADC, y2=y[i2];
+  if(y0>0 && y2>0)
+  {
+    double t0=t[i0], t1=input.peakTime, t2=t[i2];
+    double l0=std::log(y0), l1=std::log(y1), l2=std::log(y2);
+    double d01=(l1-l0)/(t1-t0);
+    double a=((l2-l1)/(t2-t1)-d01)/(t2-t0);
+    if(a<0)
+    {
+      double mu=0.5*(t0+t1)-d01/(2.0*a);
+      par[1]=mu;
+      par[2]=std::sqrt(-0.5/a);
+      par[0]=std::exp(l0+d01*(mu-t0)+a*(mu-t0)*(mu-t1))*TMath::E();
+      for(int i=0; i<3; ++i) par[i]=std::min(std::max(par[i],lower[i]),upper[i]);
+    }
+  }
+
+  double chi2Current=Chi2(t,y,n,par);
+  bool valid=std::isfinite(chi2Current);
+  for(int iteration=0; iteration<maxGaussNewtonIterations && valid; ++iteration)
+  {
+    double M[3][3]={}, v[3]={}, d[3];
+    for(size_t i=0; i<n; ++i)
+    {
+      double r = y[i]-GumbelAndDerivatives(t[i],par,d);
+      for(int j=0; j<3; ++j)
+      {
+        v[j]+=d[j]*r;
+        for(int k=0; k<=j; ++k) M[j][k]+=d[j]*d[k];
+      }
+    }
+    for(int j=0; j<3; ++j) for(int k=j+1; k<3; ++k) M[j][k]=M[k][j];
+
+    double step[3];
+    if(!SolveNormalEquations(M,v,step)) {valid=(iteration>0); break;}
+
+    bool improved=false;
+    double chi2New=0;
+    double parNew[3];
+    for(int halving=0; halving<maxStepHalvings && !improved; ++halving)
+    {
+      for(int i=0; i<3; ++i) parNew[i]=std::min(std::max(par[i]+step[i],lower[i]),upper[i]);
+      chi2New=Chi2(t,y,n,parNew);
+      if(chi2New<=chi2Current) improved=true;
+      else for(int i=0; i<3; ++i) step[i]*=0.5;
+    }
+    if(!improved) break;  //at the minimum (within the limits)
+
+    for(int i=0; i<3; ++i) par[i]=parNew[i];
+    bool converged=(chi2Current-chi2New<=1e-6*chi2Current+1e-9);
+    chi2Current=chi2New;
+    if(converged) break;
+  }
+
+  chi2 = (ndf>0?chi2Current/ndf:-1);
+  if(!valid) return true;
+  for(int i=0; i<3; ++i)
+  {
+    if((par[i]-lower[i])/(upper[i]-lower[i])<boundTolerance) return true;
+    if((upper[i]-par[i])/(upper[i]-lower[i])<boundTolerance) return true;
+  }
+  return false;
+}
+
+void MakeCrvRecoPulses::Clear()
 {
   _pulseTimes.clear();
   _pulseHeights.clear();
@@ -238,61 +415,81 @@ void MakeCrvRecoPulses::SetWaveform(const std::vector<int16_t> &waveform,
   _pulseTimesNoFit.clear();
   _pulseStart.clear();
   _pulseEnd.clear();
+  _fitInputs.clear();
+  _fitTimes.clear();
+  _fitADCs.clear();
+}
 
-  //fill graph and find peaks
+size_t MakeCrvRecoPulses::AddWaveform(const std::vector<int16_t> &waveform,
+                                      uint16_t startTDC, float digitizationPeriod, float pedestal,
+                                      float calibrationFactor, float calibrationFactorPulseHeight)
+{
+  //find peaks
   std::vector<std::pair<size_t,size_t> > peaks;
-  size_t nBins = waveform.size();
-  TGraph g(nBins);
-  FillGraphAndFindPeaks(waveform, startTDC, digitizationPeriod, pedestal, g, peaks);
+  FindPeaks(waveform, pedestal, peaks);
 
-  //loop through all peaks
+  //collect the fit points of all peaks
   for(size_t ipeak=0; ipeak<peaks.size(); ++ipeak)
   {
     size_t peakStartBin=peaks[ipeak].first;
     size_t peakEndBin=peaks[ipeak].second;
-    double peakStartTime=(startTDC+peakStartBin)*digitizationPeriod;
-    double peakEndTime=(startTDC+peakEndBin)*digitizationPeriod;
-    double peakTime=0.5*(peakStartTime+peakEndTime);
-
-    _f1.SetParameter(0, (waveform[peakStartBin]-pedestal)*TMath::E());
-    _f1.SetParameter(1, peakTime);
-    _f1.SetParameter(2, _defaultBeta);
-    _f1.SetParLimits(0,(waveform[peakStartBin]-pedestal)*TMath::E()*_minPulseHeightRatio,(waveform[peakStartBin]-pedestal)*TMath::E()*_maxPulseHeightRatio);
-    _f1.SetParLimits(1,peakStartTime-_maxTimeDifference,peakEndTime+_maxTimeDifference);
-    _f1.SetParLimits(2, _minBeta, _maxBeta);
-
     size_t fitStartBin, fitEndBin;
     RangeFinder(waveform, peakStartBin, peakEndBin, fitStartBin, fitEndBin);
-    double fitStartTime=(startTDC+fitStartBin)*digitizationPeriod;
-    double fitEndTime=(startTDC+fitEndBin)*digitizationPeriod;
-    _f1.SetRange(fitStartTime,fitEndTime);
-
-    //do the fit
-    TFitResultPtr fr = g.Fit(&_f1,"NQSR");
-    double fitParam0 = fr->Parameter(0);
-    double fitParam1 = fr->Parameter(1);
-    double fitParam2 = fr->Parameter(2);
-
-    //collect fit information for the first peak
-    float  PEs          = fitParam0*fitParam2 / calibrationFactor;
-    double pulseTime    = fitParam1;
-    float  pulseHeight  = fitParam0/TMath::E();
-    float  pulseBeta    = fitParam2;
-    float  pulseFitChi2 = (fr->Ndf()>0?fr->Chi2()/fr->Ndf():-1);
-    bool   zeroNdf      = (fr->Ndf()>0?false:true);
-    bool   failedFit    = FailedFit(fr);
+
+    PulseFitInput input;
+    input.firstPoint    = _fitTimes.size();
+    input.nPoints       = fitEndBin-fitStartBin+1;
+    input.peakPoint     = peakStartBin-fitStartBin;
+    input.peakWidth     = peakEndBin-peakStartBin;
+    input.peakStartTime = (startTDC+peakStartBin)*digitizationPeriod;
+    input.peakEndTime   = (startTDC+peakEndBin)*digitizationPeriod;
+    input.peakTime      = 0.5*(input.peakStartTime+input.peakEndTime);
+    input.peakADC       = waveform[peakStartBin]-pedestal;
+    input.calibrationFactor            = calibrationFactor;
+    input.calibrationFactorPulseHeight = calibrationFactorPulseHeight;
+    _fitInputs.push_back(input);
+
+    for(size_t bin=fitStartBin; bin<=fitEndBin; ++bin)
+    {
+      _fitTimes.push_back((startTDC+bin)*digitizationPeriod);
+      _fitADCs.push_back(waveform[bin]-pedestal);
+    }
+  }
+
+  NoFitOption(waveform, peaks, startTDC, digitizationPeriod, pedestal, calibrationFactor);
+
+  return peaks.size();
+}
+
+void MakeCrvRecoPulses::FitPulses()
+{
+  for(const PulseFitInput &input : _fitInputs)
+  {
+    double par[3], lower[3], upper[3];
+    InitialParameters(input, par, lower, upper);
+    float pulseFitChi2;
+    int   ndf;
+    bool  failedFit = (_fitMethod==TF1Fit ? FitTF1(input, par, lower, upper, pulseFitChi2, ndf)
+                                          : FitGaussNewton(input, par, lower, upper, pulseFitChi2, ndf));
+
+    //collect fit information
+    float  PEs          = par[0]*par[2] / input.calibrationFactor;
+    double pulseTime    = par[1];
+    float  pulseHeight  = par[0]/TMath::E();
+    float  pulseBeta    = par[2];
+    bool   zeroNdf      = (ndf>0?false:true);
 
     if(failedFit)
     {
-      PEs          = (waveform[peakStartBin]-pedestal)*TMath::E() * _defaultBeta / calibrationFactor;
-      pulseTime    = peakTime;
-      pulseHeight  = waveform[peakStartBin]-pedestal;
+      PEs          = input.peakADC*TMath::E() * _defaultBeta / input.calibrationFactor;
+      pulseTime    = input.peakTime;
+      pulseHeight  = input.peakADC;
       pulseBeta    = _defaultBeta;
       pulseFitChi2 = -1;
     }
 
     double LEtime         = pulseTime-_LEtimeFactor*pulseBeta;  //50% pulse height is reached at -0.985*beta before the peak
-    float  PEsPulseHeight = pulseHeight / calibrationFactorPulseHeight;
+    float  PEsPulseHeight = pulseHeight / input.calibrationFactorPulseHeight;
 
     _pulseTimes.push_back(pulseTime);
     _pulseHeights.push_back(pulseHeight);
@@ -305,9 +502,18 @@ void MakeCrvRecoPulses::SetWaveform(const std::vector<int16_t> &waveform,
     _failedFits.push_back(failedFit);
   }
 
-  NoFitOption(waveform, peaks, startTDC, digitizationPeriod, pedestal, calibrationFactor);
-
+  _fitInputs.clear();
+  _fitTimes.clear();
+  _fitADCs.clear();
 }
 
+void MakeCrvRecoPulses::SetWaveform(const std::vector<int16_t> &waveform,
+                                    uint16_t startTDC, float digitizationPeriod, float pedestal,
+                                    float calibrationFactor, float calibrationFactorPulseHeight)
+{
+  Clear();
+  AddWaveform(waveform, startTDC, digitizationPeriod, pedestal, calibrationFactor, calibrationFactorPulseHeight);
+  FitPulses();
 }
 
+}
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <map>
+#include <cstdint>
 #include "CLHEP/Vector/ThreeVector.h"
 #include "CLHEP/Random/Randomize.h"
 
@@ -23,6 +24,7 @@ struct LookupConstants
   double scintillatorBirksConstant;
   double WLSfiberDecayTime;
   void Write(const std::string &filename);
+  void Write(std::ofstream &lookupfile);
   void Read(std::ifstream &lookupfile);
 };
 
@@ -34,6 +36,7 @@ struct LookupCerenkov
   void WriteMap(std::map<double,double> &m, std::ofstream &o);
   void ReadMap(std::map<double,double> &m, std::ifstream &i);
   void Write(const std::string &filename);
+  void Write(std::ofstream &lookupfile);
   void Read(std::ifstream &lookupfile);
 };
 
@@ -49,6 +52,7 @@ struct LookupBinDefinitions
   void WriteVector(std::vector<double> &v, std::ofstream &o);
   void ReadVector(std::vector<double> &v, std::ifstream &i);
   void Write(const std::string &filename);
+  void Write(std::ofstream &lookupfile);
   void Read(std::ifstream &lookupfile);
 
   unsigned int getNScintillatorScintillationBins();
@@ -87,6 +91,54 @@ struct LookupBin
   void Read(std::ifstream &lookupfile, const unsigned int &i);
 };
 
+//Lookup bin as it is used for the photon generation: a fixed size record with the offsets
+//of its time delay and fiber emission probabilities in one contiguous probability array.
+//These records and the probability array are what the mapped lookup table files store.
+struct LookupBinRecord
+{
+  static const int nTimeDelayGuides=16;
+
+  float    arrivalProbability;
+  uint32_t probabilityScaleTimeDelays;
+  uint32_t probabilityScaleFiberEmissions;
+  uint32_t nTimeDelays;
+  uint32_t nFiberEmissions;
+  uint32_t spare;
+  uint64_t timeDelays;      //offset in the probability array
+  uint64_t fiberEmissions;  //offset in the probability array
+  //guide table to the inverse of the cumulative time delay distribution:
+  //timeDelayGuide[j] is the first time delay whose cumulative probability reaches j/nTimeDelayGuides,
+  //timeDelayGuideSum[j] is the cumulative probability before this time delay (both scaled as timeDelays)
+  uint16_t timeDelayGuide[nTimeDelayGuides];
+  uint32_t timeDelayGuideSum[nTimeDelayGuides];
+
+  //fills the record from a bin read from a lookup table file, and appends its probabilities
+  void Fill(const LookupBin &bin, std::vector<unsigned char> &probabilities);
+};
+
+//Layout of the mapped lookup table files (written by MakeCrvPhotons::WriteMappedLookupTable):
+//  header
+//  lookup constants, Cerenkov photon yields, and bin definitions (as in the version 6 files)
+//  LookupBinRecords of the three tables (aligned)
+//  probability array
+struct MappedLookupTableHeader
+{
+  static const uint32_t currentFormat=1;
+  static const uint32_t endianMarker=0xDEADBEEF;
+
+  char     magic[8];     //"MU2ECRV"
+  uint32_t endian;
+  uint32_t format;
+  uint64_t fileSize;
+  uint64_t definitionsOffset;
+  uint64_t binRecordsOffset[3];
+  uint64_t nBins[3];
+  uint64_t probabilitiesOffset;
+  uint64_t nProbabilities;
+
+  static const char *Magic() {return "MU2ECRV";}
+};
+
 
 
 class MakeCrvPhotons
@@ -95,17 +147,27 @@ class MakeCrvPhotons
     static const int _nSiPMs=4;
 
     MakeCrvPhotons(CLHEP::RandFlat &randFlat, CLHEP::RandGaussQ &randGaussQ, CLHEP::RandPoissonQ &randPoissonQ) :
+                                                      _probabilities(NULL), _nProbabilities(0), _mappedFile(NULL), _mappedFileSize(0),
                                                       _randFlat(randFlat), _randGaussQ(randGaussQ), _randPoissonQ(randPoissonQ)
     {
+      for(int i=0; i<3; ++i) {_bins[i]=NULL; _nBins[i]=0;}
       _scintillationYield=39400;
       for(int i=0; i<_nSiPMs; ++i) _photonYieldDeviation[i]=1.0;
     }
 
     ~MakeCrvPhotons();
 
+    //the lookup tables may be mapped from a file, so the photon maker can't be copied
+    MakeCrvPhotons(const MakeCrvPhotons&) = delete;
+    MakeCrvPhotons& operator=(const MakeCrvPhotons&) = delete;
+
     const std::string         &GetFileName() const {return _fileName;}
 
+    //reads a version 6 lookup table file, or maps a file written by WriteMappedLookupTable
     void                      LoadLookupTable(const std::string &filename, int debug);
+    //writes the loaded lookup table in the format that can be mapped read-only
+    //(shared by all processes which use the same file)
+    void                      WriteMappedLookupTable(const std::string &filename);
     void                      MakePhotons(const CLHEP::Hep3Vector &stepStart,   //they need to be points
                                       const CLHEP::Hep3Vector &stepEnd,         //local to the CRV bar
                                       double timeStart, double timeEnd,
@@ -130,7 +192,16 @@ class MakeCrvPhotons
     LookupConstants           _LC;
     LookupCerenkov            _LCerenkov;
     LookupBinDefinitions      _LBD;
-    std::vector<LookupBin>    _bins[3];   //scintillation in scintillator (0), Cerenkov in scintillator (1), Cerenkov in fiber (2)
+    //scintillation in scintillator (0), Cerenkov in scintillator (1), Cerenkov in fiber (2)
+    //either in the mapped file or in the vectors below
+    const LookupBinRecord     *_bins[3];
+    unsigned int              _nBins[3];
+    const unsigned char       *_probabilities;
+    size_t                    _nProbabilities;
+    std::vector<LookupBinRecord> _binStorage[3];
+    std::vector<unsigned char>   _probabilityStorage;
+    void                      *_mappedFile;
+    size_t                    _mappedFileSize;
 
     CLHEP::RandFlat           &_randFlat;
     CLHEP::RandGaussQ         &_randGaussQ;
@@ -138,8 +209,13 @@ class MakeCrvPhotons
 
     bool   IsInsideScintillator(const CLHEP::Hep3Vector &p);
     bool   IsInsideFiber(const CLHEP::Hep3Vector &p, const CLHEP::Hep3Vector &dir, double &r, double &phi);
-    double GetRandomTime(const LookupBin *theBin);
-    int    GetRandomFiberEmissions(const LookupBin *theBin);
+    void   ReadLookupTable(std::ifstream &lookupfile);
+    void   MapLookupTable(std::ifstream &lookupfile, const MappedLookupTableHeader &header);
+    void   CheckLookupConstants();
+    void   UnmapLookupTable();
+    void   AddArrivingPhotons(const LookupBinRecord *theBin, int nPhotons, double t, int SiPM, std::vector<double> &arrivalTimes);
+    double GetRandomTime(const LookupBinRecord *theBin);
+    int    GetRandomFiberEmissions(const LookupBinRecord *theBin);
     double GetAverageNumberOfCerenkovPhotons(double beta, double charge, std::map<double,double> &photons);
     int    GetNumberOfPhotonsFromAverage(double average, int nSteps);
 
@@ -26,7 +26,7 @@ void MakeCrvPhotons::DrawHistograms()
     double z=(_LBD.zBins[iz-1]+_LBD.zBins[iz])/2.0;
     int i=_LBD.findScintillatorScintillationBin(0.0,y,z);
     if(i<0) continue;
-    const LookupBin &bin = _bins[0][i];
+    const LookupBinRecord &bin = _bins[0][i];
     float p = bin.arrivalProbability;
     if(!std::isnan(p)) h1.Fill(y,z,p);
   }
@@ -61,7 +61,7 @@ void MakeCrvPhotons::DrawHistograms()
       double z=(_LBD.zBins[iz-1]+_LBD.zBins[iz])/2.0;
       int i=_LBD.findScintillatorScintillationBin(x,0.0,z);
       if(i<0) continue;
-      const LookupBin &bin = _bins[0][i];
+      const LookupBinRecord &bin = _bins[0][i];
       float p = bin.arrivalProbability;
       if(!std::isnan(p)) h2Tmp->Fill(z,p);
     }
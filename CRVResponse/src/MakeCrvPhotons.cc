@@ -1,7 +1,15 @@
 #include "Offline/CRVResponse/inc/MakeCrvPhotons.hh"
 
+#include <algorithm>
+#include <cstring>
 #include <sstream>
 
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "CLHEP/Units/GlobalSystemOfUnits.h"
 #include "CLHEP/Vector/TwoVector.h"
 
@@ -10,9 +18,13 @@ namespace mu2eCrv
 void LookupConstants::Write(const std::string &filename)
 {
   std::ofstream lookupfile(filename,std::ios::binary|std::ios::app);
-  lookupfile.write(reinterpret_cast<char*>(this),sizeof(LookupConstants));
+  Write(lookupfile);
   lookupfile.close();
 }
+void LookupConstants::Write(std::ofstream &lookupfile)
+{
+  lookupfile.write(reinterpret_cast<char*>(this),sizeof(LookupConstants));
+}
 void LookupConstants::Read(std::ifstream &lookupfile)
 {
   lookupfile.read(reinterpret_cast<char*>(this),sizeof(LookupConstants));
@@ -43,9 +55,13 @@ void LookupCerenkov::ReadMap(std::map<double,double> &m, std::ifstream &i)
 void LookupCerenkov::Write(const std::string &filename)
 {
   std::ofstream lookupfile(filename,std::ios::binary|std::ios::app);
+  Write(lookupfile);
+  lookupfile.close();
+}
+void LookupCerenkov::Write(std::ofstream &lookupfile)
+{
   WriteMap(photonsScintillator,lookupfile);
   WriteMap(photonsFiber,lookupfile);
-  lookupfile.close();
 }
 void LookupCerenkov::Read(std::ifstream &lookupfile)
 {
@@ -71,6 +87,11 @@ void LookupBinDefinitions::ReadVector(std::vector<double> &v, std::ifstream &i)
 void LookupBinDefinitions::Write(const std::string &filename)
 {
   std::ofstream lookupfile(filename,std::ios::binary|std::ios::app);
+  Write(lookupfile);
+  lookupfile.close();
+}
+void LookupBinDefinitions::Write(std::ofstream &lookupfile)
+{
   WriteVector(xBins,lookupfile);
   WriteVector(yBins,lookupfile);
   WriteVector(zBins,lookupfile);
@@ -78,7 +99,6 @@ void LookupBinDefinitions::Write(const std::string &filename)
   WriteVector(thetaBins,lookupfile);
   WriteVector(phiBins,lookupfile);
   WriteVector(rBins,lookupfile);
-  lookupfile.close();
 }
 void LookupBinDefinitions::Read(std::ifstream &lookupfile)
 {
@@ -118,9 +138,12 @@ unsigned int LookupBinDefinitions::getNFiberCerenkovBins()
 
 unsigned int LookupBinDefinitions::findBin(const std::vector<double> &v, const double &x, bool &notFound)
 {
-  for(size_t i=1; i<v.size(); i++)
+  //binary search for the first bin i with v[i-1]<=x<=v[i]
+  //(the bin boundaries are in increasing order)
+  if(v.size()>1)
   {
-    if(v[i-1]<=x && v[i]>=x) return(i-1);
+    size_t i=std::lower_bound(v.begin()+1,v.end(),x)-v.begin();
+    if(i<v.size() && v[i-1]<=x && v[i]>=x) return(i-1);
   }
   notFound=true;
   return(-1);
@@ -249,39 +272,231 @@ void LookupBin::Read(std::ifstream &lookupfile, const unsigned int &i)
   if(i!=binNumber) throw std::logic_error("Corrupt lookup table.");
 }
 
-  void MakeCrvPhotons::LoadLookupTable(const std::string &filename, int debug)
+void LookupBinRecord::Fill(const LookupBin &bin, std::vector<unsigned char> &probabilities)
 {
+  arrivalProbability=bin.arrivalProbability;
+  probabilityScaleTimeDelays=bin.probabilityScaleTimeDelays;
+  probabilityScaleFiberEmissions=bin.probabilityScaleFiberEmissions;
+  nTimeDelays=bin.timeDelays.size();
+  nFiberEmissions=bin.fiberEmissions.size();
+  spare=0;
+  timeDelays=probabilities.size();
+  probabilities.insert(probabilities.end(),bin.timeDelays.begin(),bin.timeDelays.end());
+  fiberEmissions=probabilities.size();
+  probabilities.insert(probabilities.end(),bin.fiberEmissions.begin(),bin.fiberEmissions.end());
+
+  //the search for a random time delay with cumulative probability rand (see MakeCrvPhotons::GetRandomTime)
+  //can start at the guide of j=floor(rand/probabilityScaleTimeDelays*nTimeDelayGuides),
+  //since all earlier time delays have cumulative probabilities below rand.
+  uint32_t sum=0;
+  size_t timeDelay=0;
+  for(int j=0; j<nTimeDelayGuides; ++j)
+  {
+    double guideProb=static_cast<double>(j)*probabilityScaleTimeDelays/nTimeDelayGuides;
+    while(timeDelay<bin.timeDelays.size() && sum+bin.timeDelays[timeDelay]<guideProb) sum+=bin.timeDelays[timeDelay++];
+    timeDelayGuide[j]=timeDelay;
+    timeDelayGuideSum[j]=sum;
+  }
+}
+
+void MakeCrvPhotons::LoadLookupTable(const std::string &filename, int debug)
+{
+  UnmapLookupTable();
+  for(int table=0; table<3; ++table) _binStorage[table].clear();
+  _probabilityStorage.clear();
+
   _fileName = filename;
   std::ifstream lookupfile(filename,std::ios::binary);
   if(!lookupfile.good()) throw std::logic_error("Could not open lookup table file "+filename);
 
-  _LC.Read(lookupfile);
+  if(debug>0) std::cout<<"Reading CRV lookup tables "<<filename<<" ... "<<std::flush;
+  MappedLookupTableHeader header;
+  lookupfile.read(reinterpret_cast<char*>(&header),sizeof(MappedLookupTableHeader));
+  if(lookupfile.good() && std::memcmp(header.magic,MappedLookupTableHeader::Magic(),sizeof(header.magic))==0)
+  {
+    MapLookupTable(lookupfile,header);
+  }
+  else
+  {
+    lookupfile.clear();
+    lookupfile.seekg(0);
+    ReadLookupTable(lookupfile);
+  }
+  if(debug>0) std::cout<<"Done."<<std::endl;
+
+  lookupfile.close();
+}
+
+void MakeCrvPhotons::CheckLookupConstants()
+{
   if(_LC.version1!=6) throw std::logic_error("This version of Offline expects a lookup table version 6.x.");
   if(_LC.reflector!=0 && _LC.reflector!=1 && _LC.reflector!=2) throw std::logic_error("Lookup tables can have either no reflector/absorber, or a reflector/absorber on the +z side.");
+}
+
+//reads a version 6 lookup table file bin by bin
+void MakeCrvPhotons::ReadLookupTable(std::ifstream &lookupfile)
+{
+  _LC.Read(lookupfile);
+  CheckLookupConstants();
 
   _LCerenkov.Read(lookupfile);
   _LBD.Read(lookupfile);
 
-  unsigned int nScintillatorScintillationBins = _LBD.getNScintillatorScintillationBins();
-  unsigned int nScintillatorCerenkovBins      = _LBD.getNScintillatorCerenkovBins();
-  unsigned int nFiberCerenkovBins             = _LBD.getNFiberCerenkovBins();
-
   //0...scintillationInScintillator, 1...cerenkovInScintillator 2...cerenkovInFiber
-  _bins[0].resize(nScintillatorScintillationBins);
-  _bins[1].resize(nScintillatorCerenkovBins);
-  _bins[2].resize(nFiberCerenkovBins);
+  _nBins[0] = _LBD.getNScintillatorScintillationBins();
+  _nBins[1] = _LBD.getNScintillatorCerenkovBins();
+  _nBins[2] = _LBD.getNFiberCerenkovBins();
 
-  if(debug>0) std::cout<<"Reading CRV lookup tables "<<filename<<" ... "<<std::flush;
-  for(unsigned int i=0; i<nScintillatorScintillationBins; i++) _bins[0][i].Read(lookupfile,i);
-  for(unsigned int i=0; i<nScintillatorCerenkovBins; i++)      _bins[1][i].Read(lookupfile,i);
-  for(unsigned int i=0; i<nFiberCerenkovBins; i++)             _bins[2][i].Read(lookupfile,i);
-  if(debug>0) std::cout<<"Done."<<std::endl;
+  LookupBin bin;
+  for(int table=0; table<3; ++table)
+  {
+    _binStorage[table].resize(_nBins[table]);
+    for(unsigned int i=0; i<_nBins[table]; i++)
+    {
+      bin.Read(lookupfile,i);
+      _binStorage[table][i].Fill(bin,_probabilityStorage);
+    }
+    _bins[table] = _binStorage[table].data();
+  }
+  _probabilities = _probabilityStorage.data();
+  _nProbabilities = _probabilityStorage.size();
+}
+
+//maps a lookup table file written by WriteMappedLookupTable.
+//only the small constants and bin definitions are read, the bins themselves are used in place.
+void MakeCrvPhotons::MapLookupTable(std::ifstream &lookupfile, const MappedLookupTableHeader &header)
+{
+  if(header.endian!=MappedLookupTableHeader::endianMarker)
+    throw std::logic_error("Lookup table file "+_fileName+" was written on a machine with a different byte order.");
+  if(header.format!=MappedLookupTableHeader::currentFormat)
+    throw std::logic_error("Lookup table file "+_fileName+" has format "+std::to_string(header.format)
+                           +", but this version of Offline reads format "+std::to_string(MappedLookupTableHeader::currentFormat)+".");
+
+  lookupfile.seekg(header.definitionsOffset);
+  _LC.Read(lookupfile);
+  CheckLookupConstants();
+  _LCerenkov.Read(lookupfile);
+  _LBD.Read(lookupfile);
+  if(!lookupfile.good()) throw std::logic_error("Corrupt lookup table file "+_fileName);
+
+  _nBins[0] = _LBD.getNScintillatorScintillationBins();
+  _nBins[1] = _LBD.getNScintillatorCerenkovBins();
+  _nBins[2] = _LBD.getNFiberCerenkovBins();
+
+  int fd = open(_fileName.c_str(), O_RDONLY);
+  if(fd<0) throw std::logic_error("Could not open lookup table file "+_fileName+": "+strerror(errno));
+  struct stat info;
+  if(fstat(fd,&info)!=0 || static_cast<uint64_t>(info.st_size)!=header.fileSize)
+  {
+    close(fd);
+    throw std::logic_error("Lookup table file "+_fileName+" does not have the size given in its header.");
+  }
+  //a read-only shared mapping uses the pages of the page cache,
+  //i.e. all processes on a node which map this file share one copy
+  _mappedFileSize = header.fileSize;
+  _mappedFile = mmap(NULL, _mappedFileSize, PROT_READ, MAP_SHARED, fd, 0);
+  int errsave = errno;
+  close(fd);
+  if(_mappedFile==MAP_FAILED)
+  {
+    _mappedFile=NULL;
+    throw std::logic_error("Could not map lookup table file "+_fileName+": "+strerror(errsave));
+  }
+
+  const char *data = static_cast<const char*>(_mappedFile);
+  for(int table=0; table<3; ++table)
+  {
+    if(header.nBins[table]!=_nBins[table] ||
+       header.binRecordsOffset[table]%alignof(LookupBinRecord)!=0 ||
+       header.binRecordsOffset[table]+header.nBins[table]*sizeof(LookupBinRecord)>_mappedFileSize)
+    {
+      UnmapLookupTable();
+      throw std::logic_error("Corrupt lookup table file "+_fileName);
+    }
+    _bins[table] = reinterpret_cast<const LookupBinRecord*>(data+header.binRecordsOffset[table]);
+  }
+  if(header.probabilitiesOffset+header.nProbabilities>_mappedFileSize)
+  {
+    UnmapLookupTable();
+    throw std::logic_error("Corrupt lookup table file "+_fileName);
+  }
+  _probabilities = reinterpret_cast<const unsigned char*>(data+header.probabilitiesOffset);
+  _nProbabilities = header.nProbabilities;
 
+  //the bins are used without any further checks, so all offsets into the probability array are checked here once.
+  //a guide can be equal to nTimeDelays (if the last time delays have zero probability).
+  for(int table=0; table<3; ++table)
+  {
+    for(unsigned int i=0; i<_nBins[table]; ++i)
+    {
+      const LookupBinRecord &bin = _bins[table][i];
+      bool good = bin.timeDelays<=_nProbabilities && bin.nTimeDelays<=_nProbabilities-bin.timeDelays &&
+                  bin.fiberEmissions<=_nProbabilities && bin.nFiberEmissions<=_nProbabilities-bin.fiberEmissions;
+      for(int j=0; j<LookupBinRecord::nTimeDelayGuides && good; ++j)
+      {
+        if(bin.timeDelayGuide[j]>bin.nTimeDelays) good=false;
+      }
+      if(!good)
+      {
+        UnmapLookupTable();
+        throw std::logic_error("Corrupt lookup table file "+_fileName);
+      }
+    }
+  }
+}
+
+void MakeCrvPhotons::UnmapLookupTable()
+{
+  if(_mappedFile) munmap(_mappedFile,_mappedFileSize);
+  _mappedFile=NULL;
+  _mappedFileSize=0;
+  for(int table=0; table<3; ++table) {_bins[table]=NULL; _nBins[table]=0;}
+  _probabilities=NULL;
+  _nProbabilities=0;
+}
+
+void MakeCrvPhotons::WriteMappedLookupTable(const std::string &filename)
+{
+  if(_probabilities==NULL) throw std::logic_error("No lookup table has been loaded, which could be written to "+filename);
+
+  std::ofstream lookupfile(filename,std::ios::binary|std::ios::trunc);
+  if(!lookupfile.good()) throw std::logic_error("Could not open lookup table file "+filename);
+
+  //the header is written again at the end, when all offsets are known
+  MappedLookupTableHeader header;
+  std::memset(&header,0,sizeof(MappedLookupTableHeader));
+  std::memcpy(header.magic,MappedLookupTableHeader::Magic(),sizeof(header.magic));
+  header.endian = MappedLookupTableHeader::endianMarker;
+  header.format = MappedLookupTableHeader::currentFormat;
+  lookupfile.write(reinterpret_cast<const char*>(&header),sizeof(MappedLookupTableHeader));
+
+  header.definitionsOffset = lookupfile.tellp();
+  _LC.Write(lookupfile);
+  _LCerenkov.Write(lookupfile);
+  _LBD.Write(lookupfile);
+
+  for(int table=0; table<3; ++table)
+  {
+    while(lookupfile.tellp()%alignof(LookupBinRecord)!=0) lookupfile.put(0);
+    header.binRecordsOffset[table] = lookupfile.tellp();
+    header.nBins[table] = _nBins[table];
+    lookupfile.write(reinterpret_cast<const char*>(_bins[table]),sizeof(LookupBinRecord)*_nBins[table]);
+  }
+
+  header.probabilitiesOffset = lookupfile.tellp();
+  header.nProbabilities = _nProbabilities;
+  lookupfile.write(reinterpret_cast<const char*>(_probabilities),_nProbabilities);
+  header.fileSize = lookupfile.tellp();
+
+  lookupfile.seekp(0);
+  lookupfile.write(reinterpret_cast<const char*>(&header),sizeof(MappedLookupTableHeader));
+  if(!lookupfile.good()) throw std::logic_error("Failed writing lookup table file "+filename);
   lookupfile.close();
 }
 
 MakeCrvPhotons::~MakeCrvPhotons()
 {
+  UnmapLookupTable();
 }
 
 void MakeCrvPhotons::MakePhotons(const CLHEP::Hep3Vector &stepStartTmp,   //they need to be points
@@ -321,9 +536,6 @@ void MakeCrvPhotons::MakePhotons(const CLHEP::Hep3Vector &stepStartTmp,   //they
   stepEnd[3].setZ(-stepEnd[3].z());
   stepEnd[3].setY(-stepEnd[3].y());
 
-static int nPScintillation=0;
-static int nPCerenkov=0;
-
   for(int SiPM=0; SiPM<_nSiPMs; SiPM++)
   {
     //there are only lookup tables without reflector or with reflector on the +z side (i.e. at SiPMs #1 and #3)
@@ -346,6 +558,8 @@ static int nPCerenkov=0;
     int nPhotonsCerenkovInScintillatorPerStep = GetNumberOfPhotonsFromAverage(avgNPhotonsCerenkovInScintillator,nSteps);
     int nPhotonsCerenkovInFiberPerStep        = GetNumberOfPhotonsFromAverage(avgNPhotonsCerenkovInFiber,nSteps);
 
+    std::vector<double> &arrivalTimes = (reflector!=-1 && reflector!=-2 ? _arrivalTimes[SiPM] : _arrivalTimes[SiPM+1]);
+
     for(int step=0; step<nSteps; step++)
     {
       double stepFraction = (step+0.5)/nSteps;
@@ -356,74 +570,64 @@ static int nPCerenkov=0;
       double r=0;  //distance from fiber center for fiber tables
       double phi=0;  //angle w.r.t. the radius vector from the fiber center to the point in the 2D cross section plane
                      //0...+pi due to symmetry
-      bool isInFiber = IsInsideFiber(p,distanceVector, r,phi);
 
-      const LookupBin *scintillationBin=NULL;
-      const LookupBin *cerenkovBin=NULL;
-      int nPhotonsScintillation=0;
-      int nPhotonsCerenkov=0;
       if(isInScintillator)
       {
         int binNumberS=_LBD.findScintillatorScintillationBin(fabs(p.x()),p.y(),p.z());  //use only positive x values due to symmetry in x
         if(binNumberS>=0)
         {
-          scintillationBin = &_bins[0][binNumberS];   //lookup table number for scintillation in scintillator is 0
-          nPhotonsScintillation = nPhotonsScintillationPerStep;
+          //lookup table number for scintillation in scintillator is 0
+          AddArrivingPhotons(&_bins[0][binNumberS], nPhotonsScintillationPerStep, t, SiPM, arrivalTimes);
         }
         int binNumberC=_LBD.findScintillatorCerenkovBin(fabs(p.x()),p.y(),p.z(),beta);  //use only positive x values due to symmetry in x
         if(binNumberC>=0)
         {
-          cerenkovBin = &_bins[1][binNumberC];   //lookup table number for cerenkov in scintillator is 1
-          nPhotonsCerenkov = nPhotonsCerenkovInScintillatorPerStep;
+          //lookup table number for cerenkov in scintillator is 1
+          AddArrivingPhotons(&_bins[1][binNumberC], nPhotonsCerenkovInScintillatorPerStep, t, SiPM, arrivalTimes);
         }
       }
-      else if(isInFiber)
+      else if(IsInsideFiber(p,distanceVector, r,phi))
       {
         int binNumber=_LBD.findFiberCerenkovBin(beta,theta,phi,r,p.z());
         if(binNumber>=0)
         {
-          cerenkovBin = &_bins[2][binNumber];   //lookup table number for cerenkov in fiber is 2
-          nPhotonsCerenkov = nPhotonsCerenkovInFiberPerStep;
+          //lookup table number for cerenkov in fiber is 2
+          AddArrivingPhotons(&_bins[2][binNumber], nPhotonsCerenkovInFiberPerStep, t, SiPM, arrivalTimes);
         }
       }
+    }//loop over all points along the track
+  }//loop over all SiPMs
+}
 
-nPScintillation+=nPhotonsScintillation;
-nPCerenkov+=nPhotonsCerenkov;
-
-      //loop over all photons created at this point
-      int nPhotons = nPhotonsScintillation + nPhotonsCerenkov;
-      for(int i=0; i<nPhotons; i++)
-      {
-        //get the right bin
-        const LookupBin *theBin=cerenkovBin;
-        if(i<nPhotonsScintillation) theBin=scintillationBin;
-        if(theBin==NULL) continue;  //this can't actually happen
-
-        //photon arrival probability at SiPM
-        double probability = theBin->arrivalProbability;
-        probability*=_photonYieldDeviation[SiPM];   //channel-specific deviation from nominal, e.g. due to scintillator variations or SiPM misalignments
-        if(_randFlat.fire()<=probability)  //a photon arrives at the SiPM --> calculate arrival time
-        {
-          //start time of photons
-          double arrivalTime = t;
+//adds the arrival times of the photons (out of nPhotons created at time t) that arrive at the SiPM.
+//every photon arrives independently with the arrival probability of the bin,
+//so the number of arriving photons is drawn from a binomial distribution.
+void MakeCrvPhotons::AddArrivingPhotons(const LookupBinRecord *theBin, int nPhotons, double t, int SiPM, std::vector<double> &arrivalTimes)
+{
+  if(nPhotons<=0) return;
 
-          //add fiber decay times depending on the number of emissions
-          int nEmissions = GetRandomFiberEmissions(theBin);
-          for(int iEmission=0; iEmission<nEmissions; iEmission++) arrivalTime+=-_LC.WLSfiberDecayTime*log(_randFlat.fire());
+  //photon arrival probability at SiPM
+  double probability = theBin->arrivalProbability;
+  probability*=_photonYieldDeviation[SiPM];   //channel-specific deviation from nominal, e.g. due to scintillator variations or SiPM misalignments
+  if(probability<=0) return;
 
-          //add additional time delay due to the photons bouncing around
-          arrivalTime+=GetRandomTime(theBin);
+  long nArrivingPhotons = nPhotons;
+  if(probability<1.0) nArrivingPhotons = CLHEP::RandBinomial::shoot(&_randFlat.engine(), nPhotons, probability);
 
-          if(reflector!=-1 && reflector!=-2) _arrivalTimes[SiPM].push_back(arrivalTime);
-          else _arrivalTimes[SiPM+1].push_back(arrivalTime);
+  for(long i=0; i<nArrivingPhotons; i++)
+  {
+    //start time of photons
+    double arrivalTime = t;
 
-        }// if a photon was created
-      }//loop over all SiPMs
-    }//loop over all photons at this point
-  }//loop over all points along the track
+    //add fiber decay times depending on the number of emissions
+    int nEmissions = GetRandomFiberEmissions(theBin);
+    for(int iEmission=0; iEmission<nEmissions; iEmission++) arrivalTime+=-_LC.WLSfiberDecayTime*log(_randFlat.fire());
 
-//std::cout<<"Lookup tables:  total scintillation: "<<nPScintillation<<"  total Cerenkov: "<<nPCerenkov<<std::endl;
+    //add additional time delay due to the photons bouncing around
+    arrivalTime+=GetRandomTime(theBin);
 
+    arrivalTimes.push_back(arrivalTime);
+  }
 }
 
 bool MakeCrvPhotons::IsInsideScintillator(const CLHEP::Hep3Vector &p)
@@ -476,40 +680,50 @@ bool MakeCrvPhotons::IsInsideFiber(const CLHEP::Hep3Vector &p, const CLHEP::Hep3
   return true;
 }
 
-double MakeCrvPhotons::GetRandomTime(const LookupBin *theBin)
+double MakeCrvPhotons::GetRandomTime(const LookupBinRecord *theBin)
 {
   //The lookup tables encodes probabilities as probability*mu2eCrv::LookupBin::probabilityScale(255),
   //so that the probabilities can be stored as integers. For example, the probability of 1 is stored as 255.
   //Due to rounding issues, the sum of all entries for this bin may not be 255.
   //This bin-specifc sum is the probabilityScaleTimeDelays.
 
-  size_t timeDelay=0;
+  //The search starts at the time delay given by the guide table of this bin (see LookupBinRecord::Fill).
+
   double rand=_randFlat.fire()*theBin->probabilityScaleTimeDelays;
-  double sumProb=0;
-  size_t maxTimeDelay=theBin->timeDelays.size();
-  for(timeDelay=0; timeDelay<maxTimeDelay; ++timeDelay)
+  size_t guide=0;
+  if(theBin->probabilityScaleTimeDelays>0)
+  {
+    guide=static_cast<size_t>(rand/theBin->probabilityScaleTimeDelays*LookupBinRecord::nTimeDelayGuides);
+    if(guide>=LookupBinRecord::nTimeDelayGuides) guide=LookupBinRecord::nTimeDelayGuides-1;
+  }
+  const unsigned char *timeDelays=_probabilities+theBin->timeDelays;
+  size_t timeDelay=theBin->timeDelayGuide[guide];
+  double sumProb=theBin->timeDelayGuideSum[guide];
+  size_t maxTimeDelay=theBin->nTimeDelays;
+  for(; timeDelay<maxTimeDelay; ++timeDelay)
   {
-    sumProb+=theBin->timeDelays[timeDelay];
+    sumProb+=timeDelays[timeDelay];
     if(rand<=sumProb) break;
   }
 
   return static_cast<double>(timeDelay);
 }
 
-int MakeCrvPhotons::GetRandomFiberEmissions(const LookupBin *theBin)
+int MakeCrvPhotons::GetRandomFiberEmissions(const LookupBinRecord *theBin)
 {
   //The lookup tables encodes probabilities as probability*mu2eCrv::LookupBin::probabilityScale(255),
   //so that the probabilities can be stored as integers. For example, the probability of 1 is stored as 255.
   //Due to rounding issues, the sum of all entries for this bin may not be 255.
   //This bin-specifc sum is the probabilityScaleFiberEmissions.
 
+  const unsigned char *fiberEmissions=_probabilities+theBin->fiberEmissions;
   size_t emissions=0;
   double rand=_randFlat.fire()*theBin->probabilityScaleFiberEmissions;
   double sumProb=0;
-  size_t maxEmissions=theBin->fiberEmissions.size();
+  size_t maxEmissions=theBin->nFiberEmissions;
   for(emissions=0; emissions<maxEmissions; ++emissions)
   {
-    sumProb+=theBin->fiberEmissions[emissions];
+    sumProb+=fiberEmissions[emissions];
     if(rand<=sumProb) break;
   }
 
@@ -0,0 +1,47 @@
+//
+// Converts CRV lookup tables (version 6) into the format which MakeCrvPhotons
+// maps read-only, so that all processes on a node share one copy of the tables.
+//
+//   convertCrvLookupTable LookupTable_6000_0 LookupTable_6000_0.map
+//
+
+#include "Offline/CRVResponse/inc/MakeCrvPhotons.hh"
+
+#include "CLHEP/Random/JamesRandom.h"
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+int main(int argc, char** argv)
+{
+  if(argc!=3)
+  {
+    std::cerr<<"usage: "<<argv[0]<<" <input lookup table> <output mapped lookup table>"<<std::endl;
+    return 1;
+  }
+
+  //the random number generators are not used, but needed for the photon maker
+  CLHEP::HepJamesRandom engine;
+  CLHEP::RandFlat       randFlat(engine);
+  CLHEP::RandGaussQ     randGaussQ(engine);
+  CLHEP::RandPoissonQ   randPoissonQ(engine);
+
+  try
+  {
+    mu2eCrv::MakeCrvPhotons photonMaker(randFlat, randGaussQ, randPoissonQ);
+    photonMaker.LoadLookupTable(argv[1],1);
+    photonMaker.WriteMappedLookupTable(argv[2]);
+
+    //check that the new file can be mapped
+    mu2eCrv::MakeCrvPhotons mappedPhotonMaker(randFlat, randGaussQ, randPoissonQ);
+    mappedPhotonMaker.LoadLookupTable(argv[2],1);
+  }
+  catch(std::exception &e)
+  {
+    std::cerr<<e.what()<<std::endl;
+    return 1;
+  }
+
+  return 0;
+}
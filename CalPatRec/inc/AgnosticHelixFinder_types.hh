@@ -16,6 +16,8 @@ namespace mu2e {
       int     nComboHits;
       int     nStrawHits;
       float   time;
+      float   seedTime;      // time (ms) spent building seed circles from triplets
+      int     nSeedCircles;  // number of triplets for which a seed circle was built
     };
 
     struct lineSegmentInfo {
@@ -27,6 +29,8 @@ namespace mu2e {
       float                          moduleTime;
       int                            nHelices;
       int                            nTimeClusters;
+      float                          seedTime;      // for the time cluster being processed
+      int                            nSeedCircles;
       std::vector<tcInfo>            timeClusterData;
       std::vector<lineSegmentInfo>   lineSegmentData;
     };
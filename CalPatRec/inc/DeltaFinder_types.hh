@@ -18,6 +18,7 @@ namespace fhicl {
 #include "Offline/DataProducts/inc/StrawId.hh"
 #include "Offline/RecoDataProducts/inc/StereoHit.hh"
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitSoAView.hh"
 #include "Offline/RecoDataProducts/inc/TimeCluster.hh"
 #include "Offline/TrackerGeom/inc/Straw.hh"
 #include "Offline/TrackerGeom/inc/Tracker.hh"
@@ -110,6 +111,8 @@ namespace mu2e {
       art::InputTag                 sdmcCollTag;
 
       const ComboHitCollection*     chcol;
+      const ComboHitSoAView*        chsoa;                   // view of chcol, written with it
+      ComboHitSoAView               chsoaLocal;              // used for inputs written without a view
       ComboHitCollection*           outputChColl;
 
       DeltaFinderAlg*               _finder;
@@ -118,7 +121,7 @@ namespace mu2e {
 
       int                           _nComboHits;
       int                           _nStrawHits;
-      std::vector<const ComboHit*>  _v;                      // sorted
+      std::vector<int>              _v;                      // hit indices, sorted in time
 
       ManagedList<DeltaSeed>        fListOfSeeds       [kNStations];
       std::vector<DeltaSeed*>       fListOfProtonSeeds [kNStations];
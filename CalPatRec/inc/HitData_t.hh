@@ -7,6 +7,7 @@
 #include <cmath>
 
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitSoAView.hh"
 
 namespace mu2e {
   class DeltaSeed;
@@ -22,6 +23,8 @@ namespace CalPatRec {
     float                   fChi2Min;
     float                   fSigW2;          // cached resolution^2 along the wire
     float                   fCorrTime;       // cached hit corrected time
+    float                   fTime;           // cached hit time
+    int                     fPanel;          // cached panel index within its face, 0-2
     float                   fX;
     float                   fY;
     float                   fWx;
@@ -34,19 +37,21 @@ namespace CalPatRec {
     float                   fNyr;
 
 
-    HitData_t(const mu2e::ComboHit* Hit,int ZFace) {
+    // 'Index' is the index of 'Hit' in the collection described by 'Chv'
+    HitData_t(const mu2e::ComboHit* Hit, const mu2e::ComboHitSoAView& Chv, int Index, int ZFace) {
         fHit         = Hit;
         fSeed        = nullptr;
         fUsed        = 0;
         fZFace       = ZFace;
         fChi2Min     = 99999.0;
-        float sigw   =  Hit->posRes(mu2e::ComboHit::wire);
-        fSigW2       = sigw*sigw;
-        fCorrTime    = Hit->correctedTime();
-        fX           = Hit->pos ().x();
-        fY           = Hit->pos ().y();
-        fWx          = Hit->uDir2D().x();
-        fWy          = Hit->uDir2D().y();
+        fSigW2       = Chv.wireVar()[Index];
+        fCorrTime    = Chv.correctedTime()[Index];
+        fTime        = Chv.time()[Index];
+        fPanel       = (Chv.uniquePanel()[Index] % mu2e::StrawId::_npanels) / 2;
+        fX           = Chv.x()[Index];
+        fY           = Chv.y()[Index];
+        fWx          = Chv.uDirX()[Index];
+        fWy          = Chv.uDirY()[Index];
         fNr          = fX*fWy-fY*fWx;
         fNx2         = fWx*fWx;
         fNxy         = fWx*fWy;
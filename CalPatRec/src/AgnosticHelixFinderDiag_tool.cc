@@ -35,6 +35,9 @@ namespace mu2e {
       TH1F* nStrawHitsPerTC;
       TH1F* timePerTC;
       TProfile* timePerTCVSnComboHitsPerTC;
+      TH1F* seedTimePerTC;
+      TH1F* nSeedCirclesPerTC;
+      TProfile* seedTimePerTCVSnComboHitsPerTC;
     };
 
     struct LineSegmentHists {
@@ -102,6 +105,12 @@ namespace mu2e {
       Dir->make<TH1F>("timePerTC", "time (ms) searching for helix per TC", 50000, 0.0, 25.0);
     Hist->timePerTCVSnComboHitsPerTC = Dir->make<TProfile>(
                                                            "timePerTCVSnComboHitsPerTC", "timePerTCVSnComboHitsPerTC", 200, 0.0, 200.0, 0.0, 25.0, "i");
+    Hist->seedTimePerTC =
+      Dir->make<TH1F>("seedTimePerTC", "time (ms) building triplet seed circles per TC", 50000, 0.0, 25.0);
+    Hist->nSeedCirclesPerTC =
+      Dir->make<TH1F>("nSeedCirclesPerTC", "number of triplet seed circles per TC", 1000, 0.0, 10000.0);
+    Hist->seedTimePerTCVSnComboHitsPerTC = Dir->make<TProfile>(
+                                                               "seedTimePerTCVSnComboHitsPerTC", "seedTimePerTCVSnComboHitsPerTC", 200, 0.0, 200.0, 0.0, 25.0, "i");
 
     return 0;
   }
@@ -175,6 +184,10 @@ namespace mu2e {
     Hist->timePerTC->Fill(Data->timeClusterData.at(loopIndex).time);
     Hist->timePerTCVSnComboHitsPerTC->Fill(Data->timeClusterData.at(loopIndex).nComboHits,
                                            Data->timeClusterData.at(loopIndex).time, 1);
+    Hist->seedTimePerTC->Fill(Data->timeClusterData.at(loopIndex).seedTime);
+    Hist->nSeedCirclesPerTC->Fill(Data->timeClusterData.at(loopIndex).nSeedCircles);
+    Hist->seedTimePerTCVSnComboHitsPerTC->Fill(Data->timeClusterData.at(loopIndex).nComboHits,
+                                               Data->timeClusterData.at(loopIndex).seedTime, 1);
 
     return 0;
   }
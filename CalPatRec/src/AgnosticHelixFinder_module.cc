@@ -6,21 +6,24 @@
 #include "Offline/CalPatRec/inc/AgnosticHelixFinder_types.hh"
 
 #include "Offline/ConfigTools/inc/ConfigFileLookupPolicy.hh"
-#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Core/SharedProducer.h"
 #include "art/Framework/Principal/Event.h"
 #include "art/Framework/Principal/Handle.h"
 #include "art/Utilities/make_tool.h"
 #include "art_root_io/TFileService.h"
+#include "cetlib_except/exception.h"
 #include "fhiclcpp/ParameterSet.h"
 
 #include "Offline/BFieldGeom/inc/BFieldManager.hh"
 #include "Offline/CalorimeterGeom/inc/Calorimeter.hh"
+#include "Offline/GeneralUtilities/inc/ObjectPool.hh"
 #include "Offline/GeometryService/inc/DetectorSystem.hh"
 #include "Offline/GeometryService/inc/GeomHandle.hh"
 #include "Offline/TrackerGeom/inc/Tracker.hh"
 
 #include "Offline/RecoDataProducts/inc/CaloCluster.hh"
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitSoAView.hh"
 #include "Offline/RecoDataProducts/inc/HelixHit.hh"
 #include "Offline/RecoDataProducts/inc/HelixSeed.hh"
 #include "Offline/RecoDataProducts/inc/StrawHitIndex.hh"
@@ -52,13 +55,20 @@
 #include "TMultiGraph.h"
 #include <TROOT.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
 
 namespace mu2e {
 
   using namespace AgnosticHelixFinderTypes;
 
-  class AgnosticHelixFinder : public art::EDProducer {
+  //-----------------------------------------------------------------------------
+  // the helix search of one event.  It keeps its working state in data members,
+  // so the module below runs one instance per event processed concurrently
+  //-----------------------------------------------------------------------------
+  class AgnosticHelixFinderAlg {
 
   public:
     struct Config {
@@ -84,6 +94,8 @@ namespace mu2e {
       fhicl::Atom<float>         maxTripletDz           {Name("maxTripletDz"         ), Comment("max Z dist btwn 2 trip pts"  )  };
       fhicl::Atom<float>         minTripletDist         {Name("minTripletDist"       ), Comment("min XY dist btwn 2 trip pts" )  };
       fhicl::Atom<float>         minTripletArea         {Name("minTripletArea"       ), Comment("triangle area of triplet"    )  };
+      fhicl::Atom<std::string>   seedEngine             {Name("seedEngine"           ), Comment("exhaustive or grid"          )  };
+      fhicl::Atom<float>         seedGridCell           {Name("seedGridCell"         ), Comment("xy cell size of seed grid"   )  };
       fhicl::Atom<float>         maxSeedCircleResidual  {Name("maxSeedCircleResidual"), Comment("add hits to triplet circle"  )  };
       fhicl::Atom<int>           minSeedCircleHits      {Name("minSeedCircleHits"    ), Comment("min hits to continue search" )  };
       fhicl::Atom<float>         maxDphiDz              {Name("maxDphiDz"            ), Comment("used finding phi-z segment"  )  };
@@ -130,6 +142,22 @@ namespace mu2e {
       bool    debugParticle = false; // only filled in debug mode -- true if mc particle, false if background
     };
 
+    // per-hit quantities cached when filling _tcHits, used by the triplet seeding
+    struct seedHit {
+      XYZVectorF   pos;
+      float        maxCircleError2 = 0.0; // upper bound on circleError2 for any circle center
+    };
+
+    // hits of a time cluster binned on an xy grid, in compressed form: the hits of cell c are
+    // hits[start[c]] to hits[start[c+1]-1], in _tcHits order.  The hits are split in classes
+    // by their largest seed circle residual distance, maxDist, so that a circle only needs the
+    // cells within maxDist of each class
+    struct seedGridClass {
+      float                  maxDist = 0.0;
+      std::vector<uint32_t>  start;
+      std::vector<uint32_t>  hits;
+    };
+
     struct tripletPoint {
       XYZVectorF   pos;
       int          hitIndice;
@@ -166,6 +194,14 @@ namespace mu2e {
       STOPPINGTARGET = -2
     };
 
+    // how the seed circle of a triplet collects its hits: EXHAUSTIVE computes the circle error
+    // and residual of every hit, GRID only looks at the hits in the xy grid cells that cross the
+    // annulus allowed by their largest possible circle error.  Both give the same seeds.
+    enum SeedEngine {
+      EXHAUSTIVE,
+      GRID
+    };
+
     // struct to hold info specifically for when debugging
     struct logicTrackingInfo {
       std::vector<std::vector<cHit>>   tcHitsColl;
@@ -206,6 +242,8 @@ namespace mu2e {
     // collections
     //-----------------------------------------------------------------------------
     const ComboHitCollection*      _chColl;
+    const ComboHitSoAView*         _chSoA;      // view written with _chColl, or _chSoALocal
+    ComboHitSoAView                _chSoALocal; // filled only for inputs written without a view
     const TimeClusterCollection*   _tcColl;
     const CaloClusterCollection*   _ccColl;
 
@@ -226,6 +264,8 @@ namespace mu2e {
     float    _maxTripletDz;
     float    _minTripletDist;
     float    _minTripletArea;
+    SeedEngine _seedEngine;
+    float    _seedGridCell;
     float    _maxSeedCircleResidual;
     int      _minSeedCircleHits;
     float    _maxDphiDz;
@@ -272,6 +312,15 @@ namespace mu2e {
     // stuff for doing helix search
     //-----------------------------------------------------------------------------
     std::vector<cHit>             _tcHits;
+    std::vector<seedHit>          _seedHits; // parallel to _tcHits
+    static constexpr size_t       nSeedGridClasses = 6;
+    float                         _seedGridX0;
+    float                         _seedGridY0;
+    int                           _seedGridNx;
+    int                           _seedGridNy;
+    std::vector<seedGridClass>    _seedGrid;       // nSeedGridClasses, filled with _tcHits
+    std::vector<size_t>           _seedCandidates; // hits near the current triplet circle
+    std::vector<size_t>           _seedCircleHits; // hits added to the current seed circle
     XYZVectorF                    _stopTargPos;
     XYZVectorF                    _caloPos;
     ::LsqSums4                    _circleFitter;
@@ -321,13 +370,13 @@ namespace mu2e {
     //-----------------------------------------------------------------------------
 
   public:
-    explicit AgnosticHelixFinder(const art::EDProducer::Table<Config>& config);
-    virtual ~AgnosticHelixFinder();
+    explicit AgnosticHelixFinderAlg(const art::SharedProducer::Table<Config>& config);
+    ~AgnosticHelixFinderAlg();
 
-    virtual void beginJob  ();
-    virtual void beginRun  (art::Run&);
-    virtual void produce   (art::Event& e);
-    virtual void endJob    ();
+    void beginJob  ();
+    void beginRun  ();
+    void produce   (art::Event& e);
+    void endJob    ();
 
     //-----------------------------------------------------------------------------
     // helper functions
@@ -349,6 +398,9 @@ namespace mu2e {
     void         setTripletK               (size_t& tcHitsIndex, triplet& trip, LoopCondition& outcome);
     void         initTriplet               (triplet& trip, LoopCondition& outcome);
     void         initSeedCircle            (LoopCondition& outcome);
+    void         fillSeedGrid              ();
+    void         findSeedGridCandidates    (float xC, float yC, float rC);
+    void         initSeedCircleGrid        (LoopCondition& outcome);
     void         initHelixPhi              ();
     void         findSeedPhiLines          ();
     void         resolve2PiAmbiguities     ();
@@ -373,8 +425,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // module constructor
   //-----------------------------------------------------------------------------
-  AgnosticHelixFinder::AgnosticHelixFinder(const art::EDProducer::Table<Config>& config) :
-    art::EDProducer{config},
+  AgnosticHelixFinderAlg::AgnosticHelixFinderAlg(const art::SharedProducer::Table<Config>& config) :
     _diagLevel                     (config().diagLevel()                             ),
     _debug                         (config().debug()                                 ),
     _runDisplay                    (config().runDisplay()                            ),
@@ -395,6 +446,8 @@ namespace mu2e {
     _maxTripletDz                  (config().maxTripletDz()                          ),
     _minTripletDist                (config().minTripletDist()                        ),
     _minTripletArea                (config().minTripletArea()                        ),
+    _seedEngine                    (EXHAUSTIVE                                       ),
+    _seedGridCell                  (config().seedGridCell()                          ),
     _maxSeedCircleResidual         (config().maxSeedCircleResidual()                 ),
     _minSeedCircleHits             (config().minSeedCircleHits()                     ),
     _maxDphiDz                     (config().maxDphiDz()                             ),
@@ -423,11 +476,6 @@ namespace mu2e {
 
     {
 
-      consumes<ComboHitCollection>     (_chLabel);
-      consumes<TimeClusterCollection>  (_tcLabel);
-      consumes<CaloClusterCollection>  (_ccLabel);
-      produces<HelixSeedCollection>    ();
-
       if (_debug == 1) {
         _mcUtils = art::make_tool<McUtilsToolBase>(config().mcUtils, "mcUtils");
         if (_runDisplay == 1) {
@@ -450,17 +498,29 @@ namespace mu2e {
 
       if (_useStoppingTarget == true) { _stopTargPos.SetCoordinates(0.0, 0.0, std::numeric_limits<float>::max()); }
 
+      std::string seedEngine = config().seedEngine();
+      if (seedEngine == "exhaustive") {
+        _seedEngine = EXHAUSTIVE;
+      } else if (seedEngine == "grid") {
+        _seedEngine = GRID;
+      } else {
+        throw cet::exception("RECO") << "AgnosticHelixFinder: unknown seedEngine " << seedEngine << std::endl;
+      }
+      if (_seedEngine == GRID && _seedGridCell <= 0.0) {
+        throw cet::exception("RECO") << "AgnosticHelixFinder: seedGridCell must be positive, not " << _seedGridCell << std::endl;
+      }
+
     }
 
   //-----------------------------------------------------------------------------
   // destructor
   //-----------------------------------------------------------------------------
-  AgnosticHelixFinder::~AgnosticHelixFinder() {}
+  AgnosticHelixFinderAlg::~AgnosticHelixFinderAlg() {}
 
   //-----------------------------------------------------------------------------
   // beginJob
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::beginJob() {
+  void AgnosticHelixFinderAlg::beginJob() {
     if (_diagLevel == 1) {
       art::ServiceHandle<art::TFileService> tfs;
       _hmanager->bookHistograms(tfs);
@@ -470,7 +530,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // beginRun
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::beginRun(art::Run&) {
+  void AgnosticHelixFinderAlg::beginRun() {
 
     GeomHandle<mu2e::Calorimeter> ch;
     _calorimeter = ch.get();
@@ -484,7 +544,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // find input things
   //-----------------------------------------------------------------------------
-  bool AgnosticHelixFinder::findData(const art::Event& evt) {
+  bool AgnosticHelixFinderAlg::findData(const art::Event& evt) {
 
     auto chCollH = evt.getValidHandle<ComboHitCollection>(_chLabel);
     if (chCollH.product() != 0) {
@@ -492,6 +552,10 @@ namespace mu2e {
     } else {
       _chColl = 0;
     }
+    if (_chColl != 0) {
+      auto chSoAH = evt.getHandle<ComboHitSoAView>(_chLabel);
+      _chSoA = &ComboHitSoAView::get(chSoAH.isValid() ? chSoAH.product() : nullptr, *_chColl, _chSoALocal);
+    }
 
     auto _tcCollH = evt.getValidHandle<TimeClusterCollection>(_tcLabel);
     if (_tcCollH.product() != 0) {
@@ -512,7 +576,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // event entry point
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::produce(art::Event& event) {
+  void AgnosticHelixFinderAlg::produce(art::Event& event) {
 
     // get time (needed for diagnostic tool)
     auto moduleStartTime = std::chrono::high_resolution_clock::now();
@@ -570,6 +634,8 @@ namespace mu2e {
         tcInfo timeClusterInfo;
         auto tcStartTime = std::chrono::high_resolution_clock::now();
         int nHelicesInitial = _diagInfo.nHelices;
+        _diagInfo.seedTime = 0.0;
+        _diagInfo.nSeedCircles = 0;
         _tcHits.clear();
         _helixCandidates.clear();
         tcHitsFill(i);
@@ -587,6 +653,8 @@ namespace mu2e {
           timeClusterInfo.nHelices = _diagInfo.nHelices - nHelicesInitial;
           timeClusterInfo.nComboHits = _tcColl->at(i).nhits();
           timeClusterInfo.nStrawHits = _tcColl->at(i).nStrawHits();
+          timeClusterInfo.seedTime = _diagInfo.seedTime;
+          timeClusterInfo.nSeedCircles = _diagInfo.nSeedCircles;
           _diagInfo.timeClusterData.push_back(timeClusterInfo);
         }
       }
@@ -611,57 +679,45 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // endJob
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::endJob() {}
+  void AgnosticHelixFinderAlg::endJob() {}
 
   //-----------------------------------------------------------------------------
   // get pointer to position of hit given some index in _tcHits
   //-----------------------------------------------------------------------------
-  XYZVectorF AgnosticHelixFinder::getPos(size_t& tcHitsIndex) {
-
-    int hitIndice = _tcHits[tcHitsIndex].hitIndice;
+  XYZVectorF AgnosticHelixFinderAlg::getPos(size_t& tcHitsIndex) {
 
-    if (hitIndice >= 0) {
-      return _chColl->at(hitIndice).pos();
-    }
-    if (hitIndice == HitType::STOPPINGTARGET) {
-      return _stopTargPos;
-    }
-    if (hitIndice == HitType::CALOCLUSTER) {
-      return _caloPos;
-    }
-
-    XYZVectorF p(0.0,0.0,0.0);
-    return p;
+    return _seedHits[tcHitsIndex].pos;
 
   }
 
   //-----------------------------------------------------------------------------
   // updates circleError of hit given some circle parameters
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::computeCircleError2(size_t& tcHitsIndex, float& xC, float& yC) {
+  void AgnosticHelixFinderAlg::computeCircleError2(size_t& tcHitsIndex, float& xC, float& yC) {
 
     int hitIndice = _tcHits[tcHitsIndex].hitIndice;
 
     if (hitIndice == HitType::CALOCLUSTER) {
       _tcHits[tcHitsIndex].circleError2 = _caloClusterSigma * _caloClusterSigma;
     } else {
-      float transVar = _chColl->at(hitIndice).transVar();
+      float transVar = _chSoA->transVar()[hitIndice];
       float x = getPos(tcHitsIndex).x();
       float y = getPos(tcHitsIndex).y();
       float dx = x - xC;
       float dy = y - yC;
-      float dxn = dx * _chColl->at(hitIndice).vDir().x() + dy * _chColl->at(hitIndice).vDir().y();
+      // vDir = (-uDir.y, uDir.x)
+      float dxn = -dx * _chSoA->uDirY()[hitIndice] + dy * _chSoA->uDirX()[hitIndice];
       float costh2 = dxn * dxn / (dx * dx + dy * dy);
       float sinth2 = 1 - costh2;
       _tcHits[tcHitsIndex].circleError2 =
-        _chColl->at(hitIndice).wireVar() * sinth2 + transVar * costh2;
+        _chSoA->wireVar()[hitIndice] * sinth2 + transVar * costh2;
     }
   }
 
   //-----------------------------------------------------------------------------
   // compute residual between point an circle
   //-----------------------------------------------------------------------------
-  float AgnosticHelixFinder::computeCircleResidual2(size_t& tcHitsIndex, float& xC, float& yC, float& rC) {
+  float AgnosticHelixFinderAlg::computeCircleResidual2(size_t& tcHitsIndex, float& xC, float& yC, float& rC) {
 
     float xP = getPos(tcHitsIndex).x();
     float yP = getPos(tcHitsIndex).y();
@@ -674,7 +730,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // compute phi relative to helix center, and set helixPhiError
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::computeHelixPhi(size_t& tcHitsIndex, float& xC, float& yC) {
+  void AgnosticHelixFinderAlg::computeHelixPhi(size_t& tcHitsIndex, float& xC, float& yC) {
 
     int hitIndice = _tcHits[tcHitsIndex].hitIndice;
 
@@ -692,13 +748,13 @@ namespace mu2e {
     } else {
       float tanVecX = Y / std::sqrt(X * X + Y * Y);
       float tanVecY = -X / std::sqrt(X * X + Y * Y);
-      float wireErr = _chColl->at(hitIndice).wireRes();
-      float wireVecX = _chColl->at(hitIndice).uDir().x();
-      float wireVecY = _chColl->at(hitIndice).uDir().y();
+      float wireErr = std::sqrt(_chSoA->wireVar()[hitIndice]);
+      float wireVecX = _chSoA->uDirX()[hitIndice];
+      float wireVecY = _chSoA->uDirY()[hitIndice];
       float projWireErr = wireErr * (wireVecX * tanVecX + wireVecY * tanVecY);
-      float transErr = _chColl->at(hitIndice).transRes();
-      float transVecX = _chColl->at(hitIndice).uDir().y();
-      float transVecY = -_chColl->at(hitIndice).uDir().x();
+      float transErr = std::sqrt(_chSoA->transVar()[hitIndice]);
+      float transVecX = wireVecY;
+      float transVecY = -wireVecX;
       float projTransErr = transErr * (transVecX * tanVecX + transVecY * tanVecY);
       deltaS2 = projWireErr * projWireErr + projTransErr * projTransErr;
     }
@@ -708,7 +764,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // function to compute helix momentum^2 given some circle radius and line slope
   //-----------------------------------------------------------------------------
-  float AgnosticHelixFinder::computeHelixMomentum2(float& radius, float& dphidz) {
+  float AgnosticHelixFinderAlg::computeHelixMomentum2(float& radius, float& dphidz) {
 
     float lambda = 1.0 / dphidz;
 
@@ -718,7 +774,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // function to compute helix transverse momentum given circle radius and b-field
   //-----------------------------------------------------------------------------
-  float AgnosticHelixFinder::computeHelixPerpMomentum(float& radius) {
+  float AgnosticHelixFinderAlg::computeHelixPerpMomentum(float& radius) {
 
     return radius * _bz0 * mmTconversion;
   }
@@ -726,7 +782,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // fill vector with hits to search for helix
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::tcHitsFill(size_t tc) {
+  void AgnosticHelixFinderAlg::tcHitsFill(size_t tc) {
 
     size_t sortStartIndex = 0;
 
@@ -777,16 +833,173 @@ namespace mu2e {
 
     // order from largest z to smallest z (skip over stopping target and calo cluster since they
     // aren't in _chColl)
-    std::sort(_tcHits.begin() + sortStartIndex, _tcHits.end(), [&](const cHit& a, const cHit& b) {
-        return _chColl->at(a.hitIndice).pos().z() > _chColl->at(b.hitIndice).pos().z();
+    const float* chz = _chSoA->z();
+    std::sort(_tcHits.begin() + sortStartIndex, _tcHits.end(), [chz](const cHit& a, const cHit& b) {
+        return chz[a.hitIndice] > chz[b.hitIndice];
       });
 
+    // cache the positions, and the largest circle error of each hit: circleError2 is a mix of
+    // the wire and transverse variances with weights summing to 1 (small margin for rounding)
+    _seedHits.resize(_tcHits.size());
+    for (size_t i = 0; i < _tcHits.size(); i++) {
+      int hitIndice = _tcHits[i].hitIndice;
+      seedHit& sh = _seedHits[i];
+      if (hitIndice >= 0) {
+        sh.pos.SetCoordinates(_chSoA->x()[hitIndice], _chSoA->y()[hitIndice], _chSoA->z()[hitIndice]);
+        sh.maxCircleError2 = 1.01 * std::max(_chSoA->wireVar()[hitIndice], _chSoA->transVar()[hitIndice]);
+      } else if (hitIndice == HitType::STOPPINGTARGET) {
+        sh.pos = _stopTargPos;
+        sh.maxCircleError2 = 0.0;
+      } else if (hitIndice == HitType::CALOCLUSTER) {
+        sh.pos = _caloPos;
+        sh.maxCircleError2 = 1.01 * _caloClusterSigma * _caloClusterSigma;
+      } else {
+        sh.pos.SetCoordinates(0.0, 0.0, 0.0);
+        sh.maxCircleError2 = 0.0;
+      }
+    }
+
+    if (_seedEngine == GRID) {
+      fillSeedGrid();
+    }
+
+  }
+
+  //-----------------------------------------------------------------------------
+  // bin the hits of the time cluster on an xy grid for the seed circle search.  A hit goes in
+  // the first class whose distance limit (a quarter of a cell, doubling with each class) covers
+  // the largest distance it can have from a seed circle and still be added to it
+  //-----------------------------------------------------------------------------
+  void AgnosticHelixFinderAlg::fillSeedGrid() {
+
+    float xMin = std::numeric_limits<float>::max();
+    float yMin = std::numeric_limits<float>::max();
+    float xMax = -std::numeric_limits<float>::max();
+    float yMax = -std::numeric_limits<float>::max();
+    for (size_t i = 0; i < _tcHits.size(); i++) {
+      if (_tcHits[i].hitIndice == HitType::STOPPINGTARGET) {
+        continue;
+      }
+      xMin = std::min(xMin, _seedHits[i].pos.x());
+      yMin = std::min(yMin, _seedHits[i].pos.y());
+      xMax = std::max(xMax, _seedHits[i].pos.x());
+      yMax = std::max(yMax, _seedHits[i].pos.y());
+    }
+    if (xMin > xMax) { // no hits
+      xMin = xMax = yMin = yMax = 0.0;
+    }
+    _seedGridX0 = xMin;
+    _seedGridY0 = yMin;
+    _seedGridNx = static_cast<int>((xMax - xMin) / _seedGridCell) + 1;
+    _seedGridNy = static_cast<int>((yMax - yMin) / _seedGridCell) + 1;
+    size_t nCells = _seedGridNx * _seedGridNy;
+
+    auto gridClass = [&](size_t i) {
+      float maxDist = _maxSeedCircleResidual * std::sqrt(_seedHits[i].maxCircleError2);
+      size_t c = 0;
+      float limit = 0.25 * _seedGridCell;
+      while (c + 1 < nSeedGridClasses && maxDist > limit) {
+        c++;
+        limit *= 2.0;
+      }
+      return std::make_pair(c, maxDist);
+    };
+    auto gridCell = [&](size_t i) {
+      int ix = static_cast<int>((_seedHits[i].pos.x() - _seedGridX0) / _seedGridCell);
+      int iy = static_cast<int>((_seedHits[i].pos.y() - _seedGridY0) / _seedGridCell);
+      return static_cast<size_t>(std::min(iy, _seedGridNy - 1) * _seedGridNx + std::min(ix, _seedGridNx - 1));
+    };
+
+    // count the hits of each class and cell, then fill
+    _seedGrid.resize(nSeedGridClasses);
+    for (auto& gc : _seedGrid) {
+      gc.maxDist = 0.0;
+      gc.start.assign(nCells + 1, 0);
+    }
+    for (size_t i = 0; i < _tcHits.size(); i++) {
+      if (_tcHits[i].hitIndice == HitType::STOPPINGTARGET) {
+        continue;
+      }
+      auto [c, maxDist] = gridClass(i);
+      _seedGrid[c].maxDist = std::max(_seedGrid[c].maxDist, maxDist);
+      _seedGrid[c].start[gridCell(i) + 1]++;
+    }
+    for (auto& gc : _seedGrid) {
+      for (size_t cell = 0; cell < nCells; cell++) {
+        gc.start[cell + 1] += gc.start[cell];
+      }
+      gc.hits.resize(gc.start[nCells]);
+    }
+    for (size_t i = 0; i < _tcHits.size(); i++) {
+      if (_tcHits[i].hitIndice == HitType::STOPPINGTARGET) {
+        continue;
+      }
+      seedGridClass& gc = _seedGrid[gridClass(i).first];
+      gc.hits[gc.start[gridCell(i)]++] = i;
+    }
+    // filling advanced each start to the end of its cell: shift back
+    for (auto& gc : _seedGrid) {
+      for (size_t cell = nCells; cell > 0; cell--) {
+        gc.start[cell] = gc.start[cell - 1];
+      }
+      gc.start[0] = 0;
+    }
+  }
+
+  //-----------------------------------------------------------------------------
+  // collect in _seedCandidates, in _tcHits order, the hits in the grid cells that overlap the
+  // annulus around the circle within which each class of hits can be added to a seed circle
+  //-----------------------------------------------------------------------------
+  void AgnosticHelixFinderAlg::findSeedGridCandidates(float xC, float yC, float rC) {
+
+    _seedCandidates.clear();
+    for (const auto& gc : _seedGrid) {
+      if (gc.hits.empty()) {
+        continue;
+      }
+      float rOut = rC + gc.maxDist + 1.0; // 1 mm margin for rounding
+      float rIn = std::max(rC - gc.maxDist - 1.0, 0.0);
+      int iyMin = std::max(static_cast<int>(std::floor((yC - rOut - _seedGridY0) / _seedGridCell)), 0);
+      int iyMax = std::min(static_cast<int>(std::floor((yC + rOut - _seedGridY0) / _seedGridCell)), _seedGridNy - 1);
+      for (int iy = iyMin; iy <= iyMax; iy++) {
+        // range of |x-xC| covered by the annulus within this row of cells
+        float dyLow = _seedGridY0 + iy * _seedGridCell - yC;
+        float dyHigh = dyLow + _seedGridCell;
+        float dyMin = (dyLow <= 0.0 && dyHigh >= 0.0) ? 0.0 : std::min(std::abs(dyLow), std::abs(dyHigh));
+        float dyMax = std::max(std::abs(dyLow), std::abs(dyHigh));
+        if (dyMin > rOut) {
+          continue;
+        }
+        float dxOut = std::sqrt(rOut * rOut - dyMin * dyMin);
+        float dxIn = dyMax < rIn ? std::sqrt(rIn * rIn - dyMax * dyMax) : 0.0;
+        int ixLeftMin = static_cast<int>(std::floor((xC - dxOut - _seedGridX0) / _seedGridCell));
+        int ixLeftMax = static_cast<int>(std::floor((xC - dxIn - _seedGridX0) / _seedGridCell));
+        int ixRightMin = static_cast<int>(std::floor((xC + dxIn - _seedGridX0) / _seedGridCell));
+        int ixRightMax = static_cast<int>(std::floor((xC + dxOut - _seedGridX0) / _seedGridCell));
+        if (ixLeftMax >= ixRightMin - 1) { // the two sides touch: one range
+          ixLeftMax = ixRightMax;
+          ixRightMin = ixRightMax + 1;
+        }
+        int ranges[2][2] = {{ixLeftMin, ixLeftMax}, {ixRightMin, ixRightMax}};
+        for (auto& range : ranges) {
+          int ixMin = std::max(range[0], 0);
+          int ixMax = std::min(range[1], _seedGridNx - 1);
+          if (ixMin > ixMax) {
+            continue;
+          }
+          size_t first = gc.start[iy * _seedGridNx + ixMin];
+          size_t last = gc.start[iy * _seedGridNx + ixMax + 1];
+          _seedCandidates.insert(_seedCandidates.end(), gc.hits.begin() + first, gc.hits.begin() + last);
+        }
+      }
+    }
+    std::sort(_seedCandidates.begin(), _seedCandidates.end());
   }
 
   //-----------------------------------------------------------------------------
   // logic for setting certain flags on hits
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::setFlags() {
+  void AgnosticHelixFinderAlg::setFlags() {
 
     // do isolation and average flagging
     if (_doIsolationFlag == true || _doAverageFlag == true) {
@@ -835,7 +1048,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // logic for setting certain flags on hits
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::resetFlags() {
+  void AgnosticHelixFinderAlg::resetFlags() {
 
     // first flag hits that are isolated
     for (size_t i = 0; i < _tcHits.size(); i++) {
@@ -852,7 +1065,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // logic to find helix
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::findHelix(size_t tc, HelixSeedCollection& HSColl, bool& findAnotherHelix) {
+  void AgnosticHelixFinderAlg::findHelix(size_t tc, HelixSeedCollection& HSColl, bool& findAnotherHelix) {
 
     // if in runDisplay mode we store collections for plotting
     _circleFitter.clear();
@@ -930,7 +1143,21 @@ namespace mu2e {
           if (loopCondition == CONTINUE) {
             continue;
           }
-          initSeedCircle(loopCondition);
+          if (_diagLevel == 1) {
+            auto seedStartTime = std::chrono::high_resolution_clock::now();
+            if (_seedEngine == GRID) {
+              initSeedCircleGrid(loopCondition);
+            } else {
+              initSeedCircle(loopCondition);
+            }
+            auto seedEndTime = std::chrono::high_resolution_clock::now();
+            _diagInfo.seedTime += std::chrono::duration<float, std::milli>(seedEndTime - seedStartTime).count();
+            _diagInfo.nSeedCircles++;
+          } else if (_seedEngine == GRID) {
+            initSeedCircleGrid(loopCondition);
+          } else {
+            initSeedCircle(loopCondition);
+          }
           if (loopCondition == CONTINUE) {
             if (_debug == 1 && _runDisplay == 1) { // stage 2 info (seed circle + helix phi)
               initHelixPhi();
@@ -1028,17 +1255,18 @@ namespace mu2e {
           int nComboHitsInHelix = 0;
           int nStrawHitsInTimeCluster = 0;
           int nComboHitsInTimeCluster = 0;
+          const uint16_t* chNStrawHits = _chSoA->nStrawHits();
           for (size_t q = 0; q < _tcHits.size(); q++) {
             if (_tcHits[q].inHelix == true || _tcHits[q].hitIndice < 0) {
               continue;
             }
             int hitIndice = _tcHits[q].hitIndice;
-            nStrawHitsInTimeCluster = nStrawHitsInTimeCluster + _chColl->at(hitIndice).nStrawHits();
+            nStrawHitsInTimeCluster = nStrawHitsInTimeCluster + chNStrawHits[hitIndice];
             nComboHitsInTimeCluster = nComboHitsInTimeCluster + 1;
             if (_tcHits[q].used == false) {
               continue;
             }
-            nStrawHitsInHelix = nStrawHitsInHelix + _chColl->at(hitIndice).nStrawHits();
+            nStrawHitsInHelix = nStrawHitsInHelix + chNStrawHits[hitIndice];
             nComboHitsInHelix = nComboHitsInHelix + 1;
           }
           if (nStrawHitsInHelix >= _minNHelixStrawHits && nComboHitsInHelix >= _minNHelixComboHits) {
@@ -1084,7 +1312,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // check flags to see if point is good for triplet-ing with
   //-----------------------------------------------------------------------------
-  bool AgnosticHelixFinder::passesFlags(size_t& tcHitsIndex) {
+  bool AgnosticHelixFinderAlg::passesFlags(size_t& tcHitsIndex) {
 
     if (_tcHits[tcHitsIndex].inHelix == true) {
       return false;
@@ -1105,7 +1333,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // set ith point of triplet, return outcome value which can be used to direct for loops
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::setTripletI(size_t& tcHitsIndex, triplet& trip, LoopCondition& outcome) {
+  void AgnosticHelixFinderAlg::setTripletI(size_t& tcHitsIndex, triplet& trip, LoopCondition& outcome) {
 
     // set info for point
     trip.i.pos = getPos(tcHitsIndex);
@@ -1135,7 +1363,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // set jth point of triplet, return outcome value which can be used to direct for loops
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::setTripletJ(size_t& tcHitsIndex, triplet& trip, LoopCondition& outcome) {
+  void AgnosticHelixFinderAlg::setTripletJ(size_t& tcHitsIndex, triplet& trip, LoopCondition& outcome) {
 
     // set info for point
     trip.j.pos = getPos(tcHitsIndex);
@@ -1167,7 +1395,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // set kth point of triplet, return outcome value which can be used to direct for loops
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::setTripletK(size_t& tcHitsIndex, triplet& trip, LoopCondition& outcome) {
+  void AgnosticHelixFinderAlg::setTripletK(size_t& tcHitsIndex, triplet& trip, LoopCondition& outcome) {
 
     // set info for point
     trip.k.pos = getPos(tcHitsIndex);
@@ -1194,7 +1422,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // finding circle from triplet
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::initTriplet(triplet& trip, LoopCondition& outcome) {
+  void AgnosticHelixFinderAlg::initTriplet(triplet& trip, LoopCondition& outcome) {
 
     _circleFitter.addPoint(trip.i.pos.x(), trip.i.pos.y());
     _circleFitter.addPoint(trip.j.pos.x(), trip.j.pos.y());
@@ -1213,7 +1441,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // start with initial seed circle
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::initSeedCircle(LoopCondition& outcome) {
+  void AgnosticHelixFinderAlg::initSeedCircle(LoopCondition& outcome) {
 
     // get triplet circle parameters then clear fitter
     float xC = _circleFitter.x0();
@@ -1249,10 +1477,69 @@ namespace mu2e {
     }
   }
 
+  //-----------------------------------------------------------------------------
+  // same as initSeedCircle, but only the hits in the grid cells near the triplet circle are
+  // looked at.  They are added to the fitter in the same order, so the seed is the same.  The
+  // used flags and circle errors of the other hits are only read once the seed is good (or when
+  // plotting), so they are only updated then.
+  //-----------------------------------------------------------------------------
+  void AgnosticHelixFinderAlg::initSeedCircleGrid(LoopCondition& outcome) {
+
+    // get triplet circle parameters then clear fitter
+    float xC = _circleFitter.x0();
+    float yC = _circleFitter.y0();
+    float rC = _circleFitter.radius();
+    _circleFitter.clear();
+
+    float maxResidual2 = _maxSeedCircleResidual * _maxSeedCircleResidual;
+    findSeedGridCandidates(xC, yC, rC);
+    _seedCircleHits.clear();
+    for (size_t i : _seedCandidates) {
+      if (_tcHits[i].inHelix == true) {
+        continue;
+      }
+      const seedHit& sh = _seedHits[i];
+      float dx = sh.pos.x() - xC;
+      float dy = sh.pos.y() - yC;
+      float dr = rC - std::sqrt(dx * dx + dy * dy);
+      if (dr * dr > maxResidual2 * sh.maxCircleError2) {
+        continue;
+      }
+      computeCircleError2(i, xC, yC);
+      if (computeCircleResidual2(i, xC, yC, rC) < maxResidual2) {
+        float wP = 1.0 / (_tcHits[i].circleError2);
+        _circleFitter.addPoint(sh.pos.x(), sh.pos.y(), wP);
+        _seedCircleHits.push_back(i);
+      }
+    }
+
+    // check if there are enough hits to continue with search
+    if (_circleFitter.qn() < _minSeedCircleHits) {
+      outcome = CONTINUE;
+    } else {
+      outcome = GOOD;
+    }
+
+    if (outcome == GOOD || (_debug == 1 && _runDisplay == 1)) {
+      for (size_t i = 0; i < _tcHits.size(); i++) {
+        if (_tcHits[i].inHelix == true) {
+          continue;
+        }
+        _tcHits[i].used = false;
+        if (_tcHits[i].hitIndice != HitType::STOPPINGTARGET) {
+          computeCircleError2(i, xC, yC);
+        }
+      }
+      for (size_t i : _seedCircleHits) {
+        _tcHits[i].used = true;
+      }
+    }
+  }
+
   //-----------------------------------------------------------------------------
   // function to initialize phi info relative to helix center in _tcHits
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::initHelixPhi() {
+  void AgnosticHelixFinderAlg::initHelixPhi() {
 
     float xC = _circleFitter.x0();
     float yC = _circleFitter.y0();
@@ -1270,7 +1557,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // function to find seed phi lines
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::findSeedPhiLines() {
+  void AgnosticHelixFinderAlg::findSeedPhiLines() {
 
     _seedPhiLines.clear();
     lineSegmentInfo lsInfo;
@@ -1408,7 +1695,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // function to resolve 2 Pi Ambiguities for each seed phi line found
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::resolve2PiAmbiguities() {
+  void AgnosticHelixFinderAlg::resolve2PiAmbiguities() {
 
     for (size_t i = 0; i < _seedPhiLines.size(); i++) {
       float lineSlope = _seedPhiLines[i].fitter.dydx();
@@ -1459,7 +1746,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // function for refining the phi line that was found
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::refinePhiLine(size_t lineIndex, bool& removals) {
+  void AgnosticHelixFinderAlg::refinePhiLine(size_t lineIndex, bool& removals) {
 
     float largestResidual2 = 0.0;
     size_t rmIndex = 0;
@@ -1500,7 +1787,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // initialize final circle / line seed prior to hit recovery
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::initFinalSeed() {
+  void AgnosticHelixFinderAlg::initFinalSeed() {
 
     // first find best phi line
     size_t bestLineIndex = 0;
@@ -1554,7 +1841,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // recover points
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::recoverPoints(bool& recoveries) {
+  void AgnosticHelixFinderAlg::recoverPoints(bool& recoveries) {
 
     float xC = _circleFitter.x0();
     float yC = _circleFitter.y0();
@@ -1643,7 +1930,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // function to make copies of relevant info for helix candidate
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::saveHelixCandidate() {
+  void AgnosticHelixFinderAlg::saveHelixCandidate() {
 
     helixCandidate hel;
     hel.tcHitsCopy = _tcHits;
@@ -1656,7 +1943,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // function to save helix
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::saveHelix(size_t tc, HelixSeedCollection& HSColl) {
+  void AgnosticHelixFinderAlg::saveHelix(size_t tc, HelixSeedCollection& HSColl) {
 
     size_t bestIndex = 0;
     _tcHits = _helixCandidates[bestIndex].tcHitsCopy;
@@ -1726,7 +2013,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // calling logic that needs to be called to run debug mode
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::initDebugMode() {
+  void AgnosticHelixFinderAlg::initDebugMode() {
 
     // first find the TC we want to focus on
     findBestTC();
@@ -1775,7 +2062,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // function to find the best time cluster in debug mode given particle of interest (set in fcl)
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::findBestTC() {
+  void AgnosticHelixFinderAlg::findBestTC() {
 
     _simIDsPerTC.clear();
 
@@ -1898,7 +2185,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // find the best index in _plottingData to plot (the search that went furthest)
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::findBestPlotIndex() {
+  void AgnosticHelixFinderAlg::findBestPlotIndex() {
 
     bool helixFound = false;
     int mostHits = 0;
@@ -1931,7 +2218,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // function to make all the plots in debug mode when runDisplay is on
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::doAllPlots() {
+  void AgnosticHelixFinderAlg::doAllPlots() {
 
     findBestPlotIndex();
     _xy0->Clear();
@@ -1971,7 +2258,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // function to plot XY view at various stages of logic
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::plotXY(int stage) {
+  void AgnosticHelixFinderAlg::plotXY(int stage) {
 
     if (stage == 0) {
       _xy0->cd();
@@ -2155,7 +2442,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // function to plot phi-z view relative to circle center at various stages of logic
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::plotPhiZ(int stage) {
+  void AgnosticHelixFinderAlg::plotPhiZ(int stage) {
 
     if (stage == 2) {
       _phiz2->cd();
@@ -2332,7 +2619,7 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // function to plot phi-z segment that leads to best candidate line
   //-----------------------------------------------------------------------------
-  void AgnosticHelixFinder::plotSegment(int option) {
+  void AgnosticHelixFinderAlg::plotSegment(int option) {
 
     lineInfo line;
 
@@ -2446,6 +2733,74 @@ namespace mu2e {
     phiZFit->Draw("same");
   }
 
+  //-----------------------------------------------------------------------------
+  // the module: a pool of helix finders, one per event being processed
+  //-----------------------------------------------------------------------------
+  class AgnosticHelixFinder : public art::SharedProducer {
+
+  public:
+    using Config = AgnosticHelixFinderAlg::Config;
+    using Parameters = art::SharedProducer::Table<Config>;
+
+    explicit AgnosticHelixFinder(const Parameters& config, const art::ProcessingFrame&);
+
+    void beginJob  (const art::ProcessingFrame&) override;
+    void beginRun  (art::Run&, const art::ProcessingFrame&) override;
+    void produce   (art::Event& e, const art::ProcessingFrame&) override;
+    void endJob    (const art::ProcessingFrame&) override;
+
+  private:
+    fhicl::ParameterSet                  _pset;       // to configure the finders made on demand
+    bool                                 _runStarted;
+    ObjectPool<AgnosticHelixFinderAlg>   _finders;
+  };
+
+  AgnosticHelixFinder::AgnosticHelixFinder(const Parameters& config, const art::ProcessingFrame&) :
+    art::SharedProducer{config},
+    _pset(config.get_PSet()),
+    _runStarted(false),
+    _finders([this]() {
+      auto finder = std::make_unique<AgnosticHelixFinderAlg>(Parameters(_pset));
+      if (_runStarted) finder->beginRun();
+      return finder;
+    })
+  {
+    consumes<ComboHitCollection>     (config().chCollLabel());
+    mayConsume<ComboHitSoAView>      (config().chCollLabel());
+    consumes<TimeClusterCollection>  (config().tcCollLabel());
+    consumes<CaloClusterCollection>  (config().ccCollLabel());
+    produces<HelixSeedCollection>    ();
+
+    // make the first finder now, so it books the diagnostic histograms in beginJob
+    _finders.get();
+
+    // the diagnostic tool, the MC matching and the display keep job-wide state:
+    // process one event at a time when any of them is on
+    if (config().diagLevel() != 0 || config().debug() != 0 || config().runDisplay() != 0) {
+      serialize<art::InEvent>(art::TFileService::resource_name());
+    } else {
+      async<art::InEvent>();
+    }
+  }
+
+  void AgnosticHelixFinder::beginJob(const art::ProcessingFrame&) {
+    _finders.forEach([](AgnosticHelixFinderAlg& finder) { finder.beginJob(); });
+  }
+
+  void AgnosticHelixFinder::beginRun(art::Run&, const art::ProcessingFrame&) {
+    _runStarted = true;
+    _finders.forEach([](AgnosticHelixFinderAlg& finder) { finder.beginRun(); });
+  }
+
+  void AgnosticHelixFinder::produce(art::Event& event, const art::ProcessingFrame&) {
+    auto finder = _finders.get();
+    finder->produce(event);
+  }
+
+  void AgnosticHelixFinder::endJob(const art::ProcessingFrame&) {
+    _finders.forEach([](AgnosticHelixFinderAlg& finder) { finder.endJob(); });
+  }
+
 } // namespace mu2e
 
 using mu2e::AgnosticHelixFinder;
@@ -21,6 +21,7 @@
 #include "Offline/CalorimeterGeom/inc/DiskCalorimeter.hh"
 // data
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitSoAView.hh"
 #include "Offline/RecoDataProducts/inc/StrawHit.hh"
 #include "Offline/RecoDataProducts/inc/StrawHitPosition.hh"
 #include "Offline/RecoDataProducts/inc/StereoHit.hh"
@@ -105,6 +106,7 @@ namespace mu2e {
     consumes<StrawDigiMCCollection> (_sdmcCollTag);
 
     produces<ComboHitCollection>();
+    produces<ComboHitSoAView>();
     produces<StrawHitFlagCollection>();
   }
 
@@ -173,6 +175,7 @@ namespace mu2e {
 //-----------------------------------------------------------------------------
 // finally, put the output flag collection into the event
 //-----------------------------------------------------------------------------
+    Event.put(std::make_unique<ComboHitSoAView>(*new_chColl));
     Event.put(std::move(new_chColl ));
     Event.put(std::move(new_chfColl));
 //-----------------------------------------------------------------------------
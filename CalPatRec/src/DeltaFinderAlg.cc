@@ -234,19 +234,18 @@ namespace mu2e {
       float  x1  = hd1->fX;
       float  y1  = hd1->fY;
 
-      const ComboHit* ch1 = hd1->fHit;
       int   seed_found    = 0;
 //-----------------------------------------------------------------------------
 // panels 0,2,4 are panels 0,1,2 in the first  (#0) face of a plane
 // panels 1,3,5 are panels 0,1,2 in the second (#1) face
 //-----------------------------------------------------------------------------
-      int    ip1 = ch1->strawId().panel() / 2;
+      int    ip1 = hd1->fPanel;
       Pzz_t* pz1 = fz1->Panel(ip1);
 //-----------------------------------------------------------------------------
 // figure out the first and the last timing bins to loop over
 // loop over 3 bins (out of > 20) - the rest cant contain hits of interest
 //-----------------------------------------------------------------------------
-      float  t1       = ch1->time();
+      float  t1       = hd1->fTime;
       int    time_bin = (int) t1/_timeBin;
 
       int    first_tbin(0), last_tbin(_maxT/_timeBin), max_bin(_maxT/_timeBin);
@@ -273,8 +272,7 @@ namespace mu2e {
         for (int h2=first; h2<=last; h2++) {
           HitData_t*      hd2 = &fz2->fHitData[h2];
           if (hd2->Used() >= 3)                                       continue;
-          const ComboHit* ch2 = hd2->fHit;
-          float t2 = ch2->time();
+          float t2 = hd2->fTime;
           float dt = t2-t1;
 
           if (dt < -_maxDriftTime)                                    continue;
@@ -290,7 +288,7 @@ namespace mu2e {
 // 'ip2' - panel index within its face
 // check overlap in phi between the panels coresponding to the wires - 120 deg
 //-----------------------------------------------------------------------------
-          int    ip2  = ch2->strawId().panel() / 2;
+          int    ip2  = hd2->fPanel;
           Pzz_t* pz2  = fz2->Panel(ip2);
           float  n1n2 = pz1->nx*pz2->nx+pz1->ny*pz2->ny;
           if (n1n2 < -0.5)                                            continue;
@@ -630,31 +628,37 @@ namespace mu2e {
   int DeltaFinderAlg::orderHits() {
     ChannelID cx, co;
 //-----------------------------------------------------------------------------
-// vector of pointers to CH, ordered in time. Initial list is not touched
+// vector of CH indices, ordered in time. Initial list is not touched
+// times, flags and panels are read from the structure-of-arrays view of the hits
 //-----------------------------------------------------------------------------
+    const ComboHitSoAView& chv   = *_data->chsoa;
+    const float*           time  = chv.time();
+    const StrawHitFlag*    flags = chv.flag();
+    const uint16_t*        upanel= chv.uniquePanel();
+
     _data->_v.resize(_data->_nComboHits);
 
     for (int i=0; i<_data->_nComboHits; i++) {
-      _data->_v[i] = &(*_data->chcol)[i];
+      _data->_v[i] = i;
     }
 
     std::sort(_data->_v.begin(), _data->_v.end(),
-              [](const ComboHit*& a, const ComboHit*& b) { return a->time() < b->time(); });
+              [time](int a, int b) { return time[a] < time[b]; });
 //-----------------------------------------------------------------------------
 // at this point hits in '_v' are already ordered in time
 //-----------------------------------------------------------------------------
     for (int ih=0; ih<_data->_nComboHits; ih++) {
-      const ComboHit* ch = _data->_v[ih];
+      int ich = _data->_v[ih];
 
-      const StrawHitFlag* flag   = &ch->flag();
+      const StrawHitFlag* flag   = &flags[ich];
       if (_testHitMask && (! flag->hasAllProperties(_goodHitMask) || flag->hasAnyProperty(_bkgHitMask)) ) continue;
 
-      // float corr_time    = ch->correctedTime();
+      int plane                  = upanel[ich] / StrawId::_npanels;
 
-      cx.Station                 = ch->strawId().station();
-      cx.Plane                   = ch->strawId().plane() % 2;
+      cx.Station                 = plane / 2;
+      cx.Plane                   = plane % 2;
       cx.Face                    = -1;
-      cx.Panel                   = ch->strawId().panel();
+      cx.Panel                   = upanel[ich] % StrawId::_npanels;
 //-----------------------------------------------------------------------------
 // get Z-ordered location
 //-----------------------------------------------------------------------------
@@ -678,15 +682,15 @@ namespace mu2e {
       FaceZ_t* fz  = &_data->fFaceData[os][of];
       int      loc = fz->fHitData.size();
 
-      fz->fHitData.push_back(HitData_t(ch,of));
-      int time_bin = int (ch->time()/_timeBin);
+      fz->fHitData.push_back(HitData_t(&(*_data->chcol)[ich],chv,ich,of));
+      int time_bin = int (time[ich]/_timeBin);
 
       if (time_bin < kMaxNTimeBins) {
         if (fz->fFirst[time_bin] < 0) fz->fFirst[time_bin] = loc;
         fz->fLast[time_bin] = loc;
       }
       else {
-        printf("ERROR in DeltaFinderAlg::orderHits : hist time = %10.3f time_bin=%i TOO LARGE, ignored\n",ch->time(),time_bin);
+        printf("ERROR in DeltaFinderAlg::orderHits : hist time = %10.3f time_bin=%i TOO LARGE, ignored\n",time[ich],time_bin);
       }
     }
 
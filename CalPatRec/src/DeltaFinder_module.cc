@@ -34,6 +34,7 @@
 
 // data
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitSoAView.hh"
 #include "Offline/RecoDataProducts/inc/StrawHit.hh"
 #include "Offline/RecoDataProducts/inc/StrawHitPosition.hh"
 #include "Offline/RecoDataProducts/inc/StereoHit.hh"
@@ -147,11 +148,16 @@ namespace mu2e {
   {
 
     consumesMany<ComboHitCollection>(); // ??? Necessary because fillStrawHitIndices calls getManyByType.
+    mayConsume<ComboHitSoAView>(_chCollTag);
 
     produces<IntensityInfoTimeCluster>();
 
     produces<ComboHitCollection>("");
-    if (_writeStrawHits         == 1) produces<ComboHitCollection>("StrawHits");
+    produces<ComboHitSoAView>("");
+    if (_writeStrawHits         == 1) {
+      produces<ComboHitCollection>("StrawHits");
+      produces<ComboHitSoAView>("StrawHits");
+    }
 
                                         // this is a list of delta-electron candidates (or proton ones ?)
     produces<TimeClusterCollection>();
@@ -204,6 +210,9 @@ namespace mu2e {
     auto chcH   = Evt.getValidHandle<mu2e::ComboHitCollection>(_chCollTag);
     _data.chcol = chcH.product();
 
+    auto chsoaH = Evt.getHandle<mu2e::ComboHitSoAView>(_chCollTag);
+    _data.chsoa = &ComboHitSoAView::get(chsoaH.isValid() ? chsoaH.product() : nullptr, *_data.chcol, _data.chsoaLocal);
+
     auto sschcH = Evt.getValidHandle<mu2e::ComboHitCollection>(_sschCollTag);
     _sschColl   = sschcH.product();
 
@@ -406,8 +415,12 @@ namespace mu2e {
 // moving in the end, after diagnostics plugin routines have been called - move
 // invalidates the original pointer...
 //-----------------------------------------------------------------------------
+    Event.put(std::make_unique<ComboHitSoAView>(*outputChColl));
     Event.put(std::move(outputChColl));
-    if (_writeStrawHits == 1) Event.put(std::move(outputSschColl),"StrawHits");
+    if (_writeStrawHits == 1) {
+      Event.put(std::make_unique<ComboHitSoAView>(*outputSschColl),"StrawHits");
+      Event.put(std::move(outputSschColl),"StrawHits");
+    }
 
     Event.put(std::move(tcColl));
     Event.put(std::move(ppii));
@@ -3,6 +3,9 @@
 // Individual photo-electrons are generated for each readout, including photo-statistic fluctuations
 // Simulate digitization procedure and produce CaloDigis.
 //
+// The CaloShowerROs are first bucketed by readout, and the PE times of a readout are histogrammed
+// in fine time bins, so the pulse shape is added once per filled bin rather than once per PE.
+//
 //
 #include "art/Framework/Core/EDProducer.h"
 #include "art/Framework/Principal/Event.h"
@@ -39,8 +42,10 @@
 #include "TStyle.h"
 #include "TGraph.h"
 
+#include <algorithm>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 #include <numeric>
 
@@ -107,6 +112,7 @@ namespace mu2e {
     private:
 
        void makeDigitization  (const CaloShowerROCollection&, CaloDigiCollection&, const EventWindowMarker&, const ProtonBunchTimeMC&);
+       void bucketShowerROs   (const CaloShowerROCollection&, unsigned nWaveforms);
        bool fillROHits        (unsigned iRO, std::vector<double>& waveform, const CaloShowerROCollection&,
                                const ConditionsHandle<CalorimeterCalibrations>&, const ProtonBunchTimeMC&);
        void generateSpotNoise (std::vector<double>& waveform, unsigned iRO, const ConditionsHandle<CalorimeterCalibrations>&);
@@ -134,6 +140,10 @@ namespace mu2e {
        bool                    addRandomNoise_;
        const Calorimeter*      calorimeter_;
        int                     diagLevel_;
+       std::vector<unsigned>   roStart_;   // CaloShowerROs of readout i are roIndex_[roStart_[i]..roStart_[i+1]]
+       std::vector<unsigned>   roIndex_;
+       std::vector<int>        peBins_;    // fine time bins of the PEs of one readout
+       std::vector<std::pair<int,double>> fineHits_;
   };
 
 
@@ -197,9 +207,12 @@ namespace mu2e {
       if (waveformSize<1) throw cet::exception("Rethrow")<< "[CaloMC/CaloDigiMaker] digitization size too short " << std::endl;
       bool resetWaveform(false);
       std::vector<double> waveform(waveformSize,0.0);
+      bucketShowerROs(CaloShowerROs, nWaveforms);
 
       for (int iRO=0;iRO<nWaveforms;++iRO)
       {
+          // without random noise, readouts with no signal are skipped entirely
+          if (!addRandomNoise_ && roStart_[iRO]==roStart_[iRO+1]) continue;
           if (resetWaveform) std::fill(waveform.begin(), waveform.end(), 0.0);
           bool isEmpty = fillROHits(iRO, waveform, CaloShowerROs, calorimeterCalibrations, pbtmc);
           resetWaveform = (addRandomNoise_ || !isEmpty);
@@ -220,32 +233,61 @@ namespace mu2e {
   }
 
 
+  //--------------------------------------------------------------------------
+  // counting sort of the CaloShowerROs by readout, keeping their order within a readout
+  void CaloDigiMaker::bucketShowerROs(const CaloShowerROCollection& CaloShowerROs, unsigned nWaveforms)
+  {
+      roStart_.assign(nWaveforms+1,0);
+      for (const auto& CaloShowerRO : CaloShowerROs)
+      {
+          unsigned SiPMID = CaloShowerRO.SiPMID();
+          if (SiPMID < nWaveforms) ++roStart_[SiPMID+1];
+      }
+      std::partial_sum(roStart_.begin(), roStart_.end(), roStart_.begin());
+
+      roIndex_.resize(roStart_.back());
+      std::vector<unsigned> next(roStart_.begin(), roStart_.end()-1);
+      for (unsigned i=0;i<CaloShowerROs.size();++i)
+      {
+          unsigned SiPMID = CaloShowerROs[i].SiPMID();
+          if (SiPMID < nWaveforms) roIndex_[next[SiPMID]++] = i;
+      }
+  }
+
+
   //--------------------------------------------------------------------------
   bool CaloDigiMaker::fillROHits(unsigned iRO, std::vector<double>& waveform, const CaloShowerROCollection& CaloShowerROs,
                                  const ConditionsHandle<CalorimeterCalibrations>& calorimeterCalibrations, const ProtonBunchTimeMC& pbtmc)
   {
-      bool  isEmpty(true);
+      if (roStart_[iRO]==roStart_[iRO+1]) return true;
       float scaleFactor = calorimeterCalibrations->MeV2ADC(iRO)/calorimeterCalibrations->peMeV(iRO);
 
-      for (const auto& CaloShowerRO : CaloShowerROs)
+      peBins_.clear();
+      for (unsigned i=roStart_[iRO];i<roStart_[iRO+1];++i)
       {
-          unsigned SiPMID = CaloShowerRO.SiPMID();
-          if (SiPMID != iRO) continue;
-
-          isEmpty = false;
-          for (const auto PEtime : CaloShowerRO.PETime())
+          for (const auto PEtime : CaloShowerROs[roIndex_[i]].PETime())
           {
               //PE time is given in DR frame, we need to subtract the event window start and the digi Start time
-              float       time           = PEtime + pbtmc.pbtime_- digitizationStart_ + timeFromProtonsToDRMarker_ + startTimeBuffer_;
-              unsigned    startSample    = std::max(0u,unsigned(time/digiSampling_));
-              const auto& pulse          = pulseShape_.digitizedPulse(time);
-              unsigned    stopSample     = std::min(startSample+pulse.size(), waveform.size());
-
-              for (size_t timeSample = startSample; timeSample < stopSample; ++timeSample)
-                 waveform.at(timeSample) += pulse.at(timeSample - startSample)*scaleFactor;
+              float time = PEtime + pbtmc.pbtime_- digitizationStart_ + timeFromProtonsToDRMarker_ + startTimeBuffer_;
+              int fbin = pulseShape_.fineBin(time);
+              if (fbin < 0) continue; // before the start of the waveform
+              peBins_.push_back(fbin);
           }
       }
-      return isEmpty;
+
+      // PEs in the same fine time bin have the same digitized pulse, add it once with their number as weight
+      std::sort(peBins_.begin(),peBins_.end());
+      fineHits_.clear();
+      for (size_t i=0;i<peBins_.size();)
+      {
+          size_t j(i+1);
+          while (j<peBins_.size() && peBins_[j]==peBins_[i]) ++j;
+          fineHits_.emplace_back(peBins_[i],(j-i)*scaleFactor);
+          i = j;
+      }
+      pulseShape_.addPulses(waveform, fineHits_);
+
+      return false;
   }
 
 
@@ -6,7 +6,8 @@
 // Each peak in the waveform is described by two parameters: amplitide and peak time
 // For a single peak, the amplitude can be found analytically for a given start time, and a
 // quasi-Netwon method can be used to fit the waveform.
-// If there are more than one peak, we use a generic gradient descent method, namely minuit.
+// If there are more than one peak, we use a generic gradient descent method, namely minuit, or
+// a Levenberg-Marquardt fit with the analytic derivatives of the template (fitter LevenbergMarquardt).
 //
 // There is an additional option to refit the leding edge of the first peak to improve
 // timing accuracy
@@ -47,7 +48,8 @@ namespace mu2e {
         };
 
 
-        CaloTemplateWFProcessor(const Config& config);
+        CaloTemplateWFProcessor(const Config& config,
+                                CaloTemplateWFUtil::fitterType fitter = CaloTemplateWFUtil::Minuit);
 
         virtual void     initialize  () override;
         virtual void     reset       () override;
@@ -89,6 +91,8 @@ namespace mu2e {
        std::vector<double> resAmpErr_;
        std::vector<double> resTime_;
        std::vector<double> resTimeErr_;
+       std::vector<double> yvec_;   // work buffers for the peak search, kept between waveforms
+       std::vector<double> ywork_;
 
        TH1F* _hTime;
        TH1F* _hTimeErr;
@@ -11,7 +11,11 @@ namespace mu2e {
   class CaloTemplateWFUtil  {
 
      public:
-        CaloTemplateWFUtil(double minPeakAmplitude, double digiSampling, double minDTPeaks, int printLevel=-1);
+        // the minimization engine: TMinuit, or a Levenberg-Marquardt fit with analytic template derivatives
+        enum fitterType {Minuit, LevenbergMarquardt};
+
+        CaloTemplateWFUtil(double minPeakAmplitude, double digiSampling, double minDTPeaks, int printLevel=-1,
+                           fitterType fitter=Minuit);
 
         void                        initialize    ();
         void                        setXYVector   (const std::vector<double>& xvec, const std::vector<double>& yvec);
@@ -32,6 +36,7 @@ namespace mu2e {
         void                        setPrintLevel (int val) {printLevel_  = val;}
         void                        setFitStartegy(int val) {fitStrategy_ = val;}
         void                        setDiagLevel  (int val) {diagLevel_   = val;}
+        void                        setFitter     (fitterType val) {fitter_ = val;}
 
         unsigned                    status        ()                const {return status_;}
         double                      chi2          ()                const {return chi2_;}
@@ -46,8 +51,10 @@ namespace mu2e {
 
      private:
         bool                selectComponent(const std::vector<double>& tempPar, const std::vector<double>& tempErr, unsigned ip);
+        void                fitLM          ();
 
         CaloPulseShape      pulseCache_;
+        fitterType          fitter_;
         double              minPeakAmplitude_;
         double              minDTPeaks_;
         int                 fitStrategy_;
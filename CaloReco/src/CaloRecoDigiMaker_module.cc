@@ -27,7 +27,7 @@ namespace mu2e {
   class CaloRecoDigiMaker : public art::EDProducer
   {
      public:
-        enum processorStrategy {NoChoice, RawExtract, Template};
+        enum processorStrategy {NoChoice, RawExtract, Template, TemplateLM};
 
         struct Config
         {
@@ -37,7 +37,7 @@ namespace mu2e {
            fhicl::Table<mu2e::CaloTemplateWFProcessor::Config> proc_templ_conf     { Name("TemplateProcessor"),   Comment("Log normal fit processor config") };
            fhicl::Atom<art::InputTag>                          caloDigiCollection  { Name("caloDigiCollection"),  Comment("Calo Digi module label") };
            fhicl::Atom<art::InputTag>                          pbttoken            { Name("ProtonBunchTimeTag"),  Comment("ProtonBunchTime producer")};
-           fhicl::Atom<std::string>                            processorStrategy   { Name("processorStrategy"),   Comment("Digi reco processor name") };
+           fhicl::Atom<std::string>                            processorStrategy   { Name("processorStrategy"),   Comment("Digi reco processor name: RawExtract, TemplateFit (Minuit) or TemplateFitLM (Levenberg-Marquardt)") };
            fhicl::Atom<double>                                 digiSampling        { Name("digiSampling"),        Comment("Calo ADC sampling time (ns)") };
            fhicl::Atom<double>                                 maxChi2Cut          { Name("maxChi2Cut"),          Comment("Chi2 cut for keeping reco digi") };
            fhicl::Atom<int>                                    maxPlots            { Name("maxPlots"),            Comment("Maximum number of waveform plots") };
@@ -59,6 +59,7 @@ namespace mu2e {
             std::map<std::string, processorStrategy> spmap;
             spmap["RawExtract"]  = RawExtract;
             spmap["TemplateFit"] = Template;
+            spmap["TemplateFitLM"] = TemplateLM;
 
             switch (spmap[processorStrategy_])
             {
@@ -72,6 +73,11 @@ namespace mu2e {
                     waveformProcessor_ = std::make_unique<CaloTemplateWFProcessor>(config().proc_templ_conf());
                     break;
                 }
+                case TemplateLM:
+                {
+                    waveformProcessor_ = std::make_unique<CaloTemplateWFProcessor>(config().proc_templ_conf(), CaloTemplateWFUtil::LevenbergMarquardt);
+                    break;
+                }
                 default:
                 {
                     throw cet::exception("CATEGORY")<< "Unrecognized processor in CaloHitsFromDigis module";
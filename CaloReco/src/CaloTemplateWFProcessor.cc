@@ -15,7 +15,7 @@
 
 namespace mu2e {
 
-   CaloTemplateWFProcessor::CaloTemplateWFProcessor(const Config& config) :
+   CaloTemplateWFProcessor::CaloTemplateWFProcessor(const Config& config, CaloTemplateWFUtil::fitterType fitter) :
       CaloWaveformProcessor(),
       windowPeak_      (config.windowPeak()),
       minPeakAmplitude_(config.minPeakAmplitude()),
@@ -25,13 +25,15 @@ namespace mu2e {
       chiThreshold_    (config.chiThreshold()),
       refitLeadingEdge_(config.refitLeadingEdge()),
       diagLevel_       (config.diagLevel()),
-      fmutil_          (minPeakAmplitude_,config.digiSampling(),minDTPeaks_,config.fitPrintLevel()),
+      fmutil_          (minPeakAmplitude_,config.digiSampling(),minDTPeaks_,config.fitPrintLevel(),fitter),
       chi2_            (999.),
       ndf_             (-1),
       resAmp_          (),
       resAmpErr_       (),
       resTime_         (),
-      resTimeErr_      ()
+      resTimeErr_      (),
+      yvec_            (),
+      ywork_           ()
    {
        if (diagLevel_ > 1) initHistos();
        if (windowPeak_ < 1) windowPeak_=1;
@@ -119,17 +121,18 @@ namespace mu2e {
    void CaloTemplateWFProcessor::setPrimaryPeakPar1(const std::vector<double>& xvec, const std::vector<double>& yvecOrig)
    {
         if (windowPeak_ > xvec.size()) return;
-        std::vector<double> parInit{},yvec(yvecOrig);
+        std::vector<double> parInit{};
 
         //estimate the noise level with the first few bins
-        if (yvec.size() <= numNoiseBins_) return;
-        float noise= std::accumulate(yvec.begin(),yvec.begin()+numNoiseBins_,0)/float(numNoiseBins_);
+        if (yvecOrig.size() <= numNoiseBins_) return;
+        float noise= std::accumulate(yvecOrig.begin(),yvecOrig.begin()+numNoiseBins_,0)/float(numNoiseBins_);
         parInit.push_back(noise);
-        for (auto& val : yvec) val -= noise;
+        std::vector<double>& ywork = ywork_;
+        ywork.assign(yvecOrig.begin(),yvecOrig.end());
+        for (auto& val : ywork) val -= noise;
 
         if (diagLevel_>1) std::cout<<"[CaloTemplateWFProcessor] Noise level "<<noise<<std::endl;
 
-        std::vector<double> ywork(yvec);
         for (auto i=windowPeak_;i+windowPeak_<xvec.size();++i)
         {
             if (std::max_element(ywork.begin()+i-windowPeak_,ywork.begin()+i+windowPeak_+1) != ywork.begin()+i) continue;
@@ -165,14 +168,17 @@ namespace mu2e {
    void CaloTemplateWFProcessor::setPrimaryPeakPar2(const std::vector<double>& xvec, const std::vector<double>& yvecOrig)
    {
         if (windowPeak_ > xvec.size()) return;
-        std::vector<double> parInit{},yvec(yvecOrig);
+        std::vector<double> parInit{};
+        std::vector<double>& yvec = yvec_;
+        yvec.assign(yvecOrig.begin(),yvecOrig.end());
 
         //estimate the noise level with the first few bins
         float noise= std::accumulate(yvec.begin(),yvec.begin()+numNoiseBins_,0)/float(numNoiseBins_);
         parInit.push_back(noise);
         for (auto& val : yvec) val -= noise;
 
-        std::vector<double> ywork(yvec);
+        std::vector<double>& ywork = ywork_;
+        ywork.assign(yvec.begin(),yvec.end());
         for (auto i=windowPeak_;i<int(xvec.size())-windowPeak_;++i)
         {
             if (std::max_element(ywork.begin()+i-windowPeak_,ywork.begin()+i+windowPeak_+1) != ywork.begin()+i) continue;
@@ -255,7 +261,8 @@ namespace mu2e {
         if (windowPeak_ > xvec.size()) return;
         if (xvec.size() != yvec.size()) throw cet::exception("CATEGORY")<<"CaloTemplateWFProcessor::setSecondaryPeakPar  xvec and yvec must have the same size";
 
-        std::vector<double> ywork(yvec);
+        std::vector<double>& ywork = ywork_;
+        ywork.assign(yvec.begin(),yvec.end());
         for (unsigned j=0;j<xvec.size();++j) ywork[j] -= fmutil_.eval_fcn(xvec[j]);
 
         std::vector<double> parInit(fmutil_.par());
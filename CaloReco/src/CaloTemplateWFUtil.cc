@@ -7,6 +7,8 @@
 #include "TCanvas.h"
 
 #include <algorithm>
+#include <array>
+#include <cmath>
 #include <vector>
 #include <sstream>
 
@@ -46,6 +48,141 @@ namespace
             if (fabs(par[0]) > 1e-5) f += (y-val)*(y-val)/par[0];
         }
     }
+
+
+    // Levenberg-Marquardt minimization of the myfcn chi2 = sum (y-f)^2/b, with analytic derivatives of the
+    // template. Only the parameters flagged in isFree are varied, and they are kept within the bounds of the
+    // Minuit fit [0,1e6]. The normal equations use fixed-size buffers. Returns true if converged, and fills
+    // chi2 and the errors sqrt(diag((J^T J)^-1)), the Minuit parabolic errors for a chi2 with UP=1
+    constexpr unsigned maxParLM = 49;
+    using LMVector = std::array<double,maxParLM>;
+    using LMMatrix = std::array<double,maxParLM*maxParLM>;
+
+    // chi2, and if jtj is given the normal equations J^T J and J^T r for the free parameters
+    double lmNormal(const double* par, const unsigned* ifree, unsigned nfree, LMMatrix* jtj, LMVector* jtr)
+    {
+        double b     = std::max(par[0],1e-5);
+        double sqrtb = std::sqrt(b);
+        if (jtj) {std::fill(jtj->begin(),jtj->begin()+nfree*maxParLM,0.0); std::fill(jtr->begin(),jtr->begin()+nfree,0.0);}
+
+        LMVector grad{};  // d(residual)/d(par) for all the parameters
+        double chi2(0);
+        for (unsigned i=x0_;i<x1_;++i)
+        {
+            double x   = xvec_[i];
+            double val = par[0];
+            for (unsigned ip=npBkg_; ip<npTot_; ip+=npFcn_)
+            {
+                double slope(0);
+                double shape = pulseCachePtr_->evaluate(x-par[ip+1],slope);
+                val         += par[ip]*shape;
+                grad[ip]     = -shape/sqrtb;
+                grad[ip+1]   = par[ip]*slope/sqrtb;
+            }
+            double r = (yvec_[i]-val)/sqrtb;
+            chi2    += r*r;
+            if (!jtj) continue;
+
+            grad[0] = -1.0/sqrtb - 0.5*r/b;
+            for (unsigned j=0;j<nfree;++j)
+            {
+                double gj = grad[ifree[j]];
+                (*jtr)[j] += gj*r;
+                for (unsigned k=0;k<=j;++k) (*jtj)[j*maxParLM+k] += gj*grad[ifree[k]];
+            }
+        }
+        if (jtj) for (unsigned j=0;j<nfree;++j) for (unsigned k=0;k<j;++k) (*jtj)[k*maxParLM+j] = (*jtj)[j*maxParLM+k];
+        return chi2;
+    }
+
+    // in-place Cholesky decomposition of a (lower triangle), false if not positive definite
+    bool lmCholesky(LMMatrix& a, unsigned n)
+    {
+        for (unsigned j=0;j<n;++j)
+        {
+            double d = a[j*maxParLM+j];
+            for (unsigned k=0;k<j;++k) d -= a[j*maxParLM+k]*a[j*maxParLM+k];
+            if (d <= 0) return false;
+            a[j*maxParLM+j] = std::sqrt(d);
+            for (unsigned i=j+1;i<n;++i)
+            {
+                double s = a[i*maxParLM+j];
+                for (unsigned k=0;k<j;++k) s -= a[i*maxParLM+k]*a[j*maxParLM+k];
+                a[i*maxParLM+j] = s/a[j*maxParLM+j];
+            }
+        }
+        return true;
+    }
+
+    // solve L L^T x = b in place
+    void lmSolve(const LMMatrix& l, unsigned n, LMVector& b)
+    {
+        for (unsigned i=0;i<n;++i)
+        {
+            double s = b[i];
+            for (unsigned k=0;k<i;++k) s -= l[i*maxParLM+k]*b[k];
+            b[i] = s/l[i*maxParLM+i];
+        }
+        for (unsigned i=n;i-- >0;)
+        {
+            double s = b[i];
+            for (unsigned k=i+1;k<n;++k) s -= l[k*maxParLM+i]*b[k];
+            b[i] = s/l[i*maxParLM+i];
+        }
+    }
+
+    bool lmfit(double* par, const bool* isFree, unsigned npar, double* err, double& chi2)
+    {
+        unsigned nfree(0);
+        std::array<unsigned,maxParLM> ifree;
+        for (unsigned ip=0;ip<npar;++ip) if (isFree[ip]) ifree[nfree++] = ip;
+
+        LMMatrix jtj, work;
+        LMVector jtr, step, trial;
+        double   lambda(1e-3);
+        bool     converged(false);
+
+        chi2 = lmNormal(par,ifree.data(),nfree,&jtj,&jtr);
+        for (unsigned iter=0; iter<200 && !converged; ++iter)
+        {
+            work = jtj;
+            for (unsigned j=0;j<nfree;++j) work[j*maxParLM+j] *= 1.0+lambda;
+            for (unsigned j=0;j<nfree;++j) step[j] = -jtr[j];
+            if (!lmCholesky(work,nfree)) {lambda *= 10; if (lambda>1e10) break; continue;}
+            lmSolve(work,nfree,step);
+
+            std::copy(par,par+npar,trial.begin());
+            for (unsigned j=0;j<nfree;++j) trial[ifree[j]] = std::clamp(par[ifree[j]]+step[j],0.0,1e6);
+            double chi2Trial = lmNormal(trial.data(),ifree.data(),nfree,nullptr,nullptr);
+
+            if (chi2Trial < chi2)
+            {
+                converged = chi2-chi2Trial < 1e-6*chi2+1e-9;
+                std::copy(trial.begin(),trial.begin()+npar,par);
+                chi2   = lmNormal(par,ifree.data(),nfree,&jtj,&jtr);
+                lambda = std::max(lambda/10,1e-9);
+            }
+            else
+            {
+                // no step improves the chi2 any more, we are at the minimum
+                lambda *= 10;
+                if (lambda > 1e10) converged = true;
+            }
+        }
+
+        // parabolic errors from the covariance at the minimum
+        std::fill(err,err+npar,0.0);
+        work = jtj;
+        if (!lmCholesky(work,nfree)) return false;
+        for (unsigned j=0;j<nfree;++j)
+        {
+            std::fill(step.begin(),step.begin()+nfree,0.0);
+            step[j] = 1.0;
+            lmSolve(work,nfree,step);
+            err[ifree[j]] = std::sqrt(std::max(step[j],0.0));
+        }
+        return converged;
+    }
 }
 
 
@@ -57,8 +194,10 @@ namespace
 namespace mu2e {
 
 
-   CaloTemplateWFUtil::CaloTemplateWFUtil(double minPeakAmplitude, double digiSampling, double minDTPeaks, int printLevel) :
+   CaloTemplateWFUtil::CaloTemplateWFUtil(double minPeakAmplitude, double digiSampling, double minDTPeaks, int printLevel,
+                                          fitterType fitter) :
       pulseCache_(CaloPulseShape(digiSampling)),
+      fitter_(fitter),
       minPeakAmplitude_(minPeakAmplitude),
       minDTPeaks_(minDTPeaks),
       fitStrategy_(1),
@@ -90,6 +229,7 @@ namespace mu2e {
        status_ = 0;
        if (param_.empty() || param_.size()>49 || xvec_.empty()) return;
        if (nParTot_ < nParBkg_  || (nParTot_-nParBkg_)%nParFcn_ !=0) return;
+       if (fitter_ == LevenbergMarquardt) {fitLM(); return;}
 
        int ierr(0),nvpar(999), nparx(999), istat(999);
        double arglist[2]={0,0}, edm(999), errdef(999);
@@ -177,6 +317,50 @@ namespace mu2e {
 
 
 
+   //-----------------------------------------------------------------------------------------------------
+   // Same procedure as the Minuit fit: fit all components, remove the small or duplicate ones and refit
+   void CaloTemplateWFUtil::fitLM()
+   {
+       std::array<double,maxParLM> par,err;
+       std::array<bool,maxParLM>   isFree;
+       std::copy(param_.begin(),param_.end(),par.begin());
+       std::fill(isFree.begin(),isFree.end(),true);
+
+       bool converged = lmfit(par.data(),isFree.data(),nParTot_,err.data(),chi2_);
+
+       if (nParTot_ > nParFcn_+nParBkg_)
+       {
+           bool refit(false);
+           std::vector<double> tempPar(par.begin(),par.begin()+nParTot_),tempErr(err.begin(),err.begin()+nParTot_);
+           for (unsigned ip=nParBkg_; ip<nParTot_; ip += nParFcn_)
+           {
+               if (selectComponent(tempPar,tempErr,ip)) continue;
+               par[ip] = par[ip+1] = 0;
+               isFree[ip] = isFree[ip+1] = false;
+               refit = true;
+           }
+           if (refit) converged = lmfit(par.data(),isFree.data(),nParTot_,err.data(),chi2_);
+       }
+
+       // Save the results - exclude low components
+       param_.clear();
+       paramErr_.clear();
+       unsigned i(0);
+       while (i<nParTot_)
+       {
+           if (par[i]<1 && i >=nParBkg_ && (i-nParBkg_)%nParFcn_==0) {i+=nParFcn_;continue;}
+           param_.push_back(par[i]);
+           paramErr_.push_back(err[i]);
+           ++i;
+       }
+
+       nParTot_ = param_.size();
+       npTot_   = nParTot_;
+       status_  = converged ? 3 : 0;  // as the Minuit covariance status, 3 is a full accurate matrix
+   }
+
+
+
    //-----------------------------------------------------------------------------------------------------
    void CaloTemplateWFUtil::refitEdge()
    {
@@ -191,6 +375,27 @@ namespace mu2e {
        //x0_ = ilow;
        x1_ = imax;
 
+       if (fitter_ == LevenbergMarquardt)
+       {
+           // only the baseline and the first peak are fitted, as in the Minuit refit
+           std::array<double,maxParLM> par,err;
+           std::array<bool,maxParLM>   isFree;
+           std::copy(param_.begin(),param_.begin()+nParBkg_+nParFcn_,par.begin());
+           std::fill(isFree.begin(),isFree.end(),true);
+           unsigned npTotSave = npTot_;
+           npTot_ = nParBkg_+nParFcn_;
+           double chi(0);
+           bool converged = lmfit(par.data(),isFree.data(),npTot_,err.data(),chi);
+           npTot_ = npTotSave;
+
+           param_[nParBkg_+1]    = par[nParBkg_+1];
+           paramErr_[nParBkg_+1] = err[nParBkg_+1];
+           status_               = converged ? 3 : 0;
+           x0_ = 0;
+           x1_ = xvec_.size();
+           return;
+       }
+
        int ierr(0),nvpar(999), nparx(999), istat(999);
        double arglist[2]={0,0}, edm(999), errdef(999),chi(9999),val(0),err(0);
 
@@ -18,22 +18,22 @@ namespace mu2e {
   public:
     CaloDAQUtilities(std::string ModuleName);
 
-    uint16_t  getCrystalID(CalorimeterDataDecoder::CalorimeterHitDataPacket const& Hit){ return Hit.DIRACB & 0x0FFF;}
-    uint16_t  getSiPMID   (CalorimeterDataDecoder::CalorimeterHitDataPacket const& Hit){
+    uint16_t  getCrystalID(CalorimeterDataDecoder::CalorimeterHitDataPacket const& Hit) const { return Hit.DIRACB & 0x0FFF;}
+    uint16_t  getSiPMID   (CalorimeterDataDecoder::CalorimeterHitDataPacket const& Hit) const {
       uint16_t  crystalID  = getCrystalID(Hit);
       uint16_t  sipmID     = Hit.DIRACB >> 12;
       return (crystalID * 2 + sipmID);
     }
 
-    void   printCaloFragmentInfo(CalorimeterDataDecoder const& Frag);
+    void   printCaloFragmentInfo(CalorimeterDataDecoder const& Frag) const;
 
-    void   printCaloFragmentHeader(std::shared_ptr<DTCLib::DTC_DataHeaderPacket> Header);
+    void   printCaloFragmentHeader(std::shared_ptr<DTCLib::DTC_DataHeaderPacket> Header) const;
 
-    void   printCaloPulse(CalorimeterDataDecoder::CalorimeterHitDataPacket const& Hit);
+    void   printCaloPulse(CalorimeterDataDecoder::CalorimeterHitDataPacket const& Hit) const;
 
-    void   printWaveform(std::vector<uint16_t> const& Pulse);
+    void   printWaveform(std::vector<uint16_t> const& Pulse) const;
 
-    void   printAllHitInfo(int CrystalID, int SiPMID, std::shared_ptr<DTCLib::DTC_DataHeaderPacket> Header, CalorimeterDataDecoder::CalorimeterHitDataPacket const& Hit, uint16_t PulseMax);
+    void   printAllHitInfo(int CrystalID, int SiPMID, std::shared_ptr<DTCLib::DTC_DataHeaderPacket> Header, CalorimeterDataDecoder::CalorimeterHitDataPacket const& Hit, uint16_t PulseMax) const;
 
   private:
     std::string  moduleName_;
@@ -0,0 +1,71 @@
+#ifndef DAQ_DAQBlockSlices_hh
+#define DAQ_DAQBlockSlices_hh
+//
+// Helpers to decode the DTC data blocks of an event independently of each other.
+// The blocks of all the fragments are listed once, each block is decoded into its
+// own slice (in parallel if requested), and the slices are then concatenated in
+// block order, so the output is the same as a serial decoding.  The decode
+// function is called with the fragment, the DAQBlockRef and the slice to fill,
+// and must only use const (read-only) decoder methods.
+//
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace mu2e {
+
+  // one DTC data block: fragment index in the collection and block index in the fragment
+  struct DAQBlockRef {
+    size_t frag;
+    size_t block;
+  };
+
+  template <typename Decoder>
+  std::vector<DAQBlockRef> listDAQBlocks(std::vector<Decoder> const& frags) {
+    size_t nblocks(0);
+    for (auto const& frag : frags) nblocks += frag.block_count();
+    std::vector<DAQBlockRef> blocks;
+    blocks.reserve(nblocks);
+    for (size_t ifrag = 0; ifrag < frags.size(); ++ifrag) {
+      for (size_t iblock = 0; iblock < frags[ifrag].block_count(); ++iblock) {
+        blocks.push_back(DAQBlockRef{ifrag, iblock});
+      }
+    }
+    return blocks;
+  }
+
+  // decode each block into slices[i]; the blocks are spread over the TBB threads
+  // when parallel is true
+  template <typename Decoder, typename Slice, typename Func>
+  void decodeDAQBlocks(std::vector<Decoder> const& frags, std::vector<DAQBlockRef> const& blocks,
+                       std::vector<Slice>& slices, bool parallel, Func const& decode) {
+    slices.clear();
+    slices.resize(blocks.size());
+    if (parallel && blocks.size() > 1) {
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, blocks.size()),
+                        [&](tbb::blocked_range<size_t> const& range) {
+                          for (size_t i = range.begin(); i != range.end(); ++i) {
+                            decode(frags[blocks[i].frag], blocks[i], slices[i]);
+                          }
+                        });
+    } else {
+      for (size_t i = 0; i < blocks.size(); ++i) {
+        decode(frags[blocks[i].frag], blocks[i], slices[i]);
+      }
+    }
+  }
+
+  // append the contents of all the slices to out, in order, with a single allocation
+  template <typename T>
+  void concatenateDAQSlices(std::vector<std::vector<T>>& slices, std::vector<T>& out) {
+    size_t ntot(out.size());
+    for (auto const& slice : slices) ntot += slice.size();
+    out.reserve(ntot);
+    for (auto& slice : slices) {
+      for (auto& item : slice) out.push_back(std::move(item));
+    }
+  }
+} // namespace mu2e
+#endif
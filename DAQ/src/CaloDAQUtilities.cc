@@ -9,7 +9,7 @@
 namespace mu2e {
   CaloDAQUtilities::CaloDAQUtilities(std::string ModuleName):moduleName_(ModuleName){}
 
-  void CaloDAQUtilities::printCaloFragmentInfo(CalorimeterDataDecoder const& cc){
+  void CaloDAQUtilities::printCaloFragmentInfo(CalorimeterDataDecoder const& cc) const {
     std::cout << std::endl;
     std::cout << "ArtFragmentReader: ";
     std::cout << "\tBlock Count: " << std::dec << cc.block_count() << std::endl;
@@ -27,7 +27,7 @@ namespace mu2e {
   }
 
 
-  void CaloDAQUtilities::printCaloFragmentHeader(std::shared_ptr<DTCLib::DTC_DataHeaderPacket> Header){
+  void CaloDAQUtilities::printCaloFragmentHeader(std::shared_ptr<DTCLib::DTC_DataHeaderPacket> Header) const {
 
     std::cout << "timestamp: " << static_cast<int>(Header->GetEventWindowTag().GetEventWindowTag(true)) << std::endl;
     std::cout << "Header->SubsystemID: " << static_cast<int>(Header->GetSubsystemID()) << std::endl;
@@ -40,7 +40,7 @@ namespace mu2e {
 
   }
 
-  void CaloDAQUtilities::printCaloPulse(CalorimeterDataDecoder::CalorimeterHitDataPacket const& Hit){
+  void CaloDAQUtilities::printCaloPulse(CalorimeterDataDecoder::CalorimeterHitDataPacket const& Hit) const {
     std::cout << "[CaloHitsFromFragments] \tChNumber   "
               << (int)Hit.ChannelNumber
               << std::endl;
@@ -63,7 +63,7 @@ namespace mu2e {
 
   }
 
-  void CaloDAQUtilities::printWaveform(std::vector<uint16_t> const& Pulse){
+  void CaloDAQUtilities::printWaveform(std::vector<uint16_t> const& Pulse) const {
     std::cout << "Waveform: {";
     for (size_t i = 0; i < Pulse.size(); i++) {
       std::cout << Pulse[i];
@@ -76,7 +76,7 @@ namespace mu2e {
 
   void CaloDAQUtilities::printAllHitInfo(int CrystalID, int SiPMID,
                                          std::shared_ptr<DTCLib::DTC_DataHeaderPacket> Header,
-                                         CalorimeterDataDecoder::CalorimeterHitDataPacket const& Hit, uint16_t PulseMax){
+                                         CalorimeterDataDecoder::CalorimeterHitDataPacket const& Hit, uint16_t PulseMax) const {
 
     std::cout << "Crystal ID: " << CrystalID           << std::endl;
     std::cout << "SiPM ID: "    << SiPMID              << std::endl;
@@ -21,6 +21,7 @@
 #include <artdaq-core/Data/Fragment.hh>
 
 #include "Offline/DAQ/inc/CaloDAQUtilities.hh"
+#include "Offline/DAQ/inc/DAQBlockSlices.hh"
 
 #include <iostream>
 
@@ -49,6 +50,13 @@ class art::CaloHitsFromFragments : public EDProducer {
     float _eDep;
   };
 
+  // a pulse passing the energy selection, decoded from a DTC block
+  struct Pulse {
+    uint16_t crystalID;
+    float time;
+    float eDep;
+  };
+
 public:
   struct Config {
     fhicl::Atom<int> diagLevel{fhicl::Name("diagLevel"), fhicl::Comment("diagnostic level")};
@@ -74,6 +82,9 @@ public:
                                      fhicl::Comment("Maximum CAPHRI hit energy in MeV")};
     fhicl::Atom<float> caphriEDepMin{fhicl::Name("caphriEDepMin"),
                                      fhicl::Comment("Minimum CAPHRI hit energy in MeV")};
+    fhicl::Atom<bool> parallelBlocks{
+        fhicl::Name("parallelBlocks"),
+        fhicl::Comment("decode the DTC blocks in parallel (only when diagLevel < 1)"), true};
   };
 
   // --- C'tor/d'tor:
@@ -88,17 +99,15 @@ public:
 private:
   mu2e::ProditionsHandle<mu2e::CaloDAQMap> _calodaqconds_h;
 
-  void analyze_calorimeter_(mu2e::CaloDAQMap const& calodaqconds,
-                            const mu2e::CalorimeterDataDecoder& cc,
-                            std::unique_ptr<mu2e::CaloHitCollection> const& calo_hits,
-                            std::unique_ptr<mu2e::CaloHitCollection> const& caphri_hits,
-                            unsigned short& evtEnergy);
+  void decodeBlock_(mu2e::CaloDAQMap const& calodaqconds, const mu2e::CalorimeterDataDecoder& cc,
+                    size_t curBlockIdx, std::vector<Pulse>& pulses) const;
 
   void addPulse(uint16_t& crystalID, float& time, float& eDep,
                 std::unique_ptr<mu2e::CaloHitCollection> const& hits_calo,
                 std::unique_ptr<mu2e::CaloHitCollection> const& hits_caphri);
 
   int diagLevel_;
+  bool parallelBlocks_;
 
   art::InputTag caloFragmentsTag_;
   float digiSampling_;
@@ -176,7 +185,7 @@ void art::CaloHitsFromFragments::addPulse(
 
 art::CaloHitsFromFragments::CaloHitsFromFragments(const art::EDProducer::Table<Config>& config) :
     art::EDProducer{config}, diagLevel_(config().diagLevel()),
-    caloFragmentsTag_(config().caloTag()), digiSampling_(config().digiSampling()),
+    parallelBlocks_(config().parallelBlocks() && diagLevel_ < 1), caloFragmentsTag_(config().caloTag()), digiSampling_(config().digiSampling()),
     deltaTPulses_(config().deltaTPulses()), hitEDepMax_(config().hitEDepMax()),
     hitEDepMin_(config().hitEDepMin()), caphriEDepMax_(config().caphriEDepMax()),
     caphriEDepMin_(config().caphriEDepMin()), nPEperMeV_(config().nPEperMeV()),
@@ -210,14 +219,40 @@ void art::CaloHitsFromFragments::produce(Event& event) {
   auto fragmentHandle =
       event.getValidHandle<std::vector<mu2e::CalorimeterDataDecoder>>(caloFragmentsTag_);
 
-  for (auto frag : *fragmentHandle) {
-    analyze_calorimeter_(calodaqconds, frag, calo_hits, caphri_hits, evtEnergy);
+  auto const& frags = *fragmentHandle;
+
+  for (auto const& frag : frags) {
+    if (diagLevel_ > 1) {
+      caloDAQUtil_.printCaloFragmentInfo(frag);
+    }
     for (size_t i = 0; i < frag.block_count(); ++i) {
       totalSize += frag.blockSizeBytes(i);
     }
     numCalFrags++;
   }
 
+  // decode the blocks in place into per-block slices of pulses.  The two SiPMs of a
+  // crystal can be read out in different blocks, so the pulses are combined into hits
+  // afterwards, in block order
+  std::vector<std::vector<Pulse>> slices;
+  mu2e::decodeDAQBlocks(frags, mu2e::listDAQBlocks(frags), slices, parallelBlocks_,
+                        [this, &calodaqconds](const mu2e::CalorimeterDataDecoder& cc,
+                                              mu2e::DAQBlockRef const& ref,
+                                              std::vector<Pulse>& pulses) {
+                          decodeBlock_(calodaqconds, cc, ref.block, pulses);
+                        });
+  size_t npulses(0);
+  for (auto const& slice : slices) {
+    npulses += slice.size();
+  }
+  calo_hits->reserve(npulses);
+  for (auto& slice : slices) {
+    for (auto& pulse : slice) {
+      addPulse(pulse.crystalID, pulse.time, pulse.eDep, calo_hits, caphri_hits);
+      evtEnergy += pulse.eDep;
+    }
+  }
+
   if (numCalFrags == 0) {
     std::cout << "[CaloHitsFromFragments::produce] found no Calorimeter fragments!" << std::endl;
   }
@@ -245,115 +280,106 @@ void art::CaloHitsFromFragments::produce(Event& event) {
 
 } // produce()
 
-void art::CaloHitsFromFragments::analyze_calorimeter_(
-    mu2e::CaloDAQMap const& calodaqconds,
-    const mu2e::CalorimeterDataDecoder& cc, std::unique_ptr<mu2e::CaloHitCollection> const& calo_hits,
-    std::unique_ptr<mu2e::CaloHitCollection> const& caphri_hits, unsigned short& evtEnergy) {
+// Decode the pulses of one DTC block that pass the energy selection.  This only reads the
+// fragment and the conditions, so blocks can be decoded concurrently; the diagnostic
+// printout is only done when decoding serially.
+void art::CaloHitsFromFragments::decodeBlock_(mu2e::CaloDAQMap const& calodaqconds,
+                                              const mu2e::CalorimeterDataDecoder& cc,
+                                              size_t curBlockIdx,
+                                              std::vector<Pulse>& pulses) const {
 
+#if 0 // TODO: Review this code and update as necessary
   if (diagLevel_ > 1) {
-    caloDAQUtil_.printCaloFragmentInfo(cc);
+    // Print binary contents the first 3 packets starting at the current position
+    // In the case of the tracker simulation, this will be the whole tracker
+    // DataBlock. In the case of the calorimeter, the number of data packets
+    // following the header packet is variable.
+    cc.printPacketAtByte(cc.blockIndexBytes(0) + 16 * (0 + 3 * curBlockIdx));
+    cc.printPacketAtByte(cc.blockIndexBytes(0) + 16 * (1 + 3 * curBlockIdx));
+    cc.printPacketAtByte(cc.blockIndexBytes(0) + 16 * (2 + 3 * curBlockIdx));
+
+    // Print out decimal values of 16 bit chunks of packet data
+    for (int i = hexShiftPrint; i >= 0; i--) {
+      std::cout << "0x" << std::hex << std::setw(4) << std::setfill('0') << (adc_t) * (pos + i)
+                << std::dec << std::setw(0);
+      std::cout << " ";
+    }
+    std::cout << std::endl;
   }
+#endif
 
-  for (size_t curBlockIdx = 0; curBlockIdx < cc.block_count(); curBlockIdx++) {
+  auto block = cc.dataAtBlockIndex(curBlockIdx);
+  if (block == nullptr) {
+    mf::LogError("CaloHitsFromFragments")
+        << "Unable to retrieve block " << curBlockIdx << "!" << std::endl;
+    return;
+  }
+  auto hdr = block->GetHeader();
 
-#if 0 // TODO: Review this code and update as necessary
-    if (diagLevel_ > 1) {
-      // Print binary contents the first 3 packets starting at the current position
-      // In the case of the tracker simulation, this will be the whole tracker
-      // DataBlock. In the case of the calorimeter, the number of data packets
-      // following the header packet is variable.
-      cc.printPacketAtByte(cc.blockIndexBytes(0) + 16 * (0 + 3 * curBlockIdx));
-      cc.printPacketAtByte(cc.blockIndexBytes(0) + 16 * (1 + 3 * curBlockIdx));
-      cc.printPacketAtByte(cc.blockIndexBytes(0) + 16 * (2 + 3 * curBlockIdx));
-
-      // Print out decimal values of 16 bit chunks of packet data
-      for (int i = hexShiftPrint; i >= 0; i--) {
-        std::cout << "0x" << std::hex << std::setw(4) << std::setfill('0') << (adc_t) * (pos + i)
-                  << std::dec << std::setw(0);
-        std::cout << " ";
-      }
-      std::cout << std::endl;
-    }
-#endif
+  if (diagLevel_ > 1) {
+    caloDAQUtil_.printCaloFragmentHeader(hdr);
+  }
 
-    auto block = cc.dataAtBlockIndex(curBlockIdx);
-    if (block == nullptr) {
-      mf::LogError("CaloHitsFromFragments")
-          << "Unable to retrieve block " << curBlockIdx << "!" << std::endl;
-      continue;
-    }
-    auto hdr = block->GetHeader();
+  if (hdr->GetPacketCount() == 0)
+    return;
 
-    if (diagLevel_ > 1) {
-      caloDAQUtil_.printCaloFragmentHeader(hdr);
-    }
+  auto calData = cc.GetCalorimeterHitData(curBlockIdx);
+  if (calData == nullptr) {
+    mf::LogError("CaloHitsFromFragments")
+        << "Error retrieving Calorimeter data from block " << curBlockIdx
+        << "! Aborting processing of this block!";
+    return;
+  }
 
-    if (hdr->GetPacketCount() == 0)
-      continue;
+  auto hits = cc.GetCalorimeterHitsForTrigger(curBlockIdx);
+  pulses.reserve(calData->size());
+  for (size_t hitIdx = 0; hitIdx < calData->size(); hitIdx++) {
 
-    auto calData = cc.GetCalorimeterHitData(curBlockIdx);
-    if (calData == nullptr) {
+    // Fill the CaloDigiCollection
+    if (hitIdx > hits.size()) {
       mf::LogError("CaloHitsFromFragments")
-          << "Error retrieving Calorimeter data from block " << curBlockIdx
-          << "! Aborting processing of this block!";
-      continue;
+          << "Error retrieving Calorimeter data from block " << curBlockIdx << " for hit "
+          << hitIdx << "! Aborting processing of this block!";
+      break;
     }
 
-    auto hits = cc.GetCalorimeterHitsForTrigger(curBlockIdx);
-    bool err = false;
-    for (size_t hitIdx = 0; hitIdx < calData->size(); hitIdx++) {
-
-      // Fill the CaloDigiCollection
-      if (hitIdx > hits.size()) {
-        mf::LogError("CaloHitsFromFragments")
-            << "Error retrieving Calorimeter data from block " << curBlockIdx << " for hit "
-            << hitIdx << "! Aborting processing of this block!";
-        err = true;
-        break;
-      }
-
-      if (diagLevel_ > 0) {
-        std::cout << "[CaloHitsFromFragments] calo hit " << hitIdx << std::endl;
-        caloDAQUtil_.printCaloPulse(hits[hitIdx].first);
-      }
-
-      uint16_t packetid = hits[hitIdx].first.DIRACA;
-      uint16_t dirac = packetid & 0xFF;
-      uint16_t diracChannel = (packetid >>8) & 0x1F;
-      mu2e::CaloRawSiPMId rawId(dirac,diracChannel);
-      mu2e::CaloSiPMId offlineId = calodaqconds.offlineId(rawId);
-
-      uint16_t crystalID = offlineId.crystal().id();
-      uint16_t sipmID = offlineId.SiPMLocalId();
-
-      size_t peakIndex = hits[hitIdx].first.IndexOfMaxDigitizerSample;
-      // float  eDep(0);
-      //      if (hits[hitIdx].first.IndexOfMaxDigitizerSample < hits[hitIdx].second.size()) {
-      // eDep = hits[hitIdx].second.at(peakIndex) * peakADC2MeV_[sipmID];
-      float eDep = hits[hitIdx].second * peakADC2MeV_[sipmID];
-      //      }
-      float time = hits[hitIdx].first.Time + peakIndex * digiSampling_ + timeCalib_[sipmID];
-
-      bool  isCaphri = offlineId.crystal().isCaphri();
-      // FIX ME! WE NEED TO CHECK IF TEH PULSE IS SATURATED HERE
-      if (((eDep >= hitEDepMin_) || (isCaphri && (eDep >= caphriEDepMin_))) &&
-          ((eDep < hitEDepMax_) || (isCaphri && (eDep < caphriEDepMax_)))) {
-        addPulse(crystalID, time, eDep, calo_hits, caphri_hits);
-        evtEnergy += eDep;
-      }
-      if (diagLevel_ > 1) {
-        // Until we have the final mapping, the BoardID is just a placeholder
-        // adc_t BoardId    = cc.DBC_BoardID(pos,channelIdx);
+    if (diagLevel_ > 0) {
+      std::cout << "[CaloHitsFromFragments] calo hit " << hitIdx << std::endl;
+      caloDAQUtil_.printCaloPulse(hits[hitIdx].first);
+    }
 
-        caloDAQUtil_.printAllHitInfo(crystalID, sipmID, hdr, hits[hitIdx].first,
-                                     hits[hitIdx].second);
-      } // End debug output
+    uint16_t packetid = hits[hitIdx].first.DIRACA;
+    uint16_t dirac = packetid & 0xFF;
+    uint16_t diracChannel = (packetid >>8) & 0x1F;
+    mu2e::CaloRawSiPMId rawId(dirac,diracChannel);
+    mu2e::CaloSiPMId offlineId = calodaqconds.offlineId(rawId);
+
+    uint16_t crystalID = offlineId.crystal().id();
+    uint16_t sipmID = offlineId.SiPMLocalId();
+
+    size_t peakIndex = hits[hitIdx].first.IndexOfMaxDigitizerSample;
+    // float  eDep(0);
+    //      if (hits[hitIdx].first.IndexOfMaxDigitizerSample < hits[hitIdx].second.size()) {
+    // eDep = hits[hitIdx].second.at(peakIndex) * peakADC2MeV_[sipmID];
+    float eDep = hits[hitIdx].second * peakADC2MeV_[sipmID];
+    //      }
+    float time = hits[hitIdx].first.Time + peakIndex * digiSampling_ + timeCalib_[sipmID];
+
+    bool  isCaphri = offlineId.crystal().isCaphri();
+    // FIX ME! WE NEED TO CHECK IF TEH PULSE IS SATURATED HERE
+    if (((eDep >= hitEDepMin_) || (isCaphri && (eDep >= caphriEDepMin_))) &&
+        ((eDep < hitEDepMax_) || (isCaphri && (eDep < caphriEDepMax_)))) {
+      pulses.push_back(Pulse{crystalID, time, eDep});
+    }
+    if (diagLevel_ > 1) {
+      // Until we have the final mapping, the BoardID is just a placeholder
+      // adc_t BoardId    = cc.DBC_BoardID(pos,channelIdx);
 
-    } // End loop over readout channels in DataBlock
+      caloDAQUtil_.printAllHitInfo(crystalID, sipmID, hdr, hits[hitIdx].first,
+                                   hits[hitIdx].second);
+    } // End debug output
 
-    if (err)
-      continue;
-  }
+  } // End loop over readout channels in DataBlock
 }
 // ======================================================================
 
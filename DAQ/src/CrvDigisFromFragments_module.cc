@@ -10,6 +10,7 @@
 #include "fhiclcpp/ParameterSet.h"
 
 #include "Offline/CRVConditions/inc/CRVOrdinal.hh"
+#include "Offline/DAQ/inc/DAQBlockSlices.hh"
 #include "Offline/ProditionsService/inc/ProditionsHandle.hh"
 #include "Offline/RecoDataProducts/inc/CrvDigi.hh"
 #include "art/Framework/Principal/Handle.h"
@@ -19,6 +20,7 @@
 #include <iostream>
 #include <string>
 #include <memory>
+#include <vector>
 
 namespace art
 {
@@ -37,6 +39,8 @@ class art::CrvDigisFromFragments : public EDProducer
     fhicl::Atom<int> diagLevel{fhicl::Name("diagLevel"), fhicl::Comment("diagnostic Level")};
     fhicl::Atom<art::InputTag> CRVDataDecodersTag{fhicl::Name("crvTag"),
                                                fhicl::Comment("crv Fragments Tag")};
+    fhicl::Atom<bool> parallelBlocks{fhicl::Name("parallelBlocks"),
+                                     fhicl::Comment("decode the DTC blocks in parallel (only when diagLevel < 1)"), true};
   };
 
   // --- C'tor/d'tor:
@@ -47,7 +51,11 @@ class art::CrvDigisFromFragments : public EDProducer
   void produce(Event&) override;
 
   private:
+  void decodeBlock(const mu2e::CRVOrdinal& channelMap, const mu2e::CRVDataDecoder& CRVDataDecoder,
+                   const mu2e::DAQBlockRef& ref, mu2e::CrvDigiCollection& crv_digis) const;
+
   int                                      _diagLevel;
+  bool                                     _parallelBlocks;
   art::InputTag                            _CRVDataDecodersTag;
   mu2e::ProditionsHandle<mu2e::CRVOrdinal> _channelMap_h;
 
@@ -56,7 +64,8 @@ class art::CrvDigisFromFragments : public EDProducer
 // ======================================================================
 
 CrvDigisFromFragments::CrvDigisFromFragments(const art::EDProducer::Table<Config>& config) :
-    art::EDProducer{config}, _diagLevel(config().diagLevel()), _CRVDataDecodersTag(config().CRVDataDecodersTag())
+    art::EDProducer{config}, _diagLevel(config().diagLevel()),
+    _parallelBlocks(config().parallelBlocks() && _diagLevel<1), _CRVDataDecodersTag(config().CRVDataDecodersTag())
 {
   produces<mu2e::CrvDigiCollection>();
 }
@@ -93,129 +102,142 @@ void CrvDigisFromFragments::produce(Event& event)
   std::unique_ptr<mu2e::CrvDigiCollection> crv_digis(new mu2e::CrvDigiCollection);
   auto const& channelMap = _channelMap_h.get(event.id());
 
-  // Loop over the CRV fragments
-  for(size_t iSubEvent = 0; iSubEvent < nSubEvents; ++iSubEvent)
-  {
-    const mu2e::CRVDataDecoder& CRVDataDecoder((*CRVDataDecoders)[iSubEvent]);
-    CRVDataDecoder.setup_event();
+  // Prepare the fragments for decoding
+  for(size_t iSubEvent = 0; iSubEvent < nSubEvents; ++iSubEvent) (*CRVDataDecoders)[iSubEvent].setup_event();
 
-    for(size_t iDataBlock = 0; iDataBlock < CRVDataDecoder.block_count(); ++iDataBlock)
-    {
-      if(_diagLevel>0) std::cout << "iSubEvent/iDataBlock: " << iSubEvent << "/" << iDataBlock << std::endl;
+  // Decode the DataBlocks in place into per-block slices, then concatenate them in block order
+  std::vector<mu2e::CrvDigiCollection> slices;
+  mu2e::decodeDAQBlocks(*CRVDataDecoders, mu2e::listDAQBlocks(*CRVDataDecoders), slices, _parallelBlocks,
+                        [this, &channelMap](const mu2e::CRVDataDecoder& CRVDataDecoder, const mu2e::DAQBlockRef& ref,
+                                            mu2e::CrvDigiCollection& digis)
+                        {decodeBlock(channelMap, CRVDataDecoder, ref, digis);});
+  mu2e::concatenateDAQSlices(slices, *crv_digis);
 
-      auto block = CRVDataDecoder.dataAtBlockIndex(iDataBlock);
-      if(block == nullptr)
-      {
-        std::cerr << "Unable to retrieve block in " << std::endl;
-        continue;
-      }
-      auto header = block->GetHeader();
+  // Store the straw digis and calo digis in the event
+  event.put(std::move(crv_digis));
+
+} // produce()
+
+// ----------------------------------------------------------------------
+
+// Decode the CrvDigis of one DataBlock.  This only reads the fragment and the channel map,
+// so DataBlocks can be decoded concurrently; the diagnostic printout is only done when
+// decoding serially.
+void CrvDigisFromFragments::decodeBlock(const mu2e::CRVOrdinal& channelMap, const mu2e::CRVDataDecoder& CRVDataDecoder,
+                                        const mu2e::DAQBlockRef& ref, mu2e::CrvDigiCollection& crv_digis) const
+{
+  size_t iSubEvent = ref.frag;
+  size_t iDataBlock = ref.block;
+  if(_diagLevel>0) std::cout << "iSubEvent/iDataBlock: " << iSubEvent << "/" << iDataBlock << std::endl;
+
+  auto block = CRVDataDecoder.dataAtBlockIndex(iDataBlock);
+  if(block == nullptr)
+  {
+    std::cerr << "Unable to retrieve block in " << std::endl;
+    return;
+  }
+  auto header = block->GetHeader();
 /*
 FIXME: This function will be available in a new release of artdaq_core_mu2e
-      if(!header->isValid())
-      {
-        std::cerr << "CRV packet is not valid." << std::endl;
-        std::cerr << "sub system ID: "<<(uint16_t)header->GetSubsystemID()<<" packet count: "<<header->GetPacketCount() << std::endl;
-        continue;
-      }
+  if(!header->isValid())
+  {
+    std::cerr << "CRV packet is not valid." << std::endl;
+    std::cerr << "sub system ID: "<<(uint16_t)header->GetSubsystemID()<<" packet count: "<<header->GetPacketCount() << std::endl;
+    return;
+  }
 */
-      if(header->GetSubsystemID() != DTCLib::DTC_Subsystem::DTC_Subsystem_CRV)
-      {
-        std::cerr << "CRV packet does not have system ID 2." << std::endl;
-        std::cerr << "sub system ID: "<<(uint16_t)header->GetSubsystemID()<<" packet count: "<<header->GetPacketCount() << std::endl;
-        continue;
-      }
+  if(header->GetSubsystemID() != DTCLib::DTC_Subsystem::DTC_Subsystem_CRV)
+  {
+    std::cerr << "CRV packet does not have system ID 2." << std::endl;
+    std::cerr << "sub system ID: "<<(uint16_t)header->GetSubsystemID()<<" packet count: "<<header->GetPacketCount() << std::endl;
+    return;
+  }
+
+  if(_diagLevel>0) std::cout << "packet count: " << header->GetPacketCount() << std::endl;
+  if(header->GetPacketCount() > 0)
+  {
+    auto crvRocHeader = CRVDataDecoder.GetCRVROCStatusPacket(iDataBlock);
+    if(crvRocHeader == nullptr)
+    {
+      std::cerr << "Error retrieving CRV ROC Status Packet from DataBlock in " << iDataBlock << std::endl;
+      return;
+    }
+
+    auto crvHits = CRVDataDecoder.GetCRVHits(iDataBlock);
+    crv_digis.reserve(crvHits.size());
+    for(auto const& crvHit : crvHits)
+    {
+      const auto& crvHitInfo = crvHit.first;
+      const auto& waveform = crvHit.second;
 
-      if(_diagLevel>0) std::cout << "packet count: " << header->GetPacketCount() << std::endl;
-      if(header->GetPacketCount() > 0)
+      uint16_t rocID = crvHitInfo.controllerNumber + 1; // FIXME ROC IDs between 1 and 17   //also: header->GetLinkID()+1;
+      uint16_t rocPort = crvHitInfo.portNumber;
+      uint16_t febChannel = crvHitInfo.febChannel;
+      mu2e::CRVROC onlineChannel(rocID, rocPort, febChannel);
+
+      uint16_t offlineChannel = channelMap.offline(onlineChannel);
+      int crvBarIndex = offlineChannel / 4;
+      int SiPMNumber = offlineChannel % 4;
+
+      for(size_t i = 0; i < crvHitInfo.NumSamples; i += mu2e::CrvDigi::NSamples)
       {
-        auto crvRocHeader = CRVDataDecoder.GetCRVROCStatusPacket(iDataBlock);
-        if(crvRocHeader == nullptr)
-        {
-          std::cerr << "Error retrieving CRV ROC Status Packet from DataBlock in " << iDataBlock << std::endl;
-          continue;
-        }
-
-        auto crvHits = CRVDataDecoder.GetCRVHits(iDataBlock);
-        for(auto const& crvHit : crvHits)
-        {
-          const auto& crvHitInfo = crvHit.first;
-          const auto& waveform = crvHit.second;
-
-          uint16_t rocID = crvHitInfo.controllerNumber + 1; // FIXME ROC IDs between 1 and 17   //also: header->GetLinkID()+1;
-          uint16_t rocPort = crvHitInfo.portNumber;
-          uint16_t febChannel = crvHitInfo.febChannel;
-          mu2e::CRVROC onlineChannel(rocID, rocPort, febChannel);
-
-          uint16_t offlineChannel = channelMap.offline(onlineChannel);
-          int crvBarIndex = offlineChannel / 4;
-          int SiPMNumber = offlineChannel % 4;
-
-          for(size_t i = 0; i < crvHitInfo.NumSamples; i += mu2e::CrvDigi::NSamples)
-          {
-            std::array<int16_t, mu2e::CrvDigi::NSamples> adc = {0};
-            for(size_t j = 0; j < mu2e::CrvDigi::NSamples && i+j < crvHitInfo.NumSamples; ++j)
-              adc[j] = waveform.at(i+j).ADC;
-
-            // CrvDigis use a constant array size of 8 samples
-            // waveforms with more than 8 samples need to be written to multiple CrvDigis
-            // the TDC increases by 8 for every subsequent CrvDigi
-            crv_digis->emplace_back(adc, crvHitInfo.HitTime + i, mu2e::CRSScintillatorBarIndex(crvBarIndex), SiPMNumber);
-          }
-        } // loop over all crvHits
-
-        if(_diagLevel>1)
-        {
-          std::cout << "EventWindowTag (TDC header): "
-                    << header->GetEventWindowTag().GetEventWindowTag(true) << std::endl;
-          std::cout << "SubsystemID: " << (uint16_t)header->GetSubsystemID() << std::endl;
-          std::cout << "DTCID: " << (uint16_t)header->GetID() << std::endl;
-          std::cout << "ROCID: " << (uint16_t)header->GetLinkID() << std::endl;
-          std::cout << "packetCount: " << header->GetPacketCount() << std::endl;
-          std::cout << "EVB mode: " << (uint16_t)header->GetEVBMode() << std::endl;
-          std::cout << "TriggerCount: " << crvRocHeader->TriggerCount << std::endl;
-          std::cout << "ActiveFEBFlags: " << crvRocHeader->GetActiveFEBFlags() << std::endl;
-          std::cout << "ROCID (ROC header): " << (uint16_t)crvRocHeader->ControllerID  << std::endl;
-          std::cout << "EventWindowTag (ROC header): " << crvRocHeader->GetEventWindowTag() << std::endl;
-        }
-
-        if(_diagLevel>0)
-        {
-          for(auto const& crvHit : crvHits)
-          {
-            const auto& crvHitInfo = crvHit.first;
-            const auto& waveform = crvHit.second;
-
-            uint16_t rocID = crvHitInfo.controllerNumber + 1; // FIXME  //ROC IDs are between 1 and 17
-            uint16_t rocPort = crvHitInfo.portNumber;
-            uint16_t febChannel = crvHitInfo.febChannel;
-            mu2e::CRVROC onlineChannel(rocID, rocPort, febChannel);
-
-            uint16_t offlineChannel = channelMap.offline(onlineChannel);
-            int crvBarIndex = offlineChannel / 4;
-            int SiPMNumber = offlineChannel % 4;
-
-            std::cout << "ROCID (increased by 1 to match the Online/Offline-Channel Map) " << rocID
-                      << "   rocPort " << rocPort << "   febChannel " << febChannel
-                      << "   crvBarIndex " << crvBarIndex << "   SiPMNumber " << SiPMNumber
-                      << std::endl;
-            std::cout << "TDC: " << crvHitInfo.HitTime << std::endl;
-            std::cout << "nSamples " << crvHitInfo.NumSamples << "  ";
-            std::cout << "Waveform: {";
-            for(size_t i = 0; i < crvHitInfo.NumSamples; i++)
-              std::cout << "  " << waveform.at(i).ADC;
-            std::cout << "}" << std::endl;
-            std::cout << std::endl;
-          } // loop over hits
-        }   // debug output
-      }     // end parsing CRV DataBlocks
-    }       // loop over DataBlocks within CRVDataDecoders
-  }         // Close loop over fragments
+        std::array<int16_t, mu2e::CrvDigi::NSamples> adc = {0};
+        for(size_t j = 0; j < mu2e::CrvDigi::NSamples && i+j < crvHitInfo.NumSamples; ++j)
+          adc[j] = waveform.at(i+j).ADC;
+
+        // CrvDigis use a constant array size of 8 samples
+        // waveforms with more than 8 samples need to be written to multiple CrvDigis
+        // the TDC increases by 8 for every subsequent CrvDigi
+        crv_digis.emplace_back(adc, crvHitInfo.HitTime + i, mu2e::CRSScintillatorBarIndex(crvBarIndex), SiPMNumber);
+      }
+    } // loop over all crvHits
 
-  // Store the straw digis and calo digis in the event
-  event.put(std::move(crv_digis));
+    if(_diagLevel>1)
+    {
+      std::cout << "EventWindowTag (TDC header): "
+                << header->GetEventWindowTag().GetEventWindowTag(true) << std::endl;
+      std::cout << "SubsystemID: " << (uint16_t)header->GetSubsystemID() << std::endl;
+      std::cout << "DTCID: " << (uint16_t)header->GetID() << std::endl;
+      std::cout << "ROCID: " << (uint16_t)header->GetLinkID() << std::endl;
+      std::cout << "packetCount: " << header->GetPacketCount() << std::endl;
+      std::cout << "EVB mode: " << (uint16_t)header->GetEVBMode() << std::endl;
+      std::cout << "TriggerCount: " << crvRocHeader->TriggerCount << std::endl;
+      std::cout << "ActiveFEBFlags: " << crvRocHeader->GetActiveFEBFlags() << std::endl;
+      std::cout << "ROCID (ROC header): " << (uint16_t)crvRocHeader->ControllerID  << std::endl;
+      std::cout << "EventWindowTag (ROC header): " << crvRocHeader->GetEventWindowTag() << std::endl;
+    }
 
-} // produce()
+    if(_diagLevel>0)
+    {
+      for(auto const& crvHit : crvHits)
+      {
+        const auto& crvHitInfo = crvHit.first;
+        const auto& waveform = crvHit.second;
+
+        uint16_t rocID = crvHitInfo.controllerNumber + 1; // FIXME  //ROC IDs are between 1 and 17
+        uint16_t rocPort = crvHitInfo.portNumber;
+        uint16_t febChannel = crvHitInfo.febChannel;
+        mu2e::CRVROC onlineChannel(rocID, rocPort, febChannel);
+
+        uint16_t offlineChannel = channelMap.offline(onlineChannel);
+        int crvBarIndex = offlineChannel / 4;
+        int SiPMNumber = offlineChannel % 4;
+
+        std::cout << "ROCID (increased by 1 to match the Online/Offline-Channel Map) " << rocID
+                  << "   rocPort " << rocPort << "   febChannel " << febChannel
+                  << "   crvBarIndex " << crvBarIndex << "   SiPMNumber " << SiPMNumber
+                  << std::endl;
+        std::cout << "TDC: " << crvHitInfo.HitTime << std::endl;
+        std::cout << "nSamples " << crvHitInfo.NumSamples << "  ";
+        std::cout << "Waveform: {";
+        for(size_t i = 0; i < crvHitInfo.NumSamples; i++)
+          std::cout << "  " << waveform.at(i).ADC;
+        std::cout << "}" << std::endl;
+        std::cout << std::endl;
+      } // loop over hits
+    }   // debug output
+  }     // end parsing CRV DataBlocks
+} // decodeBlock()
 
 // ======================================================================
 
@@ -28,6 +28,7 @@
 #include "Offline/DataProducts/inc/StrawEnd.hh"
 #include "Offline/RecoDataProducts/inc/CaloCluster.hh"
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitSoAView.hh"
 #include "Offline/RecoDataProducts/inc/ProtonBunchTime.hh"
 #include "Offline/RecoDataProducts/inc/StrawDigi.hh"
 #include "Offline/RecoDataProducts/inc/StrawHit.hh"
@@ -128,6 +129,7 @@ art::StrawHitRecoFromFragments::StrawHitRecoFromFragments(Parameters const& conf
                                      config().cccTag())},
     _pbttoken{consumes<mu2e::ProtonBunchTime>(config().pbttoken())}, _tfTag(config().tfTag()) {
   produces<mu2e::ComboHitCollection>();
+  produces<mu2e::ComboHitSoAView>();
   if (_writesh)
     produces<mu2e::StrawHitCollection>();
   if (_printLevel > 0)
@@ -175,6 +177,7 @@ void art::StrawHitRecoFromFragments::produce(art::Event& event) {
               << std::endl;
     if (_writesh)
       event.put(std::move(shCol));
+    event.put(std::make_unique<mu2e::ComboHitSoAView>(*chCol));
     event.put(std::move(chCol));
     return;
   }
@@ -190,6 +193,7 @@ void art::StrawHitRecoFromFragments::produce(art::Event& event) {
 
   if (_writesh)
     event.put(std::move(shCol));
+  event.put(std::make_unique<mu2e::ComboHitSoAView>(*chCol));
   event.put(std::move(chCol));
 }
 
@@ -13,6 +13,7 @@
 #include "artdaq-core-mu2e/Data/TrackerDataDecoder.hh"
 #include "artdaq-core-mu2e/Overlays/FragmentType.hh"
 
+#include "Offline/DAQ/inc/DAQBlockSlices.hh"
 #include "Offline/DataProducts/inc/TrkTypes.hh"
 #include "Offline/RecoDataProducts/inc/IntensityInfoTrackerHits.hh"
 #include "Offline/RecoDataProducts/inc/ProtonBunchTime.hh"
@@ -25,6 +26,7 @@
 #include <string>
 
 #include <memory>
+#include <vector>
 
 namespace art {
 class StrawRecoFromFragments;
@@ -40,6 +42,9 @@ public:
     fhicl::Atom<int> useTrkADC{fhicl::Name("useTrkADC"),
                                fhicl::Comment("parse tracker ADC waveforms")};
     fhicl::Atom<art::InputTag> trkTag{fhicl::Name("trkTag"), fhicl::Comment("trkTag")};
+    fhicl::Atom<bool> parallelBlocks{
+        fhicl::Name("parallelBlocks"),
+        fhicl::Comment("decode the DTC blocks in parallel (only when diagLevel < 2)"), true};
   };
 
   // --- C'tor/d'tor:
@@ -50,12 +55,18 @@ public:
   virtual void produce(Event&);
 
 private:
-  void
-  analyze_tracker_(const mu2e::TrackerDataDecoder& cc,
-                   std::unique_ptr<mu2e::StrawDigiCollection> const& straw_digis,
-                   std::unique_ptr<mu2e::StrawDigiADCWaveformCollection> const& straw_digi_adcs);
+  // the digis decoded from one DTC block
+  struct BlockSlice {
+    mu2e::StrawDigiCollection digis;
+    mu2e::StrawDigiADCWaveformCollection adcs;
+  };
+
+  void printFragmentInfo_(const mu2e::TrackerDataDecoder& cc) const;
+  void decodeBlock_(const mu2e::TrackerDataDecoder& cc, size_t curBlockIdx,
+                    BlockSlice& slice) const;
   int diagLevel_;
   int useTrkADC_;
+  bool parallelBlocks_;
 
   art::InputTag trkFragmentsTag_;
 
@@ -67,6 +78,7 @@ private:
 
 art::StrawRecoFromFragments::StrawRecoFromFragments(const art::EDProducer::Table<Config>& config) :
     art::EDProducer{config}, diagLevel_(config().diagLevel()), useTrkADC_(config().useTrkADC()),
+    parallelBlocks_(config().parallelBlocks() && diagLevel_ < 2),
     trkFragmentsTag_(config().trkTag()) {
   produces<mu2e::StrawDigiCollection>();
   if (useTrkADC_) {
@@ -99,14 +111,40 @@ void art::StrawRecoFromFragments::produce(Event& event) {
   size_t numTrkFrags = 0;
   auto fragmentHandle = event.getValidHandle<std::vector<mu2e::TrackerDataDecoder> >(trkFragmentsTag_);
 
-  for (auto frag : *fragmentHandle) {
-    analyze_tracker_(frag, straw_digis, straw_digi_adcs);
+  auto const& frags = *fragmentHandle;
+
+  for (auto const& frag : frags) {
+    if (diagLevel_ > 1) {
+      printFragmentInfo_(frag);
+    }
     for (size_t i = 0; i < frag.block_count(); ++i) {
       totalSize += frag.blockSizeBytes(i);
     }
     numTrkFrags++;
   }
 
+  // decode the blocks in place into per-block slices, then concatenate them in block order
+  std::vector<BlockSlice> slices;
+  mu2e::decodeDAQBlocks(frags, mu2e::listDAQBlocks(frags), slices, parallelBlocks_,
+                        [this](const mu2e::TrackerDataDecoder& cc, mu2e::DAQBlockRef const& ref,
+                               BlockSlice& slice) { decodeBlock_(cc, ref.block, slice); });
+  size_t ndigis(0);
+  for (auto const& slice : slices) {
+    ndigis += slice.digis.size();
+  }
+  straw_digis->reserve(ndigis);
+  if (useTrkADC_) {
+    straw_digi_adcs->reserve(ndigis);
+  }
+  for (auto& slice : slices) {
+    straw_digis->insert(straw_digis->end(), slice.digis.begin(), slice.digis.end());
+    if (useTrkADC_) {
+      for (auto& adc : slice.adcs) {
+        straw_digi_adcs->push_back(std::move(adc));
+      }
+    }
+  }
+
   if (numTrkFrags == 0) {
     std::cout << "[StrawRecoFromFragments::produce] found no Tracker fragments!" << std::endl;
   }
@@ -134,154 +172,158 @@ void art::StrawRecoFromFragments::produce(Event& event) {
 
 } // produce()
 
-void art::StrawRecoFromFragments::analyze_tracker_(
-    const mu2e::TrackerDataDecoder& cc, std::unique_ptr<mu2e::StrawDigiCollection> const& straw_digis,
-    std::unique_ptr<mu2e::StrawDigiADCWaveformCollection> const& straw_digi_adcs) {
-
-  if (diagLevel_ > 1) {
-    std::cout << std::endl;
-    std::cout << "TrackerDataDecoder: ";
-    std::cout << "\tBlock Count: " << std::dec << cc.block_count() << std::endl;
-    std::cout << std::endl;
-    std::cout << "\t"
-              << "====== Example Block Sizes ======" << std::endl;
-    for (size_t i = 0; i < 10; i++) {
-      if (i < cc.block_count()) {
-        std::cout << "\t" << i << "\t" << cc.blockSizeBytes(i) << std::endl;
-      }
+void art::StrawRecoFromFragments::printFragmentInfo_(const mu2e::TrackerDataDecoder& cc) const {
+  std::cout << std::endl;
+  std::cout << "TrackerDataDecoder: ";
+  std::cout << "\tBlock Count: " << std::dec << cc.block_count() << std::endl;
+  std::cout << std::endl;
+  std::cout << "\t"
+            << "====== Example Block Sizes ======" << std::endl;
+  for (size_t i = 0; i < 10; i++) {
+    if (i < cc.block_count()) {
+      std::cout << "\t" << i << "\t" << cc.blockSizeBytes(i) << std::endl;
     }
-    std::cout << "\t"
-              << "=========================" << std::endl;
   }
+  std::cout << "\t"
+            << "=========================" << std::endl;
+}
 
-  for (size_t curBlockIdx = 0; curBlockIdx < cc.block_count(); curBlockIdx++) {
+// Decode one DTC block into its slice.  This only reads the fragment, so blocks can be
+// decoded concurrently; the diagnostic printout is only done when decoding serially.
+void art::StrawRecoFromFragments::decodeBlock_(const mu2e::TrackerDataDecoder& cc,
+                                               size_t curBlockIdx, BlockSlice& slice) const {
 #if 0 // TODO: Review this code and update as necessary
-    if (diagLevel_ > 1) {
-      // Print binary contents the first 3 packets starting at the current position
-      // In the case of the tracker simulation, this will be the whole tracker
-      // DataBlock. In the case of the calorimeter, the number of data packets
-      // following the header packet is variable.
-      cc.printPacketAtByte(cc.blockIndexBytes(0) + 16 * (0 + 3 * curBlockIdx));
-      cc.printPacketAtByte(cc.blockIndexBytes(0) + 16 * (1 + 3 * curBlockIdx));
-      cc.printPacketAtByte(cc.blockIndexBytes(0) + 16 * (2 + 3 * curBlockIdx));
-
-      // Print out decimal values of 16 bit chunks of packet data
-      for (int i = hexShiftPrint; i >= 0; i--) {
-        std::cout << "0x" << std::hex << std::setw(4) << std::setfill('0') << (adc_t) * (pos + i)
-                  << std::dec << std::setw(0);
-        std::cout << " ";
-      }
-      std::cout << std::endl;
+  if (diagLevel_ > 1) {
+    // Print binary contents the first 3 packets starting at the current position
+    // In the case of the tracker simulation, this will be the whole tracker
+    // DataBlock. In the case of the calorimeter, the number of data packets
+    // following the header packet is variable.
+    cc.printPacketAtByte(cc.blockIndexBytes(0) + 16 * (0 + 3 * curBlockIdx));
+    cc.printPacketAtByte(cc.blockIndexBytes(0) + 16 * (1 + 3 * curBlockIdx));
+    cc.printPacketAtByte(cc.blockIndexBytes(0) + 16 * (2 + 3 * curBlockIdx));
+
+    // Print out decimal values of 16 bit chunks of packet data
+    for (int i = hexShiftPrint; i >= 0; i--) {
+      std::cout << "0x" << std::hex << std::setw(4) << std::setfill('0') << (adc_t) * (pos + i)
+                << std::dec << std::setw(0);
+      std::cout << " ";
     }
+    std::cout << std::endl;
+  }
 #endif
 
-    auto block = cc.dataAtBlockIndex(curBlockIdx);
-    if (block == nullptr) {
-      mf::LogError("StrawRecoFromFragments")
-          << "Unable to retrieve block " << curBlockIdx << "!" << std::endl;
-      continue;
-    }
-    auto hdr = block->GetHeader();
+  auto block = cc.dataAtBlockIndex(curBlockIdx);
+  if (block == nullptr) {
+    mf::LogError("StrawRecoFromFragments")
+        << "Unable to retrieve block " << curBlockIdx << "!" << std::endl;
+    return;
+  }
+  auto hdr = block->GetHeader();
 
-    if (diagLevel_ > 1) {
+  if (diagLevel_ > 1) {
 
-      std::cout << "timestamp: "
-                << static_cast<int>(hdr->GetEventWindowTag().GetEventWindowTag(true)) << std::endl;
-      std::cout << "hdr->SubsystemID: " << static_cast<int>(hdr->GetSubsystemID()) << std::endl;
-      std::cout << "dtcID: " << static_cast<int>(hdr->GetID()) << std::endl;
-      std::cout << "rocID: " << static_cast<int>(hdr->GetLinkID()) << std::endl;
-      std::cout << "packetCount: " << static_cast<int>(hdr->GetPacketCount()) << std::endl;
-      std::cout << "EVB mode: " << static_cast<int>(hdr->GetEVBMode()) << std::endl;
+    std::cout << "timestamp: "
+              << static_cast<int>(hdr->GetEventWindowTag().GetEventWindowTag(true)) << std::endl;
+    std::cout << "hdr->SubsystemID: " << static_cast<int>(hdr->GetSubsystemID()) << std::endl;
+    std::cout << "dtcID: " << static_cast<int>(hdr->GetID()) << std::endl;
+    std::cout << "rocID: " << static_cast<int>(hdr->GetLinkID()) << std::endl;
+    std::cout << "packetCount: " << static_cast<int>(hdr->GetPacketCount()) << std::endl;
+    std::cout << "EVB mode: " << static_cast<int>(hdr->GetEVBMode()) << std::endl;
 
-      std::cout << std::endl;
-    }
+    std::cout << std::endl;
+  }
 
-    // Parse phyiscs information from TRK packets
-    if (hdr->GetPacketCount() > 0) {
+  // Parse phyiscs information from TRK packets
+  if (hdr->GetPacketCount() > 0) {
 
-      // Create the StrawDigi data products
-      auto trkDataVec = cc.GetTrackerData(curBlockIdx, useTrkADC_);
-      if (trkDataVec.empty()) {
-        mf::LogError("StrawRecoFromFragments")
-            << "Error retrieving Tracker data from DataBlock " << curBlockIdx
-            << "! Aborting processing of this block!";
-        continue;
-      }
+    // Create the StrawDigi data products
+    auto trkDataVec = cc.GetTrackerData(curBlockIdx, useTrkADC_);
+    if (trkDataVec.empty()) {
+      mf::LogError("StrawRecoFromFragments")
+          << "Error retrieving Tracker data from DataBlock " << curBlockIdx
+          << "! Aborting processing of this block!";
+      return;
+    }
 
-      for (auto& trkDataPair : trkDataVec) {
+    // size the slice once from the number of hits in the block
+    slice.digis.reserve(trkDataVec.size());
+    if (useTrkADC_) {
+      slice.adcs.reserve(trkDataVec.size());
+    }
 
-        mu2e::StrawId sid(trkDataPair.first->StrawIndex);
-        mu2e::TrkTypes::TDCValues tdc = {trkDataPair.first->TDC0(), trkDataPair.first->TDC1()};
-        mu2e::TrkTypes::TOTValues tot = {trkDataPair.first->TOT0, trkDataPair.first->TOT1};
-        mu2e::TrkTypes::ADCValue pmp = trkDataPair.first->PMP;
+    for (auto& trkDataPair : trkDataVec) {
 
-        // Fill the StrawDigiCollection
-        straw_digis->emplace_back(sid, tdc, tot, pmp);
-        if (useTrkADC_) {
-          straw_digi_adcs->emplace_back(trkDataPair.second);
-        }
+      mu2e::StrawId sid(trkDataPair.first->StrawIndex);
+      mu2e::TrkTypes::TDCValues tdc = {trkDataPair.first->TDC0(), trkDataPair.first->TDC1()};
+      mu2e::TrkTypes::TOTValues tot = {trkDataPair.first->TOT0, trkDataPair.first->TOT1};
+      mu2e::TrkTypes::ADCValue pmp = trkDataPair.first->PMP;
+
+      // Fill the StrawDigiCollection
+      slice.digis.emplace_back(sid, tdc, tot, pmp);
+      if (useTrkADC_) {
+        slice.adcs.emplace_back(trkDataPair.second);
+      }
 
-        if (diagLevel_ > 1) {
-          std::cout << "MAKEDIGI: " << sid.asUint16() << " " << tdc[0] << " " << tdc[1] << " "
-                    << tot[0] << " " << tot[1] << " ";
-          for (size_t i = 0; i < trkDataPair.second.size(); i++) {
-            std::cout << trkDataPair.second[i];
-            if (i < trkDataPair.second.size() - 1) {
-              std::cout << " ";
-            }
+      if (diagLevel_ > 1) {
+        std::cout << "MAKEDIGI: " << sid.asUint16() << " " << tdc[0] << " " << tdc[1] << " "
+                  << tot[0] << " " << tot[1] << " ";
+        for (size_t i = 0; i < trkDataPair.second.size(); i++) {
+          std::cout << trkDataPair.second[i];
+          if (i < trkDataPair.second.size() - 1) {
+            std::cout << " ";
           }
-          std::cout << std::endl;
-
-          std::cout << std::endl;
-
-          std::cout << "strawIdx: " << sid.asUint16() << std::endl;
-          std::cout << "TDC0: " << tdc[0] << std::endl;
-          std::cout << "TDC1: " << tdc[1] << std::endl;
-          std::cout << "TOT0: " << tot[0] << std::endl;
-          std::cout << "TOT1: " << tot[1] << std::endl;
-          std::cout << "PMP:  " << pmp << std::endl;
-          std::cout << "Waveform: {";
-          for (size_t i = 0; i < trkDataPair.second.size(); i++) {
-            std::cout << trkDataPair.second[i];
-            if (i < trkDataPair.second.size() - 1) {
-              std::cout << ",";
-            }
+        }
+        std::cout << std::endl;
+
+        std::cout << std::endl;
+
+        std::cout << "strawIdx: " << sid.asUint16() << std::endl;
+        std::cout << "TDC0: " << tdc[0] << std::endl;
+        std::cout << "TDC1: " << tdc[1] << std::endl;
+        std::cout << "TOT0: " << tot[0] << std::endl;
+        std::cout << "TOT1: " << tot[1] << std::endl;
+        std::cout << "PMP:  " << pmp << std::endl;
+        std::cout << "Waveform: {";
+        for (size_t i = 0; i < trkDataPair.second.size(); i++) {
+          std::cout << trkDataPair.second[i];
+          if (i < trkDataPair.second.size() - 1) {
+            std::cout << ",";
           }
-          std::cout << "}" << std::endl;
-
-          std::cout << "FPGA Flags: ";
-          for (size_t i = 8; i < 16; i++) {
-            if (((0x0001 << (15 - i)) & trkDataPair.first->ErrorFlags) > 0) {
-              std::cout << "1";
-            } else {
-              std::cout << "0";
-            }
+        }
+        std::cout << "}" << std::endl;
+
+        std::cout << "FPGA Flags: ";
+        for (size_t i = 8; i < 16; i++) {
+          if (((0x0001 << (15 - i)) & trkDataPair.first->ErrorFlags) > 0) {
+            std::cout << "1";
+          } else {
+            std::cout << "0";
           }
-          std::cout << std::endl;
-
-          std::cout << "LOOP: " << hdr->GetEventWindowTag().GetEventWindowTag(true) << " "
-                    << curBlockIdx << std::endl;
-
-          // Text format: timestamp strawidx tdc0 tdc1 nsamples sample0-11
-          // Example: 1 1113 36978 36829 12 1423 1390 1411 1354 2373 2392 2342 2254 1909 1611 1525
-          // 1438
-          std::cout << "GREPMETRK: " << hdr->GetEventWindowTag().GetEventWindowTag(true) << " ";
-          std::cout << sid.asUint16() << " ";
-          std::cout << tdc[0] << " ";
-          std::cout << tdc[1] << " ";
-          std::cout << tot[0] << " ";
-          std::cout << tot[1] << " ";
-          std::cout << pmp << " ";
-          std::cout << trkDataPair.second.size() << " ";
-          for (size_t i = 0; i < trkDataPair.second.size(); i++) {
-            std::cout << trkDataPair.second[i];
-            if (i < trkDataPair.second.size() - 1) {
-              std::cout << " ";
-            }
+        }
+        std::cout << std::endl;
+
+        std::cout << "LOOP: " << hdr->GetEventWindowTag().GetEventWindowTag(true) << " "
+                  << curBlockIdx << std::endl;
+
+        // Text format: timestamp strawidx tdc0 tdc1 nsamples sample0-11
+        // Example: 1 1113 36978 36829 12 1423 1390 1411 1354 2373 2392 2342 2254 1909 1611 1525
+        // 1438
+        std::cout << "GREPMETRK: " << hdr->GetEventWindowTag().GetEventWindowTag(true) << " ";
+        std::cout << sid.asUint16() << " ";
+        std::cout << tdc[0] << " ";
+        std::cout << tdc[1] << " ";
+        std::cout << tot[0] << " ";
+        std::cout << tot[1] << " ";
+        std::cout << pmp << " ";
+        std::cout << trkDataPair.second.size() << " ";
+        for (size_t i = 0; i < trkDataPair.second.size(); i++) {
+          std::cout << trkDataPair.second[i];
+          if (i < trkDataPair.second.size() - 1) {
+            std::cout << " ";
           }
-          std::cout << std::endl;
-        } // End debug output
-      }
+        }
+        std::cout << std::endl;
+      } // End debug output
     }
   }
 
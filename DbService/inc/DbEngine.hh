@@ -7,8 +7,14 @@
 // and extract a set of IoVs and calibration pointerss.  The DbHandle contacts
 // this class through the service, and asks the update method
 // for appropriate tables.  Database tables can be overridden by a text file.
+// If a snapshot file is given, the IoV structure and the tables are read
+// only from it, and the database is not contacted.
+// A table missing from the cache is read outside the lock, so only threads
+// asking for the same cid wait for that read; the others proceed.
 
 #include <chrono>
+#include <future>
+#include <map>
 #include <shared_mutex>
 
 #include "Offline/DbService/inc/DbReader.hh"
@@ -16,17 +22,21 @@
 #include "Offline/DbTables/inc/DbId.hh"
 #include "Offline/DbTables/inc/DbLiveTable.hh"
 #include "Offline/DbTables/inc/DbSet.hh"
+#include "Offline/DbTables/inc/DbSnapshot.hh"
 #include "Offline/DbTables/inc/DbTable.hh"
 #include "Offline/DbTables/inc/DbTableCollection.hh"
 #include "Offline/DbTables/inc/DbValCache.hh"
 #include "Offline/DbTables/inc/DbVersion.hh"
+#include "Offline/GeneralUtilities/inc/ObjectPool.hh"
 
 namespace mu2e {
 class DbEngine {
  public:
   DbEngine() :
       _verbose(0), _saveCsv(true), _nearestMatch(false), _initialized(false),
-      _lockWaitTime(0), _lockTime(0) {}
+      _prefetchThreads(4),
+      _readers([this]() { return std::make_unique<DbReader>(_reader); }),
+      _lockWaitTime(0), _lockTime(0), _fetchWaitTime(0) {}
   // the big read of the IOV structure is done in beginJob
   int beginJob();
   int endJob();
@@ -35,6 +45,10 @@ class DbEngine {
   void setVersion(DbVersion const& version) { _version = version; }
   // copy in the cache - optionally set before beginJob
   void setValCache(std::shared_ptr<DbValCache> vcache) { _vcache = vcache; }
+  // read only from this snapshot - optionally set before beginJob
+  void setSnapshot(std::shared_ptr<const DbSnapshot> snapshot) {
+    _snapshot = snapshot;
+  }
   // add tables directly - optionally set before beginJob
   void addOverride(DbTableCollection const& coll);
   void setVerbose(int verbose = 0) { _verbose = verbose; }
@@ -42,6 +56,8 @@ class DbEngine {
   void setSaveCsv(bool saveCsv) { _saveCsv = saveCsv; }
   // whether, if no perfect match, accept neaby data
   void setNearestMatch(bool nearestMatch) { _nearestMatch = nearestMatch; }
+  // number of concurrent database reads in prefetch
+  void setPrefetchThreads(int n) { _prefetchThreads = n; }
   // these should only be called in after startup
   std::shared_ptr<DbValCache>& valCache() { return _vcache; }
   DbReader& reader() { return _reader; }
@@ -49,6 +65,9 @@ class DbEngine {
   // these are the only methods that can be called from threads,
   // such as DbHandle, after the single-threaded configuration
   DbLiveTable update(int tid, uint32_t run, uint32_t subrun);
+  // read, concurrently, all the tables of the set valid for some part of
+  // this run, so that the first events of the run do not wait on the database
+  int prefetch(uint32_t run);
   // ruten tid for table name and reverce, for connecting handles
   int tidByName(std::string const& name);
 
@@ -58,6 +77,11 @@ class DbEngine {
   // set cid and tid for override text tables - called during intialization
   int setOverrideId();
   int updateOverrideTid();
+  // return the table from the cache, or read it, or wait for the thread
+  // already reading it
+  DbTable::cptr_t load(int tid, int cid, uint32_t run, uint32_t subrun);
+  // the database read itself, called without any lock
+  DbTable::cptr_t fetch(int tid, int cid, uint32_t run, uint32_t subrun);
 
   DbId _id;
   DbReader _reader;
@@ -68,15 +92,24 @@ class DbEngine {
   DbTableCollection _override;  // the text tables
   DbCache _cache;               // cache of table contents
   std::shared_ptr<DbValCache> _vcache;  // full db iov heirarchy
+  std::shared_ptr<const DbSnapshot> _snapshot;  // replaces the db if set
   bool _initialized;
   DbSet _dbset;                              // simple set of relevant iovs
   std::map<std::string, int> _overrideTids;  // fake tids for text tables
+  int _prefetchThreads;
+
+  // the tables being read, by cid, for threads needing the same table
+  std::map<int, std::shared_future<DbTable::cptr_t>> _inflight;
+  // readers for concurrent reads, configured like _reader
+  ObjectPool<DbReader> _readers;
 
   // lock for threaded access
   mutable std::shared_mutex _mutex;
   // count the time locked
   std::chrono::microseconds _lockWaitTime;
   std::chrono::microseconds _lockTime;
+  // count the time waiting for another thread to read a table
+  std::chrono::microseconds _fetchWaitTime;
 };
 }  // namespace mu2e
 #endif
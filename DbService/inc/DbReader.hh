@@ -31,6 +31,10 @@ class DbReader {
   };
 
   DbReader();
+  // a new reader with the same connection and settings, but its own
+  // curl handle and timers, so it can read concurrently with the original
+  DbReader(DbReader const& other);
+  DbReader& operator=(DbReader const&) = delete;
   ~DbReader();
 
   const DbId& id() const { return _id; }
@@ -60,6 +60,18 @@ class DbService {
         Name("nearestMatch"),
         Comment("if no proper IoV, accept nearby calibrations, default false"),
         false};
+    fhicl::OptionalAtom<std::string> snapshotFile{
+        Name("snapshotFile"),
+        Comment("read the IoVs and tables only from this file, made by "
+                "dbTool export-snapshot, and not from the database")};
+    fhicl::Atom<bool> prefetch{
+        Name("prefetch"),
+        Comment("at each beginRun, read all the tables valid in the run "
+                "concurrently, default false"),
+        false};
+    fhicl::OptionalAtom<int> prefetchThreads{
+        Name("prefetchThreads"),
+        Comment("number of concurrent database reads in prefetch (4)")};
     fhicl::Table<cacheConfig> cacheParameters{
         Name("cacheParameters"), Comment("database data caching details")};
   };
@@ -73,6 +85,7 @@ class DbService {
 
   // Functions registered for callbacks.
   void postBeginJob();
+  void preBeginRun(art::Run const& run);
   void postEndJob();
 
   // how the DbHandle interacts with this service
@@ -59,6 +59,7 @@ class DbTool {
   int printSet();
   int printRun();
   int printAdhoc();
+  int exportSnapshot();
 
   std::string getResult() { return _result; }
   int printCIDLine(int cid, int indent = 0);
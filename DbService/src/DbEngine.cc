@@ -2,6 +2,8 @@
 #include "Offline/DbService/inc/DbValTool.hh"
 #include "Offline/DbTables/inc/DbTableFactory.hh"
 #include "cetlib_except/exception.h"
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <iostream>
 #include <mutex>
@@ -35,9 +37,28 @@ int mu2e::DbEngine::beginJob() {
     return 0;
   }
 
+  // the snapshot only holds the calibrations of the set it was made for, so
+  // the purpose and the version, as given (unset fields included), must match
+  if (_snapshot) {
+    DbVersion snapVersion(_snapshot->purpose(), _snapshot->version());
+    if (snapVersion.purpose() != _version.purpose() ||
+        snapVersion.major() != _version.major() ||
+        snapVersion.minor() != _version.minor() ||
+        snapVersion.extension() != _version.extension()) {
+      throw cet::exception("DBENGINE_SNAPSHOT_MISMATCH")
+          << "DbEngine::beginJob snapshot " << _snapshot->fileName()
+          << " was made for " << snapVersion.to_string() << ", not "
+          << _version.to_string() << "\n";
+    }
+  }
+
   if (!_vcache) {  // if not already provided, create and fill it
     _vcache = std::make_shared<DbValCache>();
-    _reader.fillValTables(*_vcache);
+    if (_snapshot) {
+      _snapshot->fillValTables(*_vcache, _saveCsv);
+    } else {
+      _reader.fillValTables(*_vcache);
+    }
   }
 
   // use the purpose and version to fill the DbSet, the list of relevant iovs
@@ -124,59 +145,179 @@ mu2e::DbLiveTable mu2e::DbEngine::update(int tid, uint32_t run,
         << run << ":" << subrun << "\n";
   }
 
-  // if it wasn't found in cache, try to read from database
-  if (!ptr) {
+  // if it wasn't found in cache, read it from the database,
+  // or wait for the thread that is already reading it
+  if (!ptr) ptr = load(tid, cid, run, subrun);
+
+  // this code handles the case where an override takes effect
+  // in the middle of a database IOV - remove the override
+  // table interval from the database table's interval
+  for (auto& oltab : _override) {  // loop over override tables
+    if (oltab.tid() == tid) {      // if override is the right type
+      iov.subtract(oltab.iov(), run, subrun);
+    }
+  }
+
+  auto dblt = DbLiveTable(iov, ptr, tid, cid);
+
+  return dblt;
+}
+
+mu2e::DbTable::cptr_t mu2e::DbEngine::load(int tid, int cid, uint32_t run,
+                                           uint32_t subrun) {
+  std::promise<DbTable::cptr_t> promise;
+  std::shared_future<DbTable::cptr_t> future;
+  bool reading = false;
+  {
     auto stime = std::chrono::high_resolution_clock::now();
     std::unique_lock lock(_mutex);  // write lock
     auto mtime = std::chrono::high_resolution_clock::now();
-    auto dt =
+    _lockWaitTime +=
         std::chrono::duration_cast<std::chrono::microseconds>(mtime - stime);
-    _lockWaitTime += dt;
 
     // have to check if some other thread loaded it
-    // since the above read attempt
-    if (_cache.hasTable(cid)) {
-      ptr = _cache.get(cid);
-    } else {
-      auto const& tabledef = _vcache->valTables().row(tid);
-      // this makes the memory
-      auto ncptr = DbTableFactory::newTable(tabledef.name());
-      // the actual http read
-      int rc = _reader.fillTableByCid(ncptr, cid);
-
-      // reader does not abort, so do it here
-      if (rc != 0) {
-        auto const& tabledef = _vcache->valTables().row(tid);
-        throw cet::exception("DBENGINE_UPDATE_FAILED")
-            << " DbEngine::update failed to find table " << tabledef.name()
-            << " for run:subrun " << run << ":" << subrun << ", cid =" << cid
-            << ", rc =" << rc << "\n";
-      }
+    // since the read attempt in update
+    if (_cache.hasTable(cid)) return _cache.get(cid);
 
-      // make it const
-      ptr = std::const_pointer_cast<const mu2e::DbTable, mu2e::DbTable>(ncptr);
-      // push to cache
-      _cache.add(cid, ptr);
+    auto it = _inflight.find(cid);
+    if (it != _inflight.end()) {
+      future = it->second;
+    } else {
+      // this thread will read it, others needing it will wait on the future
+      future = promise.get_future().share();
+      _inflight[cid] = future;
+      reading = true;
     }
 
     auto etime = std::chrono::high_resolution_clock::now();
-    dt = std::chrono::duration_cast<std::chrono::microseconds>(etime - mtime);
-    _lockTime += dt;
-
+    _lockTime +=
+        std::chrono::duration_cast<std::chrono::microseconds>(etime - mtime);
   }  // write lock goes out of scope
 
-  // this code handles the case where an override takes effect
-  // in the middle of a database IOV - remove the override
-  // table interval from the database table's interval
-  for (auto& oltab : _override) {  // loop over override tables
-    if (oltab.tid() == tid) {      // if override is the right type
-      iov.subtract(oltab.iov(), run, subrun);
+  if (!reading) {
+    auto stime = std::chrono::high_resolution_clock::now();
+    // rethrows if the reading thread failed
+    auto ptr = future.get();
+    auto etime = std::chrono::high_resolution_clock::now();
+    std::unique_lock lock(_mutex);
+    _fetchWaitTime +=
+        std::chrono::duration_cast<std::chrono::microseconds>(etime - stime);
+    return ptr;
+  }
+
+  DbTable::cptr_t ptr;
+  try {
+    ptr = fetch(tid, cid, run, subrun);
+  } catch (...) {
+    {
+      std::unique_lock lock(_mutex);
+      _inflight.erase(cid);
     }
+    // the waiting threads get the same exception
+    promise.set_exception(std::current_exception());
+    throw;
   }
 
-  auto dblt = DbLiveTable(iov, ptr, tid, cid);
+  {
+    std::unique_lock lock(_mutex);
+    _cache.add(cid, ptr);
+    _inflight.erase(cid);
+  }
+  promise.set_value(ptr);
 
-  return dblt;
+  return ptr;
+}
+
+mu2e::DbTable::cptr_t mu2e::DbEngine::fetch(int tid, int cid, uint32_t run,
+                                            uint32_t subrun) {
+  auto const& tabledef = _vcache->valTables().row(tid);
+  // this makes the memory
+  auto ncptr = DbTableFactory::newTable(tabledef.name());
+  int rc;
+  if (_snapshot) {
+    rc = _snapshot->fillTableByCid(ncptr, cid, _saveCsv);
+    if (rc != 0) {
+      throw cet::exception("DBENGINE_UPDATE_FAILED")
+          << " DbEngine::update failed to find table " << tabledef.name()
+          << " for run:subrun " << run << ":" << subrun << ", cid =" << cid
+          << " in snapshot " << _snapshot->fileName() << ", made for runs "
+          << _snapshot->runs().to_string(true) << "\n";
+    }
+  } else {
+    // the actual http read, with a reader no other thread is using
+    auto reader = _readers.get();
+    rc = reader->fillTableByCid(ncptr, cid);
+  }
+
+  // reader does not abort, so do it here
+  if (rc != 0) {
+    throw cet::exception("DBENGINE_UPDATE_FAILED")
+        << " DbEngine::update failed to find table " << tabledef.name()
+        << " for run:subrun " << run << ":" << subrun << ", cid =" << cid
+        << ", rc =" << rc << "\n";
+  }
+
+  // make it const
+  return std::const_pointer_cast<const mu2e::DbTable, mu2e::DbTable>(ncptr);
+}
+
+int mu2e::DbEngine::prefetch(uint32_t run) {
+  lazyBeginJob();  // initialize if needed
+
+  // the tables valid for some part of this run, which are not in the cache
+  std::vector<std::pair<int, DbSet::EIoV>> todo;
+  {
+    std::shared_lock lock(_mutex);  // shared read lock
+    for (auto const& [tid, eiovs] : _dbset.emap()) {
+      for (auto const& eiov : eiovs) {
+        if (eiov.iov().startRun() <= run && run <= eiov.iov().endRun() &&
+            !_cache.hasTable(eiov.cid())) {
+          todo.emplace_back(tid, eiov);
+        }
+      }
+    }
+  }  // read lock goes out of scope
+  if (todo.empty()) return 0;
+
+  auto start_time = std::chrono::high_resolution_clock::now();
+
+  // a few threads take the tables from the list in turn
+  std::atomic<size_t> next(0);
+  auto work = [this, &todo, &next, run]() {
+    int nfail = 0;
+    for (size_t i = next++; i < todo.size(); i = next++) {
+      auto const& eiov = todo[i].second;
+      try {
+        load(todo[i].first, eiov.cid(), run, eiov.iov().startSubrun());
+      } catch (std::exception const& e) {
+        // not fatal here; update will try again if the table is needed
+        nfail++;
+        if (_verbose > 0) {
+          cout << "DbEngine::prefetch failed to read cid " << eiov.cid()
+               << ": " << e.what() << endl;
+        }
+      }
+    }
+    return nfail;
+  };
+  size_t nthreads = std::min(size_t(std::max(_prefetchThreads, 1)), todo.size());
+  std::vector<std::future<int>> workers;
+  for (size_t i = 0; i < nthreads; i++) {
+    workers.push_back(std::async(std::launch::async, work));
+  }
+  int nfail = 0;
+  for (auto& w : workers) nfail += w.get();
+
+  if (_verbose > 1) {
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto dt = std::chrono::duration_cast<std::chrono::microseconds>(
+        end_time - start_time);
+    cout << "DbEngine::prefetch read " << todo.size() - nfail
+         << " tables for run " << run << " in " << dt.count() * 1.0e-6
+         << " s" << endl;
+  }
+
+  return nfail;
 }
 
 int mu2e::DbEngine::tidByName(std::string const& name) {
@@ -318,12 +459,16 @@ int mu2e::DbEngine::endJob() {
   if (!_vcache) return 0;
   if (_verbose > 1) {
     std::cout << "DbEngine::endJob" << std::endl;
-    std::cout << "    Total time in reading DB: " << _reader.totalTime() << " s"
+    double readTime = _reader.totalTime();
+    _readers.forEach([&readTime](DbReader& r) { readTime += r.totalTime(); });
+    std::cout << "    Total time in reading DB: " << readTime << " s"
               << std::endl;
     std::cout << "    Total time waiting for locks: "
               << _lockWaitTime.count() * 1.0e-6 << " s" << std::endl;
     std::cout << "    Total time in locks: " << _lockTime.count() * 1.0e-6
               << " s" << std::endl;
+    std::cout << "    Total time waiting for other threads' reads: "
+              << _fetchWaitTime.count() * 1.0e-6 << " s" << std::endl;
     std::cout << "    valcache memory: " << _vcache->size() << " b"
               << std::endl;
     std::cout << "  Database cache stats:\n";
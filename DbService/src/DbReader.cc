@@ -2,23 +2,45 @@
 #include "Offline/DbService/inc/DbCurl.hh"
 #include "Offline/DbTables/inc/DbUtil.hh"
 #include "cetlib_except/exception.h"
+#include <cstdlib>
 #include <iomanip>
 #include <iostream>
+#include <mutex>
 #include <unistd.h>
 
 using namespace std;
 
+namespace {
+// curl_global_init is not thread safe, and readers are copied on worker
+// threads, so the global curl state is set up once per process and kept
+// until exit.  Each reader only makes its own easy handles.
+void initCurlGlobal() {
+  static std::once_flag once;
+  std::call_once(once, []() {
+    curl_global_init(CURL_GLOBAL_ALL);
+    std::atexit(curl_global_cleanup);
+  });
+}
+}  // namespace
+
 mu2e::DbReader::DbReader() :
     _curl_handle(nullptr), _timeout(3600), _totalTime(0), _removeHeader(true),
     _abortOnFail(true), _useCache(true), _cacheLifetime(0), _verbose(0),
     _timeVerbose(0), _saveCsv(true) {
-  // allocates memory for curl
-  curl_global_init(CURL_GLOBAL_ALL);
+  initCurlGlobal();
+}
+
+mu2e::DbReader::DbReader(DbReader const& other) :
+    _id(other._id), _curl_handle(nullptr), _timeout(other._timeout),
+    _totalTime(0), _removeHeader(other._removeHeader),
+    _abortOnFail(other._abortOnFail), _useCache(other._useCache),
+    _cacheLifetime(other._cacheLifetime), _verbose(other._verbose),
+    _timeVerbose(other._timeVerbose), _saveCsv(other._saveCsv) {
+  // the original has already set up the global curl state
 }
 
 mu2e::DbReader::~DbReader() {
-  // free memory
-  curl_global_cleanup();
+  // the global curl state is cleaned up at exit, see initCurlGlobal
 }
 
 int mu2e::DbReader::query(std::string& csv, const std::string& select,
@@ -2,6 +2,7 @@
 #include "Offline/DbService/inc/DbIdList.hh"
 #include "Offline/DbService/inc/DbService.hh"
 #include "Offline/DbTables/inc/DbUtil.hh"
+#include "art/Framework/Principal/Run.h"
 #include "art/Framework/Services/Registry/ServiceDefinitionMacros.h"
 #include "messagefacility/MessageLogger/MessageLogger.h"
 
@@ -14,6 +15,9 @@ DbService::DbService(Parameters const& config,
     _version(config().purpose(), config().version()) {
   // register callbacks
   iRegistry.sPostBeginJob.watch(this, &DbService::postBeginJob);
+  if (_config.prefetch()) {
+    iRegistry.sPreBeginRun.watch(this, &DbService::preBeginRun);
+  }
   iRegistry.sPostEndJob.watch(this, &DbService::postEndJob);
 
   if (_verbose > 0) {
@@ -42,6 +46,20 @@ DbService::DbService(Parameters const& config,
   _engine.setDbId(idList.getDbId(_config.dbName()));
   _engine.setVersion(_version);
 
+  // a local snapshot of the database replaces the database
+  std::string snapshotFile;
+  if (_config.snapshotFile(snapshotFile)) {
+    ConfigFileLookupPolicy configFile;
+    auto snapshot = std::make_shared<DbSnapshot>(configFile(snapshotFile));
+    if (_verbose > 0) {
+      std::cout << "DbService reading from snapshot " << snapshot->fileName()
+                << " with " << snapshot->nTables() << " tables for "
+                << snapshot->purpose() << " " << snapshot->version()
+                << " runs " << snapshot->runs().to_string(true) << std::endl;
+    }
+    _engine.setSnapshot(snapshot);
+  }
+
   // if there were text files containing calibrations,
   // then read them and tell the engine to let them override IOV
   std::vector<std::string> files;
@@ -71,6 +89,11 @@ DbService::DbService(Parameters const& config,
     _engine.reader().setTimeout(retryTimeout);
   }
 
+  int prefetchThreads = 0;
+  if (_config.prefetchThreads(prefetchThreads)) {
+    _engine.setPrefetchThreads(prefetchThreads);
+  }
+
   int64_t cacheLimit;
   if (_config.cacheParameters().cacheLimit(cacheLimit)) {
     _engine.cache().setLimitSize(cacheLimit);
@@ -103,6 +126,16 @@ DbService::~DbService() {}
 /********************************************************/
 void DbService::postBeginJob() {}
 
+/********************************************************/
+void DbService::preBeginRun(art::Run const& run) {
+  // read the tables for this run before the first event asks for them
+  int nfail = _engine.prefetch(uint32_t(run.run()));
+  if (nfail > 0 && _verbose > 0) {
+    std::cout << "DbService::preBeginRun failed to prefetch " << nfail
+              << " tables for run " << run.run() << std::endl;
+  }
+}
+
 /********************************************************/
 void DbService::postEndJob() {
   // just print summaries according to verbosity
@@ -1,6 +1,7 @@
 #include "Offline/DbService/inc/DbTool.hh"
 #include "Offline/DbService/inc/DbIdList.hh"
 #include "Offline/DbService/inc/DbValTool.hh"
+#include "Offline/DbTables/inc/DbSnapshot.hh"
 #include "Offline/DbTables/inc/DbTableFactory.hh"
 #include "cetlib_except/exception.h"
 #include <algorithm>
@@ -28,6 +29,7 @@ int mu2e::DbTool::run() {
   if (_action == "print-set") return printSet();
   if (_action == "print-run") return printRun();
   if (_action == "print-adhoc") return printAdhoc();
+  if (_action == "export-snapshot") return exportSnapshot();
 
   int iid, gid, eid;
   if (_action == "commit-calibration") return commitCalibration();
@@ -699,6 +701,75 @@ int mu2e::DbTool::printRun() {
   return 0;
 }
 
+// ****************************************  exportSnapshot
+
+int mu2e::DbTool::exportSnapshot() {
+  int rc = 0;
+
+  map_ss args;
+  args["purpose"] = "";
+  args["version"] = "";
+  args["run"] = "";
+  args["file"] = "";
+  if ((rc = getArgs(args))) return rc;
+  std::string purpose = args["purpose"];
+  std::string version = args["version"];
+  std::string runstr = args["run"];
+  std::string fn = args["file"];
+
+  if (purpose.empty()) {
+    std::cout << "Error - purpose is required" << std::endl;
+    return 1;
+  }
+  if (version.empty()) {
+    std::cout << "Error - version is required" << std::endl;
+    return 1;
+  }
+  if (fn.empty()) {
+    std::cout << "Error - file is required" << std::endl;
+    return 1;
+  }
+
+  DbIoV runs;
+  runs.setMax();
+  if (!runstr.empty()) runs.setByString(runstr);
+
+  DbVersion dbver(purpose, version);
+  DbValTool vtool(_valcache);
+  DbSet dbset;
+  vtool.fillSetVer(dbver, dbset);
+
+  // every calibration of the set valid for some part of the runs
+  DbTableCollection coll;
+  for (auto const& tp : dbset.emap()) {
+    std::string tname;
+    if (!vtool.nameByTid(tp.first, tname)) {
+      std::cout << "Error - did not recognize tid " << tp.first << std::endl;
+      return 1;
+    }
+    for (auto const& eiov : tp.second) {
+      if (eiov.iov().isOverlapping(runs) == 0) continue;
+      auto ptr = mu2e::DbTableFactory::newTable(tname);
+      rc = _reader.fillTableByCid(ptr, eiov.cid());
+      if (rc != 0) {
+        std::cout << "Error - could not retrieve CID " << eiov.cid()
+                  << std::endl;
+        return rc;
+      }
+      coll.emplace_back(eiov.iov(), ptr, tp.first, eiov.cid());
+    }
+  }
+
+  DbSnapshot::write(fn, dbver, runs, _valcache, coll);
+
+  if (_verbose > 0)
+    std::cout << "export-snapshot: wrote " << coll.size() << " tables for "
+              << dbver.to_string() << " runs " << runs.to_string(true)
+              << " to " << fn << std::endl;
+
+  return 0;
+}
+
 // ****************************************  printAdhoc
 
 int mu2e::DbTool::printAdhoc() {
@@ -2677,6 +2748,7 @@ int mu2e::DbTool::help() {
            "set\n"
            "    print-set : print all the data in a calibration set\n"
            "    print-run : print data for given run in a calibration set\n"
+           "    export-snapshot : write a calibration set to a snapshot file\n"
            "    \n"
            "    the following are for a calibration maintainer (subdetector "
            "roles)...\n"
@@ -2860,6 +2932,23 @@ int mu2e::DbTool::help() {
                  "    --table TABLENAME : only print for this table\n"
                  "    --content : print table content (requires --table)\n"
               << std::endl;
+  } else if (_action == "export-snapshot") {
+    std::cout
+        << " \n"
+           " dbTool export-snapshot [OPTIONS]\n"
+           " \n"
+           " Write the IoV structure and all the calibration tables of a\n"
+           " PURPOSE/VERSION, for a range of runs, to a binary snapshot file.\n"
+           " The DbService can read the snapshot (parameter snapshotFile)\n"
+           " instead of contacting the database.\n"
+           " \n"
+           " [OPTIONS]\n"
+           "    --purpose PURPOSE : the purpose (required)\n"
+           "    --version VERSION : the version (required)\n"
+           "    --run RUNS : the run range, like 1000-1100 or 1000:1-1000:9,\n"
+           "                 default is all runs\n"
+           "    --file FILENAME : the output file (required)\n"
+        << std::endl;
   } else if (_action == "print-adhoc") {
     std::cout
         << " \n"
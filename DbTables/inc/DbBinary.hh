@@ -0,0 +1,102 @@
+#ifndef DbTables_DbBinary_hh
+#define DbTables_DbBinary_hh
+
+// Typed, columnar binary form of a DbTable.  A table writes each of
+// its columns as one array of fixed-size values, and reads them back
+// with a memcpy per column, without any text parsing.  The layout is
+//   uint64 number of rows
+//   for each column: uint32 value size, uint32 (unused),
+//                    uint64 number of values, values padded to 8 bytes
+// Values are in the native byte order, as in DbSnapshot.
+
+#include "cetlib_except/exception.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace mu2e {
+
+class DbBinaryWriter {
+ public:
+  explicit DbBinaryWriter(std::size_t nrow) { put(uint64_t(nrow)); }
+
+  template <typename T>
+  void column(std::vector<T> const& values) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "DbBinaryWriter columns must be trivially copyable");
+    put(uint32_t(sizeof(T)));
+    put(uint32_t(0));
+    put(uint64_t(values.size()));
+    _data.append(reinterpret_cast<char const*>(values.data()),
+                 values.size() * sizeof(T));
+    _data.append((8 - _data.size() % 8) % 8, '\0');
+  }
+
+  std::string const& data() const { return _data; }
+
+ private:
+  template <typename T>
+  void put(T value) {
+    _data.append(reinterpret_cast<char const*>(&value), sizeof(T));
+  }
+
+  std::string _data;
+};
+
+class DbBinaryReader {
+ public:
+  DbBinaryReader(char const* data, std::size_t size) :
+      _data(data), _size(size), _pos(0) {
+    _nrow = get<uint64_t>();
+  }
+
+  std::size_t nrow() const { return _nrow; }
+
+  template <typename T>
+  void column(std::vector<T>& values) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "DbBinaryReader columns must be trivially copyable");
+    uint32_t vsize = get<uint32_t>();
+    get<uint32_t>();
+    uint64_t n = get<uint64_t>();
+    if (vsize != sizeof(T) || n != _nrow) {
+      throw cet::exception("DBBINARY_BAD_COLUMN")
+          << "DbBinaryReader found a column of " << n << " values of size "
+          << vsize << " where " << _nrow << " values of size " << sizeof(T)
+          << " were expected\n";
+    }
+    values.resize(n);
+    std::size_t nbytes = n * sizeof(T);
+    check(nbytes);
+    std::memcpy(values.data(), _data + _pos, nbytes);
+    _pos += nbytes + (8 - nbytes % 8) % 8;
+  }
+
+ private:
+  template <typename T>
+  T get() {
+    T value;
+    check(sizeof(T));
+    std::memcpy(&value, _data + _pos, sizeof(T));
+    _pos += sizeof(T);
+    return value;
+  }
+
+  void check(std::size_t nbytes) const {
+    if (_pos + nbytes > _size) {
+      throw cet::exception("DBBINARY_TRUNCATED")
+          << "DbBinaryReader buffer of " << _size
+          << " bytes ended while reading at " << _pos << "\n";
+    }
+  }
+
+  char const* _data;
+  std::size_t _size;
+  std::size_t _pos;
+  std::size_t _nrow;
+};
+
+}  // namespace mu2e
+#endif
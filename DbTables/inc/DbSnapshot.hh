@@ -0,0 +1,92 @@
+#ifndef DbTables_DbSnapshot_hh
+#define DbTables_DbSnapshot_hh
+
+// A local, read-only copy of part of the conditions database in one
+// binary file: the val tables (the IoV structure) and the contents of
+// every calibration (cid) used by a purpose/version in a run range.
+// It is written by "dbTool export-snapshot" and read by DbEngine when
+// DbService is configured with a snapshotFile, so that jobs start
+// without contacting the database servers.
+//
+// The file is mapped into memory, and a table is only read when it is
+// requested.  The file format is:
+//   header (magic, format, number of entries, index offset, run range)
+//   purpose and version text
+//   table payloads
+//   index of entries (cid, tid, encoding, offset, size), sorted by cid
+// The val tables are stored with negative cids.  A table that supports
+// it (DbTable::hasBinary) is stored in the columnar binary form of
+// DbBinary.hh, which is read without parsing text, the others as csv.  The integers are
+// written in the native byte order, so a snapshot is for use on the
+// same kind of machine it was written on.
+
+#include "Offline/DbTables/inc/DbIoV.hh"
+#include "Offline/DbTables/inc/DbTable.hh"
+#include "Offline/DbTables/inc/DbTableCollection.hh"
+#include "Offline/DbTables/inc/DbValCache.hh"
+#include "Offline/DbTables/inc/DbVersion.hh"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mu2e {
+
+class DbSnapshot {
+ public:
+  // how a table payload is written
+  enum Encoding : uint32_t { csv = 0, binary = 1 };
+
+  // one table in the file
+  struct Entry {
+    int32_t cid;
+    int32_t tid;
+    uint32_t encoding;
+    uint32_t spare;
+    uint64_t offset;  // of the payload, from the start of the file
+    uint64_t size;    // of the payload in bytes
+  };
+
+  // map the file, throws if it is not a snapshot
+  explicit DbSnapshot(std::string const& fn);
+  ~DbSnapshot();
+  DbSnapshot(DbSnapshot const&) = delete;
+  DbSnapshot& operator=(DbSnapshot const&) = delete;
+
+  std::string const& fileName() const { return _fn; }
+  std::string const& purpose() const { return _purpose; }
+  std::string const& version() const { return _version; }
+  // the runs the snapshot was made for
+  DbIoV const& runs() const { return _runs; }
+  // number of calibration tables (not counting val tables)
+  size_t nTables() const;
+  bool hasCid(int cid) const { return find(cid) != nullptr; }
+
+  // fill the val tables
+  void fillValTables(DbValCache& vcache, bool saveCsv = true) const;
+  // fill a calibration table; returns non-zero if the cid is not in the
+  // snapshot.  This only reads the mapped file, so it is thread-safe.
+  int fillTableByCid(DbTable::ptr_t const& ptr, int cid,
+                     bool saveCsv = true) const;
+
+  // write a snapshot of the val tables and the calibrations in coll
+  static void write(std::string const& fn, DbVersion const& version,
+                    DbIoV const& runs, DbValCache const& vcache,
+                    DbTableCollection const& coll);
+
+ private:
+  Entry const* find(int cid) const;
+  void fillTable(DbTable& table, Entry const& entry, bool saveCsv) const;
+
+  std::string _fn;
+  std::string _purpose;
+  std::string _version;
+  DbIoV _runs;
+  int _fd;
+  size_t _length;
+  char const* _data;
+  Entry const* _index;
+  size_t _nentries;
+};
+
+}  // namespace mu2e
+#endif
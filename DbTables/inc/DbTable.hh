@@ -9,6 +9,9 @@
 
 namespace mu2e {
 
+class DbBinaryWriter;
+class DbBinaryReader;
+
 class DbTable {
  public:
   typedef std::shared_ptr<mu2e::DbTable> ptr_t;
@@ -28,8 +31,11 @@ class DbTable {
   const std::string& dbname() const { return _dbname; }
   // the column names, written as in the db
   const std::string& query() const { return _query; }
-  // the table data in string format
+  // the table data in string format, empty unless saved at fill or
+  // made with toCsv()
   const std::string& csv() const { return _csv; }
+  // the table data in string format, made from the rows if not saved
+  std::string csvText() const;
   // number of rows - overridden by derived class
   virtual std::size_t nrow() const = 0;
   // expected nrows - overridden by derived class
@@ -45,6 +51,16 @@ class DbTable {
   int fill(const std::string& csv, bool saveCsv = true);
   // in case table was filled with binary values, convert to csv
   int toCsv();
+  // take the columnar binary form written by toBinary and build out the
+  // table contents; the csv text is only made if saveCsv is set
+  int fillBinary(const char* data, std::size_t size, bool saveCsv = false);
+
+  // true if the table can be written in the columnar binary form
+  virtual bool hasBinary() const { return false; }
+  // write the rows, one typed array per column
+  virtual void toBinary(DbBinaryWriter& writer) const;
+  // part of fillBinary, read the columns and build the rows
+  virtual void addBinary(DbBinaryReader& reader);
 
   // part of building content, convert list of strings to binary row
   virtual void addRow(const std::vector<std::string>& columns) = 0;
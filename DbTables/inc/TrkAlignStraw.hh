@@ -1,6 +1,7 @@
 #ifndef DbTables_TrkAlignStraw_hh
 #define DbTables_TrkAlignStraw_hh
 
+#include "Offline/DbTables/inc/DbBinary.hh"
 #include "Offline/DbTables/inc/DbTable.hh"
 #include "Offline/DbTables/inc/TrkStrawEndAlign.hh"
 #include "CLHEP/Vector/ThreeVector.h"
@@ -68,6 +69,42 @@ class TrkAlignStraw : public DbTable {
     sstream << r._straw_hv_dW;
   }
 
+  bool hasBinary() const override { return true; }
+
+  void toBinary(DbBinaryWriter& writer) const override {
+    std::vector<uint16_t> sid;
+    sid.reserve(_rows.size());
+    for (auto const& r : _rows) sid.push_back(r.id().asUint16());
+    writer.column(sid);
+    std::vector<float> col(_rows.size());
+    auto write = [&](float TrkStrawEndAlign::*member) {
+      for (std::size_t i = 0; i < _rows.size(); i++) col[i] = _rows[i].*member;
+      writer.column(col);
+    };
+    write(&TrkStrawEndAlign::_wire_cal_dV);
+    write(&TrkStrawEndAlign::_wire_cal_dW);
+    write(&TrkStrawEndAlign::_wire_hv_dV);
+    write(&TrkStrawEndAlign::_wire_hv_dW);
+    write(&TrkStrawEndAlign::_straw_cal_dV);
+    write(&TrkStrawEndAlign::_straw_cal_dW);
+    write(&TrkStrawEndAlign::_straw_hv_dV);
+    write(&TrkStrawEndAlign::_straw_hv_dW);
+  }
+
+  // the index is the row number, so it is not stored
+  void addBinary(DbBinaryReader& reader) override {
+    std::vector<uint16_t> sid;
+    reader.column(sid);
+    std::vector<float> col[8];
+    for (auto& c : col) reader.column(c);
+    _rows.reserve(_rows.size() + reader.nrow());
+    for (std::size_t i = 0; i < reader.nrow(); i++) {
+      _rows.emplace_back(int(_rows.size()), StrawId(sid[i]), col[0][i],
+                         col[1][i], col[2][i], col[3][i], col[4][i], col[5][i],
+                         col[6][i], col[7][i]);
+    }
+  }
+
   virtual void clear() {
     baseClear();
     _rows.clear();
@@ -1,6 +1,7 @@
 #ifndef DbTables_TrkDelayRStraw_hh
 #define DbTables_TrkDelayRStraw_hh
 
+#include "Offline/DbTables/inc/DbBinary.hh"
 #include "Offline/DbTables/inc/DbTable.hh"
 #include <iomanip>
 #include <map>
@@ -60,6 +61,31 @@ class TrkDelayRStraw : public DbTable {
     sstream << r.delayCal();
   }
 
+  bool hasBinary() const override { return true; }
+
+  void toBinary(DbBinaryWriter& writer) const override {
+    std::vector<float> delay_hv, delay_cal;
+    delay_hv.reserve(_rows.size());
+    delay_cal.reserve(_rows.size());
+    for (auto const& r : _rows) {
+      delay_hv.push_back(r.delayHv());
+      delay_cal.push_back(r.delayCal());
+    }
+    writer.column(delay_hv);
+    writer.column(delay_cal);
+  }
+
+  // the straw is the row number, so it is not stored
+  void addBinary(DbBinaryReader& reader) override {
+    std::vector<float> delay_hv, delay_cal;
+    reader.column(delay_hv);
+    reader.column(delay_cal);
+    _rows.reserve(_rows.size() + reader.nrow());
+    for (std::size_t i = 0; i < reader.nrow(); i++) {
+      _rows.emplace_back(int(_rows.size()), delay_hv[i], delay_cal[i]);
+    }
+  }
+
   virtual void clear() override {
     baseClear();
     _rows.clear();
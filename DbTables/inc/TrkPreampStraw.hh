@@ -1,6 +1,7 @@
 #ifndef DbTables_TrkPreampStraw_hh
 #define DbTables_TrkPreampStraw_hh
 
+#include "Offline/DbTables/inc/DbBinary.hh"
 #include "Offline/DbTables/inc/DbTable.hh"
 #include "cetlib_except/exception.h"
 #include <iomanip>
@@ -74,6 +75,36 @@ class TrkPreampStraw : public DbTable {
     sstream << r.gain();
   }
 
+  bool hasBinary() const override { return true; }
+
+  void toBinary(DbBinaryWriter& writer) const override {
+    std::vector<float> col(_rows.size());
+    auto write = [&](float (Row::*get)() const) {
+      for (std::size_t i = 0; i < _rows.size(); i++) col[i] = (_rows[i].*get)();
+      writer.column(col);
+    };
+    write(&Row::delayHv);
+    write(&Row::delayCal);
+    write(&Row::thresholdHv);
+    write(&Row::thresholdCal);
+    write(&Row::gain);
+  }
+
+  // the index is the row number, so it is not stored
+  void addBinary(DbBinaryReader& reader) override {
+    std::vector<float> delay_hv, delay_cal, threshold_hv, threshold_cal, gain;
+    reader.column(delay_hv);
+    reader.column(delay_cal);
+    reader.column(threshold_hv);
+    reader.column(threshold_cal);
+    reader.column(gain);
+    _rows.reserve(_rows.size() + reader.nrow());
+    for (std::size_t i = 0; i < reader.nrow(); i++) {
+      _rows.emplace_back(int(_rows.size()), delay_hv[i], delay_cal[i],
+                         threshold_hv[i], threshold_cal[i], gain[i]);
+    }
+  }
+
   virtual void clear() override {
     baseClear();
     _rows.clear();
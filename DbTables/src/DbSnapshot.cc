@@ -0,0 +1,244 @@
+#include "Offline/DbTables/inc/DbSnapshot.hh"
+#include "Offline/DbTables/inc/DbBinary.hh"
+#include "cetlib_except/exception.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <set>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char snapshotMagic[8] = {'M', 'U', '2', 'E', 'D', 'B', 'S', 'N'};
+const uint32_t snapshotFormat = 2;
+
+struct Header {
+  char magic[8];
+  uint32_t format;
+  uint32_t nentries;
+  uint64_t index;  // offset of the index
+  uint32_t startRun, startSubrun, endRun, endSubrun;
+  uint32_t purposeSize, versionSize;
+};
+
+// the val tables, in the order of their (negative) cids -1, -2, ...
+const std::vector<std::string> valNames = {
+    "ValTables",     "ValCalibrations", "ValIovs",       "ValGroups",
+    "ValGroupLists", "ValPurposes",     "ValLists",      "ValTableLists",
+    "ValVersions",   "ValExtensions",   "ValExtensionLists"};
+
+int valCid(size_t ival) { return -1 - int(ival); }
+
+}  // namespace
+
+mu2e::DbSnapshot::DbSnapshot(std::string const& fn) :
+    _fn(fn), _fd(-1), _length(0), _data(nullptr), _index(nullptr),
+    _nentries(0) {
+  _fd = ::open(fn.c_str(), O_RDONLY);
+  if (_fd < 0) {
+    throw cet::exception("DBSNAPSHOT_OPEN_FAILED")
+        << "DbSnapshot could not open file " << fn << "\n";
+  }
+  struct stat st;
+  if (::fstat(_fd, &st) != 0 || size_t(st.st_size) < sizeof(Header)) {
+    ::close(_fd);
+    throw cet::exception("DBSNAPSHOT_BAD_FILE")
+        << "DbSnapshot file " << fn << " is too short\n";
+  }
+  _length = st.st_size;
+  void* addr = ::mmap(nullptr, _length, PROT_READ, MAP_PRIVATE, _fd, 0);
+  if (addr == MAP_FAILED) {
+    ::close(_fd);
+    throw cet::exception("DBSNAPSHOT_MMAP_FAILED")
+        << "DbSnapshot could not map file " << fn << "\n";
+  }
+  _data = static_cast<char const*>(addr);
+
+  Header hdr;
+  std::memcpy(&hdr, _data, sizeof(Header));
+  size_t textEnd = sizeof(Header) + hdr.purposeSize + hdr.versionSize;
+  if (std::memcmp(hdr.magic, snapshotMagic, sizeof(snapshotMagic)) != 0 ||
+      hdr.format != snapshotFormat || textEnd > _length ||
+      hdr.index % alignof(Entry) != 0 ||
+      hdr.index + hdr.nentries * sizeof(Entry) > _length) {
+    ::munmap(addr, _length);
+    ::close(_fd);
+    throw cet::exception("DBSNAPSHOT_BAD_FILE")
+        << "DbSnapshot file " << fn << " is not a valid snapshot\n";
+  }
+  _purpose.assign(_data + sizeof(Header), hdr.purposeSize);
+  _version.assign(_data + sizeof(Header) + hdr.purposeSize, hdr.versionSize);
+  _runs.set(hdr.startRun, hdr.startSubrun, hdr.endRun, hdr.endSubrun);
+  _index = reinterpret_cast<Entry const*>(_data + hdr.index);
+  _nentries = hdr.nentries;
+}
+
+mu2e::DbSnapshot::~DbSnapshot() {
+  if (_data) ::munmap(const_cast<char*>(_data), _length);
+  if (_fd >= 0) ::close(_fd);
+}
+
+size_t mu2e::DbSnapshot::nTables() const {
+  return std::count_if(_index, _index + _nentries,
+                       [](Entry const& e) { return e.cid >= 0; });
+}
+
+mu2e::DbSnapshot::Entry const* mu2e::DbSnapshot::find(int cid) const {
+  auto end = _index + _nentries;
+  auto it = std::lower_bound(
+      _index, end, cid, [](Entry const& e, int c) { return e.cid < c; });
+  if (it == end || it->cid != cid) return nullptr;
+  return it;
+}
+
+void mu2e::DbSnapshot::fillTable(DbTable& table, Entry const& entry,
+                                 bool saveCsv) const {
+  if (entry.offset + entry.size > _length) {
+    throw cet::exception("DBSNAPSHOT_BAD_FILE")
+        << "DbSnapshot file " << _fn << " is truncated at cid " << entry.cid
+        << "\n";
+  }
+  if (entry.encoding == binary) {
+    table.fillBinary(_data + entry.offset, entry.size, saveCsv);
+  } else {
+    table.fill(std::string(_data + entry.offset, entry.size), saveCsv);
+  }
+}
+
+void mu2e::DbSnapshot::fillValTables(DbValCache& vcache, bool saveCsv) const {
+  auto fillVal = [this, saveCsv](DbTable& table) {
+    auto it = std::find(valNames.begin(), valNames.end(), table.name());
+    Entry const* entry = nullptr;
+    if (it != valNames.end()) entry = find(valCid(it - valNames.begin()));
+    if (entry == nullptr) {
+      throw cet::exception("DBSNAPSHOT_NO_VAL_TABLE")
+          << "DbSnapshot file " << _fn << " does not contain " << table.name()
+          << "\n";
+    }
+    fillTable(table, *entry, saveCsv);
+  };
+
+  ValTables tables;
+  fillVal(tables);
+  vcache.setValTables(tables);
+  ValCalibrations calibrations;
+  fillVal(calibrations);
+  vcache.setValCalibrations(calibrations);
+  ValIovs iovs;
+  fillVal(iovs);
+  vcache.setValIovs(iovs);
+  ValGroups groups;
+  fillVal(groups);
+  vcache.setValGroups(groups);
+  ValGroupLists grouplists;
+  fillVal(grouplists);
+  vcache.setValGroupLists(grouplists);
+  ValPurposes purposes;
+  fillVal(purposes);
+  vcache.setValPurposes(purposes);
+  ValLists lists;
+  fillVal(lists);
+  vcache.setValLists(lists);
+  ValTableLists tablelists;
+  fillVal(tablelists);
+  vcache.setValTableLists(tablelists);
+  ValVersions versions;
+  fillVal(versions);
+  vcache.setValVersions(versions);
+  ValExtensions extensions;
+  fillVal(extensions);
+  vcache.setValExtensions(extensions);
+  ValExtensionLists extensionlists;
+  fillVal(extensionlists);
+  vcache.setValExtensionLists(extensionlists);
+}
+
+int mu2e::DbSnapshot::fillTableByCid(DbTable::ptr_t const& ptr, int cid,
+                                     bool saveCsv) const {
+  Entry const* entry = find(cid);
+  if (cid < 0 || entry == nullptr) return 1;
+  fillTable(*ptr, *entry, saveCsv);
+  return 0;
+}
+
+void mu2e::DbSnapshot::write(std::string const& fn, DbVersion const& version,
+                             DbIoV const& runs, DbValCache const& vcache,
+                             DbTableCollection const& coll) {
+  std::ofstream out(fn, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    throw cet::exception("DBSNAPSHOT_OPEN_FAILED")
+        << "DbSnapshot could not open file " << fn << " for writing\n";
+  }
+
+  std::string purpose = version.purpose();
+  // unset fields are written as "*", so that DbVersion reads the text back
+  auto field = [](int v) { return v < 0 ? std::string("*") : std::to_string(v); };
+  std::string vtext = "v" + field(version.major()) + "_" +
+                      field(version.minor()) + "_" + field(version.extension());
+  Header hdr;
+  std::memset(&hdr, 0, sizeof(Header));
+  std::memcpy(hdr.magic, snapshotMagic, sizeof(snapshotMagic));
+  hdr.format = snapshotFormat;
+  hdr.startRun = runs.startRun();
+  hdr.startSubrun = runs.startSubrun();
+  hdr.endRun = runs.endRun();
+  hdr.endSubrun = runs.endSubrun();
+  hdr.purposeSize = purpose.size();
+  hdr.versionSize = vtext.size();
+  // the header is written again at the end, when the index is known
+  out.write(reinterpret_cast<char const*>(&hdr), sizeof(Header));
+  out.write(purpose.data(), purpose.size());
+  out.write(vtext.data(), vtext.size());
+  uint64_t offset = sizeof(Header) + purpose.size() + vtext.size();
+
+  std::vector<Entry> index;
+  auto addPayload = [&](int cid, int tid, DbTable const& table) {
+    std::string payload;
+    Encoding encoding = csv;
+    if (table.hasBinary()) {
+      // binary columns start on an 8-byte boundary
+      while (offset % 8 != 0) {
+        out.put(0);
+        offset++;
+      }
+      DbBinaryWriter writer(table.nrow());
+      table.toBinary(writer);
+      payload = writer.data();
+      encoding = binary;
+    } else {
+      payload = table.csvText();
+    }
+    out.write(payload.data(), payload.size());
+    index.push_back(Entry{cid, tid, encoding, 0, offset, payload.size()});
+    offset += payload.size();
+  };
+
+  for (size_t ival = 0; ival < valNames.size(); ival++) {
+    addPayload(valCid(ival), -1, vcache.asTable(valNames[ival]));
+  }
+  std::set<int> cids;
+  for (auto const& lt : coll) {
+    if (cids.insert(lt.cid()).second) addPayload(lt.cid(), lt.tid(), lt.table());
+  }
+
+  std::sort(index.begin(), index.end(),
+            [](Entry const& a, Entry const& b) { return a.cid < b.cid; });
+  // align the index so it can be used in place once mapped
+  while (offset % alignof(Entry) != 0) {
+    out.put(0);
+    offset++;
+  }
+  hdr.index = offset;
+  hdr.nentries = index.size();
+  out.write(reinterpret_cast<char const*>(index.data()),
+            index.size() * sizeof(Entry));
+  out.seekp(0);
+  out.write(reinterpret_cast<char const*>(&hdr), sizeof(Header));
+  if (!out) {
+    throw cet::exception("DBSNAPSHOT_WRITE_FAILED")
+        << "DbSnapshot failed writing file " << fn << "\n";
+  }
+}
@@ -1,4 +1,5 @@
 #include "Offline/DbTables/inc/DbTable.hh"
+#include "Offline/DbTables/inc/DbBinary.hh"
 #include "Offline/DbTables/inc/DbUtil.hh"
 #include "cetlib_except/exception.h"
 #include <boost/algorithm/string/split.hpp>
@@ -38,14 +39,55 @@ int mu2e::DbTable::fill(const std::string& csv, bool saveCsv) {
   return 0;
 }
 
+int mu2e::DbTable::fillBinary(const char* data, std::size_t size,
+                              bool saveCsv) {
+  DbBinaryReader reader(data, size);
+  addBinary(reader);
+
+  if (nrow() != reader.nrow()) {
+    throw cet::exception("DBTABLE_BAD_ROW_COUNT")
+        << "DbTable::fillBinary made " << nrow() << " rows from a buffer of "
+        << reader.nrow() << " rows while filling " << name();
+  }
+  if (nrowFix() > 0 && nrow() != nrowFix()) {
+    throw cet::exception("DBTABLE_BAD_ROW_COUNT")
+        << "DbTable::fillBinary row count is " << std::to_string(nrow())
+        << " but " << std::to_string(nrowFix())
+        << " is required while filling " << name();
+  }
+
+  _csv.clear();
+  if (saveCsv) toCsv();
+
+  return 0;
+}
+
 int mu2e::DbTable::toCsv() {
   if (!_csv.empty()) return 0;
-  std::ostringstream ss;
-  for (std::size_t i = 0; i < nrow(); i++) rowToCsv(ss, i);
-  _csv = ss.str();
+  _csv = csvText();
   return 0;
 }
 
+std::string mu2e::DbTable::csvText() const {
+  if (!_csv.empty() || nrow() == 0) return _csv;
+  std::ostringstream ss;
+  for (std::size_t i = 0; i < nrow(); i++) {
+    rowToCsv(ss, i);
+    ss << "\n";
+  }
+  return ss.str();
+}
+
+void mu2e::DbTable::toBinary(DbBinaryWriter& writer) const {
+  throw cet::exception("DBTABLE_FUNCTION_NOT_IMPLEMENTED")
+      << "DbTable::toBinary is not implemented for " << name() << "\n";
+}
+
+void mu2e::DbTable::addBinary(DbBinaryReader& reader) {
+  throw cet::exception("DBTABLE_FUNCTION_NOT_IMPLEMENTED")
+      << "DbTable::addBinary is not implemented for " << name() << "\n";
+}
+
 void mu2e::DbTable::addRow(const std::vector<std::string>& columns) {
   throw cet::exception("DBTABLE_FUNCTION_NOT_IMPLEMENTED")
       << "DbTable::addRow must be overridden ";
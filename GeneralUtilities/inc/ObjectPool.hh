@@ -0,0 +1,83 @@
+#ifndef GeneralUtilities_ObjectPool_hh
+#define GeneralUtilities_ObjectPool_hh
+//
+// A pool of reusable objects, for the per-event working state of shared
+// (multi-threaded) modules.  Each call to get() hands out an object that no
+// other thread is using, making a new one with the factory when all are
+// busy, and the object goes back to the pool when the returned handle goes
+// out of scope.  The pool therefore grows to the number of events the module
+// processes concurrently, and the objects keep their allocated buffers from
+// one event to the next.
+//
+// forEach() visits all the objects made so far, to update them between runs
+// or to collect their diagnostics at the end of the job; it must only be
+// called when no event is being processed by the module.
+//
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mu2e {
+
+  template <typename T>
+  class ObjectPool {
+    public:
+      using Factory = std::function<std::unique_ptr<T>()>;
+
+      // a handle on an object taken from the pool; it returns the object when destroyed
+      class Handle {
+        public:
+          Handle(ObjectPool& pool, T* obj) : _pool(&pool), _obj(obj) {}
+          Handle(Handle const&) = delete;
+          Handle& operator=(Handle const&) = delete;
+          Handle(Handle&& other) : _pool(other._pool), _obj(other._obj) { other._obj = nullptr; }
+          ~Handle() { if(_obj)_pool->release(_obj); }
+          T& operator*() const { return *_obj; }
+          T* operator->() const { return _obj; }
+        private:
+          ObjectPool* _pool;
+          T* _obj;
+      };
+
+      explicit ObjectPool(Factory factory) : _factory(std::move(factory)) {}
+      ObjectPool(ObjectPool const&) = delete;
+      ObjectPool& operator=(ObjectPool const&) = delete;
+
+      Handle get() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if(!_free.empty()){
+          T* obj = _free.back();
+          _free.pop_back();
+          return Handle(*this,obj);
+        }
+        // the factory is called under the lock, so it need not be thread-safe itself
+        // (ROOT objects, for example).  This only happens while the pool grows.
+        _all.push_back(_factory());
+        return Handle(*this,_all.back().get());
+      }
+
+      template <typename F> void forEach(F&& func) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for(auto& obj : _all) func(*obj);
+      }
+
+      // number of objects made so far
+      size_t size() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _all.size();
+      }
+
+    private:
+      void release(T* obj) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _free.push_back(obj);
+      }
+      Factory _factory;
+      mutable std::mutex _mutex;
+      std::vector<std::unique_ptr<T>> _all;
+      std::vector<T*> _free;
+  };
+}
+#endif
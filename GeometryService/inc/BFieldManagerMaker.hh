@@ -61,6 +61,12 @@ namespace mu2e {
                       const std::string& resolvedFileName,
                       const BFieldConfig& config);
 
+        // Create a map backed by a memory-mapped file written by writeMappedBinary.
+        void loadMapped(MapContainerType& whichMap,
+                        const std::string& key,
+                        const std::string& mappedFileName,
+                        const BFieldConfig& config);
+
         // Read a G4BL text format map.
         void readG4BLMap(const std::string& filename, BFGridMap& bfmap,
                          CLHEP::Hep3Vector offset);
@@ -73,6 +79,11 @@ namespace mu2e {
 
         // Write an existing BFMap in binary format.
         void writeG4BLBinary(const BFGridMap& bf, const std::string& outputfile);
+
+        // Write an existing BFMap in the memory-mappable format read by BFMappedGrid.
+        void writeMappedBinary(const BFGridMap& bf,
+                               const std::string& outputfile,
+                               bool singlePrecision);
         void flipMap(BFGridMap& bf);
 
     };  // end class BFieldManagerMaker
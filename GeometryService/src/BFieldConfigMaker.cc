@@ -43,6 +43,9 @@ namespace mu2e {
     BFieldConfigMaker::BFieldConfigMaker(const SimpleConfig& config, const Beamline& beamg)
         : bfconf_(new BFieldConfig()) {
         bfconf_->writeBinaries_ = config.getBool("bfield.writeG4BLBinaries", false);
+        bfconf_->writeMappedBinaries_ = config.getBool("bfield.writeMappedBinaries", false);
+        bfconf_->mappedSinglePrecision_ = config.getBool("bfield.mappedSinglePrecision", false);
+        bfconf_->useMappedMaps_ = config.getBool("bfield.useMappedMaps", false);
         bfconf_->verbosityLevel_ = config.getInt("bfield.verbosityLevel");
         bfconf_->flipBFieldMaps_ = config.getBool("bfield.flipMaps", false);
 
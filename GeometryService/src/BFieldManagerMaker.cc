@@ -5,9 +5,11 @@
 
 // Includes from C++
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <vector>
 
 // Includes from C ( needed for block IO ).
 #include <errno.h>
@@ -30,6 +32,7 @@
 
 // Includes from Mu2e
 #include "Offline/BFieldGeom/inc/BFInterpolationStyle.hh"
+#include "Offline/BFieldGeom/inc/BFMappedGrid.hh"
 #include "Offline/BFieldGeom/inc/BFieldConfig.hh"
 #include "Offline/BFieldGeom/inc/BFieldManager.hh"
 #include "Offline/GeneralUtilities/inc/MinMax.hh"
@@ -64,6 +67,10 @@ namespace mu2e {
             }
             return file;
         }
+        bool endsWith(std::string const& s, std::string const& suffix) {
+            return s.size() >= suffix.size() &&
+                   s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+        }
     }  // namespace
 
     //
@@ -148,6 +155,18 @@ namespace mu2e {
             }
         }
 
+        if (config.writeMappedBinaries()) {
+            for (auto mapptr : innerMaps) {
+                writeMappedBinary(dynamic_cast<const BFGridMap&>(*mapptr),
+                                  mapptr->getKey() + ".bfmap", config.mappedSinglePrecision());
+            }
+
+            for (auto mapptr : outerMaps) {
+                writeMappedBinary(dynamic_cast<const BFGridMap&>(*mapptr),
+                                  mapptr->getKey() + ".bfmap", config.mappedSinglePrecision());
+            }
+        }
+
         // For debug purposes: print the field in the target region
         if (bfieldVerbosityLevel > 0) {
             CLHEP::Hep3Vector b = _bfmgr->getBField(CLHEP::Hep3Vector(3900.0, 0.0, -6550.0));
@@ -377,6 +396,26 @@ namespace mu2e {
                                       const std::string& resolvedFileName,
                                       const BFieldConfig& config) {
 
+        // Maps in the mapped binary format are self-describing and need no G4BL header.
+        std::string mappedFileName;
+        if (endsWith(resolvedFileName, ".bfmap")) {
+            mappedFileName = resolvedFileName;
+        } else if (config.useMappedMaps() && endsWith(resolvedFileName, ".header")) {
+            // Look for the mapped file next to the header; else fall back to the .bin file.
+            std::string candidate =
+                resolvedFileName.substr(0, resolvedFileName.size() - 7) + ".bfmap";
+            if (access(candidate.c_str(), R_OK) == 0) {
+                mappedFileName = candidate;
+            } else if (bfieldVerbosityLevel > 0) {
+                cout << "No mapped field map " << candidate << ", reading " << resolvedFileName
+                     << endl;
+            }
+        }
+        if (!mappedFileName.empty()) {
+            loadMapped(mapContainer, key, mappedFileName, config);
+            return;
+        }
+
         // Extract information from the header.
         vector<double> X0;
         vector<int> dim;
@@ -407,6 +446,25 @@ namespace mu2e {
     }
 
 
+    // Create a map whose field values are read in place from a memory-mapped file.
+    void BFieldManagerMaker::loadMapped(MapContainerType& mapContainer,
+                                        const std::string& key,
+                                        const std::string& mappedFileName,
+                                        const BFieldConfig& config) {
+        auto grid = std::make_shared<const BFMappedGrid>(mappedFileName);
+        auto dsmap = std::make_shared<BFGridMap>(key, grid, BFMapType::G4BL,
+                                                 config.scaleFactor(),
+                                                 config.interpolationStyle());
+        if (bfieldVerbosityLevel > 0) {
+            cout << "Mapped " << mappedFileName << " ("
+                 << (grid->singlePrecision() ? "float" : "double") << ")" << endl;
+        }
+
+        if(config.flipBFieldMaps()) flipMap(*dsmap);
+
+        mapContainer.emplace_back(dsmap);
+    }
+
     //
     // Read one magnetic field map file in G4BL (TD) format.
     //
@@ -717,7 +775,19 @@ namespace mu2e {
         unsigned int deadbeef(0XDEADBEEF);
 
         // Address of the first element in the big array.
-        CLHEP::Hep3Vector const* fieldAddr = &bf._field.get(0, 0, 0);
+        // A mapped map has no in-memory array; make one.
+        std::vector<CLHEP::Hep3Vector> copy;
+        if (bf.isMapped()) {
+            copy.reserve(nPoints);
+            for (int ix = 0; ix < bf.nx(); ++ix) {
+                for (int iy = 0; iy < bf.ny(); ++iy) {
+                    for (int iz = 0; iz < bf.nz(); ++iz) {
+                        copy.push_back(bf.fieldAt(ix, iy, iz));
+                    }
+                }
+            }
+        }
+        CLHEP::Hep3Vector const* fieldAddr = bf.isMapped() ? copy.data() : &bf._field.get(0, 0, 0);
 
         // Open the output file.
         mode_t mode = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
@@ -762,8 +832,105 @@ namespace mu2e {
     }  // end BFieldManagerMaker::writeG4BLBinary
 
 
+    void BFieldManagerMaker::writeMappedBinary(const BFGridMap& bf,
+                                               const std::string& outputfile,
+                                               bool singlePrecision) {
+        // Fill the header.
+        BFMappedGrid::Header header =
+            BFMappedGrid::makeHeader(singlePrecision ? sizeof(float) : sizeof(double));
+        header.flipy = bf._flipy ? 1 : 0;
+        header.nx = bf.nx();
+        header.ny = bf.ny();
+        header.nz = bf.nz();
+        header.xmin = bf.xmin();
+        header.ymin = bf.ymin();
+        header.zmin = bf.zmin();
+        header.dx = bf.dx();
+        header.dy = bf.dy();
+        header.dz = bf.dz();
+        const size_t nPoints = size_t(bf.nx()) * bf.ny() * bf.nz();
+        header.payloadBytes = 3 * nPoints * header.bytesPerValue;
+
+        cout << "Writing G4BL Magnetic field map in mapped binary format ("
+             << (singlePrecision ? "float" : "double") << ") to file: " << outputfile << endl;
+
+        // Open the output file.
+        mode_t mode = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
+        int flags = O_CREAT | O_WRONLY | O_TRUNC | O_EXCL;
+        int fd = open(outputfile.c_str(), flags, mode);
+        int errsave = errno;
+
+        // Check for errors.
+        if (fd < 0) {
+            if (errsave == EEXIST) {
+                throw cet::exception("GEOM") << "BFieldManagerMaker:writeMappedBinary Error opening "
+                                             << outputfile << "  File already exists.\n";
+            }
+            char* errmsg = strerror(errsave);
+            throw cet::exception("GEOM")
+                << "BFieldManagerMaker:writeMappedBinary Error opening " << outputfile
+                << "  errno: " << errsave << " " << errmsg << "\n";
+        }
+
+        auto writeOrThrow = [&](const void* buf, size_t nbytes, const char* what) {
+            const char* p = static_cast<const char*>(buf);
+            while (nbytes > 0) {
+                ssize_t s = write(fd, p, nbytes);
+                if (s == -1) {
+                    int werr = errno;
+                    char* errmsg = strerror(werr);
+                    close(fd);
+                    throw cet::exception("GEOM")
+                        << "BFieldManagerMaker:writeMappedBinary Error writing " << what << " to "
+                        << outputfile << "  errno: " << werr << " " << errmsg << "\n";
+                }
+                p += s;
+                nbytes -= s;
+            }
+        };
+
+        // The header, padded so that the payload starts on a page boundary.
+        std::vector<char> head(header.payloadOffset, 0);
+        std::memcpy(head.data(), &header, sizeof(header));
+        writeOrThrow(head.data(), head.size(), "header");
+
+        // The field values, one z-row at a time, in Container3D order.
+        std::vector<float> frow;
+        std::vector<double> drow;
+        for (int ix = 0; ix < bf.nx(); ++ix) {
+            for (int iy = 0; iy < bf.ny(); ++iy) {
+                frow.clear();
+                drow.clear();
+                for (int iz = 0; iz < bf.nz(); ++iz) {
+                    CLHEP::Hep3Vector b = bf.fieldAt(ix, iy, iz);
+                    if (singlePrecision) {
+                        frow.insert(frow.end(), {float(b.x()), float(b.y()), float(b.z())});
+                    } else {
+                        drow.insert(drow.end(), {b.x(), b.y(), b.z()});
+                    }
+                }
+                if (singlePrecision) {
+                    writeOrThrow(frow.data(), frow.size() * sizeof(float), "field values");
+                } else {
+                    writeOrThrow(drow.data(), drow.size() * sizeof(double), "field values");
+                }
+            }
+        }
+
+        close(fd);
+
+        cout << "Writing complete for file: " << outputfile << endl;
+
+    }  // end BFieldManagerMaker::writeMappedBinary
+
     void BFieldManagerMaker::flipMap(BFGridMap& bf) {
         std::cout << "Flipping B field vector in map " << bf.getKey() << std::endl;
+        // Mapped field values are read-only; flipping every vector is the same as
+        // flipping the overall scale.
+        if (bf.isMapped()) {
+            bf._scaleFactor = -bf._scaleFactor;
+            return;
+        }
         for (int ix = 0; ix < bf.nx(); ++ix) {
             for (int iy = 0; iy < bf.ny(); ++iy) {
                 for (int iz = 0; iz < bf.nz(); ++iz) {
@@ -17,7 +17,7 @@ namespace mu2e {
           {}
 
           const art::Ptr<CaloShowerStep>&   caloShowerStep()  const {return step_;}
-          const std::vector<float>          PETime()          const {return PETime_;}
+          const std::vector<float>&         PETime()          const {return PETime_;}
           int                               SiPMID()          const {return SiPMID_;}
           unsigned                          NPE()             const {return PETime_.size();}
 
@@ -44,6 +44,8 @@ namespace mu2e {
       fhicl::OptionalTuple<int,double,int> ionToGenerate { Name("ionToGenerate") };
 
       fhicl::Atom<int> checkFieldMap {Name("checkFieldMap"), 0 };
+      fhicl::Atom<bool> printBFieldCacheStats {Name("printBFieldCacheStats"),
+          Comment("At endJob, print the hit rate per map of the field cell cache"), false};
 
       fhicl::Atom<bool> printElements {Name("printElements"), Comment("Print elements from constructMaterials()")};
       fhicl::Atom<bool> printMaterials {Name("printMaterials"), Comment("Print materials from constructMaterials()")};
@@ -8,9 +8,10 @@
 // Major rewrite Rob Kutschke at version 1.4
 //
 
+#include <memory>
 #include <string>
 
-#include "Offline/BFieldGeom/inc/BFCacheManager.hh"
+#include "Offline/BFieldGeom/inc/BFCellCache.hh"
 
 #include "Geant4/G4MagneticField.hh"
 #include "Geant4/G4Types.hh"
@@ -44,8 +45,9 @@ namespace mu2e {
     // Non-owning pointer to the field map object (it is owned by the geometry service).
     const BFieldManager* _map;
 
-    // A copy of the bfield cache manager - must be thread local.
-    BFCacheManager _cm;
+    // Last cell cache, with its own copy of the bfield cache manager - must be thread local.
+    // There is one instance of this class per G4 thread.
+    std::unique_ptr<BFCellCache> _cache;
 
   };
 }
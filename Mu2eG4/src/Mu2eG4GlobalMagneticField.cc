@@ -41,7 +41,7 @@ namespace mu2e {
     point -= _mapOrigin;
 
     // Look up BField and reformat to required return format.
-    const CLHEP::Hep3Vector bf = _map->getBField(point, _cm);
+    const CLHEP::Hep3Vector bf = _cache->getBField(point);
     Bfield[0] = bf.x()*CLHEP::tesla;
     Bfield[1] = bf.y()*CLHEP::tesla;
     Bfield[2] = bf.z()*CLHEP::tesla;
@@ -66,10 +66,10 @@ namespace mu2e {
     // Throws if the map is not found.
     _map = &*bfMgr;
 
-    _cm = bfMgr->cacheManager();
+    _cache = std::make_unique<BFCellCache>(*bfMgr);
 
       //std::cout << " from Thread #" << G4Threading::G4GetThreadId()
-      //<< ", address of CacheManager is " << &_cm << std::endl;
+      //<< ", address of CellCache is " << _cache.get() << std::endl;
   }
 
 } // end namespace mu2e
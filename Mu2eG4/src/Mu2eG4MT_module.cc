@@ -25,6 +25,7 @@
 #include "Offline/Mu2eG4/inc/writePhysicalVolumes.hh"
 #include "Offline/Mu2eG4/inc/Mu2eG4MTRunManager.hh"
 #include "Offline/Mu2eG4/inc/validGeometryOrThrow.hh"
+#include "Offline/BFieldGeom/inc/BFCellCache.hh"
 
 // Data products that will be produced by this module.
 #include "Offline/MCDataProducts/inc/GenParticle.hh"
@@ -54,6 +55,7 @@
 #include <iostream>
 #include <memory>
 #include <mutex>
+#include <sstream>
 #include <string>
 #include <thread>
 #include <utility>
@@ -117,6 +119,9 @@ namespace mu2e {
     bool  _exportPDTStart;
     bool  _exportPDTEnd;
 
+    // Print the hit rates of the field cell caches of all G4 threads at endJob.
+    bool  _printBFieldCacheStats;
+
     std::string storePhysicsTablesDir_;
 
     int _rmvlevel;
@@ -165,6 +170,7 @@ namespace mu2e {
     _warnEveryNewRun(pars().debug().warnEveryNewRun()),
     _exportPDTStart(pars().debug().exportPDTStart()),
     _exportPDTEnd(pars().debug().exportPDTEnd()),
+    _printBFieldCacheStats(pars().debug().printBFieldCacheStats()),
 
     storePhysicsTablesDir_(pars().debug().storePhysicsTablesDir()),
 
@@ -418,6 +424,12 @@ namespace mu2e {
 
     if ( _exportPDTEnd ) exportG4PDT( "End:" );
     physVolHelper_.endRun();
+
+    if ( _printBFieldCacheStats ) {
+      std::ostringstream os;
+      BFCellCache::printStatistics(os);
+      mf::LogInfo("Mu2eG4") << os.str();
+    }
   }
 
 
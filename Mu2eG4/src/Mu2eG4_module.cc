@@ -37,6 +37,7 @@
 #include "Offline/Mu2eG4/inc/Mu2eG4Config.hh"
 #include "Offline/Mu2eG4/inc/Mu2eG4IOConfigHelper.hh"
 #include "Offline/Mu2eG4/inc/validGeometryOrThrow.hh"
+#include "Offline/BFieldGeom/inc/BFCellCache.hh"
 #include "Offline/Mu2eG4/inc/writePhysicalVolumes.hh"
 #if ( defined G4VIS_USE_OPENGLX || defined G4VIS_USE_OPENGL || defined G4VIS_USE_OPENGLQT )
 #include "Offline/Mu2eG4/inc/Mu2eG4VisCommands.hh"
@@ -89,6 +90,7 @@
 #include <memory>
 #include <iomanip>
 #include <utility>
+#include <sstream>
 
 using namespace std;
 
@@ -136,6 +138,9 @@ namespace mu2e {
     bool  _exportPDTStart;
     bool  _exportPDTEnd;
 
+    // Print the hit rates of the field cell caches of all G4 threads at endJob.
+    bool  _printBFieldCacheStats;
+
     // to be able to make StorePhysicsTable call after the event loop started
     G4VUserPhysicsList* physicsList_;
     std::string storePhysicsTablesDir_;
@@ -198,6 +203,7 @@ namespace mu2e {
     _warnEveryNewRun(pars().debug().warnEveryNewRun()),
     _exportPDTStart(pars().debug().exportPDTStart()),
     _exportPDTEnd(pars().debug().exportPDTEnd()),
+    _printBFieldCacheStats(pars().debug().printBFieldCacheStats()),
 
     storePhysicsTablesDir_(pars().debug().storePhysicsTablesDir()),
 
@@ -458,6 +464,12 @@ namespace mu2e {
 
     if ( _exportPDTEnd ) exportG4PDT( "End:" );
     _physVolHelper.endRun();
+
+    if ( _printBFieldCacheStats ) {
+      std::ostringstream os;
+      BFCellCache::printStatistics(os);
+      mf::LogInfo("Mu2eG4") << os.str();
+    }
     _runManager.reset();
   }
 
@@ -1,9 +1,12 @@
 #ifndef Mu2eInterfaces_ProditionsCache_hh
 #define Mu2eInterfaces_ProditionsCache_hh
+#include <atomic>
 #include <memory>
 #include <tuple>
 #include <string>
 #include <set>
+#include <map>
+#include <vector>
 #include <shared_mutex>
 #include <mutex>
 #include <chrono>
@@ -13,33 +16,54 @@
 #include "Offline/DbTables/inc/DbIoV.hh"
 #include "Offline/Mu2eInterfaces/inc/ProditionsEntity.hh"
 
+//
+// The cache of one type of ProditionsEntity, shared by all threads.
+//
+// Entities already made are found under a shared (read) lock, in an
+// index of their intervals of validity sorted by the end of the
+// interval.  A new entity is made outside that lock, so threads
+// reading cached entities are never blocked by a slow construction
+// (AlignedTracker, StrawResponse, Mu2eMaterial...).
+//
+// Construction is serialized per cache, not per interval of validity.
+// The calls into the derived class (makeSet, makeIov, makeEntity) go
+// through DbHandle and ProditionsHandle members of the cache; DbHandle
+// has no lock, and makeIov reads the iov() each handle kept from the
+// preceding get(), so two makers of one cache cannot run at once even
+// for different intervals.  A thread that needs the entity another
+// thread is making waits on _makeMutex, then finds the new entity in
+// the index.  Making construction per interval would need handles
+// owned by each call rather than by the cache.
+//
+
 namespace mu2e {
   class ProditionsCache {
 
   protected:
 
-    // lock for threaded access
+    // lock for threaded access to the index
     std::shared_mutex _mutex;
-
-    // count the time waiting and locked
-    std::chrono::microseconds _lockWaitTime;
-    std::chrono::microseconds _lockTime;
-
+    // serializes calls into the derived class, whose handles are
+    // shared by every interval of this cache
+    std::mutex _makeMutex;
 
   public:
     typedef std::shared_ptr<ProditionsCache> ptr;
     typedef std::tuple<ProditionsEntity::ptr,DbIoV> ret_t;
     typedef ProditionsEntity::set_t set_t;
 
-    // what is actually held in the cache
-    // new iovs are added if the data is the same
+    // what is actually held in the cache: an interval of
+    // validity and its entity, which may be shared by several
+    // intervals if the data is the same
     struct cacheItem {
       ProditionsEntity::ptr _p;
-      std::vector<DbIoV> _iovs;
+      DbIoV _iov;
     };
 
     ProditionsCache(std::string name, int verbose=0):
-      _name(name),_verbose(verbose),_initialized(false) {}
+      _lockWaitTime(0),_lockTime(0),_makeWaitTime(0),_makeTime(0),
+      _nMade(0),_nIovs(0),
+      _name(name),_verbose(verbose) {}
     virtual ~ProditionsCache() {}
 
     // the following are provided by the
@@ -60,130 +84,170 @@ namespace mu2e {
     // this is the main call to the cache asking for an existing
     // entity, creating and cacheing a new entity as needed
     ret_t update(art::EventID const& eid) {
-      // do lazy initialization, don't bother with
-      // read lock since a bool can't be partially constructed
-      if(!_initialized) {
-        //gain write lock
-        auto stime = std::chrono::high_resolution_clock::now();
-        std::unique_lock lock(_mutex); // write lock
-        auto mtime = std::chrono::high_resolution_clock::now();
-        auto dt = std::chrono::duration_cast<std::chrono::microseconds>
-                                               ( mtime - stime );
-         _lockWaitTime += dt;
-        // check if another thread initialized while we were
-        // waiting for write lock
-        if(!_initialized) {
-          // derived class creates database and service dependencies
-          initialize();
-          _initialized = true;
-        }
-        auto etime = std::chrono::high_resolution_clock::now();
-        dt = std::chrono::duration_cast<std::chrono::microseconds>
-                                               ( etime - mtime );
-        _lockTime += dt;  // time we spent write locked
-      } // end initialize, write lock out of scope, released
-
-      // gain shared read lock to find what
-      // set of tables are needed
-      bool made = false;
-      bool found = false;
-      ProditionsEntity::ptr p;
-      set_t cids;
+      // lazy initialization, the derived class creates database
+      // and service dependencies
+      std::call_once(_initFlag,[this](){ initialize(); });
+
       DbIoV iov;
-      { // start read lock scope
-        std::shared_lock lock(_mutex);
-        p = findByRun(eid,iov);  // if found, iov is valid
-      } // end read lock lifetime
-
-      // if it was not found in cache, make it
-      if(!p) {
-        //gain write lock
-        auto stime = std::chrono::high_resolution_clock::now();
-        std::unique_lock lock(_mutex); // write lock
-        auto mtime = std::chrono::high_resolution_clock::now();
-        auto dt = std::chrono::duration_cast<std::chrono::microseconds>
-                                               ( mtime - stime );
-         _lockWaitTime += dt;
-         // need to check again in case another thread made it
-         // between read lock and write lock
-         p = findByRun(eid,iov);
-         if(!p) {
-
-           p = makeEntity(eid);
-           cids = makeSet(eid);
-           p->addCids(cids);
-           iov = makeIov(eid);
-
-           // at this point, we might have existing cache items with
-           // the same cids, but not the relevant iov,
-           // in this case just add the iov
-           for(auto& ci : _cache) {
-             if(ci._p->getCids()==cids) {
-               ci._iovs.emplace_back(iov);
-               found = true;
-               break;
-             }
-           }
-           if(!found) {
-             cacheItem ci;
-             ci._p = p;
-             ci._iovs.emplace_back(iov);
-             _cache.emplace_back(ci);
-             made = true;
-             if(_verbose>7) p->print(std::cout);
-           }
-         } // p not found
-
-         auto etime = std::chrono::high_resolution_clock::now();
-         dt = std::chrono::duration_cast<std::chrono::microseconds>
-                                               ( etime - mtime );
-        _lockTime += dt;  // time we spent write locked
-
-      } // endif not in cache, write lock now destroyed
-
-      if(_verbose>1) {
-        if(made) {
-          if(found) {
-            std::cout<< "ProditionsCache::update made new iov for "
-                     << name() << std::endl;
-          } else {
-            std::cout<< "ProditionsCache::update made new "
-                     << name() << std::endl;
-          }
-        } else {
-          std::cout<< "ProditionsCache::update return cached "<< name() << std::endl;
-        }
-        std::cout << "     iov " << iov.to_string(true);
-        std::cout << "     cids ";
-        for(auto cid : cids) std::cout << cid << " " ;
-        std::cout << std::endl;
+      ProditionsEntity::ptr p = findShared(eid,iov);
+      if(p) {
+        if(_verbose>1) print("return cached",iov,p->getCids());
+        return std::make_tuple(p,iov);
+      }
+
+      // not in the cache, make it
+      auto stime = std::chrono::high_resolution_clock::now();
+      std::lock_guard<std::mutex> make(_makeMutex);
+      auto mtime = std::chrono::high_resolution_clock::now();
+      addTime(_makeWaitTime,stime,mtime);
+
+      // need to check again in case another thread made it
+      // while we waited
+      p = findShared(eid,iov);
+      if(p) {
+        if(_verbose>1) print("return cached",iov,p->getCids());
+        return std::make_tuple(p,iov);
+      }
+
+      set_t cids = makeSet(eid);
+      iov = makeIov(eid);
+
+      // at this point, we might have an existing entity with the
+      // same cids, but not the relevant iov, in this case just add
+      // the iov.  _byCids is only used under _makeMutex
+      bool found = false;
+      auto ic = _byCids.find(cids);
+      if(ic!=_byCids.end()) {
+        p = ic->second;
+        found = true;
+      } else {
+        p = makeEntity(eid);
+        p->addCids(cids);
+        _byCids.emplace(cids,p);
+        _nMade++;
+        if(_verbose>7) p->print(std::cout);
       }
 
+      { // write lock, only to insert in the index
+        auto wtime = std::chrono::high_resolution_clock::now();
+        std::unique_lock lock(_mutex);
+        auto ltime = std::chrono::high_resolution_clock::now();
+        addTime(_lockWaitTime,wtime,ltime);
+        insert(iov,p);
+        _nIovs++;
+        addTime(_lockTime,ltime,std::chrono::high_resolution_clock::now());
+      }
+
+      addTime(_makeTime,mtime,std::chrono::high_resolution_clock::now());
+
+      if(_verbose>1) print(found ? "made new iov for" : "made new",
+                           iov,cids);
+
       return std::make_tuple(p,iov);
 
     } // end update
 
     // is there a cache entry covering this run/subrun?
-    // return good pointer or null, and fill iov
+    // return good pointer or null, and fill iov.
+    // The caller must hold _mutex, shared or exclusive
     ProditionsEntity::ptr  findByRun(art::EventID eid, DbIoV& iov) {
       uint32_t run = eid.run();
       uint32_t subrun = eid.subRun();
-      for(auto const& ci : _cache) {
-        for(auto const& ii : ci._iovs) {
-          if(ii.inInterval(run,subrun)) {
-            iov = ii;
-            return ci._p;
-          }
+      // the first interval ending at or after this run/subrun
+      auto it = _index.lower_bound(key(run,subrun));
+      if(it!=_index.end() && it->second._iov.inInterval(run,subrun)) {
+        iov = it->second._iov;
+        return it->second._p;
+      }
+      for(auto const& ci : _overlaps) {
+        if(ci._iov.inInterval(run,subrun)) {
+          iov = ci._iov;
+          return ci._p;
         }
       }
       return ProditionsEntity::ptr();
     }
 
+    // timing and counts, for monitoring
+    double lockWaitTime() const { return _lockWaitTime*1.0e-6; } // s
+    double lockTime() const { return _lockTime*1.0e-6; } // s
+    double makeWaitTime() const { return _makeWaitTime*1.0e-6; } // s
+    double makeTime() const { return _makeTime*1.0e-6; } // s
+    size_t nMade() const { return _nMade; }
+    size_t nIovs() const { return _nIovs; }
+
+    void printStats(std::ostream& os = std::cout) const {
+      os << "  " << name() << ": " << nMade() << " entities for "
+         << nIovs() << " iovs" << std::endl;
+      os << "    time making entities: " << makeTime() << " s, waiting for "
+         << "other threads making: " << makeWaitTime() << " s" << std::endl;
+      os << "    time waiting for locks: " << lockWaitTime()
+         << " s, in write locks: " << lockTime() << " s" << std::endl;
+    }
+
+  protected:
+    // times in microseconds, summed over threads
+    std::atomic<long long> _lockWaitTime;
+    std::atomic<long long> _lockTime;
+    std::atomic<long long> _makeWaitTime;
+    std::atomic<long long> _makeTime;
+    std::atomic<size_t> _nMade;
+    std::atomic<size_t> _nIovs;
+
   private:
+
+    static uint64_t key(uint32_t run, uint32_t subrun) {
+      return (uint64_t(run)<<32) | subrun;
+    }
+
+    static void addTime(std::atomic<long long>& total,
+                        std::chrono::high_resolution_clock::time_point t0,
+                        std::chrono::high_resolution_clock::time_point t1) {
+      total += std::chrono::duration_cast<std::chrono::microseconds>
+                                               ( t1 - t0 ).count();
+    }
+
+    ProditionsEntity::ptr findShared(art::EventID const& eid, DbIoV& iov) {
+      auto stime = std::chrono::high_resolution_clock::now();
+      std::shared_lock lock(_mutex);
+      addTime(_lockWaitTime,stime,std::chrono::high_resolution_clock::now());
+      return findByRun(eid,iov);
+    }
+
+    // add to the index, the caller holds the write lock.  The intervals
+    // of one cache are normally disjoint; if the new one overlaps one
+    // already indexed, it is kept aside and searched linearly
+    void insert(DbIoV const& iov, ProditionsEntity::ptr const& p) {
+      cacheItem ci{p,iov};
+      auto it = _index.lower_bound(key(iov.startRun(),iov.startSubrun()));
+      bool overlaps = it!=_index.end() &&
+        key(it->second._iov.startRun(),it->second._iov.startSubrun())
+        <= key(iov.endRun(),iov.endSubrun());
+      if(overlaps) {
+        _overlaps.emplace_back(ci);
+      } else {
+        _index.emplace(key(iov.endRun(),iov.endSubrun()),ci);
+      }
+    }
+
+    void print(const char* what, DbIoV const& iov,
+               set_t const& cids) const {
+      std::cout<< "ProditionsCache::update " << what << " "
+               << name() << std::endl;
+      std::cout << "     iov " << iov.to_string(true);
+      std::cout << "     cids ";
+      for(auto cid : cids) std::cout << cid << " " ;
+      std::cout << std::endl;
+    }
+
     std::string _name;
     int _verbose;
-    bool _initialized;
-    std::vector<cacheItem> _cache;
+    std::once_flag _initFlag;
+    // intervals of validity by the end of the interval
+    std::map<uint64_t,cacheItem> _index;
+    std::vector<cacheItem> _overlaps;
+    // entities by the set of cids they were made from
+    std::map<set_t,ProditionsEntity::ptr> _byCids;
 
   };
 
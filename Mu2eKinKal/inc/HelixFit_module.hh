@@ -9,7 +9,7 @@
 #include "fhiclcpp/types/Table.h"
 #include "fhiclcpp/types/Tuple.h"
 #include "fhiclcpp/types/OptionalAtom.h"
-#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Core/SharedProducer.h"
 #include "art/Framework/Principal/Event.h"
 #include "art/Framework/Principal/Run.h"
 #include "art/Framework/Principal/Handle.h"
@@ -127,13 +127,15 @@ namespace mu2e {
     double zval_; // z value required
   };
 
-  class HelixFit : public art::EDProducer {
+  // Events are fit concurrently: the fit helpers are only used through const methods, and the
+  // proditions handles are thread-safe.  Data members are only written at construction and beginRun
+  class HelixFit : public art::SharedProducer {
     public:
-      using Parameters = art::EDProducer::Table<HelixFitConfig>;
+      using Parameters = art::SharedProducer::Table<HelixFitConfig>;
       explicit HelixFit(const Parameters& settings,TrkFitFlag fitflag);
       virtual ~HelixFit() {}
-      void beginRun(art::Run& run) override;
-      void produce(art::Event& event) override;
+      void beginRun(art::Run& run, art::ProcessingFrame const&) override;
+      void produce(art::Event& event, art::ProcessingFrame const&) override;
     protected:
       TrkFitFlag fitflag_;
       // parameter-specific functions that need to be overridden in subclasses
@@ -159,12 +161,12 @@ namespace mu2e {
       std::unique_ptr<KinKal::BFieldMap> kkbf_;
       Config config_; // initial fit configuration object
       Config exconfig_; // extension configuration object
-      KinKal::ExtraConfig xconfig_; // tolerance and maximum Dt when extrapolating
+      KinKal::ExtraConfig xconfig_; // tolerance and maximum Dt when extrapolating; the direction is set per track
       bool fixedfield_; // special case usage for seed fits, if no BField corrections are needed
       SurfaceMap::SurfacePairCollection extrap_; // surfaces to extrapolate the fit to
   };
 
-  HelixFit::HelixFit(const Parameters& settings,TrkFitFlag fitflag) : art::EDProducer{settings},
+  HelixFit::HelixFit(const Parameters& settings,TrkFitFlag fitflag) : art::SharedProducer{settings},
     fitflag_(fitflag),
     chcol_T_(consumes<ComboHitCollection>(settings().modSettings().comboHitCollection())),
     cccol_T_(mayConsume<CaloClusterCollection>(settings().modSettings().caloClusterCollection())),
@@ -208,9 +210,10 @@ namespace mu2e {
       // configuration for extrapolation
       xconfig_.tol_ = settings().modSettings().extrapTol();
       xconfig_.maxdt_ = settings().modSettings().extrapMaxDt();
+      async<art::InEvent>();
     }
 
-  void HelixFit::beginRun(art::Run& run) {
+  void HelixFit::beginRun(art::Run& run, art::ProcessingFrame const&) {
     // setup things that rely on data related to beginRun
     auto const& ptable = GlobalConstantsHandle<ParticleDataList>();
     mass_ = ptable->particle(fpart_).mass();
@@ -224,7 +227,7 @@ namespace mu2e {
     if(print_ > 0) kkbf_->print(std::cout);
   }
 
-  void HelixFit::produce(art::Event& event ) {
+  void HelixFit::produce(art::Event& event, art::ProcessingFrame const&) {
     GeomHandle<Calorimeter> calo_h;
     // find current proditions
     auto const& strawresponse = strawResponse_h_.getPtr(event.id());
@@ -233,6 +236,8 @@ namespace mu2e {
     auto ch_H = event.getValidHandle<ComboHitCollection>(chcol_T_);
     auto cc_H = event.getValidHandle<CaloClusterCollection>(cccol_T_);
     auto const& chcol = *ch_H;
+    // index of the hits that can be added to the tracks, shared by all the fits of this event
+    auto chindex = kkfit_.hitIndex(chcol);
     // create output
     unique_ptr<KKTRKCOL> kktrkcol(new KKTRKCOL );
     unique_ptr<KalSeedCollection> kkseedcol(new KalSeedCollection );
@@ -297,7 +302,7 @@ namespace mu2e {
             auto goodfit = goodFit(*kktrk);
             // if we have an extension schedule, extend.
             if(goodfit && exconfig_.schedule().size() > 0) {
-              kkfit_.extendTrack(exconfig_,*kkbf_, *tracker,*strawresponse, kkmat_.strawMaterial(), chcol, *calo_h, cc_H, *kktrk );
+              kkfit_.extendTrack(exconfig_,*kkbf_, *tracker,*strawresponse, kkmat_.strawMaterial(), chindex, *calo_h, cc_H, *kktrk );
               goodfit = goodFit(*kktrk);
             }
             // extrapolate as required
@@ -306,18 +311,19 @@ namespace mu2e {
               auto const& ftraj = kktrk->fitTraj();
               bool downstream = ftraj.momentum3(ftraj.range().mid()).Z() > 0.0; // replace with momentum at tracker middle TODO
               const static VEC3 opos(0.0,0.0,0.0);
+              auto xconfig = xconfig_;
               for(auto const& surf : extrap_){
                 // configure the extrapolation time direction according to the surface and the track momentum direction
                 if(surf.first.id() == SurfaceIdEnum::TT_Front){
-                  xconfig_.xdir_ = downstream ? TimeDir::backwards : TimeDir::forwards;
+                  xconfig.xdir_ = downstream ? TimeDir::backwards : TimeDir::forwards;
                   double zpos = surf.second->tangentPlane(opos).center().Z(); // this is crude: I need an accessor that knows the TT_Front is a plane TODO
-                  ExtrapolateToZ xtoz(*kktrk,xconfig_.xdir_,zpos);
-                  kktrk->extrapolate(xconfig_,xtoz);
+                  ExtrapolateToZ xtoz(*kktrk,xconfig.xdir_,zpos);
+                  kktrk->extrapolate(xconfig,xtoz);
                 } else if(surf.first.id() == SurfaceIdEnum::TT_Back){
-                  xconfig_.xdir_ = downstream ? TimeDir::forwards : TimeDir::backwards;
+                  xconfig.xdir_ = downstream ? TimeDir::forwards : TimeDir::backwards;
                   double zpos = surf.second->tangentPlane(opos).center().Z();
-                  ExtrapolateToZ xtoz(*kktrk,xconfig_.xdir_,zpos);
-                  kktrk->extrapolate(xconfig_,xtoz);
+                  ExtrapolateToZ xtoz(*kktrk,xconfig.xdir_,zpos);
+                  kktrk->extrapolate(xconfig,xtoz);
                 } else if(surf.first.id() == SurfaceIdEnum::TT_Outer){
                   // extrapolate in both time directions
                 }
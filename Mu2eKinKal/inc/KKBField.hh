@@ -30,6 +30,10 @@ namespace mu2e
       bool inRange(VEC3 const& position) const override;
       void print(std::ostream& os ) const override;
     private:
+      // field gradient (grad[j] = dB/dx_j) at a point in detector coordinates; false if outside all maps
+      bool fieldAndGrad(VEC3 const& position, CLHEP::Hep3Vector grad[3]) const;
+      // throw for out-of-range points unless this is the no-field case
+      void checkNoField(CLHEP::Hep3Vector const& vpoint_mu2e) const;
       BFieldManager const& bfmgr_;
       DetectorSystem const& det_;
   };
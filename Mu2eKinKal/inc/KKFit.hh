@@ -11,6 +11,7 @@
 #include "Offline/Mu2eKinKal/inc/KKCaloHit.hh"
 #include "Offline/Mu2eKinKal/inc/KKFitUtilities.hh"
 #include "Offline/Mu2eKinKal/inc/KKFitSettings.hh"
+#include "Offline/Mu2eKinKal/inc/KKHitIndex.hh"
 #include "Offline/Mu2eKinKal/inc/WireHitState.hh"
 // art includes
 #include "canvas/Persistency/Common/Ptr.h"
@@ -41,8 +42,10 @@
 // Other
 #include "cetlib_except/exception.h"
 #include <memory>
+#include <mutex>
 #include <cmath>
 #include <algorithm>
+#include <vector>
 namespace mu2e {
   using KinKal::SensorLine;
   using KinKal::TimeRange;
@@ -91,9 +94,11 @@ namespace mu2e {
           KKSTRAWHITCOL& hits, KKSTRAWXINGCOL& exings) const;
       SensorLine caloAxis(CaloCluster const& cluster, Calorimeter const& calo) const; // should come from CaloCluster TODO
       bool makeCaloHit(CCPtr const& cluster, Calorimeter const& calo, PKTRAJ const& pktraj, KKCALOHITCOL& hits) const;
+      // index of the hits that can be added to tracks; build once per event and use for all the tracks of that event
+      KKHitIndex hitIndex(ComboHitCollection const& chcol) const { return KKHitIndex(chcol,addsel_,addrej_); }
       // extend a track with a new configuration, optionally searching for and adding hits and straw material
       void extendTrack(Config const& config, BFieldMap const& kkbf, Tracker const& tracker,
-          StrawResponse const& strawresponse, KKStrawMaterial const& smat, ComboHitCollection const& chcol,
+          StrawResponse const& strawresponse, KKStrawMaterial const& smat, KKHitIndex const& chindex,
           Calorimeter const& calo, CCHandle const& cchandle,
           KKTRK& kktrk) const;
       // extend the fit to the surfaces specified in the config
@@ -109,7 +114,7 @@ namespace mu2e {
     private:
       void fillTrackerInfo(Tracker const& tracker) const;
       void addStrawHits(Tracker const& tracker,StrawResponse const& strawresponse, BFieldMap const& kkbf, KKStrawMaterial const& smat,
-          KKTRK const& kktrk, ComboHitCollection const& chcol, KKSTRAWHITCOL& hits) const;
+          KKTRK const& kktrk, KKHitIndex const& chindex, KKSTRAWHITCOL& hits) const;
       void addStraws(Tracker const& tracker, KKStrawMaterial const& smat, KKTRK const& kktrk, KKSTRAWHITCOL const& addhits, KKSTRAWXINGCOL& addexings) const;
       void addCaloHit(Calorimeter const& calo, KKTRK& kktrk, CCHandle cchandle, KKCALOHITCOL& hits) const;
       void sampleFit(KKTRK const& kktrk,KalIntersectionCollection& inters) const; // sample fit at the surfaces specified in the config
@@ -131,13 +136,15 @@ namespace mu2e {
       StrawHitFlag addsel_, addrej_; // selection and rejection flags when adding hits
       // parameters controlling adding hits
       float maxStrawHitDoca_, maxStrawHitDt_, maxStrawDoca_, maxStrawDocaCon_;
+      double addhittbuff_; // time buffer on the panel crossing window when adding hits
       int maxDStraw_; // maximum distance from the track a strawhit can be to consider it for adding.
       // cached info computed from the tracker, used in hit adding; these must be lazy-evaluated as the tracker doesn't exist on construction
+      // The once_flag makes this safe when the fit is shared by concurrent events
       mutable double strawradius_;
       mutable double ymin_, ymax_, umax_; // panel-level info
       mutable double rmin_, rmax_; // plane-level info
       mutable double spitch_;
-      mutable bool needstrackerinfo_ = true;
+      mutable std::once_flag trackerinfo_;
 
       double sampletol_; // surface intersection tolerance (mm)
       double sampletbuff_; // simple time buffer; replace this with extrapolation TODO
@@ -169,6 +176,7 @@ namespace mu2e {
     maxStrawHitDt_(fitconfig.maxStrawHitDt()),
     maxStrawDoca_(fitconfig.maxStrawDOCA()),
     maxStrawDocaCon_(fitconfig.maxStrawDOCAConsistency()),
+    addhittbuff_(fitconfig.addHitTBuff()),
     maxDStraw_(fitconfig.maxDStraw()),
     sampletol_(fitconfig.sampleTol()),
     sampletbuff_(fitconfig.sampleTBuff()),
@@ -262,13 +270,13 @@ namespace mu2e {
   }
 
   template <class KTRAJ> void KKFit<KTRAJ>::extendTrack(Config const& exconfig, BFieldMap const& kkbf, Tracker const& tracker,
-      StrawResponse const& strawresponse, KKStrawMaterial const& smat, ComboHitCollection const& chcol,
+      StrawResponse const& strawresponse, KKStrawMaterial const& smat, KKHitIndex const& chindex,
       Calorimeter const& calo, CCHandle const& cchandle,
       KKTRK& kktrk) const {
     KKSTRAWHITCOL addstrawhits;
     KKCALOHITCOL addcalohits;
     KKSTRAWXINGCOL addstrawxings;
-    if(addhits_)addStrawHits(tracker, strawresponse, kkbf, smat, kktrk, chcol, addstrawhits );
+    if(addhits_)addStrawHits(tracker, strawresponse, kkbf, smat, kktrk, chindex, addstrawhits );
     if(matcorr_ && addmat_)addStraws(tracker, smat, kktrk, addstrawhits, addstrawxings);
     if(addhits_ && usecalo_ && kktrk.caloHits().size()==0)addCaloHit(calo, kktrk, cchandle, addcalohits);
     if(printLevel_ > 1){
@@ -281,27 +289,43 @@ namespace mu2e {
   }
 
   template <class KTRAJ> void KKFit<KTRAJ>::addStrawHits(Tracker const& tracker,StrawResponse const& strawresponse, BFieldMap const& kkbf, KKStrawMaterial const& smat,
-      KKTRK const& kktrk, ComboHitCollection const& chcol, KKSTRAWHITCOL& addhits) const {
+      KKTRK const& kktrk, KKHitIndex const& chindex, KKSTRAWHITCOL& addhits) const {
     auto const& ftraj = kktrk.fitTraj();
-    // build the set of existing hits
-    std::set<StrawHitIndex> oldhits;
-    for(auto const& strawhit : kktrk.strawHits())oldhits.insert(strawhit->strawHitIndex());
-    for( size_t ich=0; ich < chcol.size();++ich){
-      if(oldhits.find(ich)==oldhits.end()){      // make sure this hit wasn't already found
+    auto const& chcol = chindex.comboHits();
+    // flag the existing hits
+    std::vector<bool> oldhits(chcol.size(),false);
+    for(auto const& strawhit : kktrk.strawHits())oldhits[strawhit->strawHitIndex()] = true;
+    // candidate hits: those in panels the fit crosses within the time window of each crossing.  A reflecting or
+    // looping track can cross a panel's z range several times.  The buffer covers differences between these
+    // crossing times and those found below from each hit's own time
+    std::vector<Mu2eKinKal::ZPiece> zpieces;
+    Mu2eKinKal::zPieces(ftraj,zpieces);
+    std::vector<StrawHitIndex> candidates;
+    std::vector<TimeRange> crossings;
+    for(auto const& panel : chindex.panels()){
+      crossings.clear();
+      Mu2eKinKal::zRanges(zpieces,panel.zmin_,panel.zmax_,crossings);
+      for(auto const& crossing : crossings)
+        chindex.findHits(panel,crossing.begin()-maxStrawHitDt_-addhittbuff_,crossing.end()+maxStrawHitDt_+addhittbuff_,candidates);
+    }
+    // test the candidates in collection order, as the hits are added in that order.  Windows of different
+    // crossings can overlap
+    std::sort(candidates.begin(),candidates.end());
+    candidates.erase(std::unique(candidates.begin(),candidates.end()),candidates.end());
+    for(auto ich : candidates){
+      if(!oldhits[ich]){      // make sure this hit wasn't already found
         ComboHit const& strawhit = chcol[ich];
-        if(strawhit.flag().hasAllProperties(addsel_) && (!strawhit.flag().hasAnyProperty(addrej_))){
-          double zt = Mu2eKinKal::zTime(ftraj,strawhit.pos().Z(),strawhit.correctedTime());
-          if(fabs(strawhit.correctedTime()-zt) < maxStrawHitDt_) {      // compare the measured time with the estimate from the fit
-            const Straw& straw = tracker.getStraw(strawhit.strawId());
-            auto wline = Mu2eKinKal::hitLine(strawhit,straw,strawresponse);
-            double psign = wline.direction().Dot(straw.wireDirection());  // wire distance is WRT straw center, in the nominal wire direction
-            double htime = wline.measurementTime() - (straw.halfLength()-psign*strawhit.wireDist())/wline.speed(wline.timeAtMidpoint());
-            CAHint hint(zt,htime);
-            // compute PCA between the trajectory and this straw
-            PCA pca(ftraj, wline, hint, tprec_ );
-            if(fabs(pca.doca()) < maxStrawHitDoca_){ // add test of chi TODO
-              addhits.push_back(std::make_shared<KKSTRAWHIT>(kkbf, pca, strawhit, straw, ich, strawresponse));
-            }
+        double zt = Mu2eKinKal::zTime(ftraj,strawhit.pos().Z(),strawhit.correctedTime());
+        if(fabs(strawhit.correctedTime()-zt) < maxStrawHitDt_) {      // compare the measured time with the estimate from the fit
+          const Straw& straw = tracker.getStraw(strawhit.strawId());
+          auto wline = Mu2eKinKal::hitLine(strawhit,straw,strawresponse);
+          double psign = wline.direction().Dot(straw.wireDirection());  // wire distance is WRT straw center, in the nominal wire direction
+          double htime = wline.measurementTime() - (straw.halfLength()-psign*strawhit.wireDist())/wline.speed(wline.timeAtMidpoint());
+          CAHint hint(zt,htime);
+          // compute PCA between the trajectory and this straw
+          PCA pca(ftraj, wline, hint, tprec_ );
+          if(fabs(pca.doca()) < maxStrawHitDoca_){ // add test of chi TODO
+            addhits.push_back(std::make_shared<KKSTRAWHIT>(kkbf, pca, strawhit, straw, ich, strawresponse));
           }
         }
       }
@@ -315,7 +339,7 @@ namespace mu2e {
     // build the set of existing straws
     auto const& ftraj = kktrk.fitTraj();
     // pre-compute some tracker info if needed
-    if(needstrackerinfo_)fillTrackerInfo(tracker);
+    std::call_once(trackerinfo_,[this,&tracker](){ fillTrackerInfo(tracker); });
     // list the IDs of existing straws: this speeds the search
     std::set<StrawId> oldstraws;
     for(auto const& strawxing : kktrk.strawXings())oldstraws.insert(strawxing->strawId());
@@ -455,7 +479,6 @@ namespace mu2e {
     rmin_ = innerstraw_origin.y() - maxDStraw_*strawradius_;
     rmax_ = outerstraw.wireEnd(StrawEnd::cal).mag() + maxDStraw_*strawradius_;
     spitch_ = (StrawId::_nstraws-1)/(ymax_-ymin_);
-    needstrackerinfo_= false;
   }
 
 
@@ -10,6 +10,9 @@
 #include "KinKal/Trajectory/ParticleTrajectory.hh"
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
 #include "cetlib_except/exception.h"
+#include <algorithm>
+#include <limits>
+#include <vector>
 namespace mu2e {
   class ComboHit;
   class Straw;
@@ -47,6 +50,28 @@ namespace mu2e {
 //      if(ntries == maxntries) throw cet::exception("RECO")<<"mu2e::KKFitUtilities: zTime failure" << std::endl;
       return ztime;
     }
+    // z as a function of time over one trajectory piece, z = z0_ + vz_*(t-t0_), which is exact for helices and lines
+    struct ZPiece {
+      double tbegin_, tend_; // time range of the piece
+      double t0_, z0_, vz_;
+    };
+    // the pieces of a trajectory in time order.  The first and last pieces are extended to all earlier and later times,
+    // as zTime extrapolates them
+    template <class KTRAJ> void zPieces(KinKal::ParticleTrajectory<KTRAJ> const& ptraj, std::vector<ZPiece>& zpieces) {
+      zpieces.clear();
+      zpieces.reserve(ptraj.pieces().size());
+      for(auto const& piece : ptraj.pieces()){
+        double tmid = piece->range().mid();
+        zpieces.push_back(ZPiece{piece->range().begin(),piece->range().end(),tmid,piece->position3(tmid).Z(),piece->velocity(tmid).Z()});
+      }
+      if(zpieces.size() > 0){
+        zpieces.front().tbegin_ = std::numeric_limits<double>::lowest();
+        zpieces.back().tend_ = std::numeric_limits<double>::max();
+      }
+    }
+    // append the time ranges in which the trajectory is within [zmin, zmax].  A trajectory which reflects or loops
+    // back in z gives one range for each crossing
+    void zRanges(std::vector<ZPiece> const& zpieces, double zmin, double zmax, std::vector<KinKal::TimeRange>& ranges);
     bool insideStraw(KinKal::ClosestApproachData const& tpdata,Straw const& straw,double tolerance=0.0);
     // return the time range bounding a set of hits
     KinKal::TimeRange timeBounds(ComboHitCollection const& chits);
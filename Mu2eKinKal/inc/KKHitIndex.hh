@@ -0,0 +1,36 @@
+#ifndef Mu2eKinKal_KKHitIndex_hh
+#define Mu2eKinKal_KKHitIndex_hh
+//
+//  Per-event index of the straw ComboHits that are candidates for adding to a track (KKFit::addStrawHits).
+//  The hits passing the selection flags are bucketed by panel and sorted by time within each panel, so that
+//  the hits of a panel compatible with the time the track crosses that panel's z range are found by binary search.
+//  Build it once per event and share it between all the fits of that event.
+//
+#include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/StrawHitFlag.hh"
+#include "Offline/RecoDataProducts/inc/StrawHitIndex.hh"
+#include <vector>
+namespace mu2e {
+  class KKHitIndex {
+    public:
+      // the selected hits of one panel
+      struct Panel {
+        float zmin_, zmax_; // z range of the hits
+        size_t begin_, end_; // range in the time-sorted arrays
+      };
+      KKHitIndex(ComboHitCollection const& chcol, StrawHitFlag const& selectflag, StrawHitFlag const& rejectflag);
+      ComboHitCollection const& comboHits() const { return *chcol_; }
+      // panels with at least 1 selected hit
+      std::vector<Panel> const& panels() const { return panels_; }
+      // append the indices of the hits of a panel whose time is in [tmin, tmax]
+      void findHits(Panel const& panel, double tmin, double tmax, std::vector<StrawHitIndex>& hits) const;
+      // number of selected hits
+      size_t size() const { return hits_.size(); }
+    private:
+      ComboHitCollection const* chcol_;
+      std::vector<Panel> panels_;
+      std::vector<StrawHitIndex> hits_; // hit indices, sorted by panel then time
+      std::vector<float> times_; // corrected times of the above
+  };
+}
+#endif
@@ -12,6 +12,7 @@
 #include "Offline/Mu2eKinKal/inc/KKFileFinder.hh"
 
 #include <memory>
+#include <mutex>
 #include <string>
 
 namespace mu2e {
@@ -39,7 +40,8 @@ namespace mu2e {
       std::string wallmatname_, gasmatname_, wirematname_;
       MatEnv::DetMaterial::energylossmode eloss_;
       mutable std::unique_ptr<MatDBInfo> matdbinfo_; // material database
-      mutable std::unique_ptr<KKStrawMaterial> smat_; // straw material
+      mutable std::unique_ptr<KKStrawMaterial> smat_; // straw material, made on first use
+      mutable std::once_flag smatinit_;
   };
 }
 #endif
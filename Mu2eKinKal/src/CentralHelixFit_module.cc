@@ -217,6 +217,8 @@ namespace mu2e {
     auto ph_H = event.getValidHandle<ComboHitCollection>(phcol_T_);
     auto cc_H = event.getValidHandle<CaloClusterCollection>(cccol_T_);
     auto const& chcol = *ch_H;
+    // index of the hits that can be added to the tracks, shared by all the fits of this event
+    auto chindex = kkfit_.hitIndex(chcol);
     auto const& phcol = *ph_H;
     // create output
     unique_ptr<KKTRKCOL> kktrkcol(new KKTRKCOL );
@@ -316,7 +318,7 @@ namespace mu2e {
         // if we have an extension schedule, extend.
         if(goodfit && exconfig_.schedule().size() > 0) {
           //  std::cout << "EXTENDING TRACK " << event.id() << " " << index << std::endl;
-          kkfit_.extendTrack(exconfig_,*kkbf_, *tracker,*strawresponse, kkmat_.strawMaterial(), chcol, *calo_h, cc_H, *kktrk );
+          kkfit_.extendTrack(exconfig_,*kkbf_, *tracker,*strawresponse, kkmat_.strawMaterial(), chindex, *calo_h, cc_H, *kktrk );
           goodfit = goodFit(*kktrk);
         }
 
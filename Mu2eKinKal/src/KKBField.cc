@@ -12,34 +12,48 @@ namespace mu2e {
     //    = bfmgr_.getBField(vpoint_mu2e);
     if(bfmgr_.getBFieldWithStatus(vpoint_mu2e,field))
       return VEC3(field);
-    else
-// see if there's no maps; that says this is the no-field case
-    if(bfmgr_.getInnerMaps().size() == 0){
-      static const VEC3 nullfield(0.0,0.0,0.0);
-      return nullfield;
-    } else
+    checkNoField(vpoint_mu2e);
+    static const VEC3 nullfield(0.0,0.0,0.0);
+    return nullfield;
+  }
+
+  // the gradient comes from the same map cell as the field value; the detector system is a pure translation
+  // of the mu2e system, so the gradient needs no transformation
+  bool KKBField::fieldAndGrad(VEC3 const& position, CLHEP::Hep3Vector grad[3]) const {
+    CLHEP::Hep3Vector vpoint(position.x(),position.y(),position.z());
+    CLHEP::Hep3Vector vpoint_mu2e = det_.toMu2e(vpoint);
+    CLHEP::Hep3Vector field;
+    if(bfmgr_.getBFieldAndGradient(vpoint_mu2e,field,grad))
+      return true;
+    checkNoField(vpoint_mu2e);
+    return false;
+  }
+
+  void KKBField::checkNoField(CLHEP::Hep3Vector const& vpoint_mu2e) const {
+    // see if there's no maps; that says this is the no-field case
+    if(bfmgr_.getInnerMaps().size() != 0)
       throw cet::exception("RECO")<<"mu2e::KKBfield: out-of-range access point "<< vpoint_mu2e << endl;
   }
 
   Grad KKBField::fieldGrad(VEC3 const& position) const {
     Grad retval;
-    auto dBdx = fieldDeriv(position,VEC3(1.0,0.0,0.0));
-    auto dBdy = fieldDeriv(position,VEC3(0.0,1.0,0.0));
-    auto dBdz = fieldDeriv(position,VEC3(0.0,0.0,1.0));
-    SVEC3 dBdxv(dBdx.X(),dBdx.Y(), dBdx.Z());
-    SVEC3 dBdyv(dBdy.X(),dBdy.Y(), dBdy.Z());
-    SVEC3 dBdzv(dBdz.X(),dBdz.Y(), dBdz.Z());
-    retval.Place_in_row(dBdxv,0,0);
-    retval.Place_in_row(dBdyv,1,0);
-    retval.Place_in_row(dBdzv,2,0);
+    CLHEP::Hep3Vector grad[3];
+    if(fieldAndGrad(position,grad)){
+      // row j is dB/dx_j
+      for(int j=0;j<3;++j){
+        SVEC3 dBdxj(grad[j].x(),grad[j].y(),grad[j].z());
+        retval.Place_in_row(dBdxj,j,0);
+      }
+    }
     return retval;
   }
-  // numerical derivatives for now: TODO!
+
+  // time derivative along the velocity: dB/dt = sum_j v_j dB/dx_j
   VEC3 KKBField::fieldDeriv(VEC3 const& position, VEC3 const& velocity) const {
-    static double dt(0.1); // 100 psec, ~3cm.  this is arbitrary and should be set according to the field sampling TODO
-    VEC3 start = fieldVect(position);
-    VEC3 end = fieldVect(position + velocity*dt);
-    return (end-start)/dt;
+    CLHEP::Hep3Vector grad[3];
+    if(!fieldAndGrad(position,grad))return VEC3(0.0,0.0,0.0);
+    CLHEP::Hep3Vector dBdt = velocity.X()*grad[0] + velocity.Y()*grad[1] + velocity.Z()*grad[2];
+    return VEC3(dBdt);
   }
   bool KKBField::inRange(VEC3 const& position) const {
     // clumsy conversion to CLHEP
@@ -25,6 +25,34 @@ namespace mu2e {
       return fabs(upos) < straw.halfLength() + ubuffer;
     }
 
+    void zRanges(std::vector<ZPiece> const& zpieces, double zmin, double zmax, std::vector<KinKal::TimeRange>& ranges) {
+      bool open(false); // the last range ends where the previous piece ends, inside the interval
+      for(auto const& zp : zpieces) {
+        // times this piece is inside the interval
+        double tlow(zp.tbegin_), thigh(zp.tend_);
+        bool inside(true);
+        if(zp.vz_ != 0.0){
+          double t0 = zp.t0_ + (zmin - zp.z0_)/zp.vz_;
+          double t1 = zp.t0_ + (zmax - zp.z0_)/zp.vz_;
+          tlow = std::max(tlow,std::min(t0,t1));
+          thigh = std::min(thigh,std::max(t0,t1));
+          inside = tlow <= thigh;
+        } else {
+          inside = zp.z0_ >= zmin && zp.z0_ <= zmax;
+        }
+        if(!inside){
+          open = false;
+          continue;
+        }
+        // a trajectory that stays inside the interval across pieces gives a single range
+        if(open && tlow <= zp.tbegin_)
+          ranges.back() = KinKal::TimeRange(ranges.back().begin(),thigh);
+        else
+          ranges.emplace_back(tlow,thigh);
+        open = thigh >= zp.tend_;
+      }
+    }
+
     KinKal::TimeRange timeBounds(ComboHitCollection const& chits) {
       if(chits.size() == 0) return KinKal::TimeRange();
       double tmin = std::numeric_limits<float>::max();
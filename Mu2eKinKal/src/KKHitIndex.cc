@@ -0,0 +1,49 @@
+#include "Offline/Mu2eKinKal/inc/KKHitIndex.hh"
+#include "Offline/DataProducts/inc/StrawId.hh"
+#include <algorithm>
+#include <limits>
+namespace mu2e {
+  KKHitIndex::KKHitIndex(ComboHitCollection const& chcol, StrawHitFlag const& selectflag, StrawHitFlag const& rejectflag) :
+    chcol_(&chcol) {
+    // bucket the selected hits by panel: count, then fill
+    std::vector<size_t> count(StrawId::_nupanels+1,0);
+    for(size_t ich=0; ich < chcol.size(); ++ich){
+      auto const& ch = chcol[ich];
+      if(ch.flag().hasAllProperties(selectflag) && (!ch.flag().hasAnyProperty(rejectflag)))
+        ++count[ch.strawId().uniquePanel()+1];
+    }
+    for(size_t ipan=1; ipan < count.size(); ++ipan) count[ipan] += count[ipan-1];
+    hits_.resize(count.back());
+    times_.resize(count.back());
+    std::vector<size_t> next(count.begin(),count.end()-1);
+    for(size_t ich=0; ich < chcol.size(); ++ich){
+      auto const& ch = chcol[ich];
+      if(ch.flag().hasAllProperties(selectflag) && (!ch.flag().hasAnyProperty(rejectflag)))
+        hits_[next[ch.strawId().uniquePanel()]++] = ich;
+    }
+    // sort each panel by time and record its z range
+    for(size_t ipan=0; ipan < StrawId::_nupanels; ++ipan){
+      if(count[ipan+1] == count[ipan])continue;
+      auto first = hits_.begin() + count[ipan];
+      auto last = hits_.begin() + count[ipan+1];
+      std::sort(first,last,[&chcol](StrawHitIndex i1, StrawHitIndex i2){
+          return chcol[i1].correctedTime() < chcol[i2].correctedTime(); });
+      Panel panel{std::numeric_limits<float>::max(),std::numeric_limits<float>::lowest(),count[ipan],count[ipan+1]};
+      for(size_t ihit = panel.begin_; ihit < panel.end_; ++ihit){
+        auto const& ch = chcol[hits_[ihit]];
+        times_[ihit] = ch.correctedTime();
+        panel.zmin_ = std::min(panel.zmin_,ch.pos().Z());
+        panel.zmax_ = std::max(panel.zmax_,ch.pos().Z());
+      }
+      panels_.push_back(panel);
+    }
+  }
+
+  void KKHitIndex::findHits(Panel const& panel, double tmin, double tmax, std::vector<StrawHitIndex>& hits) const {
+    auto tbegin = times_.begin() + panel.begin_;
+    auto tend = times_.begin() + panel.end_;
+    auto ifirst = std::lower_bound(tbegin,tend,tmin);
+    auto ilast = std::upper_bound(ifirst,tend,tmax);
+    for(auto it = ifirst; it != ilast; ++it) hits.push_back(hits_[it - times_.begin()]);
+  }
+}
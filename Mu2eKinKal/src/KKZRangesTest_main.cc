@@ -0,0 +1,89 @@
+//
+// Check Mu2eKinKal::zRanges, used by KKFit::addStrawHits to find the times a fit crosses a panel, on a reflecting
+// track.  The track is made of 1 ns pieces whose z velocity falls linearly, as in a magnetic mirror: it moves
+// downstream, stops at t=100 ns and comes back.  The ranges found are compared with those from sampling z(t).
+//
+// Returns the number of failed checks.
+//
+#include "Offline/Mu2eKinKal/inc/KKFitUtilities.hh"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using mu2e::Mu2eKinKal::ZPiece;
+using KinKal::TimeRange;
+
+namespace {
+
+  double zAt(vector<ZPiece> const& zpieces, double time){
+    for(auto const& zp : zpieces){
+      if(time >= zp.tbegin_ && time < zp.tend_)return zp.z0_ + zp.vz_*(time-zp.t0_);
+    }
+    return zpieces.back().z0_ + zpieces.back().vz_*(time-zpieces.back().t0_);
+  }
+
+  // the ranges found by sampling z in small time steps
+  vector<TimeRange> sampled(vector<ZPiece> const& zpieces, double zmin, double zmax, double tmin, double tmax, double dt){
+    vector<TimeRange> ranges;
+    bool inside(false);
+    double tbegin(0.0);
+    for(double time = tmin; time <= tmax; time += dt){
+      double zpos = zAt(zpieces,time);
+      bool now = zpos >= zmin && zpos <= zmax;
+      if(now && !inside)tbegin = time;
+      if(!now && inside)ranges.emplace_back(tbegin,time-dt);
+      inside = now;
+    }
+    if(inside)ranges.emplace_back(tbegin,tmax);
+    return ranges;
+  }
+
+  int check(vector<ZPiece> const& zpieces, double zmin, double zmax, size_t nexpect){
+    static const double tmin(-100.0), tmax(300.0), dt(0.001);
+    vector<TimeRange> ranges;
+    mu2e::Mu2eKinKal::zRanges(zpieces,zmin,zmax,ranges);
+    auto expect = sampled(zpieces,zmin,zmax,tmin,tmax,dt);
+    int nbad(0);
+    if(ranges.size() != nexpect || expect.size() != nexpect){
+      ++nbad;
+    } else {
+      for(size_t ir=0; ir < ranges.size(); ++ir){
+        // the sampled ranges are within one step of the exact ones
+        if(fabs(ranges[ir].begin()-expect[ir].begin()) > 2*dt || fabs(ranges[ir].end()-expect[ir].end()) > 2*dt)++nbad;
+      }
+    }
+    cout << "z [" << zmin << ", " << zmax << "]: " << ranges.size() << " crossings, expected " << nexpect
+      << (nbad == 0 ? " ok" : " MISMATCH") << endl;
+    for(auto const& range : ranges)cout << "   " << range.begin() << " to " << range.end() << endl;
+    return nbad;
+  }
+}
+
+int main(){
+  // build the pieces as zPieces would from a fit: the first and last extend to all times
+  static const double z0(-1000.0), v0(30.0), tturn(100.0); // mm, mm/ns, ns
+  vector<ZPiece> zpieces;
+  double zbegin(z0);
+  for(int ip=0; ip < 200; ++ip){
+    double tbegin(ip), tend(ip+1);
+    double tmid = 0.5*(tbegin+tend);
+    double vz = v0*(1.0-tmid/tturn);
+    zpieces.push_back(ZPiece{tbegin,tend,tmid,zbegin+vz*(tmid-tbegin),vz});
+    zbegin += vz*(tend-tbegin);
+  }
+  zpieces.front().tbegin_ = std::numeric_limits<double>::lowest();
+  zpieces.back().tend_ = std::numeric_limits<double>::max();
+
+  int nbad(0);
+  nbad += check(zpieces,-500.0,-480.0,2); // crossed on the way out and on the way back
+  nbad += check(zpieces,480.0,520.0,1); // the track turns around inside
+  nbad += check(zpieces,600.0,620.0,0); // beyond the turning point
+  nbad += check(zpieces,-2000.0,-1990.0,2); // reached only by extrapolating the first and last pieces
+  nbad += check(zpieces,-1010.0,-990.0,2); // the start of the track, and its return
+
+  cout << (nbad == 0 ? "All checks pass" : "Checks failed: ");
+  if(nbad != 0)cout << nbad;
+  cout << endl;
+  return nbad;
+}
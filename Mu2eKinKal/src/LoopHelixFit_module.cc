@@ -13,7 +13,7 @@ namespace mu2e {
   using KinKal::VEC3;
   class LoopHelixFit : public HelixFit {
     public:
-      explicit LoopHelixFit(const Parameters& settings) :
+      explicit LoopHelixFit(const Parameters& settings, art::ProcessingFrame const&) :
         HelixFit(settings,TrkFitFlag::KKLoopHelix) {}
       // parameter-specific functions
       KTRAJ makeSeedTraj(HelixSeed const& hseed,TimeRange const& trange,VEC3 const& bnom, int charge) const override;
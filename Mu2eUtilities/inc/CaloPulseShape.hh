@@ -13,11 +13,17 @@
 //  - the t0 value correspond to the content of the digitized bin whose LOW EDGE is at time t0
 //
 // 1) digitizedPulse(hitTime) returns a waveform with hitTime corresponding to low edge of first bin
-// 2) evaluate(deltaTime) return value of digitized bin at a given time difference with peak time value
+// 2) evaluate(deltaTime) return value of digitized bin at a given time difference with peak time value,
+//    optionally with its derivative with respect to deltaTime
+// 3) addPulses(waveform, hits) adds the digitized pulses of many hits at once. The hits are given as a
+//    histogram of times in fine bins (fineBin(hitTime), nSteps fine bins per digitization bin); the pulse
+//    of each fine phase is cached contiguously, so each filled bin is a single vectorizable multiply-add
 //
 //  NOTE: uncomment the pline creation if the discontinuities in the second order derivative arising from the
 //        linear piecewise approxmiation are problematic for the minimization
 
+#include <cmath>
+#include <utility>
 #include <vector>
 
 namespace mu2e {
@@ -31,7 +37,11 @@ namespace mu2e {
           void buildShapes();
 
           const std::vector<double>& digitizedPulse  (double hitTime)        const;
+          int                        fineBin         (double hitTime)        const {return int(std::floor(hitTime/digiStep_));}
+          void                       addPulses       (std::vector<double>& waveform,
+                                                      const std::vector<std::pair<int,double>>& fineHits) const;
           double                     evaluate        (double timeDifference) const;
+          double                     evaluate        (double timeDifference, double& slope) const;
           double                     fromPeakToT0    (double timePeak)       const;
           void                       diag            (bool fullDiag=false)   const;
 
@@ -40,6 +50,7 @@ namespace mu2e {
           double                      digiStep_;
           int                         nBinShape_;
           std::vector<double>         pulseVec_;
+          std::vector<double>         phaseShapes_;
           double                      deltaT_;
           mutable std::vector<double> digitizedPulse_;
     };
@@ -8,6 +8,7 @@
 #include <xercesc/util/PlatformUtils.hpp>
 #include <xercesc/parsers/XercesDOMParser.hpp>
 #include <xercesc/dom/DOMDocument.hpp>
+#include <map>
 #include <vector>
 #include <string>
 
@@ -27,11 +28,30 @@ namespace mu2e
        explicit MVATools(const Config& conf);
        explicit MVATools(const std::string& xmlfilename);
 
+       // Scratch space for the evaluation.  The evaluation methods are const and keep no state
+       // in the MVATools object, so one object can be shared between threads as long as each
+       // thread uses its own Workspace.  The methods without a Workspace argument use one
+       // per thread.
+       struct Workspace
+       {
+          std::vector<float> x;
+          std::vector<float> y;
+          std::vector<float> in;
+       };
+
        virtual ~MVATools();
        xercesc::DOMDocument* getXmlDoc();
        void     initMVA();
        float    evalMVA(const std::vector<float>&,  const MVAMask& vmask=0xffffffff) const;
        float    evalMVA(const std::vector<double>&, const MVAMask& vmask=0xffffffff) const;
+       float    evalMVA(const std::vector<float>&,  Workspace& ws, const MVAMask& vmask=0xffffffff) const;
+       // Evaluate the MVA for N input vectors of nvar variables each, stored row by row in
+       // inputs ([N x nvar]).  outputs is resized to N.  The layers are computed for blocks of
+       // rows at a time, and the results are identical to calling evalMVA on each row.
+       void     evalBatch(const std::vector<float>& inputs, size_t nvar, std::vector<float>& outputs,
+                          const MVAMask& vmask=0xffffffff) const;
+       void     evalBatch(const std::vector<float>& inputs, size_t nvar, std::vector<float>& outputs,
+                          Workspace& ws, const MVAMask& vmask=0xffffffff) const;
        void     showMVA() const;
 
        const std::vector<std::string>& titles() const { return title_;}
@@ -46,10 +66,10 @@ namespace mu2e
        void   getNorm(xercesc::DOMDocument* xmlDoc);
        void   getWgts(xercesc::DOMDocument* xmlDoc);
        float  activation(float arg) const;
+       void   evalRows(const float* inputs, size_t nrow, size_t nvar, float* outputs,
+                       Workspace& ws, const MVAMask& mask) const;
+       static Workspace& threadWorkspace();
 
-       mutable std::vector<float> x_;
-       mutable std::vector<float> y_;
-       mutable std::vector<float> fv_;
        std::vector<float>         wgts_;
        std::vector<unsigned>      links_;
        unsigned                   maxNeurons_;
@@ -5,6 +5,7 @@
 #include "TFile.h"
 #include "TH2F.h"
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -52,6 +53,11 @@ namespace mu2e {
        // find difference between peak time and t0 for digitized waveform.
        for (int i=1;i<nBinShape_;++i) {if (pulseVec_[(i+1)*nSteps_] < pulseVec_[i*nSteps_]) break; deltaT_ +=nSteps_*digiStep_;}
 
+       // digitized pulse for each fine phase of the hit time, as returned by digitizedPulse
+       phaseShapes_.assign(nSteps_*nBinShape_,0.0);
+       for (int phase=0;phase<nSteps_;++phase)
+         for (int i=0;i<nBinShape_;++i) phaseShapes_[phase*nBinShape_+i] = pulseVec_[nSteps_-phase+i*nSteps_];
+
    }
 
    //----------------------------------------------------------------------------
@@ -63,6 +69,23 @@ namespace mu2e {
        return digitizedPulse_;
    }
 
+   //----------------------------------------------------------------------------
+   // same as adding weight*digitizedPulse(t) at sample fineBin(t)/nSteps_ for each hit, hits before the waveform are ignored
+   void CaloPulseShape::addPulses(std::vector<double>& waveform, const std::vector<std::pair<int,double>>& fineHits) const
+   {
+       const int wfSize = waveform.size();
+       double* wf = waveform.data();
+       for (const auto& [fbin, weight] : fineHits)
+       {
+           if (fbin < 0) continue;
+           const int     startSample = fbin/nSteps_;
+           const int     nSamples    = std::min(nBinShape_, wfSize-startSample);
+           const double* shape       = &phaseShapes_[(fbin%nSteps_)*nBinShape_];
+           double*       out         = wf + startSample;
+           for (int i=0;i<nSamples;++i) out[i] += weight*shape[i];
+       }
+   }
+
    //----------------------------------------------------------------------------
    double CaloPulseShape::evaluate(double tDifference) const
    {
@@ -74,6 +97,19 @@ namespace mu2e {
        return (pulseVec_[ibin+1]-pulseVec_[ibin])/digiStep_*(t-t0bin)+pulseVec_[ibin];
    }
 
+   //----------------------------------------------------------------------------
+   double CaloPulseShape::evaluate(double tDifference, double& slope) const
+   {
+       double t = tDifference+deltaT_;
+       int ibin = nSteps_ + int(t*nSteps_/digiStep_/nSteps_);
+
+       slope = 0.0;
+       if (ibin < 0 || ibin >= int(pulseVec_.size()-1)) return 0.0;
+       double t0bin = (ibin-nSteps_)*digiStep_;
+       slope = (pulseVec_[ibin+1]-pulseVec_[ibin])/digiStep_;
+       return slope*(t-t0bin)+pulseVec_[ibin];
+   }
+
    //----------------------------------------------------------------------------
    double CaloPulseShape::fromPeakToT0(double timePeak) const
    {
@@ -38,9 +38,6 @@ namespace mu2e
 {
 
   MVATools::MVATools(const Config& config) :
-    x_(),
-    y_(),
-    fv_(),
     wgts_(),
     maxNeurons_(0),
     activeType_(aType::null),
@@ -59,9 +56,6 @@ namespace mu2e
   }
 
   MVATools::MVATools(fhicl::ParameterSet const& pset) :
-    x_(),
-    y_(),
-    fv_(),
     wgts_(),
     maxNeurons_(0),
     activeType_(aType::null),
@@ -80,9 +74,6 @@ namespace mu2e
   }
 
   MVATools::MVATools(const std::string& xmlfilename) :
-    x_(),
-    y_(),
-    fv_(),
     wgts_(),
     maxNeurons_(0),
     activeType_(aType::null),
@@ -376,8 +367,6 @@ namespace mu2e
       }
 
       maxNeurons_ = *std::max_element(links_.begin(),links_.end());
-      x_ = std::vector<float>(maxNeurons_,0.0f);
-      y_ = std::vector<float>(maxNeurons_,0.0f);
 
       XMLString::release(&ATT_INDEX);
       XMLString::release(&ATT_NSYNAPSES);
@@ -430,53 +419,121 @@ namespace mu2e
   }
 
 
+  MVATools::Workspace& MVATools::threadWorkspace()
+  {
+     static thread_local Workspace ws;
+     return ws;
+  }
+
   float MVATools::evalMVA(const std::vector<double >& v, const MVAMask& mask) const
   {
-     for (size_t i=0;i<v.size();++i)  fv_[i] = static_cast<float>(v[i]);
-     return evalMVA(fv_,mask);
+     Workspace& ws = threadWorkspace();
+     ws.in.assign(v.begin(),v.end());
+     float out(0.0);
+     evalRows(ws.in.data(),1,ws.in.size(),&out,ws,mask);
+     return out;
   }
 
   float MVATools::evalMVA(const std::vector<float>& v, const MVAMask& mask) const
   {
+     return evalMVA(v,threadWorkspace(),mask);
+  }
 
-      // Normalize the input data and add the bias node, skip masked values
-      size_t ival(0);
-      for (size_t ivar=0; ivar < v.size(); ivar++)
-      {
-         if ( mask & (1<<ivar) )
-         {
-            x_[ival]= isNorm_ ? (v[ivar]-voffset_[ival])*vscale_[ival] - 1.0 : v[ivar];
-            ++ival;
-         }
-      }
-      x_[ival] = 1.0;
+  float MVATools::evalMVA(const std::vector<float>& v, Workspace& ws, const MVAMask& mask) const
+  {
+     float out(0.0);
+     evalRows(v.data(),1,v.size(),&out,ws,mask);
+     return out;
+  }
 
-      if (ival != links_[0]-1)
-        throw cet::exception("RECO")<<"mu2e::MVATools: mismatch input dimension (ival = " << ival << ") and network architecture (links_[0]-1 = " << links_[0]-1 << ")" << std::endl;
+  void MVATools::evalBatch(const std::vector<float>& inputs, size_t nvar, std::vector<float>& outputs, const MVAMask& mask) const
+  {
+     evalBatch(inputs,nvar,outputs,threadWorkspace(),mask);
+  }
 
+  void MVATools::evalBatch(const std::vector<float>& inputs, size_t nvar, std::vector<float>& outputs,
+                           Workspace& ws, const MVAMask& mask) const
+  {
+     if (nvar == 0 || inputs.size()%nvar != 0)
+       throw cet::exception("RECO")<<"mu2e::MVATools: input size " << inputs.size() << " is not a multiple of the number of variables " << nvar << std::endl;
 
-      //perform feed forward calculation up to the last hidden layer
-      unsigned idxWeight(0);
-      for (unsigned k=0;k<links_.size()-1;++k)
+     size_t nrow = inputs.size()/nvar;
+     outputs.resize(nrow);
+     if (nrow > 0) evalRows(inputs.data(),nrow,nvar,outputs.data(),ws,mask);
+  }
+
+  // The activations of a block of rows are stored neuron by neuron, x[i*nblock+r] for neuron i
+  // of row r, so that each layer is a small matrix product whose inner loop runs over the rows.
+  // The sums over the neurons of the previous layer are done in the same order as for a
+  // single row, so the result does not depend on how the rows are blocked.
+  void MVATools::evalRows(const float* inputs, size_t nrow, size_t nvar, float* outputs,
+                          Workspace& ws, const MVAMask& mask) const
+  {
+      static const size_t maxBlock(64);
+
+      // the unmasked variables, which are the inputs of the network
+      size_t nin(0);
+      for (size_t ivar=0; ivar < nvar; ivar++) if ( mask & (1<<ivar) ) ++nin;
+      if (nin != links_[0]-1)
+        throw cet::exception("RECO")<<"mu2e::MVATools: mismatch input dimension (ival = " << nin << ") and network architecture (links_[0]-1 = " << links_[0]-1 << ")" << std::endl;
+
+      size_t nblock = std::min(nrow,maxBlock);
+      ws.x.resize(maxNeurons_*nblock);
+      ws.y.resize(maxNeurons_*nblock);
+
+      for (size_t row0=0; row0 < nrow; row0 += nblock)
       {
-          //the number of synpases is given by the number of neurons in the next layer -1 (do not count bias neuron!)
-          for (unsigned j=0;j<links_[k+1]-1;++j)
+          size_t nr = std::min(nblock,nrow-row0);
+          float* x = ws.x.data();
+          float* y = ws.y.data();
+
+          // Normalize the input data and add the bias node, skip masked values
+          for (size_t r=0; r<nr; ++r)
           {
-             y_[j]=0.0f;
-             for (unsigned i=0;i<links_[k];++i) y_[j] += wgts_[i+idxWeight]*x_[i];
-             y_[j] = activation(y_[j]);
-             idxWeight += links_[k];
+             const float* v = inputs + (row0+r)*nvar;
+             size_t ival(0);
+             for (size_t ivar=0; ivar < nvar; ivar++)
+             {
+                if ( mask & (1<<ivar) )
+                {
+                   x[ival*nblock+r]= isNorm_ ? (v[ivar]-voffset_[ival])*vscale_[ival] - 1.0 : v[ivar];
+                   ++ival;
+                }
+             }
+             x[ival*nblock+r] = 1.0;
           }
-          x_.swap(y_);
-          x_[links_[k+1]-1] = 1.0f; //add bias neuron
-      }
 
-      //calculate output neuron value
-      float yf(0.0);
-      for (unsigned i=0;i<links_.back();++i) yf += wgts_[i+idxWeight]*x_[i];
+          //perform feed forward calculation up to the last hidden layer
+          unsigned idxWeight(0);
+          for (unsigned k=0;k<links_.size()-1;++k)
+          {
+              //the number of synpases is given by the number of neurons in the next layer -1 (do not count bias neuron!)
+              for (unsigned j=0;j<links_[k+1]-1;++j)
+              {
+                 float* yj = y + j*nblock;
+                 for (size_t r=0;r<nr;++r) yj[r] = 0.0f;
+                 for (unsigned i=0;i<links_[k];++i)
+                 {
+                    const float w = wgts_[i+idxWeight];
+                    const float* xi = x + i*nblock;
+                    for (size_t r=0;r<nr;++r) yj[r] += w*xi[r];
+                 }
+                 for (size_t r=0;r<nr;++r) yj[r] = activation(yj[r]);
+                 idxWeight += links_[k];
+              }
+              std::swap(x,y);
+              float* bias = x + (links_[k+1]-1)*nblock;
+              for (size_t r=0;r<nr;++r) bias[r] = 1.0f; //add bias neuron
+          }
 
-      if (oldMVA_) return yf;
-      return  1.0/(1.0+expf(-yf));
+          //calculate output neuron value
+          for (size_t r=0;r<nr;++r)
+          {
+             float yf(0.0);
+             for (unsigned i=0;i<links_.back();++i) yf += wgts_[i+idxWeight]*x[i*nblock+r];
+             outputs[row0+r] = oldMVA_ ? yf : 1.0/(1.0+expf(-yf));
+          }
+      }
   }
 
 
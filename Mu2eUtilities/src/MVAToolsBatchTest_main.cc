@@ -0,0 +1,83 @@
+//
+// Check that MVATools::evalBatch gives exactly the same outputs as
+// evaluating the rows one at a time with MVATools::evalMVA.  Rows are
+// drawn at random; the row counts straddle the block size used inside
+// evalBatch and the masked case carries one extra, ignored, column.
+// Needs MU2E_SEARCH_PATH to find the weight files; run by ctest.
+//
+// Returns the number of mismatched rows.
+//
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Offline/Mu2eUtilities/inc/MVATools.hh"
+
+using namespace std;
+
+namespace {
+
+  struct WeightFile {
+    string name;
+    size_t nvar;
+  };
+
+  // compare evalBatch to evalMVA for nrow random rows of nvar values
+  int check( mu2e::MVATools const& mva, size_t nvar, size_t nrow,
+             MVAMask mask, std::mt19937& engine ){
+    std::uniform_real_distribution<float> flat(-10.0,10.0);
+    vector<float> inputs(nrow*nvar);
+    for ( auto& v : inputs ) v = flat(engine);
+
+    vector<float> batch;
+    mva.evalBatch(inputs,nvar,batch,mask);
+
+    int nbad(0);
+    vector<float> row(nvar);
+    for ( size_t r=0; r<nrow; ++r ){
+      row.assign(inputs.begin()+r*nvar,inputs.begin()+(r+1)*nvar);
+      float single = mva.evalMVA(row,mask);
+      if ( batch[r] != single ){
+        if ( nbad < 5 ) cout << "  row " << r << ": evalBatch " << batch[r]
+                             << " evalMVA " << single << endl;
+        ++nbad;
+      }
+    }
+    return nbad;
+  }
+
+}
+
+int main (){
+
+  // sigmoid and ReLU networks of different widths
+  vector<WeightFile> files = {
+    { "Offline/TrkPatRec/data/TimeCluster.weights.xml",    7 },
+    { "Offline/TrkPatRec/data/TimePhiCluster.weights.xml", 3 },
+    { "Offline/TrkHitReco/data/BkgMVA.weights.xml",        9 },
+    { "Offline/CaloFilters/data/CE_NN_ReLU.weights.xml",   8 }
+  };
+  vector<size_t> nrows = { 1, 2, 63, 64, 65, 200 };
+
+  std::mt19937 engine(12345);
+  int nbad(0);
+  for ( auto const& file : files ){
+    mu2e::MVATools mva(file.name);
+    mva.initMVA();
+    for ( auto nrow : nrows ){
+      int bad = check(mva,file.nvar,nrow,0xffffffff,engine);
+      // an extra leading column, masked out
+      bad += check(mva,file.nvar+1,nrow,0xffffffff<<1,engine);
+      cout << file.name << " rows " << nrow << ": "
+           << (bad == 0 ? "ok" : "MISMATCH") << endl;
+      nbad += bad;
+    }
+  }
+
+  cout << (nbad == 0 ? "All rows agree" : "Rows disagree: ") ;
+  if ( nbad != 0 ) cout << nbad;
+  cout << endl;
+  return nbad;
+}
@@ -4,10 +4,17 @@
 //
 // A safe pointer to a ProditionsEntity
 //
+// The handle may be shared between the threads of a shared module:
+// the current entity and its interval of validity are updated under
+// a mutex.  The entities are owned by the ProditionsCache, which keeps
+// them for the life of the job, so the references returned stay valid
+// after another thread moves the handle to a new interval.
+//
 
 #include "Offline/DbTables/inc/DbIoV.hh"
 #include "Offline/ProditionsService/inc/ProditionsService.hh"
 #include "canvas/Persistency/Provenance/EventID.h"
+#include <mutex>
 #include <string>
 
 namespace mu2e {
@@ -30,6 +37,14 @@ class ProditionsHandle {
           << " from ProditionsService ";
     }
   }
+  ProditionsHandle(ProditionsHandle const& other) {
+    std::lock_guard<std::mutex> lock(other._mutex);
+    _cptr = other._cptr;
+    ptr = other.ptr;
+    _name = other._name;
+    _iov = other._iov;
+  }
+  ProditionsHandle& operator=(ProditionsHandle const&) = delete;
   ~ProditionsHandle() {}
 
   ENTITY const& get(art::RunID const& rid) {
@@ -39,35 +54,42 @@ class ProditionsHandle {
     return get(art::EventID(sid, 0));
   }
   cptr_t getPtr(art::EventID const& eid) {
-    get(eid);
-    return ptr;
-  }
-  ENTITY const& get(art::EventID const& eid) {
     uint32_t r = eid.run();
     uint32_t s = eid.subRun();
-    if (!_iov.inInterval(r, s)) {
-      ProditionsEntity::ptr bptr;
-      std::tie(bptr, _iov) = _cptr->update(eid);
-      ptr =
-          std::dynamic_pointer_cast<const ENTITY, const ProditionsEntity>(bptr);
+    cptr_t current;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (!_iov.inInterval(r, s)) {
+        ProditionsEntity::ptr bptr;
+        std::tie(bptr, _iov) = _cptr->update(eid);
+        ptr = std::dynamic_pointer_cast<const ENTITY, const ProditionsEntity>(
+            bptr);
+      }
+      current = ptr;
     }
 
-    if (!ptr) {
+    if (!current) {
       throw cet::exception("PRODITIONSHANDLE_NO_ENTITY")
           << "ProditionsHandle could not load entity " << _name << " for Run "
           << eid.run() << " SubRun " << eid.subRun();
     }
 
-    return *ptr;
+    return current;
   }
+  ENTITY const& get(art::EventID const& eid) { return *getPtr(eid); }
 
-  DbIoV const& iov() const { return _iov; }
+  // a copy, since another thread may move the handle to a new interval
+  DbIoV iov() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _iov;
+  }
 
  private:
   ProditionsCache::ptr _cptr;
   cptr_t ptr;
   std::string _name;
   DbIoV _iov;
+  mutable std::mutex _mutex;  // guards ptr and _iov
 };
 }  // namespace mu2e
 
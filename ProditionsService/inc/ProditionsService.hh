@@ -40,9 +40,18 @@
 #include "fhiclcpp/types/OptionalSequence.h"
 #include "fhiclcpp/types/Sequence.h"
 #include "fhiclcpp/types/Table.h"
+#include "fhiclcpp/types/Tuple.h"
+#include "tbb/task_arena.h"
+#include "tbb/task_group.h"
 #include <string>
+#include <tuple>
+#include <vector>
 
 
+namespace art {
+class SubRun;
+}
+
 namespace mu2e {
 
 class ProditionsService {
@@ -51,6 +60,22 @@ class ProditionsService {
     using Name = fhicl::Name;
     using Comment = fhicl::Comment;
     fhicl::Atom<int> verbose{Name("verbose"), Comment("verbosity 0 or 1"), 0};
+    fhicl::Atom<bool> prewarm{
+        Name("prewarm"),
+        Comment("build the entities of the caches at the first subrun of "
+                "each run, so events do not pay the construction"),
+        false};
+    fhicl::OptionalSequence<std::string> prewarmCaches{
+        Name("prewarmCaches"),
+        Comment("names of the caches to prewarm (default all)")};
+    fhicl::OptionalSequence<fhicl::Tuple<int, int>> prewarmRuns{
+        Name("prewarmRuns"),
+        Comment("[run, first subrun] the job will process, in order; the next "
+                "one in the list is prewarmed in the background during the "
+                "current run")};
+    fhicl::Atom<bool> prewarmParallel{
+        Name("prewarmParallel"),
+        Comment("build the caches of a run in parallel"), true};
     fhicl::Table<CRVOrdinalConfig> crvOrdinal{
         Name("crvOrdinal"),
         Comment("CRV online-offline numbering configuration")};
@@ -111,6 +136,15 @@ class ProditionsService {
   }
 
   // void postBeginJob();
+  // at the first subrun of a run, prewarm the caches for it, and start
+  // the next one of prewarmRuns
+  void preBeginSubRun(art::SubRun const& subrun);
+  // print the cache timing when verbose
+  void postEndJob();
+
+  // build the entities of the prewarm caches valid for the subrun,
+  // returns the number of caches which failed
+  int prewarm(uint32_t run, uint32_t subrun);
 
  private:
   // This is not copyable or assignable - private and unimplemented.
@@ -119,6 +153,14 @@ class ProditionsService {
 
   Config _config;
   std::map<std::string, ProditionsCache::ptr> _caches;
+  std::vector<ProditionsCache::ptr> _prewarmCaches;
+  std::vector<std::tuple<int, int>> _prewarmRuns;
+  int _lastRun = -1;  // the last run prewarmed at its first subrun
+  // the prewarm of the next run runs in the background in an arena of
+  // its own, so waiting for it never picks up unrelated tasks
+  tbb::task_arena _arena;
+  tbb::task_group _nextRun;
+  bool _nextRunPending = false;
 };
 
 }  // namespace mu2e
@@ -33,7 +33,13 @@
 #include "Offline/AnalysisConditions/inc/TrkQualCatalogCache.hh"
 #include "Offline/SimulationConditions/inc/SimBookkeeperCache.hh"
 
+#include "art/Framework/Principal/SubRun.h"
 #include "art/Framework/Services/Registry/ServiceDefinitionMacros.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+#include "tbb/task_group.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <typeinfo>
 
@@ -107,6 +113,111 @@ ProditionsService::ProditionsService(Parameters const& sTable,
       cout << "  " << cc.first << endl;
     }
   }
+
+  if (_config.prewarm()) {
+    std::vector<std::string> names;
+    if (_config.prewarmCaches(names)) {
+      for (auto const& name : names) {
+        auto cc = getCache(name);
+        if (!cc) {
+          throw cet::exception("PRODITIONS_BAD_PREWARM_CACHE")
+              << "ProditionsService prewarmCaches has unknown cache " << name
+              << "\n";
+        }
+        _prewarmCaches.push_back(cc);
+      }
+    } else {
+      for (auto const& cc : _caches) _prewarmCaches.push_back(cc.second);
+    }
+    _config.prewarmRuns(_prewarmRuns);
+    iRegistry.sPreBeginSubRun.watch(this, &ProditionsService::preBeginSubRun);
+  }
+
+  iRegistry.sPostEndJob.watch(this, &ProditionsService::postEndJob);
+}
+
+void ProditionsService::preBeginSubRun(art::SubRun const& subrun) {
+  int run = subrun.run();
+  if (run == _lastRun) return;
+  _lastRun = run;
+
+  // the background prewarm of this run may still be going
+  if (_nextRunPending) {
+    _arena.execute([this]() { _nextRun.wait(); });
+    _nextRunPending = false;
+  }
+  // if it was done, this only finds the entities in the caches
+  prewarm(run, subrun.subRun());
+
+  auto it = std::find_if(
+      _prewarmRuns.begin(), _prewarmRuns.end(),
+      [run](auto const& rs) { return std::get<0>(rs) == run; });
+  if (it != _prewarmRuns.end() && ++it != _prewarmRuns.end()) {
+    uint32_t nrun = std::get<0>(*it);
+    uint32_t nsubrun = std::get<1>(*it);
+    _arena.execute([this, nrun, nsubrun]() {
+      _nextRun.run([this, nrun, nsubrun]() { prewarm(nrun, nsubrun); });
+    });
+    _nextRunPending = true;
+  }
+}
+
+int ProditionsService::prewarm(uint32_t run, uint32_t subrun) {
+  auto stime = std::chrono::steady_clock::now();
+  std::atomic<int> nfail(0);
+  // a cache the job does not use may not be configured for this run,
+  // so a failure is only reported; it will happen again at the first
+  // event if the cache is needed
+  auto build = [this, run, subrun, &nfail](ProditionsCache::ptr const& cc) {
+    try {
+      cc->update(art::EventID(run, subrun, 0));
+    } catch (std::exception const& e) {
+      nfail++;
+      if (_config.verbose() > 0) {
+        cout << "ProditionsService::prewarm could not build " << cc->name()
+             << " for run " << run << " subrun " << subrun << ":\n"
+             << e.what() << endl;
+      }
+    }
+  };
+  // the caches depend on each other through their handles; a cache
+  // being built by another task is waited for in ProditionsCache::update
+  if (_config.prewarmParallel()) {
+    tbb::task_group tasks;
+    for (auto const& cc : _prewarmCaches) {
+      tasks.run([&build, cc]() { build(cc); });
+    }
+    tasks.wait();
+  } else {
+    for (auto const& cc : _prewarmCaches) build(cc);
+  }
+  if (nfail > 0) {
+    mf::LogWarning("ProditionsService")
+        << "prewarm of run " << run << " subrun " << subrun
+        << " could not build " << nfail << " of " << _prewarmCaches.size()
+        << " caches";
+  }
+  if (_config.verbose() > 0) {
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - stime;
+    cout << "ProditionsService::prewarm run " << run << " subrun " << subrun
+         << " built " << _prewarmCaches.size() - nfail << " of "
+         << _prewarmCaches.size() << " caches in " << dt.count() << " s"
+         << endl;
+  }
+  return nfail;
+}
+
+void ProditionsService::postEndJob() {
+  if (_nextRunPending) {
+    _arena.execute([this]() { _nextRun.wait(); });
+    _nextRunPending = false;
+  }
+  if (_config.verbose() > 0) {
+    cout << "Proditions cache stats:" << endl;
+    for (auto const& cc : _caches) {
+      if (cc.second->nIovs() > 0) cc.second->printStats(cout);
+    }
+  }
 }
 
 }  // namespace mu2e
@@ -0,0 +1,63 @@
+#ifndef RecoDataProducts_ComboHitSoAView_hh
+#define RecoDataProducts_ComboHitSoAView_hh
+//
+// Read-only structure-of-arrays copy of the ComboHit fields used by the hot loops of
+// pattern recognition: position, wire direction and resolutions, times, flags, number
+// of straw hits and the station/panel indices.  Each field is a contiguous array indexed
+// like the collection, so that loops over all the hits touch only the fields they use and
+// can vectorize.
+//
+// Every module that writes a ComboHitCollection also writes its view, with the same module
+// label and instance name, so the view is built once per collection and shared by all the
+// consumers.  The view is a copy: it does not follow later changes of the collection.
+// Consumers reading files written without the view use get(), which fills a local copy.
+//
+#include "Offline/RecoDataProducts/inc/StrawHitFlag.hh"
+// C++ includes
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+namespace mu2e {
+  struct ComboHit;
+  class ComboHitCollection;
+
+  class ComboHitSoAView {
+    public:
+      ComboHitSoAView() {}
+      explicit ComboHitSoAView(ComboHitCollection const& chcol);
+      // replace the contents by those of chcol
+      void fill(ComboHitCollection const& chcol);
+      size_t size() const { return _x.size(); }
+      bool empty() const { return _x.empty(); }
+      // position
+      float const* x() const { return _x.data(); }
+      float const* y() const { return _y.data(); }
+      float const* z() const { return _z.data(); }
+      // ComboHit::uDir2D(), ComboHit::wireVar() and ComboHit::transVar()
+      float const* uDirX() const { return _ux.data(); }
+      float const* uDirY() const { return _uy.data(); }
+      float const* wireVar() const { return _uvar.data(); }
+      float const* transVar() const { return _vvar.data(); }
+      // ComboHit::time() and ComboHit::correctedTime()
+      float const* time() const { return _time.data(); }
+      float const* correctedTime() const { return _ctime.data(); }
+      StrawHitFlag const* flag() const { return _flag.data(); }
+      uint16_t const* nStrawHits() const { return _nsh.data(); }
+      // StrawId::station() and StrawId::uniquePanel()
+      uint16_t const* station() const { return _station.data(); }
+      uint16_t const* uniquePanel() const { return _upanel.data(); }
+      // set sel[i] to 1 for hits whose flag has all the bits of hsel and none of hbkg, 0
+      // otherwise; returns the number of selected hits
+      size_t select(StrawHitFlag const& hsel, StrawHitFlag const& hbkg, std::vector<uint8_t>& sel) const;
+      // the view of chcol: view if it describes chcol (same size), otherwise local filled from chcol
+      static ComboHitSoAView const& get(ComboHitSoAView const* view, ComboHitCollection const& chcol, ComboHitSoAView& local);
+    private:
+      std::vector<float> _x, _y, _z;
+      std::vector<float> _ux, _uy, _uvar, _vvar;
+      std::vector<float> _time, _ctime;
+      std::vector<StrawHitFlag> _flag;
+      std::vector<uint16_t> _nsh;
+      std::vector<uint16_t> _station, _upanel;
+  };
+}
+#endif
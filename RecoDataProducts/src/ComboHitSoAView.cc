@@ -0,0 +1,56 @@
+//
+// Structure-of-arrays view of a ComboHitCollection
+//
+#include "Offline/RecoDataProducts/inc/ComboHitSoAView.hh"
+#include "Offline/RecoDataProducts/inc/ComboHit.hh"
+namespace mu2e {
+
+  ComboHitSoAView::ComboHitSoAView(ComboHitCollection const& chcol) {
+    fill(chcol);
+  }
+
+  void ComboHitSoAView::fill(ComboHitCollection const& chcol) {
+    size_t n = chcol.size();
+    _x.resize(n); _y.resize(n); _z.resize(n);
+    _ux.resize(n); _uy.resize(n); _uvar.resize(n); _vvar.resize(n);
+    _time.resize(n); _ctime.resize(n);
+    _flag.resize(n);
+    _nsh.resize(n);
+    _station.resize(n); _upanel.resize(n);
+    for(size_t ich=0; ich < n; ++ich){
+      ComboHit const& ch = chcol[ich];
+      _x[ich] = ch.pos().x();
+      _y[ich] = ch.pos().y();
+      _z[ich] = ch.pos().z();
+      _ux[ich] = ch.uDir2D().x();
+      _uy[ich] = ch.uDir2D().y();
+      _uvar[ich] = ch.wireVar();
+      _vvar[ich] = ch.transVar();
+      _time[ich] = ch.time();
+      _ctime[ich] = ch.correctedTime();
+      _flag[ich] = ch.flag();
+      _nsh[ich] = ch.nStrawHits();
+      _station[ich] = ch.strawId().station();
+      _upanel[ich] = ch.strawId().uniquePanel();
+    }
+  }
+
+  size_t ComboHitSoAView::select(StrawHitFlag const& hsel, StrawHitFlag const& hbkg, std::vector<uint8_t>& sel) const {
+    size_t n = size();
+    sel.resize(n);
+    size_t nsel(0);
+    // branch-free, so the loop vectorizes
+    for(size_t ich=0; ich < n; ++ich){
+      uint8_t good = _flag[ich].hasAllProperties(hsel) & !_flag[ich].hasAnyProperty(hbkg);
+      sel[ich] = good;
+      nsel += good;
+    }
+    return nsel;
+  }
+
+  ComboHitSoAView const& ComboHitSoAView::get(ComboHitSoAView const* view, ComboHitCollection const& chcol, ComboHitSoAView& local) {
+    if(view != nullptr && view->size() == chcol.size())return *view;
+    local.fill(chcol);
+    return local;
+  }
+}
@@ -45,6 +45,15 @@ namespace mu2e {
           _sigma(sigma), _t0(t0) {};
       };
 
+      // the parts of the linear response to a charge pulse which don't depend on time
+      struct ClusterResponse{
+        double _charge;
+        double _reflectionTime; // time of the reflected pulse
+        double _reflectionScale; // relative size of the reflected pulse
+        size_t _distIndex; // wire distance interpolation point
+        double _distFrac; // interpolation weight of that point
+      };
+
       typedef std::shared_ptr<StrawElectronics> ptr_t;
       typedef std::shared_ptr<const StrawElectronics> cptr_t;
       constexpr static const char* cxname = {"StrawElectronics"};
@@ -108,6 +117,11 @@ namespace mu2e {
       // linear response to a charge pulse.  This does NOT include saturation effects,
       // since those are cumulative and cannot be computed for individual charges
       double linearResponse(Straw const& straw, Path ipath, double time, double charge, double distance, bool forsaturation=false) const; // mvolts per pCoulomb
+      // same, split into the time-independent part, computed once per charge, and the response at a time
+      ClusterResponse clusterResponse(Straw const& straw, double charge, double distance) const;
+      double linearResponse(Straw const& straw, Path ipath, double time, ClusterResponse const& cresp, bool forsaturation=false) const;
+      // time after which the linear response doesn't change anymore (the end of the response tables)
+      double constantResponseTime(ClusterResponse const& cresp) const;
       double adcImpulseResponse(StrawId sid, double time, double charge) const;
       // Given a (linear) total voltage, compute the saturated voltage
       double saturatedResponse(double lineearresponse) const;
@@ -68,29 +68,44 @@ namespace mu2e {
   }
 
   double StrawElectronics::linearResponse(Straw const& straw, Path ipath, double time, double charge, double distance, bool forsaturation) const {
+    return linearResponse(straw,ipath,time,clusterResponse(straw,charge,distance),forsaturation);
+  }
+
+  StrawElectronics::ClusterResponse StrawElectronics::clusterResponse(Straw const& straw, double charge, double distance) const {
+    ClusterResponse cresp;
+    cresp._charge = charge;
+
+    double straw_length = 2*straw.halfLength();
+    cresp._reflectionTime = _reflectionTimeShift + (2*straw_length-2*distance)/_reflectionVelocity;
+    cresp._reflectionScale = _reflectionFrac * exp(-(2*straw_length-2*distance)/_reflectionALength);
+
+    int  distIndex = 0;
+    for (size_t i=1;i<_wPoints.size()-1;i++){
+      if (distance < _wPoints[i]._distance)
+        break;
+      distIndex = i;
+    }
+    cresp._distIndex = distIndex;
+    cresp._distFrac = 1 - (distance - _wPoints[distIndex]._distance)/(_wPoints[distIndex+1]._distance - _wPoints[distIndex]._distance);
+    return cresp;
+  }
+
+  double StrawElectronics::linearResponse(Straw const& straw, Path ipath, double time, ClusterResponse const& cresp, bool forsaturation) const {
     int index = time*_sampleRate + _responseBins/2.;
     if ( index >= _responseBins)
       index = _responseBins-1;
     if (index < 0)
       index = 0;
 
-    double straw_length = 2*straw.halfLength();
-    double reflection_time = _reflectionTimeShift + (2*straw_length-2*distance)/_reflectionVelocity;
-    int index_refl = (time - reflection_time)*_sampleRate + _responseBins/2.;
+    int index_refl = (time - cresp._reflectionTime)*_sampleRate + _responseBins/2.;
     if (index_refl >= _responseBins)
       index_refl = _responseBins-1;
     if (index_refl < 0)
       index_refl = 0;
 
-    double reflection_scale = _reflectionFrac * exp(-(2*straw_length-2*distance)/_reflectionALength);
-
-    int  distIndex = 0;
-    for (size_t i=1;i<_wPoints.size()-1;i++){
-      if (distance < _wPoints[i]._distance)
-        break;
-      distIndex = i;
-    }
-    double distFrac = 1 - (distance - _wPoints[distIndex]._distance)/(_wPoints[distIndex+1]._distance - _wPoints[distIndex]._distance);
+    double reflection_scale = cresp._reflectionScale;
+    size_t distIndex = cresp._distIndex;
+    double distFrac = cresp._distFrac;
     double p0, p1;
     if (ipath == thresh){
       if (forsaturation){
@@ -104,7 +119,13 @@ namespace mu2e {
       p0 = _wPoints[distIndex]._adcResponse[index]      + _wPoints[distIndex]._adcResponse[index_refl]*reflection_scale;
       p1 = _wPoints[distIndex + 1]._adcResponse[index]  + _wPoints[distIndex + 1]._adcResponse[index_refl]*reflection_scale;
     }
-    return charge * ( p0 * distFrac + p1 * (1 - distFrac)) * _dVdI[ipath][straw.id().uniqueStraw()];
+    return cresp._charge * ( p0 * distFrac + p1 * (1 - distFrac)) * _dVdI[ipath][straw.id().uniqueStraw()];
+  }
+
+  double StrawElectronics::constantResponseTime(ClusterResponse const& cresp) const {
+    // beyond this time both the direct and the reflected pulse are in the last bin of the response,
+    // with one bin margin for rounding
+    return std::max(0.0,cresp._reflectionTime) + (_responseBins/2 + 1)/_sampleRate;
   }
 
   double StrawElectronics::adcImpulseResponse(StrawId sid, double time, double charge) const {
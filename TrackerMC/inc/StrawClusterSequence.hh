@@ -1,33 +1,50 @@
 #ifndef TrackerMC_StrawClusterSequence_hh
 #define TrackerMC_StrawClusterSequence_hh
 //
-// StrawClusterSequence is a time-ordered sequence of StrawClusters
+// StrawClusterSequence is a time-ordered sequence of StrawClusters.
+// The clusts themselves are held in a StrawClusterStore, the sequence
+// only references the range belonging to one straw end
 //
 // Original author David Brown, LBNL
 //
 
 // C++ includes
 #include <iostream>
-#include <list>
+#include <iterator>
+#include <cstddef>
 // Mu2e includes
 #include "Offline/TrackerMC/inc/StrawCluster.hh"
 #include "Offline/DataProducts/inc/StrawId.hh"
 
 namespace mu2e {
   namespace TrackerMC {
-    typedef std::list<StrawCluster> StrawClusterList;
+    // contiguous, time-ordered range of clusts
+    class StrawClusterList {
+      public:
+        typedef StrawCluster const* const_iterator;
+        typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+        StrawClusterList() : _begin(nullptr), _end(nullptr) {}
+        StrawClusterList(const_iterator begin, const_iterator end) : _begin(begin), _end(end) {}
+        const_iterator begin() const { return _begin; }
+        const_iterator end() const { return _end; }
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(_end); }
+        const_reverse_iterator rend() const { return const_reverse_iterator(_begin); }
+        StrawCluster const& front() const { return *_begin; }
+        StrawCluster const& back() const { return *(_end-1); }
+        size_t size() const { return _end-_begin; }
+        bool empty() const { return _end == _begin; }
+      private:
+        const_iterator _begin, _end;
+    };
+
     class StrawClusterSequence {
       public:
         // constructors
         StrawClusterSequence();
-        StrawClusterSequence(StrawCluster const& clust);
         StrawClusterSequence(StrawId const& sid, StrawEnd end);
-        StrawClusterSequence(StrawClusterSequence const& other);
-        StrawClusterSequence& operator =(StrawClusterSequence const& other);
+        StrawClusterSequence(StrawId const& sid, StrawEnd end, StrawClusterList const& clist);
         // accessors: just hand over the list!
         StrawClusterList const& clustList() const { return _clist; }
-        // insert a new clust, in time order.
-        StrawClusterList::iterator insert(StrawCluster const& clust);
         StrawId const& strawId() const { return _strawId; }
         StrawEnd const& strawEnd() const { return _end; }
       private:
@@ -9,14 +9,13 @@ namespace mu2e {
   namespace TrackerMC {
     class StrawClusterSequencePair{
       public:
-        typedef StrawCluster StrawClusterPair[2];
         StrawClusterSequencePair();
         StrawClusterSequencePair(StrawId sid);
+        StrawClusterSequencePair(StrawClusterSequence const& cal, StrawClusterSequence const& hv);
         StrawClusterSequencePair(StrawClusterSequencePair const& other);
         StrawClusterSequencePair& operator =(StrawClusterSequencePair const& other);
         StrawClusterSequence& clustSequence(StrawEnd end) { return _scseq[end]; }
         StrawClusterSequence const& clustSequence(StrawEnd end) const { return _scseq[end]; }
-        void insert(StrawClusterPair const& hpair);
         StrawId strawId() const { return _scseq[0].strawId(); }
       private:
         StrawClusterSequence _scseq[2];
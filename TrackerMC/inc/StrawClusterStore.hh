@@ -0,0 +1,47 @@
+#ifndef TrackerMC_StrawClusterStore_hh
+#define TrackerMC_StrawClusterStore_hh
+//
+// StrawClusterStore holds the clusts of all straws in an event, in one
+// flat array grouped by unique straw end (StrawId::uniqueStrawEnd).
+// Clusts are appended in the order they are made, without any lookup,
+// then sorted once, after which each straw end is a contiguous,
+// time-ordered range.  The store is cleared between events but keeps
+// its memory, so steady-state running makes no allocations
+//
+#include "Offline/TrackerMC/inc/StrawClusterSequencePair.hh"
+#include "Offline/DataProducts/inc/StrawId.hh"
+#include <vector>
+#include <cstdint>
+
+namespace mu2e {
+  namespace TrackerMC {
+    class StrawClusterStore {
+      public:
+        StrawClusterStore();
+        // remove all clusts, keeping the memory
+        void clear();
+        // add a clust.  It is not visible in the sequences until sort is called
+        void insert(StrawCluster const& clust);
+        // group the clusts by straw end and time-order them
+        void sort();
+        // straws with clusts on either end, in StrawId order.  Only valid after sort
+        std::vector<StrawId> const& straws() const { return _straws; }
+        // clust sequences of a straw.  Only valid after sort
+        StrawClusterSequence clustSequence(StrawId const& sid, StrawEnd end) const;
+        StrawClusterSequencePair clustSequencePair(StrawId const& sid) const;
+        size_t size() const { return _clusts.size(); }
+      private:
+        struct SortKey {
+          double _time;
+          uint32_t _index; // in _staged
+        };
+        std::vector<StrawCluster> _staged; // clusts in the order they were added
+        std::vector<StrawCluster> _clusts; // clusts grouped by straw end
+        std::vector<uint32_t> _offsets; // start of each straw end in _clusts
+        std::vector<SortKey> _keys;
+        std::vector<StrawId> _straws;
+        bool _sorted;
+    };
+  }
+}
+#endif
@@ -5,6 +5,11 @@
 // a straw, over the time period of 1 microbunch.  It includes all physical and electronics
 // effects prior to digitization.
 //
+// The clusters are copied into a time-ordered array together with the time-independent part
+// of their electronics response.  Once a cluster is older than the response tables, its response
+// is constant, so those clusters are summed once in running sums, and sampling the waveform only
+// evaluates the clusters within the response time.
+//
 // Original author David Brown, LBNL
 //
 
@@ -13,6 +18,7 @@
 #include <array>
 #include <vector>
 #include <utility>
+#include <cstddef>
 
 // Mu2e includes
 #include "Offline/DataProducts/inc/StrawEnd.hh"
@@ -40,8 +46,9 @@ namespace mu2e {
     struct WFX;
     class StrawWaveform{
       public:
-        // construct from a clust sequence and response object.  Scale affects the voltage
-        StrawWaveform(Straw const& straw, StrawClusterSequence const& hseqq, XTalk const& xtalk);
+        // construct from a clust sequence and response object.  Scale affects the voltage.
+        // The same electronics must be used for all the functions below
+        StrawWaveform(StrawElectronics const& strawele, Straw const& straw, StrawClusterSequence const& hseqq, XTalk const& xtalk);
         // disallow copy and assignment
         StrawWaveform() = delete; // don't allow default constructor, references can't be assigned empty
         StrawWaveform(StrawWaveform const& other);
@@ -65,7 +72,20 @@ namespace mu2e {
         StrawClusterSequence const& _cseq;
         XTalk _xtalk; // X-talk applied to all voltages
         Straw const& _straw;
+        // clusts with their time-independent response, in the order of the clust sequence
+        struct WFClust {
+          double _time;
+          StrawElectronics::ClusterResponse _cresp;
+        };
+        std::vector<WFClust> _clusts;
+        double _constantTime; // time after which the response of every clust is constant
+        std::vector<double> _constantSums[StrawElectronics::npaths]; // running sums of the constant responses
+        double _maxLinearSum; // sum of the maximum responses of all clusts
         // helper functions
+        double linearSum(StrawElectronics const& strawele,StrawElectronics::Path ipath,bool forsaturation,double time,
+            size_t ifirst,std::vector<double> const& constantSums) const;
+        void fillConstantSums(StrawElectronics const& strawele,StrawElectronics::Path ipath,bool forsaturation,
+            size_t ifirst,std::vector<double>& sums) const;
         void returnCrossing(StrawElectronics const& strawele, double threshold, WFX& wfx) const;
         bool roughCrossing(StrawElectronics const& strawele, double threshold, WFX& wfx) const;
         bool fineCrossing(StrawElectronics const& strawele, double threshold, double vmax, WFX& wfx) const;
@@ -5,7 +5,6 @@
 //
 // mu2e includes
 #include "Offline/TrackerMC/inc/StrawClusterSequence.hh"
-#include "cetlib_except/exception.h"
 
 using namespace std;
 
@@ -14,57 +13,12 @@ namespace mu2e {
     StrawClusterSequence::StrawClusterSequence() : _strawId(0), _end(StrawEnd::cal)
     {}
 
-    StrawClusterSequence::StrawClusterSequence(StrawCluster const& clust) :
-      _strawId(clust.strawId()), _end(clust.strawEnd())
-    {
-      insert(clust);
-    }
-
     StrawClusterSequence::StrawClusterSequence(StrawId const& sid, StrawEnd end) :
       _strawId(sid), _end(end)
     {}
 
-    StrawClusterSequence::StrawClusterSequence(StrawClusterSequence const& other) :
-      _strawId(other._strawId), _end(other._end), _clist(other._clist) {}
-
-    StrawClusterSequence& StrawClusterSequence::operator =(StrawClusterSequence const& other) {
-      if(&other != this){
-        _strawId = other._strawId;
-        _end = other._end;
-        _clist = other._clist;
-      }
-      return *this;
-    }
-    // insert a new clust.  This is the only non-trivial function
-    StrawClusterList::iterator StrawClusterSequence::insert(StrawCluster const& clust) {
-      StrawClusterList::iterator retval = _clist.end();
-      if(clust.type() == StrawCluster::unknown){
-        throw cet::exception("SIM")
-          << "mu2e::StrawClusterSequence: tried to add unknown clust type"
-          << endl;
-        return retval;
-      }
-      // make sure the straw and end are the same
-      if(!_clist.empty() && (clust.strawId() != strawId()
-            || clust.strawEnd() != strawEnd())){
-        throw cet::exception("SIM")
-          << "mu2e::StrawClusterSequence: tried to add clust from a different straw/end to a sequence"
-          << endl;
-        return retval;
-      }
-      if(_clist.empty()){
-        _clist.push_front(clust);
-        _strawId = clust.strawId();
-        _end = clust.strawEnd();
-        retval = _clist.begin();
-      } else {
-        // loop over the contents and insert in the correct place
-        StrawClusterList::iterator ibefore = _clist.begin();
-        while(ibefore != _clist.end() && ibefore->time() < clust.time())
-          ++ibefore;
-        retval = _clist.insert(ibefore,clust);
-      }
-      return retval;
-    }
+    StrawClusterSequence::StrawClusterSequence(StrawId const& sid, StrawEnd end, StrawClusterList const& clist) :
+      _strawId(sid), _end(end), _clist(clist)
+    {}
   }
 }
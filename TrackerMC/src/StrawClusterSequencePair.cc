@@ -14,6 +14,16 @@ namespace mu2e {
       _scseq{StrawClusterSequence(sid,StrawEnd::cal),StrawClusterSequence(sid,StrawEnd::hv)}
     {}
 
+    StrawClusterSequencePair::StrawClusterSequencePair(StrawClusterSequence const& cal, StrawClusterSequence const& hv)
+    {
+      if(cal.strawEnd() != StrawEnd::cal || hv.strawEnd() != StrawEnd::hv ||
+          cal.strawId() != hv.strawId())
+        throw cet::exception("SIM")
+          << "mu2e::StrawClusterSequencePair: tried to pair inconsistent clust sequences";
+      _scseq[StrawEnd::cal] = cal;
+      _scseq[StrawEnd::hv] = hv;
+    }
+
     StrawClusterSequencePair::StrawClusterSequencePair(StrawClusterSequencePair const& other)
     {
       _scseq[StrawEnd::cal] = other._scseq[StrawEnd::cal];
@@ -27,18 +37,5 @@ namespace mu2e {
       }
       return *this;
     }
-
-    void StrawClusterSequencePair::insert(StrawClusterPair const& hpair) {
-      if(hpair[StrawEnd::cal].strawEnd() != StrawEnd::cal ||
-          hpair[StrawEnd::hv].strawEnd() != StrawEnd::hv ||
-          hpair[0].strawId() != hpair[1].strawId())
-
-        throw cet::exception("SIM")
-          << "mu2e::StrawClusterSequence: tried to add inconsistent clust pair to sequence";
-
-      // maybe could use move symanatics here?  FIXME!!
-      _scseq[StrawEnd::cal].insert(hpair[StrawEnd::cal]);
-      _scseq[StrawEnd::hv].insert(hpair[StrawEnd::hv]);
-    }
   }
 }
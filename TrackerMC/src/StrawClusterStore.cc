@@ -0,0 +1,83 @@
+//
+// StrawClusterStore holds the clusts of all straws in an event, grouped by straw end
+//
+// mu2e includes
+#include "Offline/TrackerMC/inc/StrawClusterStore.hh"
+#include "cetlib_except/exception.h"
+#include <algorithm>
+#include <numeric>
+
+using namespace std;
+
+namespace mu2e {
+  namespace TrackerMC {
+    StrawClusterStore::StrawClusterStore() : _offsets(StrawId::_nustrawends+1,0), _sorted(true)
+    {}
+
+    void StrawClusterStore::clear() {
+      _staged.clear();
+      _clusts.clear();
+      _straws.clear();
+      std::fill(_offsets.begin(),_offsets.end(),0);
+      _sorted = true;
+    }
+
+    void StrawClusterStore::insert(StrawCluster const& clust) {
+      if(clust.type() == StrawCluster::unknown){
+        throw cet::exception("SIM")
+          << "mu2e::StrawClusterStore: tried to add unknown clust type"
+          << endl;
+      }
+      _staged.push_back(clust);
+      _sorted = false;
+    }
+
+    void StrawClusterStore::sort() {
+      // count the clusts of each straw end; offsets then give the end of each straw end's range
+      std::fill(_offsets.begin(),_offsets.end(),0);
+      for(auto const& clust : _staged)
+        ++_offsets[clust.strawId().uniqueStrawEnd(clust.strawEnd().end())];
+      std::partial_sum(_offsets.begin(),_offsets.end(),_offsets.begin());
+      // fill the ranges from the back, which leaves offsets at the start of each range
+      _keys.resize(_staged.size());
+      for(size_t iclust=0;iclust < _staged.size();++iclust){
+        StrawCluster const& clust = _staged[iclust];
+        _keys[--_offsets[clust.strawId().uniqueStrawEnd(clust.strawEnd().end())]] = SortKey{clust.time(),static_cast<uint32_t>(iclust)};
+      }
+      // time-order each straw end.  Clusts with the same time are ordered last-added first,
+      // as they were when each sequence was built by insertion
+      auto earlier = [](SortKey const& a, SortKey const& b) {
+        return a._time < b._time || (a._time == b._time && a._index > b._index); };
+      for(size_t iend=0;iend < StrawId::_nustrawends;++iend){
+        if(_offsets[iend+1] - _offsets[iend] > 1)
+          std::sort(_keys.begin()+_offsets[iend],_keys.begin()+_offsets[iend+1],earlier);
+      }
+      _clusts.clear();
+      _clusts.reserve(_staged.size());
+      for(auto const& key : _keys)
+        _clusts.push_back(_staged[key._index]);
+      // record the straws with any clusts
+      _straws.clear();
+      for(size_t iend=0;iend < StrawId::_nustrawends;iend += StrawEnd::nends){
+        if(_offsets[iend+StrawEnd::nends] > _offsets[iend])
+          _straws.push_back(_clusts[_offsets[iend]].strawId());
+      }
+      _sorted = true;
+    }
+
+    StrawClusterSequence StrawClusterStore::clustSequence(StrawId const& sid, StrawEnd end) const {
+      if(!_sorted){
+        throw cet::exception("SIM")
+          << "mu2e::StrawClusterStore: clust sequences requested before sorting"
+          << endl;
+      }
+      size_t iend = sid.uniqueStrawEnd(end.end());
+      StrawCluster const* clusts = _clusts.data();
+      return StrawClusterSequence(sid,end,StrawClusterList(clusts+_offsets[iend],clusts+_offsets[iend+1]));
+    }
+
+    StrawClusterSequencePair StrawClusterStore::clustSequencePair(StrawId const& sid) const {
+      return StrawClusterSequencePair(clustSequence(sid,StrawEnd::cal),clustSequence(sid,StrawEnd::hv));
+    }
+  }
+}
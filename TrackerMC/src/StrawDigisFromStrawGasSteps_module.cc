@@ -40,7 +40,7 @@
 #include "Offline/MCDataProducts/inc/StrawDigiMC.hh"
 #include "Offline/MCDataProducts/inc/SimParticle.hh"
 // temporary MC structures
-#include "Offline/TrackerMC/inc/StrawClusterSequencePair.hh"
+#include "Offline/TrackerMC/inc/StrawClusterStore.hh"
 #include "Offline/TrackerMC/inc/StrawWaveform.hh"
 #include "Offline/TrackerMC/inc/IonCluster.hh"
 #include "Offline/TrackerMC/inc/StrawPosition.hh"
@@ -51,6 +51,7 @@
 #include "CLHEP/Random/RandFlat.h"
 #include "CLHEP/Random/RandExponential.h"
 #include "CLHEP/Random/RandPoisson.h"
+#include "CLHEP/Random/MixMaxRng.h"
 #include "CLHEP/Vector/LorentzVector.h"
 // root
 #include "TMath.h"
@@ -59,12 +60,16 @@
 #include "TGraph.h"
 #include "TMarker.h"
 #include "TTree.h"
+// TBB
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
 // C++
-#include <map>
+#include <list>
 #include <algorithm>
 #include <array>
 #include <iostream>
 #include <limits>
+#include <iterator>
 using namespace std;
 using CLHEP::Hep3Vector;
 using EventIDCollection = std::vector<art::EventID>;
@@ -122,16 +127,22 @@ namespace mu2e {
           fhicl::Atom<art::InputTag> mixedDigisTag { Name("MixedDigisTag"), Comment("Source of digis to overlay event onto"), ""};
           fhicl::Atom<bool> mixDigiMCs { Name("MixDigiMCs"), Comment("Propagate mixed StrawDigiMCs through module"), false};
           fhicl::Atom<bool> allowEmptySteps { Name("AllowEmptyStrawGasSteps"), Comment("Allow digitization to proceed even without any valid straw gas step collections"), false};
+          fhicl::Atom<bool> parallelDigis { Name("ParallelDigitization"), Comment("Digitize the panels as parallel tasks.  The digis do not depend on this"), true};
         };
 
         typedef art::Ptr<StrawGasStep> SGSPtr;
         typedef art::Ptr<SimParticle> SPPtr;
-        typedef map<StrawId,StrawClusterSequencePair> StrawClusterMap;  // clusts by straw
         // work with pairs of waveforms, one for each straw end
         typedef std::array<StrawWaveform,2> SWFP;
         typedef std::array<WFX,2> WFXP;
         typedef list<WFXP> WFXPList;
         typedef WFXPList::const_iterator WFXPI;
+        // digis of one panel
+        struct PanelDigis {
+          StrawDigiCollection _digis;
+          StrawDigiADCWaveformCollection _digiadcs;
+          StrawDigiMCCollection _mcdigis;
+        };
 
         using Parameters = art::EDProducer::Table<Config>;
         explicit StrawDigisFromStrawGasSteps(const Parameters& config);
@@ -174,6 +185,10 @@ namespace mu2e {
         CLHEP::RandFlat _randflat;
         CLHEP::RandExponential _randexp;
         CLHEP::RandPoisson _randP;
+        // digitization random streams, one per panel, reseeded every event from _engine
+        // so the digis don't depend on how the panels are spread over threads
+        vector<CLHEP::MixMaxRng> _panelEngines;
+        bool _parallelDigis;
         // A category for the error logger.
         const string _messageCategory;
         // Give some informationation messages only on the first event.
@@ -224,6 +239,7 @@ namespace mu2e {
         Float_t _steplen, _stepE, _qsum, _esum, _eesum, _qe, _partP, _steptime;
         Int_t _nclust, _netot, _partPDG, _stype;
         vector<IonCluster> _clusters;
+        StrawClusterStore _clusterStore; // clusts of this event, by straw
         Float_t _pbtimemc;
         array<Float_t, StrawId::_nupanels> _ewMarkerROCdt;
         double _eventWindowLength;
@@ -232,14 +248,14 @@ namespace mu2e {
         double _digitizationEndFromMarker;
 
         //  helper functions
-        void fillClusterMap(StrawPhysics const& strawphys,
+        void fillClusterStore(StrawPhysics const& strawphys,
             StrawElectronics const& strawele,
-            art::Event const& event, StrawClusterMap & hmap);
+            art::Event const& event, StrawClusterStore& cstore);
         void addStep(StrawPhysics const& strawphys,
             StrawElectronics const& strawele,
             Straw const& straw,
             SGSPtr const& sgsptr,
-            StrawClusterSequencePair& shsp);
+            StrawClusterStore& cstore);
         void divideStep(StrawPhysics const& strawphys,
             StrawElectronics const& strawele,
             Straw const& straw,
@@ -250,21 +266,25 @@ namespace mu2e {
         void propagateCharge(StrawPhysics const& strawphys, Straw const& straw,
             WireCharge const& wireq, StrawEnd end, WireEndCharge& weq);
         double microbunchTime(StrawElectronics const& strawele, double globaltime) const;
-        void addGhosts(StrawElectronics const& strawele, StrawCluster const& clust,StrawClusterSequence& shs);
-        void addNoise(StrawClusterMap& hmap);
-        void findThresholdCrossings(StrawElectronics const& strawele, SWFP const& swfp, WFXPList& xings);
+        void addGhosts(StrawElectronics const& strawele, StrawCluster const& clust,StrawClusterStore& cstore);
+        void addNoise(StrawClusterStore& cstore);
+        void findThresholdCrossings(StrawElectronics const& strawele, SWFP const& swfp, CLHEP::RandGaussQ& randgauss, WFXPList& xings);
+        void digitizePanel(StrawPhysics const& strawphys,
+            StrawElectronics const& strawele,
+            vector<StrawId>::const_iterator const& begin, vector<StrawId>::const_iterator const& end,
+            array<long,2> const& seeds, PanelDigis& pdigis);
         void createDigis(StrawPhysics const& strawphys,
             StrawElectronics const& strawele,
             Straw const& straw,
             StrawClusterSequencePair const& hsp,
-            XTalk const& xtalk,
+            XTalk const& xtalk, CLHEP::RandGaussQ& randgauss,
             StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs, StrawDigiMCCollection* mcdigis);
         void fillDigis(StrawPhysics const& strawphys,
             StrawElectronics const& strawele,
-            WFXPList const& xings,SWFP const& swfp , StrawId sid,
+            WFXPList const& xings,SWFP const& swfp , StrawId sid, CLHEP::RandGaussQ& randgauss,
             StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs, StrawDigiMCCollection* mcdigis);
-        bool createDigi(StrawElectronics const& strawele,WFXP const& xpair, SWFP const& wf, StrawId sid, StrawDigiCollection* digis,
-            StrawDigiADCWaveformCollection* digiadcs, double &digitization_ready_time);
+        bool createDigi(StrawElectronics const& strawele,WFXP const& xpair, SWFP const& wf, StrawId sid, CLHEP::RandGaussQ& randgauss,
+            StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs, double &digitization_ready_time);
         void findCrossTalkStraws(Straw const& straw,vector<XTalk>& xtalk);
         void fillClusterNe(StrawPhysics const& strawphys,std::vector<unsigned>& me);
         void fillClusterPositions(StrawGasStep const& step, Straw const& straw, std::vector<StrawCoordinates>& cpos);
@@ -315,6 +335,8 @@ namespace mu2e {
       _randflat( _engine ),
       _randexp( _engine),
       _randP( _engine),
+      _panelEngines(StrawId::_nupanels),
+      _parallelDigis(config().parallelDigis()),
       _messageCategory("HITS"),
       _firstEvent(true),      // Control some information messages.
       _mixedDigisTag(config().mixedDigisTag()),
@@ -519,35 +541,50 @@ namespace mu2e {
       unique_ptr<StrawDigiCollection> digis(new StrawDigiCollection);
       unique_ptr<StrawDigiADCWaveformCollection> digiadcs(new StrawDigiADCWaveformCollection);
       unique_ptr<StrawDigiMCCollection> mcdigis(new StrawDigiMCCollection);
-      // create the StrawCluster map
-      // this is a map from straw ids to a list of all clusters on that straw from this event
-      StrawClusterMap hmap;
+      // collect all the clusters of this event, grouped by straw
+      _clusterStore.clear();
       // fill this from the event
-      fillClusterMap(strawphys,strawele,event,hmap);
+      fillClusterStore(strawphys,strawele,event,_clusterStore);
       // add noise clusts
-      if(_addNoise)addNoise(hmap);
-      // loop over the clust sequences (i.e. loop over straws, and for each get their list of clusters)
-      for(auto ihsp=hmap.begin();ihsp!= hmap.end();++ihsp){
-        StrawClusterSequencePair const& hsp = ihsp->second;
-        Straw const& straw = _tracker->getStraw(hsp.strawId());
-        // create primary digis from this clust sequence
-        XTalk self(hsp.strawId()); // this object represents the straws coupling to itself, ie 100%
-        createDigis(strawphys,strawele,straw,hsp,self,digis.get(),digiadcs.get(),mcdigis.get());
-        // if we're applying x-talk, look for nearby coupled straws
-        if(_addXtalk) {
-          // only apply if the charge is above a threshold
-          double totalCharge = 0;
-          for(auto ih=hsp.clustSequence(StrawEnd::cal).clustList().begin();ih!= hsp.clustSequence(StrawEnd::cal).clustList().end();++ih){
-            totalCharge += ih->charge();
-          }
-          if( totalCharge > _ctMinCharge){
-            vector<XTalk> xtalk;
-            findCrossTalkStraws(straw,xtalk);
-            for(auto ixtalk=xtalk.begin();ixtalk!=xtalk.end();++ixtalk){
-              createDigis(strawphys,strawele,straw,hsp,*ixtalk,digis.get(),digiadcs.get(),mcdigis.get());
-            }
-          }
-        }
+      if(_addNoise)addNoise(_clusterStore);
+      // time-order the clusters of each straw
+      _clusterStore.sort();
+      // split the straws by panel.  The straws are in StrawId order, so each panel is a contiguous range
+      vector<StrawId> const& straws = _clusterStore.straws();
+      vector<size_t> panelStart;
+      for(size_t istraw=0;istraw < straws.size();++istraw){
+        if(istraw == 0 || straws[istraw].uniquePanel() != straws[istraw-1].uniquePanel())
+          panelStart.push_back(istraw);
+      }
+      panelStart.push_back(straws.size());
+      // seeds for the panel random streams of this event
+      array<long,2> seeds = {_randflat.fireInt(numeric_limits<int>::max()),_randflat.fireInt(numeric_limits<int>::max())};
+      // digitize the panels independently.  The diagnostics fill module members, so they run serially
+      vector<PanelDigis> pdigis(panelStart.size()-1);
+      auto digitize = [&](size_t ipanel) {
+        digitizePanel(strawphys,strawele,straws.begin()+panelStart[ipanel],straws.begin()+panelStart[ipanel+1],seeds,pdigis[ipanel]);
+      };
+      if(_parallelDigis && _diag <= 1){
+        tbb::parallel_for(tbb::blocked_range<size_t>(0,pdigis.size()),
+            [&](tbb::blocked_range<size_t> const& range) {
+              for(size_t ipanel=range.begin();ipanel != range.end();++ipanel)
+                digitize(ipanel);
+            });
+      } else {
+        for(size_t ipanel=0;ipanel < pdigis.size();++ipanel)
+          digitize(ipanel);
+      }
+      // merge the panels, in StrawId order
+      size_t ndigis(0);
+      for(auto const& pd : pdigis)
+        ndigis += pd._digis.size();
+      digis->reserve(ndigis);
+      digiadcs->reserve(ndigis);
+      mcdigis->reserve(ndigis);
+      for(auto& pd : pdigis){
+        move(pd._digis.begin(),pd._digis.end(),back_inserter(*digis));
+        move(pd._digiadcs.begin(),pd._digiadcs.end(),back_inserter(*digiadcs));
+        move(pd._mcdigis.begin(),pd._mcdigis.end(),back_inserter(*mcdigis));
       }
       // bundle up new digis in global collection
       bundles.Append(*digis, *digiadcs, *mcdigis);
@@ -569,28 +606,67 @@ namespace mu2e {
 
     } // end produce
 
+    void StrawDigisFromStrawGasSteps::digitizePanel(
+        StrawPhysics const& strawphys,
+        StrawElectronics const& strawele,
+        vector<StrawId>::const_iterator const& begin, vector<StrawId>::const_iterator const& end,
+        array<long,2> const& seeds, PanelDigis& pdigis) {
+      // start this panel's random stream.  MixMax gives independent streams for different seed sets
+      uint16_t ipanel = begin->uniquePanel();
+      CLHEP::MixMaxRng& engine = _panelEngines[ipanel];
+      array<long,4> pseeds = {seeds[0],seeds[1],ipanel,0};
+      engine.setSeeds(pseeds.data(),pseeds.size());
+      CLHEP::RandGaussQ randgauss(engine);
+      StrawDigiCollection* digis = &pdigis._digis;
+      StrawDigiADCWaveformCollection* digiadcs = &pdigis._digiadcs;
+      StrawDigiMCCollection* mcdigis = &pdigis._mcdigis;
+      // loop over the clust sequences (i.e. loop over straws, and for each get their list of clusters)
+      for(auto isid=begin;isid != end;++isid){
+        StrawClusterSequencePair hsp = _clusterStore.clustSequencePair(*isid);
+        Straw const& straw = _tracker->getStraw(hsp.strawId());
+        // create primary digis from this clust sequence
+        XTalk self(hsp.strawId()); // this object represents the straws coupling to itself, ie 100%
+        createDigis(strawphys,strawele,straw,hsp,self,randgauss,digis,digiadcs,mcdigis);
+        // if we're applying x-talk, look for nearby coupled straws
+        if(_addXtalk) {
+          // only apply if the charge is above a threshold
+          double totalCharge = 0;
+          for(auto ih=hsp.clustSequence(StrawEnd::cal).clustList().begin();ih!= hsp.clustSequence(StrawEnd::cal).clustList().end();++ih){
+            totalCharge += ih->charge();
+          }
+          if( totalCharge > _ctMinCharge){
+            vector<XTalk> xtalk;
+            findCrossTalkStraws(straw,xtalk);
+            for(auto ixtalk=xtalk.begin();ixtalk!=xtalk.end();++ixtalk){
+              createDigis(strawphys,strawele,straw,hsp,*ixtalk,randgauss,digis,digiadcs,mcdigis);
+            }
+          }
+        }
+      }
+    }
+
     void StrawDigisFromStrawGasSteps::createDigis(
         StrawPhysics const& strawphys,
         StrawElectronics const& strawele,
         Straw const& straw,
         StrawClusterSequencePair const& hsp,
-        XTalk const& xtalk,
+        XTalk const& xtalk, CLHEP::RandGaussQ& randgauss,
         StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs,
         StrawDigiMCCollection* mcdigis) {
       // instantiate waveforms for both ends of this straw
-      SWFP waveforms  ={ StrawWaveform(straw,hsp.clustSequence(StrawEnd::cal),xtalk),
-        StrawWaveform(straw,hsp.clustSequence(StrawEnd::hv),xtalk) };
+      SWFP waveforms  ={ StrawWaveform(strawele,straw,hsp.clustSequence(StrawEnd::cal),xtalk),
+        StrawWaveform(strawele,straw,hsp.clustSequence(StrawEnd::hv),xtalk) };
       // find the threshold crossing points for these waveforms
       WFXPList xings;
       // find the threshold crossings
-      findThresholdCrossings(strawele,waveforms,xings);
+      findThresholdCrossings(strawele,waveforms,randgauss,xings);
       // convert the crossing points into digis, and add them to the event data
-      fillDigis(strawphys,strawele,xings,waveforms,xtalk._dest,digis,digiadcs,mcdigis);
+      fillDigis(strawphys,strawele,xings,waveforms,xtalk._dest,randgauss,digis,digiadcs,mcdigis);
     }
 
-    void StrawDigisFromStrawGasSteps::fillClusterMap(StrawPhysics const& strawphys,
+    void StrawDigisFromStrawGasSteps::fillClusterStore(StrawPhysics const& strawphys,
         StrawElectronics const& strawele,
-        art::Event const& event, StrawClusterMap & hmap){
+        art::Event const& event, StrawClusterStore& cstore){
 // get status if needed
       std::shared_ptr<const TrackerStatus> trackerStatus;
       if(_usestatus) {
@@ -602,7 +678,7 @@ namespace mu2e {
       // Informational message on the first event.
       if ( _firstEvent ) {
         mf::LogInfo log(_messageCategory);
-        log << "StrawDigisFromStrawGasSteps::fillHitMap will use StrawGasSteps from: \n";
+        log << "StrawDigisFromStrawGasSteps::fillClusterStore will use StrawGasSteps from: \n";
         for ( HandleVector::const_iterator i=stepsHandles.begin(), e=stepsHandles.end();
             i != e; ++i ){
           art::Provenance const& prov(*(i->provenance()));
@@ -624,8 +700,8 @@ namespace mu2e {
           if ( ((!_usestatus) || (!trackerStatus->noSignal(sid))) && sgs.ionizingEdep() > _minstepE){
             Straw const& straw = _tracker->getStraw(sid);
             auto sgsptr = SGSPtr(sgsch,isgs);
-            // create a clust from this step, and add it to the clust map
-            addStep(strawphys,strawele,straw,sgsptr,hmap[sid]);
+            // create a clust from this step, and add it to the clust store
+            addStep(strawphys,strawele,straw,sgsptr,cstore);
           } else if(_debug > 0) {
             StrawStatus stat;
             if(_usestatus) stat = trackerStatus->strawStatus(sid);
@@ -639,7 +715,7 @@ namespace mu2e {
         StrawElectronics const& strawele,
         Straw const& straw,
         SGSPtr const& sgsptr,
-        StrawClusterSequencePair& shsp) {
+        StrawClusterStore& cstore) {
       auto const& sgs = *sgsptr;
       StrawId sid = sgs.strawId();
       // apply time offsets, and take module with MB
@@ -666,11 +742,11 @@ namespace mu2e {
             double gtime = ctime + wireq._time + weq._time;
             // create the clust
             StrawCluster clust(StrawCluster::primary,sid,end,(float)gtime,weq._charge,weq._wdist,wireq._pos,(float)wireq._time,(float)weq._time,sgsptr,(float)ctime);
-            // add the clusts to the appropriate sequence.
-            shsp.clustSequence(end).insert(clust);
+            // add the clusts to the store; they are sorted into sequences later
+            cstore.insert(clust);
             // if required, add a 'ghost' copy of this clust
             if (_onSpill)
-              addGhosts(strawele,clust,shsp.clustSequence(end));
+              addGhosts(strawele,clust,cstore);
           }
         }
         if(_diag > 0) stepDiag(strawphys, strawele, sgs);
@@ -782,24 +858,24 @@ namespace mu2e {
       return mbtime;
     }
 
-    void StrawDigisFromStrawGasSteps::addGhosts(StrawElectronics const& strawele,StrawCluster const& clust,StrawClusterSequence& shs) {
+    void StrawDigisFromStrawGasSteps::addGhosts(StrawElectronics const& strawele,StrawCluster const& clust,StrawClusterStore& cstore) {
       // add enough buffer to cover both the flash blanking and the ADC waveform
       // at this point cluster times are relative to marker and wrapped at 1695 (if onspill)
       // wrap from beginning of microbunch to times > 1695 to digitize ADCs for hits near end of event window
       if(clust.time() < _mbbuffer)
-        shs.insert(StrawCluster(clust,_mbtime));
+        cstore.insert(StrawCluster(clust,_mbtime));
       // wrap from end of microbunch to negative time to digitize ADCs for hits at tdc time=0
-      if(clust.time() > _mbtime - _mbbuffer) shs.insert(StrawCluster(clust,-_mbtime));
+      if(clust.time() > _mbtime - _mbbuffer) cstore.insert(StrawCluster(clust,-_mbtime));
     }
 
-    void StrawDigisFromStrawGasSteps::findThresholdCrossings(StrawElectronics const& strawele, SWFP const& swfp, WFXPList& xings){
+    void StrawDigisFromStrawGasSteps::findThresholdCrossings(StrawElectronics const& strawele, SWFP const& swfp, CLHEP::RandGaussQ& randgauss, WFXPList& xings){
       //randomize the threshold to account for electronics noise; this includes parts that are coherent
       // for both ends (coming from the straw itself)
       // Keep track of crossings on each end to keep them in sequence
-      double strawnoise = _randgauss.fire(0,strawele.strawNoise());
+      double strawnoise = randgauss.fire(0,strawele.strawNoise());
       // add specifics for each end
-      double thresh[2] = {_randgauss.fire(strawele.threshold(swfp[0].straw().id(),static_cast<StrawEnd::End>(0))+strawnoise,strawele.analogNoise(StrawElectronics::thresh)),
-        _randgauss.fire(strawele.threshold(swfp[0].straw().id(),static_cast<StrawEnd::End>(1))+strawnoise,strawele.analogNoise(StrawElectronics::thresh))};
+      double thresh[2] = {randgauss.fire(strawele.threshold(swfp[0].straw().id(),static_cast<StrawEnd::End>(0))+strawnoise,strawele.analogNoise(StrawElectronics::thresh)),
+        randgauss.fire(strawele.threshold(swfp[0].straw().id(),static_cast<StrawEnd::End>(1))+strawnoise,strawele.analogNoise(StrawElectronics::thresh))};
       // Initialize search when the electronics becomes enabled:
       double tstart =strawele.digitizationStartFromMarker() - _flashbuffer;
       // for reading all hits, make sure we start looking for clusters at the minimum possible cluster time
@@ -822,14 +898,14 @@ namespace mu2e {
           if(std::min(wfx[0]._time,wfx[1]._time) > 0.0 )xings.push_back(wfx);
           // search for next crossing:
           // update threshold for straw noise
-          strawnoise = _randgauss.fire(0,strawele.strawNoise());
+          strawnoise = randgauss.fire(0,strawele.strawNoise());
           for(unsigned iend=0;iend<2;++iend){
             // insure a minimum time buffer between crossings
             wfx[iend]._time += strawele.deadTimeAnalog();
             // skip to the next clust
             ++(wfx[iend]._iclust);
             // update threshold for incoherent noise
-            thresh[iend] = _randgauss.fire(strawele.threshold(swfp[0].straw().id(),static_cast<StrawEnd::End>(iend)),strawele.analogNoise(StrawElectronics::thresh));
+            thresh[iend] = randgauss.fire(strawele.threshold(swfp[0].straw().id(),static_cast<StrawEnd::End>(iend)),strawele.analogNoise(StrawElectronics::thresh));
             // find next crossing
             crosses[iend] = swfp[iend].crossesThreshold(strawele,thresh[iend],wfx[iend]);
           }
@@ -846,7 +922,7 @@ namespace mu2e {
     void StrawDigisFromStrawGasSteps::fillDigis(StrawPhysics const& strawphys,
         StrawElectronics const& strawele,
         WFXPList const& xings, SWFP const& wf,
-        StrawId sid,
+        StrawId sid, CLHEP::RandGaussQ& randgauss,
         StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs,
         StrawDigiMCCollection* mcdigis ) {
       //
@@ -856,7 +932,7 @@ namespace mu2e {
       for(auto xpair : xings) {
         // create a digi from this pair.  This also performs a finial test
         // on whether the pair should make a digi
-        if(createDigi(strawele,xpair,wf,sid,digis,digiadcs,digitization_ready_time)){
+        if(createDigi(strawele,xpair,wf,sid,randgauss,digis,digiadcs,digitization_ready_time)){
           // fill associated MC truth matching. Only count the same step once
           StrawDigiMC::SGSPA sgspa;
           StrawDigiMC::PA cpos;
@@ -891,7 +967,8 @@ namespace mu2e {
     }
 
     bool StrawDigisFromStrawGasSteps::createDigi(StrawElectronics const& strawele, WFXP const& xpair, SWFP const& waveform,
-        StrawId sid, StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs, double &digitization_ready_time){
+        StrawId sid, CLHEP::RandGaussQ& randgauss,
+        StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs, double &digitization_ready_time){
       // initialize the float variables that we later digitize
       TDCTimes xtimes = {0.0,0.0};
       TrkTypes::TOTValues tot;
@@ -908,10 +985,10 @@ namespace mu2e {
         WFX const& wfx = xpair[iend];
         // record the crossing time for this end, including clock jitter  These already include noise effects
         // add noise for TDC on each side
-        double tdc_jitter = _randgauss.fire(0.0,strawele.TDCResolution());
+        double tdc_jitter = randgauss.fire(0.0,strawele.TDCResolution());
         xtimes[iend] = wfx._time+dt+tdc_jitter;
         // randomize threshold using the incoherent noise
-        double threshold = _randgauss.fire(wfx._vcross,strawele.analogNoise(StrawElectronics::thresh));
+        double threshold = randgauss.fire(wfx._vcross,strawele.analogNoise(StrawElectronics::thresh));
         // find TOT
         tot[iend] = waveform[iend].digitizeTOT(strawele,threshold,wfx._time + dt);
         // sample ADC
@@ -926,7 +1003,7 @@ namespace mu2e {
       // add ends and add noise
       ADCVoltages wfsum; wfsum.reserve(adctimes.size());
       for(unsigned isamp=0;isamp<adctimes.size();++isamp){
-        wfsum.push_back(wf[0][isamp]+wf[1][isamp]+_randgauss.fire(0.0,strawele.analogNoise(StrawElectronics::adc)));
+        wfsum.push_back(wf[0][isamp]+wf[1][isamp]+randgauss.fire(0.0,strawele.analogNoise(StrawElectronics::adc)));
       }
       // digitize, and make final test.  This call includes the clock error WRT the proton pulse
       TrkTypes::TDCValues tdcs;
@@ -975,7 +1052,7 @@ namespace mu2e {
 
     // functions that need implementing:: FIXME!!!!!!
     // Could also fold in beam-off random trigger hits from real data
-    void StrawDigisFromStrawGasSteps::addNoise(StrawClusterMap& hmap){
+    void StrawDigisFromStrawGasSteps::addNoise(StrawClusterStore& cstore){
       // create random noise clusts and add them to the sequences of random straws.
     }
 
@@ -7,19 +7,37 @@
 //
 #include "Offline/TrackerMC/inc/StrawWaveform.hh"
 #include <cmath>
+#include <algorithm>
 #include <boost/math/special_functions/binomial.hpp>
 
 using namespace std;
 namespace mu2e {
   using namespace TrkTypes;
   namespace TrackerMC {
-    StrawWaveform::StrawWaveform(Straw const& straw, StrawClusterSequence const& hseq, XTalk const& xtalk) :
-      _cseq(hseq), _xtalk(xtalk), _straw(straw)
-    {}
+    StrawWaveform::StrawWaveform(StrawElectronics const& strawele, Straw const& straw, StrawClusterSequence const& hseq, XTalk const& xtalk) :
+      _cseq(hseq), _xtalk(xtalk), _straw(straw), _constantTime(0.0), _maxLinearSum(0.0)
+    {
+      StrawClusterList const& hlist = _cseq.clustList();
+      _clusts.reserve(hlist.size());
+      for(auto iclust = hlist.begin(); iclust != hlist.end(); ++iclust){
+        WFClust wfc;
+        wfc._time = iclust->time();
+        wfc._cresp = strawele.clusterResponse(_straw,iclust->charge(),iclust->wireDistance());
+        _constantTime = std::max(_constantTime,strawele.constantResponseTime(wfc._cresp));
+        _clusts.push_back(wfc);
+        _maxLinearSum += maxLinearResponse(strawele,iclust);
+      }
+      for(size_t ipath=0;ipath<StrawElectronics::npaths;++ipath)
+        fillConstantSums(strawele,static_cast<StrawElectronics::Path>(ipath),false,0,_constantSums[ipath]);
+    }
 
     StrawWaveform::StrawWaveform(StrawWaveform const& other) : _cseq(other._cseq),
-    _xtalk(other._xtalk), _straw(other._straw)
-    {}
+    _xtalk(other._xtalk), _straw(other._straw), _clusts(other._clusts), _constantTime(other._constantTime),
+    _maxLinearSum(other._maxLinearSum)
+    {
+      for(size_t ipath=0;ipath<StrawElectronics::npaths;++ipath)
+        _constantSums[ipath] = other._constantSums[ipath];
+    }
 
     bool StrawWaveform::crossesThreshold(StrawElectronics const& strawele,double threshold,WFX& wfx) const {
       bool retval(false);
@@ -146,17 +164,40 @@ namespace mu2e {
       return linresp;
     }
 
-    double StrawWaveform::sampleWaveform(StrawElectronics const& strawele,StrawElectronics::Path ipath,double time) const {
-      // loop over all clusts and add their response at this time
-      StrawClusterList const& hlist = _cseq.clustList();
-      double linresp(0.0);
-      auto iclust = hlist.begin();
-      while(iclust != hlist.end() && iclust->time()-strawele.clusterLookbackTime() < time){
+    void StrawWaveform::fillConstantSums(StrawElectronics const& strawele,StrawElectronics::Path ipath,bool forsaturation,
+        size_t ifirst,std::vector<double>& sums) const {
+      // running sums of the constant late responses of the clusts from ifirst on, in the order they are summed in linearSum
+      sums.clear();
+      sums.reserve(_clusts.size()-ifirst+1);
+      double sum(0.0);
+      sums.push_back(sum);
+      for(size_t iclust=ifirst;iclust<_clusts.size();++iclust){
+        WFClust const& wfc = _clusts[iclust];
+        sum += strawele.linearResponse(_straw,ipath,strawele.constantResponseTime(wfc._cresp),wfc._cresp,forsaturation);
+        sums.push_back(sum);
+      }
+    }
+
+    double StrawWaveform::linearSum(StrawElectronics const& strawele,StrawElectronics::Path ipath,bool forsaturation,double time,
+        size_t ifirst,std::vector<double> const& constantSums) const {
+      // add the response at this time of all clusts from ifirst on which arrived before this time.
+      // The clusts which are so old that their response is constant are taken from the running sums
+      auto first = _clusts.begin()+ifirst;
+      auto end = std::partition_point(first,_clusts.end(),
+          [&strawele,time](WFClust const& wfc){ return wfc._time-strawele.clusterLookbackTime() < time; });
+      auto iclust = std::partition_point(first,end,
+          [this,time](WFClust const& wfc){ return time-wfc._time >= _constantTime; });
+      double linresp = constantSums[iclust-first];
+      for(;iclust != end;++iclust){
         // compute the linear straw electronics response to this charge.  This is pre-saturation
-        linresp += strawele.linearResponse(_straw,ipath,time-iclust->time(),iclust->charge(),iclust->wireDistance());
-        // move to next clust
-        ++iclust;
+        linresp += strawele.linearResponse(_straw,ipath,time-iclust->_time,iclust->_cresp,forsaturation);
       }
+      return linresp;
+    }
+
+    double StrawWaveform::sampleWaveform(StrawElectronics const& strawele,StrawElectronics::Path ipath,double time) const {
+      // add the response of all clusts at this time
+      double linresp = linearSum(strawele,ipath,false,time,0,_constantSums[ipath]);
       double totresp = linresp * _xtalk._postamp;
       if(_xtalk._preamp>0.0)
         totresp += _xtalk._preamp*linresp;
@@ -175,19 +216,16 @@ namespace mu2e {
       }
 
       // check if going to be saturated
-      double max_possible_voltage = 0;
-      for (auto iclust = _cseq.clustList().begin();iclust != _cseq.clustList().end();++iclust){
-        max_possible_voltage += maxLinearResponse(strawele,iclust);
-      }
+      double max_possible_voltage = _maxLinearSum;
       if (max_possible_voltage > strawele.saturationVoltage()){
         // create waveform of threshold circuit output
         // step along waveform and apply saturation
         // for each time, get contribution from each step in waveform using impulse response
 
         // skip to the first cluster that matters for the first adc time
-        auto iclust = _cseq.clustList().begin();
-        while (iclust != _cseq.clustList().end()){
-          double time = iclust->time()-strawele.clusterLookbackTime();
+        size_t iclust = 0;
+        while (iclust < _clusts.size()){
+          double time = _clusts[iclust]._time-strawele.clusterLookbackTime();
           if (time + strawele.truncationTime(StrawElectronics::thresh) > times[0])
             break;
           else
@@ -198,18 +236,20 @@ namespace mu2e {
         for (size_t j=0;j<times.size();j++){
           volts.push_back(0);
         }
+        // no cluster matters
+        if (iclust == _clusts.size())
+          return;
 
-        int num_steps = (int)ceil((times[times.size()-1]-iclust->time()-strawele.clusterLookbackTime())/strawele.saturationTimeStep());
+        // constant responses of the old clusters, for the saturation path
+        std::vector<double> satConstantSums;
+        fillConstantSums(strawele,StrawElectronics::thresh,true,iclust,satConstantSums);
+
+        int num_steps = (int)ceil((times[times.size()-1]-_clusts[iclust]._time-strawele.clusterLookbackTime())/strawele.saturationTimeStep());
 
         for (int i=0;i<num_steps;i++){
-          double time = iclust->time()-strawele.clusterLookbackTime() + i*strawele.saturationTimeStep();
+          double time = _clusts[iclust]._time-strawele.clusterLookbackTime() + i*strawele.saturationTimeStep();
           // sum up the preamp response at this step
-          double response = 0;
-          auto jclust = iclust;
-          while(jclust != _cseq.clustList().end() && jclust->time()-strawele.clusterLookbackTime() < time){
-            response += strawele.linearResponse(_straw,StrawElectronics::thresh,time-jclust->time(),jclust->charge(),jclust->wireDistance(),true);
-            ++jclust;
-          }
+          double response = linearSum(strawele,StrawElectronics::thresh,true,time,iclust,satConstantSums);
           // now saturate it
           double sat_response = strawele.saturatedResponse(response);
           // then calculate the impulse response at each of the adctimes and add it to that
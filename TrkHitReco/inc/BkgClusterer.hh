@@ -3,6 +3,7 @@
 
 #include "Offline/RecoDataProducts/inc/BkgCluster.hh"
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitSoAView.hh"
 
 namespace mu2e
 {
@@ -11,7 +12,8 @@ namespace mu2e
     public:
       virtual ~BkgClusterer() {};
       virtual void  init        () = 0;
-      virtual void  findClusters(BkgClusterCollection& clusters, const ComboHitCollection& shcol, int iev) = 0;
+      // chv is the structure-of-arrays view of shcol
+      virtual void  findClusters(BkgClusterCollection& clusters, const ComboHitCollection& shcol, const ComboHitSoAView& chv, int iev) = 0;
       virtual float distance    (const BkgCluster& cluster, const ComboHit& hit) const = 0;
   };
 }
@@ -49,16 +49,18 @@ namespace mu2e {
       virtual ~Chi2Clusterer() {};
 
       void init();
-      virtual void  findClusters(BkgClusterCollection& clusters, const ComboHitCollection& shcol, int iev);
+      virtual void  findClusters(BkgClusterCollection& clusters, const ComboHitCollection& shcol, const ComboHitSoAView& chv, int iev);
       virtual float distance    (const BkgCluster& cluster,      const ComboHit& hit) const;
 
 
     private:
       size_t numBuckets_; //number of buckets to store the cluster ids vs time
 
-      void     initClustering  (const ComboHitCollection& chcol, std::vector<Chi2BkgHit>& hinfo);
-      void     doClustering    (const ComboHitCollection& chcol, std::vector<BkgCluster>& clusters, std::vector<Chi2BkgHit>& hinfo);
-      unsigned formClusters    (const ComboHitCollection& chcol, std::vector<BkgCluster>& clusters, std::vector<Chi2BkgHit>& hinfo);
+      void     initClustering  (const ComboHitCollection& chcol, const ComboHitSoAView& chv, std::vector<Chi2BkgHit>& hinfo);
+      void     doClustering    (const ComboHitSoAView& chv, std::vector<BkgCluster>& clusters, std::vector<Chi2BkgHit>& hinfo);
+      unsigned formClusters    (const ComboHitSoAView& chv, std::vector<BkgCluster>& clusters, std::vector<Chi2BkgHit>& hinfo);
+      float    distance        (const BkgCluster& cluster, const TwoDPoint& point) const;
+      static TwoDPoint hitPoint(const ComboHitSoAView& chv, size_t ich);
       void     dump            (const std::vector<BkgCluster>& clusters, const std::vector<Chi2BkgHit>& hinfo);
 
       float                   tbin_;
@@ -60,20 +60,22 @@ namespace mu2e {
       virtual ~TNTClusterer() {};
 
       void          init        ();
-      virtual void  findClusters(BkgClusterCollection& clusters, const ComboHitCollection& shcol, int iev);
+      virtual void  findClusters(BkgClusterCollection& clusters, const ComboHitCollection& shcol, const ComboHitSoAView& chv, int iev);
       virtual float distance    (const BkgCluster& cluster,      const ComboHit& hit) const;
 
 
     private:
       static constexpr int numBuckets_ =256; //number of buckets to store the cluster ids vs time
 
-      void     initClustering  (const ComboHitCollection& chcol, std::vector<BkgHit>& hinfo);
-      void     doClustering    (const ComboHitCollection& chcol, std::vector<BkgCluster>& clusters, std::vector<BkgHit>& hinfo);
-      unsigned formClusters    (const ComboHitCollection& chcol, std::vector<BkgCluster>& clusters, std::vector<BkgHit>& hinfo);
-      void     mergeClusters   (std::vector<BkgCluster>& clusters, const ComboHitCollection& chcol, std::vector<BkgHit>& hinfo,
+      void     initClustering  (const ComboHitSoAView& chv, std::vector<BkgHit>& hinfo);
+      void     doClustering    (const ComboHitSoAView& chv, std::vector<BkgCluster>& clusters, std::vector<BkgHit>& hinfo);
+      unsigned formClusters    (const ComboHitSoAView& chv, std::vector<BkgCluster>& clusters, std::vector<BkgHit>& hinfo);
+      void     mergeClusters   (std::vector<BkgCluster>& clusters, const ComboHitSoAView& chv, std::vector<BkgHit>& hinfo,
                                 float dt, float dd2);
       void     mergeTwoClusters(BkgCluster& clu1, BkgCluster& clu2);
-      void     updateCluster   (BkgCluster& cluster, const ComboHitCollection& chcol, std::vector<BkgHit>& hinfo);
+      void     updateCluster   (BkgCluster& cluster, const ComboHitSoAView& chv, std::vector<BkgHit>& hinfo);
+      float    distance        (const BkgCluster& cluster, const ComboHitSoAView& chv, size_t ich) const;
+      float    distance        (const BkgCluster& cluster, float hx, float hy, float htime, float hwx, float hwy, float hwres) const;
       void     dump            (const std::vector<BkgCluster>& clusters, const std::vector<BkgHit>& hinfo);
 
       float                   tbin_;
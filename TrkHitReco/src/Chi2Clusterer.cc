@@ -30,15 +30,15 @@ namespace mu2e
 
 
   //----------------------------------------------------------------------------------------------------------
-  void Chi2Clusterer::findClusters(BkgClusterCollection& clusters, const ComboHitCollection& chcol, int iev)
+  void Chi2Clusterer::findClusters(BkgClusterCollection& clusters, const ComboHitCollection& chcol, const ComboHitSoAView& chv, int iev)
   {
 
     std::vector<Chi2BkgHit> BkgHits;
     BkgHits.reserve(chcol.size());
     if (chcol.empty()) return;
 
-    initClustering(chcol, BkgHits);
-    doClustering(chcol, clusters, BkgHits);
+    initClustering(chcol, chv, BkgHits);
+    doClustering(chv, clusters, BkgHits);
 
     auto transPred = [&BkgHits] (const int i) {return BkgHits[i].chidx_;};
     for (auto& cluster: clusters) std::transform(cluster.hits().begin(),cluster.hits().end(),cluster.hits().begin(),transPred);
@@ -49,26 +49,33 @@ namespace mu2e
 
 
   //----------------------------------------------------------------------------------------------------------------------
-  void Chi2Clusterer::initClustering(const ComboHitCollection& chcol, std::vector<Chi2BkgHit>& BkgHits)
+  void Chi2Clusterer::initClustering(const ComboHitCollection& chcol, const ComboHitSoAView& chv, std::vector<Chi2BkgHit>& BkgHits)
   {
+     // the time range is per event, so the buckets don't depend on which events this clusterer saw before
+     tmin_ = 1800.;
+     tmax_ = 0.;
+     const StrawHitFlag* flag  = chv.flag();
+     const float*        ctime = chv.correctedTime();
      float sumDriftTime(0);
-     for (size_t ich=0;ich<chcol.size();++ich) {
-       if (testflag_ && (!chcol[ich].flag().hasAllProperties(sigmask_) || chcol[ich].flag().hasAnyProperty(bkgmask_))) continue;
+     for (size_t ich=0;ich<chv.size();++ich) {
+       if (testflag_ && (!flag[ich].hasAllProperties(sigmask_) || flag[ich].hasAnyProperty(bkgmask_))) continue;
        BkgHits.emplace_back(Chi2BkgHit(ich));
-       tmin_ = std::min(tmin_,chcol[ich].correctedTime());
-       tmax_ = std::max(tmax_,chcol[ich].correctedTime());
+       tmin_ = std::min(tmin_,ctime[ich]);
+       tmax_ = std::max(tmax_,ctime[ich]);
        sumDriftTime += chcol[ich].driftTime();
      }
      tbin_ = (sumDriftTime/chcol.size())/2.;
      numBuckets_ = (tmax_ - tmin_ + tbin_)/tbin_;
 
-     auto resPred = [&chcol](const Chi2BkgHit& x, const Chi2BkgHit& y) {return chcol[x.chidx_].wireRes() < chcol[y.chidx_].wireRes();};
+     // ordering by wire variance is the same as ordering by wire resolution
+     const float* wvar = chv.wireVar();
+     auto resPred = [wvar](const Chi2BkgHit& x, const Chi2BkgHit& y) {return wvar[x.chidx_] < wvar[y.chidx_];};
      std::sort(BkgHits.begin(),BkgHits.end(),resPred);
   }
 
 
   //----------------------------------------------------------------------------------------------------------------------
-  void Chi2Clusterer::doClustering(const ComboHitCollection& chcol, std::vector<BkgCluster>& clusters, std::vector<Chi2BkgHit>& BkgHits)
+  void Chi2Clusterer::doClustering(const ComboHitSoAView& chv, std::vector<BkgCluster>& clusters, std::vector<Chi2BkgHit>& BkgHits)
   {
     unsigned niter(0);
     float prevChi2(0);
@@ -76,7 +83,7 @@ namespace mu2e
     //Check average Chi2 change.
     while ( deltaChi2 > chi2Cut_ && niter < maxNiter_ ) {
       ++niter;
-      formClusters(chcol, clusters, BkgHits);
+      formClusters(chv, clusters, BkgHits);
 
       float aveChi2(0);
       float sumChi2(0);
@@ -100,8 +107,10 @@ namespace mu2e
   // Create a new cluster if there is none. For new hits, check how much cluster chi2 is going to change when a new hit is added for all existing clusters.
   // For the minimum change, if the change is within dhit_ parameter, add it to the cluster. Create a new cluster if change is greater than dseed_.
   // Remove clusters with only single combo hit and try again to place them into existing clusters.
-  unsigned Chi2Clusterer::formClusters(const ComboHitCollection& chcol, std::vector<BkgCluster>& clusters, std::vector<Chi2BkgHit>& BkgHits)
+  unsigned Chi2Clusterer::formClusters(const ComboHitSoAView& chv, std::vector<BkgCluster>& clusters, std::vector<Chi2BkgHit>& BkgHits)
   {
+    const float*    ctime = chv.correctedTime();
+    const uint16_t* nsh   = chv.nStrawHits();
     std::vector<std::vector<size_t>> clusterIndices;
     clusterIndices.resize(numBuckets_);
     for (size_t ic=0;ic<clusters.size();++ic) {
@@ -114,31 +123,32 @@ namespace mu2e
     for (size_t ihit=0;ihit<BkgHits.size();++ihit) {
 
       auto& hit  = BkgHits[ihit];
-      const auto& chit = chcol[hit.chidx_];
+      size_t ich = hit.chidx_;
 
       if(hit.clusterIdx_ == -1){
         // -- find closest cluster. restrict search to clusters close in time using the clusterIndices structure
+        TwoDPoint point = hitPoint(chv,ich);
         int minc(-1);
         float mindist(dseed_ + 1.0f);
-        size_t itime = size_t((chit.correctedTime()-tmin_)/tbin_);
+        size_t itime = size_t((ctime[ich]-tmin_)/tbin_);
         size_t imin = std::max((size_t)0,itime-ditime);
         size_t imax = std::min(numBuckets_,itime+ditime+1);
 
         for (size_t i=imin;i<imax;++i) {
           for (const auto& ic : clusterIndices[i]) {
-            float dist = distance(clusters[ic],chcol[hit.chidx_]);
+            float dist = distance(clusters[ic],point);
             if (dist < mindist) {mindist = dist;minc = ic;}
           }
         }
 
         // -- either add hit to existing cluster, form new cluster, or do nothing if hit is "in between"
         if (mindist < dhit_)
-          clusters[minc].addHit(ihit,TwoDPoint(chit.pos(),chit.uDir(),chit.uVar(),chit.vVar()));
+          clusters[minc].addHit(ihit,point);
         else if (mindist > dseed_) {
           minc = clusters.size();
-          clusters.emplace_back(BkgCluster(TwoDPoint(chit.pos(),chit.uDir(),chit.uVar(),chit.vVar()),distMethodFlag_));
+          clusters.emplace_back(BkgCluster(point,distMethodFlag_));
           clusters[minc].addHit(ihit);
-          size_t itime = size_t((chit.correctedTime()-tmin_)/tbin_);
+          size_t itime = size_t((ctime[ich]-tmin_)/tbin_);
           clusterIndices[itime].emplace_back(minc);
         }
         else minc = -1;
@@ -155,8 +165,8 @@ namespace mu2e
         float weight(0.),wtime(0.);
         for (auto& hit : (*cluster).hits()){
           BkgHits[hit].clusterIdx_ = std::distance(clusters.begin(),cluster);
-          weight += chcol[BkgHits[hit].chidx_].nStrawHits();
-          wtime += chcol[BkgHits[hit].chidx_].correctedTime()*chcol[BkgHits[hit].chidx_].nStrawHits();
+          weight += nsh[BkgHits[hit].chidx_];
+          wtime += ctime[BkgHits[hit].chidx_]*nsh[BkgHits[hit].chidx_];
         }
         (*cluster)._time = wtime/weight;
         ++cluster;
@@ -168,7 +178,20 @@ namespace mu2e
   //---------------------------------------------------------------------------------------
   float Chi2Clusterer::distance(const BkgCluster& cluster, const ComboHit& hit) const
   {
-    return std::sqrt(cluster.points().dChi2(TwoDPoint(hit.pos(),hit.uDir(),hit.uVar(),hit.vVar()))) - std::sqrt(cluster.points().chisquared());
+    return distance(cluster,TwoDPoint(hit.pos(),hit.uDir(),hit.uVar(),hit.vVar()));
+  }
+
+  float Chi2Clusterer::distance(const BkgCluster& cluster, const TwoDPoint& point) const
+  {
+    return std::sqrt(cluster.points().dChi2(point)) - std::sqrt(cluster.points().chisquared());
+  }
+
+  //---------------------------------------------------------------------------------------
+  // the same point as TwoDPoint(ch.pos(),ch.uDir(),ch.uVar(),ch.vVar()) for hit ich
+  TwoDPoint Chi2Clusterer::hitPoint(const ComboHitSoAView& chv, size_t ich)
+  {
+    return TwoDPoint(XYZVectorF(chv.x()[ich],chv.y()[ich],chv.z()[ich]),XYZVectorF(chv.uDirX()[ich],chv.uDirY()[ich],0.0f),
+                     chv.wireVar()[ich],chv.transVar()[ich]);
   }
 
   //-------------------------------------------------------------------------------------------
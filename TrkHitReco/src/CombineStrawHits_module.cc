@@ -10,12 +10,13 @@
 #include "fhiclcpp/types/Sequence.h"
 #include "fhiclcpp/types/Table.h"
 #include "canvas/Persistency/Common/Ptr.h"
-#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Core/SharedProducer.h"
 #include "art/Framework/Principal/Event.h"
 #include "art/Framework/Principal/Handle.h"
 #include "fhiclcpp/ParameterSet.h"
 #include "messagefacility/MessageLogger/MessageLogger.h"
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitSoAView.hh"
 #include "Offline/DataProducts/inc/EventWindowMarker.hh"
 #include "TMath.h"
 
@@ -23,7 +24,7 @@
 
 namespace mu2e {
 
-  class CombineStrawHits : public art::EDProducer {
+  class CombineStrawHits : public art::SharedProducer {
 
     public:
       struct Config
@@ -54,12 +55,12 @@ namespace mu2e {
         fhicl::Atom<bool>             checkWres{ Name("CheckWres"),            Comment("Check Wres for consistency") };
       };
 
-      explicit CombineStrawHits(const art::EDProducer::Table<Config>& config);
-      void produce( art::Event& e);
+      explicit CombineStrawHits(const art::SharedProducer::Table<Config>& config, art::ProcessingFrame const&);
+      void produce( art::Event& e, art::ProcessingFrame const&) override;
 
     private:
-      void combine(EventWindowMarker const& ewm, ComboHitCollection const& chcOrig, ComboHitCollection& chcol);
-      void combineHits(const ComboHitCollection& chcOrig, ComboHit& combohit);
+      void combine(EventWindowMarker const& ewm, ComboHitCollection const& chcOrig, ComboHitCollection& chcol) const;
+      void combineHits(const ComboHitCollection& chcOrig, ComboHit& combohit) const;
 
       int           _debug;
       art::ProductToken<ComboHitCollection> const _chctoken;
@@ -82,8 +83,8 @@ namespace mu2e {
       StrawIdMask   _mask;
   };
 
-  CombineStrawHits::CombineStrawHits(const art::EDProducer::Table<Config>& config) :
-    EDProducer{config},
+  CombineStrawHits::CombineStrawHits(const art::SharedProducer::Table<Config>& config, art::ProcessingFrame const&) :
+    SharedProducer{config},
     _debug(     config().debug()),
     _chctoken{consumes<ComboHitCollection>(config().CHC())},
     _ewmtoken{consumes<EventWindowMarker>(config().EWM())},
@@ -109,9 +110,12 @@ namespace mu2e {
     _mask("uniquepanel")     // define the mask: ComboHits are made from straws in the same unique panel
     {
       produces<ComboHitCollection>();
+      produces<ComboHitSoAView>();
+      // the module has no per-event state
+      async<art::InEvent>();
     }
 
-  void CombineStrawHits::produce(art::Event& event)
+  void CombineStrawHits::produce(art::Event& event, art::ProcessingFrame const&)
   {
     auto chcH = event.getValidHandle(_chctoken);
     const ComboHitCollection& chcOrig(*chcH);
@@ -144,11 +148,12 @@ namespace mu2e {
     }else{
       combine(ewm, chcOrig, *chcolNew);
     }
+    event.put(std::make_unique<ComboHitSoAView>(*chcolNew));
     event.put(std::move(chcolNew));
   }
 
 
-  void CombineStrawHits::combine(EventWindowMarker const& ewm, ComboHitCollection const& chcOrig, ComboHitCollection& chcol)
+  void CombineStrawHits::combine(EventWindowMarker const& ewm, ComboHitCollection const& chcOrig, ComboHitCollection& chcol) const
   {
 
     // don't filter OffSpill
@@ -225,7 +230,7 @@ namespace mu2e {
   }
 
 
-  void CombineStrawHits::combineHits(const ComboHitCollection& chcOrig, ComboHit& combohit)
+  void CombineStrawHits::combineHits(const ComboHitCollection& chcOrig, ComboHit& combohit) const
   {
     // simple sums to speed up the trigger
     double eacc(0),ctacc(0),dtacc(0),twtsum(0),ptacc(0),wacc(0),wacc2(0),wwtsum(0);
@@ -1,6 +1,6 @@
 #include "art/Framework/Principal/Event.h"
 #include "art/Framework/Principal/Handle.h"
-#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Core/SharedProducer.h"
 #include "art_root_io/TFileService.h"
 #include "canvas/Utilities/InputTag.h"
 #include "fhiclcpp/types/Atom.h"
@@ -9,10 +9,12 @@
 
 #include "Offline/ConditionsService/inc/ConditionsHandle.hh"
 #include "Offline/ConfigTools/inc/ConfigFileLookupPolicy.hh"
+#include "Offline/GeneralUtilities/inc/ObjectPool.hh"
 
 #include "Offline/MCDataProducts/inc/StrawDigiMC.hh"
 #include "Offline/DataProducts/inc/StrawIdMask.hh"
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitSoAView.hh"
 #include "Offline/RecoDataProducts/inc/BkgCluster.hh"
 #include "Offline/RecoDataProducts/inc/BkgClusterHit.hh"
 
@@ -24,6 +26,7 @@
 //root
 #include "TMath.h"
 
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -35,7 +38,7 @@ namespace TMVA_SOFIE_TrainBkgDiagStationChi2SLine {
 namespace mu2e
 {
 
-  class FlagBkgHits : public art::EDProducer
+  class FlagBkgHits : public art::SharedProducer
   {
     public:
 
@@ -61,36 +64,48 @@ namespace mu2e
       };
 
       enum clusterer {TNT=1,Chi2=2};
-      explicit FlagBkgHits(const art::EDProducer::Table<Config>& config);
-      void beginJob() override;
-      void produce(art::Event& event) override;
+      explicit FlagBkgHits(const art::SharedProducer::Table<Config>& config, art::ProcessingFrame const&);
+      void produce(art::Event& event, art::ProcessingFrame const&) override;
 
     private:
+      // the clusterer and the inference session keep working buffers, so each concurrent event gets its own
+      struct Worker {
+        std::unique_ptr<BkgClusterer>                                     clusterer;
+        std::shared_ptr<TMVA_SOFIE_TrainBkgDiag::Session>                 sofiePtr1;
+        std::shared_ptr<TMVA_SOFIE_TrainBkgDiagStationChi2SLine::Session> sofiePtr2;
+        ComboHitSoAView                                                   chsoaLocal; // for inputs written without a view
+      };
+      std::unique_ptr<Worker> makeWorker() const;
+
       const art::ProductToken<ComboHitCollection> chtoken_;
+      const art::ProductToken<ComboHitSoAView>    chsoatoken_;
       unsigned                                    minnhits_;
       unsigned                                    minnp_;
       bool                                        filter_;
       bool                                        savebkg_;
       StrawHitFlag                                bkgmsk_;
       StrawIdMask::Level                          level_; // output level
-      std::unique_ptr<BkgClusterer>               clusterer_;
       float                                       cperr2_;
       int const                                   debug_;
       std::string                                 kerasW_;
       bool                                        useSLine_;
       float                                       kerasQ_;
-      int                                         iev_;
-      std::shared_ptr<TMVA_SOFIE_TrainBkgDiag::Session> sofiePtr1;
-      std::shared_ptr<TMVA_SOFIE_TrainBkgDiagStationChi2SLine::Session> sofiePtr2;
-
-      void classifyCluster(BkgClusterCollection& bkgccol, StrawHitFlagCollection& chfcol, const ComboHitCollection& chcol) const;
+      clusterer                                   ctype_;
+      std::optional<TNTClusterer::Config>         tntConfig_;
+      std::optional<Chi2Clusterer::Config>        chi2Config_;
+      std::string                                 kerasWgtsFile_;
+      ObjectPool<Worker>                          workers_;
+
+      void classifyCluster(Worker& worker, BkgClusterCollection& bkgccol, StrawHitFlagCollection& chfcol, const ComboHitCollection& chcol,
+                           const ComboHitSoAView& chv) const;
       int  findClusterIdx( BkgClusterCollection& bkgccol, unsigned ich) const;
   };
 
 
-  FlagBkgHits::FlagBkgHits(const art::EDProducer::Table<Config>& config) :
-    art::EDProducer{config},
+  FlagBkgHits::FlagBkgHits(const art::SharedProducer::Table<Config>& config, art::ProcessingFrame const&) :
+    art::SharedProducer{config},
     chtoken_{     consumes<ComboHitCollection>(config().comboHitCollection()) },
+    chsoatoken_{  mayConsume<ComboHitSoAView>(config().comboHitCollection()) },
     minnhits_(    config().minActiveHits() ),
     minnp_(       config().minNPlanes()),
     filter_(      config().filterHits()),
@@ -100,10 +115,14 @@ namespace mu2e
     kerasW_{      config().kerasWeights()},
     useSLine_(    config().useSLine()),
     kerasQ_(      config().kerasQuality()),
-    iev_(0)
+    ctype_(static_cast<clusterer>(config().clusterAlgorithm())),
+    tntConfig_(   config().TNTClustering()),
+    chi2Config_(  config().Chi2Clustering()),
+    workers_([this](){ return makeWorker(); })
     {
       ConfigFileLookupPolicy configFile;
       produces<ComboHitCollection>();
+      produces<ComboHitSoAView>();
 
       if (savebkg_)
       {
@@ -113,11 +132,10 @@ namespace mu2e
       float cperr = config().clusterPositionError();
       cperr2_ = cperr*cperr;
 
-      clusterer ctype = static_cast<clusterer>(config().clusterAlgorithm());
-      switch ( ctype )
+      switch ( ctype_ )
       {
         case TNT:
-          if(!config().TNTClustering())
+          if(!tntConfig_)
           {
             throw cet::exception("RECO")<< "FlagBkgHits: TNTClusterer is not configured. Configure by adding\n"
             << "physics.producers.FlagBkgHits.TNTClustering : {@table::TNTClusterer}" << std::endl;
@@ -126,39 +144,45 @@ namespace mu2e
           {
             throw cet::exception("RECO")<< "FlagBkgHits: TNTClusterer is not configured to run with SLine training.\n"<< std::endl;
           }
-          clusterer_ = std::make_unique<TNTClusterer>(config().TNTClustering());
           break;
         case Chi2:
-          if(!config().Chi2Clustering())
+          if(!chi2Config_)
           {
             throw cet::exception("RECO")<< "FlagBkgHits: Chi2Clusterer is not configured. Configure by adding\n"
             << "physics.producers.FlagBkgHits.Chi2Clustering : {@table::Chi2Clusterer}" << std::endl;
           }
-          clusterer_ = std::make_unique<Chi2Clusterer>(config().Chi2Clustering());
           break;
         default:
-          throw cet::exception("RECO")<< "Unknown clusterer" << ctype << std::endl;
-      }
-
-      auto kerasWgtsFile = configFile(kerasW_);
-      switch ( useSLine_ ){
-        case 0 :  sofiePtr1 = std::make_shared<TMVA_SOFIE_TrainBkgDiag::Session>(kerasWgtsFile);break;
-        case 1 :  sofiePtr2 = std::make_shared<TMVA_SOFIE_TrainBkgDiagStationChi2SLine::Session>(kerasWgtsFile);break;
+          throw cet::exception("RECO")<< "Unknown clusterer" << ctype_ << std::endl;
       }
+      kerasWgtsFile_ = configFile(kerasW_);
 
       StrawIdMask mask(config().outputLevel());
       level_ = mask.level();
+      // make the first worker now, so configuration errors show up at construction
+      workers_.get();
+      async<art::InEvent>();
     }
 
 
-  void FlagBkgHits::beginJob()
+  std::unique_ptr<FlagBkgHits::Worker> FlagBkgHits::makeWorker() const
   {
-    clusterer_->init();
+    auto worker = std::make_unique<Worker>();
+    if(ctype_ == TNT)
+      worker->clusterer = std::make_unique<TNTClusterer>(tntConfig_);
+    else
+      worker->clusterer = std::make_unique<Chi2Clusterer>(chi2Config_);
+    worker->clusterer->init();
+    switch ( useSLine_ ){
+      case 0 :  worker->sofiePtr1 = std::make_shared<TMVA_SOFIE_TrainBkgDiag::Session>(kerasWgtsFile_);break;
+      case 1 :  worker->sofiePtr2 = std::make_shared<TMVA_SOFIE_TrainBkgDiagStationChi2SLine::Session>(kerasWgtsFile_);break;
+    }
+    return worker;
   }
 
 
   //------------------------------------------------------------------------------------------
-  void FlagBkgHits::produce(art::Event& event )
+  void FlagBkgHits::produce(art::Event& event, art::ProcessingFrame const&)
   {
     auto chH = event.getValidHandle(chtoken_);
     const ComboHitCollection& chcol = *chH.product();
@@ -174,19 +198,23 @@ namespace mu2e
 
 
     // find clusters, sort is needed for recovery algorithm. bkgccolFast has hits that are autmoatically marked as bkg.
-    clusterer_->findClusters(bkgccol,chcol, iev_);
+    auto worker = workers_.get();
+    auto chsoaH = event.getHandle<ComboHitSoAView>(chsoatoken_);
+    const ComboHitSoAView& chv = ComboHitSoAView::get(chsoaH.isValid() ? chsoaH.product() : nullptr, chcol, worker->chsoaLocal);
+    BkgClusterer& clusterer = *worker->clusterer;
+    clusterer.findClusters(bkgccol,chcol,chv, event.id().event());
     std::sort(bkgccol.begin(),bkgccol.end(),[](const BkgCluster& c1,const BkgCluster& c2) {return c1.time() < c2.time();});
 
     // classify clusters
     StrawHitFlagCollection chfcol(nch);
-    classifyCluster(bkgccol, chfcol, chcol);
+    classifyCluster(*worker, bkgccol, chfcol, chcol, chv);
 
     //produce BkgClusterHit info collection
     if (savebkg_) {
       for (size_t ich=0;ich < nch; ++ich) {
         const ComboHit& ch = chcol[ich];
         int icl = findClusterIdx(bkgccol,ich);
-        if (icl > -1) bkghitcol.emplace_back(BkgClusterHit(clusterer_->distance(bkgccol[icl],ch),ch.flag()));
+        if (icl > -1) bkghitcol.emplace_back(BkgClusterHit(clusterer.distance(bkgccol[icl],ch),ch.flag()));
         else          bkghitcol.emplace_back(BkgClusterHit(999.0,ch.flag()));
       }
     }
@@ -233,6 +261,7 @@ namespace mu2e
           throw cet::exception("RECO")<< "FlagBkgHits: inconsistent ComboHit output" << std::endl;
       }
     }
+    event.put(std::make_unique<ComboHitSoAView>(*chcol_out));
     event.put(std::move(chcol_out));
 
     //produce background collection
@@ -241,20 +270,28 @@ namespace mu2e
       event.put(std::make_unique<BkgClusterCollection>(bkgccol));
     }
 
-    ++iev_;
     return;
   }
 
 
   //------------------------------------------------------------------------------------------
-  void FlagBkgHits::classifyCluster(BkgClusterCollection& bkgccol, StrawHitFlagCollection& chfcol, const ComboHitCollection& chcol) const
+  void FlagBkgHits::classifyCluster(Worker& worker, BkgClusterCollection& bkgccol, StrawHitFlagCollection& chfcol, const ComboHitCollection& chcol,
+                                    const ComboHitSoAView& chv) const
   {
+    // the fields read for every hit come from the view; the SLine fields only from the collection
+    const float*        x      = chv.x();
+    const float*        y      = chv.y();
+    const float*        htime  = chv.time();
+    const float*        uvar   = chv.wireVar();
+    const float*        vvar   = chv.transVar();
+    const uint16_t*     nsh    = chv.nStrawHits();
+    const uint16_t*     upanel = chv.uniquePanel();
+    const StrawHitFlag* hflag  = chv.flag();
     for (auto& cluster : bkgccol) {
       // count hits and planes
       std::array<int,StrawId::_nplanes> hitplanes{0};
       for (const auto& chit : cluster.hits()) {
-        const ComboHit& ch = chcol[chit];
-        hitplanes[ch.strawId().plane()] += ch.nStrawHits();
+        hitplanes[upanel[chit]/StrawId::_npanels] += nsh[chit];
       }
       unsigned npexp(0),np(0),nhits(0);
       int ipmin(0),ipmax(StrawId::_nplanes-1);
@@ -289,15 +326,15 @@ namespace mu2e
         unsigned nsthits(0.);
         unsigned nchits = cluster.hits().size();
         for (const auto& chit : cluster.hits()) {
-          sumEdep +=  chcol[chit].energyDep()/chcol[chit].nStrawHits();
-          sqrSumDeltaX += std::pow(chcol[chit].pos().x() - cluster.pos().x(),2);
-          sqrSumDeltaY += std::pow(chcol[chit].pos().y() - cluster.pos().y(),2);
-          sqrSumDeltaTime += std::pow(chcol[chit].time() - cluster.time(),2);
-          auto hdir = chcol[chit].hDir();
-          auto wecc = chcol[chit].nStrawHits();
-          sumEcc += std::sqrt(1-(chcol[chit].vVar()/chcol[chit].uVar()))*wecc;
+          sumEdep +=  chcol[chit].energyDep()/nsh[chit];
+          sqrSumDeltaX += std::pow(x[chit] - cluster.pos().x(),2);
+          sqrSumDeltaY += std::pow(y[chit] - cluster.pos().y(),2);
+          sqrSumDeltaTime += std::pow(htime[chit] - cluster.time(),2);
+          auto wecc = nsh[chit];
+          sumEcc += std::sqrt(1-(vvar[chit]/uvar[chit]))*wecc;
           sumwEcc += wecc;
-          if(chcol[chit].flag().hasAllProperties(StrawHitFlag::sline)){
+          if(hflag[chit].hasAllProperties(StrawHitFlag::sline)){
+            auto hdir = chcol[chit].hDir();
 
             //quality of SLine fit
             sqrSumQual += std::pow(chcol[chit].qual(),2);
@@ -341,8 +378,8 @@ namespace mu2e
 
         std::vector<float> kerasout;
         switch ( useSLine_ ){
-        case 0 : kerasout = sofiePtr1->infer(kerasvars.data());break;
-        case 1 : kerasout = sofiePtr2->infer(kerasvars.data());break;
+        case 0 : kerasout = worker.sofiePtr1->infer(kerasvars.data());break;
+        case 1 : kerasout = worker.sofiePtr2->infer(kerasvars.data());break;
         }
         cluster.setKerasQ(kerasout[0]);
         if(debug_>0)std::cout << "kerasout = " << kerasout[0] << std::endl;
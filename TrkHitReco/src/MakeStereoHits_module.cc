@@ -6,7 +6,7 @@
 //
 
 #include "canvas/Persistency/Common/Ptr.h"
-#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Core/SharedProducer.h"
 #include "art/Framework/Principal/Event.h"
 #include "art/Framework/Principal/Handle.h"
 #include "fhiclcpp/types/Atom.h"
@@ -18,6 +18,7 @@
 #include "Offline/TrackerGeom/inc/Tracker.hh"
 #include "Offline/RecoDataProducts/inc/StrawHit.hh"
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitSoAView.hh"
 #include "Offline/RecoDataProducts/inc/StrawHitFlag.hh"
 #include "Offline/TrkHitReco/inc/CombineStereoPoints.hh"
 #include "Offline/DataProducts/inc/EventWindowMarker.hh"
@@ -37,7 +38,7 @@
 #include <list>
 
 namespace mu2e {
-  class MakeStereoHits : public art::EDProducer {
+  class MakeStereoHits : public art::SharedProducer {
     public:
       struct Config {
         using Name    = fhicl::Name;
@@ -65,10 +66,9 @@ namespace mu2e {
         fhicl::Atom<std::string>         smask    { Name("SelectionMask"),   Comment("define the mask to select hits") };
       };
 
-      explicit MakeStereoHits(const art::EDProducer::Table<Config>& config);
-      void produce( art::Event& e);
-      virtual void beginJob();
-      virtual void beginRun(art::Run & run);
+      explicit MakeStereoHits(const art::SharedProducer::Table<Config>& config, art::ProcessingFrame const&);
+      void produce( art::Event& e, art::ProcessingFrame const&) override;
+      void beginRun(art::Run & run, art::ProcessingFrame const&) override;
     private:
       typedef std::vector<uint16_t> ComboHits;
 
@@ -93,13 +93,14 @@ namespace mu2e {
       unsigned      _slinendof;  // minimum NDOF to use the sline fit when producing output ComboHits
       StrawIdMask   _smask;      // mask for combining hits
 
-      std::array<std::vector<StrawId>,StrawId::_nupanels > _panelOverlap;   // which panels overlap each other
+      std::array<std::vector<StrawId>,StrawId::_nupanels > _panelOverlap;   // which panels overlap each other, filled at the first beginRun
+      bool          _mapInit = false;
       void genMap();
       void fillComboHit(ComboHit& ch, CombineStereoPoints const& cpts, ComboHitCollection const& inchcol) const;
   };
 
-  MakeStereoHits::MakeStereoHits(const art::EDProducer::Table<Config>& config) :
-    art::EDProducer{config},
+  MakeStereoHits::MakeStereoHits(const art::SharedProducer::Table<Config>& config, art::ProcessingFrame const&) :
+    art::SharedProducer{config},
     _debug(config().debug()),
     _chctoken{consumes<ComboHitCollection>(config().CHC())},
     _ewmtoken{consumes<EventWindowMarker>(config().EWM())},
@@ -123,16 +124,16 @@ namespace mu2e {
     _smask(config().smask())
     {
       produces<ComboHitCollection>();
+      produces<ComboHitSoAView>();
+      // the overlap map is only written at beginRun, events just read it
+      async<art::InEvent>();
     }
 
-  void MakeStereoHits::beginJob() {
-  }
-
-  void MakeStereoHits::beginRun(art::Run & run) {
+  void MakeStereoHits::beginRun(art::Run & run, art::ProcessingFrame const&) {
     genMap();
   }
 
-  void MakeStereoHits::produce(art::Event& event) {
+  void MakeStereoHits::produce(art::Event& event, art::ProcessingFrame const&) {
     auto chcH = event.getValidHandle(_chctoken);
     const ComboHitCollection& inchcol(*chcH);
     auto ewmH = event.getValidHandle(_ewmtoken);
@@ -240,6 +241,7 @@ namespace mu2e {
       if( (!filter) || ( combohit.flag().hasAllProperties(_shsel) &&
             (!combohit.flag().hasAnyProperty(_shrej))) ) chcol->push_back(combohit);
     }
+    event.put(std::make_unique<ComboHitSoAView>(*chcol));
     event.put(std::move(chcol));
   }
 
@@ -338,9 +340,8 @@ namespace mu2e {
 
   // generate the overlap map
   void MakeStereoHits::genMap() {
-    static bool init(false);
-    if(!init){
-      init = true;
+    if(!_mapInit){
+      _mapInit = true;
       // initialize
       const Tracker& tt(*GeomHandle<Tracker>());
       // establihit the extent of a panel using the longest straw (0)
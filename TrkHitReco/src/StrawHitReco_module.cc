@@ -8,7 +8,7 @@
 #include "art/Framework/Principal/Event.h"
 #include "art/Framework/Principal/Handle.h"
 #include "Offline/GeometryService/inc/GeomHandle.hh"
-#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Core/SharedProducer.h"
 #include "Offline/GeometryService/inc/DetectorSystem.hh"
 #include "art_root_io/TFileService.h"
 #include "art/Framework/Principal/Run.h"
@@ -30,6 +30,7 @@
 #include "Offline/RecoDataProducts/inc/CaloCluster.hh"
 #include "Offline/RecoDataProducts/inc/StrawDigi.hh"
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitSoAView.hh"
 #include "Offline/RecoDataProducts/inc/StrawHit.hh"
 #include "Offline/RecoDataProducts/inc/IntensityInfoTrackerHits.hh"
 #include "Offline/DataProducts/inc/EventWindowMarker.hh"
@@ -43,7 +44,7 @@
 namespace mu2e {
   using namespace TrkTypes;
 
-  class StrawHitReco : public art::EDProducer {
+  class StrawHitReco : public art::SharedProducer {
     public:
       using Name=fhicl::Name;
       using Comment=fhicl::Comment;
@@ -73,10 +74,10 @@ namespace mu2e {
         fhicl::Atom<art::InputTag> EWM { Name("EventWindowMarker"), Comment("EventWindowMarker")};
      };
 
-      using Parameters = art::EDProducer::Table<Config>;
-      explicit StrawHitReco(Parameters const& config);
-      void produce( art::Event& e) override;
-      void beginJob() override;
+      using Parameters = art::SharedProducer::Table<Config>;
+      explicit StrawHitReco(Parameters const& config, art::ProcessingFrame const&);
+      void produce( art::Event& e, art::ProcessingFrame const&) override;
+      void beginJob(art::ProcessingFrame const&) override;
 
     private:
       StrawHitRecoUtils _shrUtils;
@@ -101,8 +102,8 @@ namespace mu2e {
       ProditionsHandle<Tracker> _alignedTracker_h;
   };
 
-  StrawHitReco::StrawHitReco(Parameters const& config) :
-    art::EDProducer{config},
+  StrawHitReco::StrawHitReco(Parameters const& config, art::ProcessingFrame const&) :
+    art::SharedProducer{config},
     _shrUtils ((TrkHitReco::FitType) config().fittype(),
         config().diag(),
         StrawIdMask::uniquestraw, // this module produces individual straw ComboHits
@@ -133,13 +134,19 @@ namespace mu2e {
 
   {
     produces<ComboHitCollection>();
+    produces<ComboHitSoAView>();
     produces<IntensityInfoTrackerHits>();
     if (_writesh) produces<StrawHitCollection>();
     if (_printLevel > 0) std::cout << "In StrawHitReco constructor " << std::endl;
+    // events are processed concurrently unless the diagnostic histograms are filled
+    if (_diagLevel > 0)
+      serialize<art::InEvent>(art::TFileService::resource_name());
+    else
+      async<art::InEvent>();
   }
 
   //------------------------------------------------------------------------------------------
-  void StrawHitReco::beginJob()
+  void StrawHitReco::beginJob(art::ProcessingFrame const&)
   {
     if(_diagLevel > 0){
       art::ServiceHandle<art::TFileService> tfs;
@@ -148,7 +155,7 @@ namespace mu2e {
   }
 
   //------------------------------------------------------------------------------------------
-  void StrawHitReco::produce(art::Event& event)
+  void StrawHitReco::produce(art::Event& event, art::ProcessingFrame const&)
   {
     if (_printLevel > 0) std::cout << "In StrawHitReco produce " << std::endl;
 
@@ -209,6 +216,7 @@ namespace mu2e {
     if(_writesh)event.put(std::move(shCol));
     intInfo->setNTrackerHits(chCol->size());
     event.put(std::move(intInfo));
+    event.put(std::make_unique<ComboHitSoAView>(*chCol));
     event.put(std::move(chCol));
   }
 }
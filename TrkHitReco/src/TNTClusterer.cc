@@ -40,14 +40,14 @@ namespace mu2e
 
 
   //----------------------------------------------------------------------------------------------------------
-  void TNTClusterer::findClusters(BkgClusterCollection& clusters, const ComboHitCollection& chcol, int iev)
+  void TNTClusterer::findClusters(BkgClusterCollection& clusters, const ComboHitCollection& chcol, const ComboHitSoAView& chv, int iev)
   {
     std::vector<BkgHit> BkgHits;
-    BkgHits.reserve(chcol.size());
-    if (chcol.empty()) return;
+    BkgHits.reserve(chv.size());
+    if (chv.empty()) return;
 
-    initClustering(chcol, BkgHits);
-    doClustering(chcol, clusters, BkgHits);
+    initClustering(chv, BkgHits);
+    doClustering(chv, clusters, BkgHits);
 
     long unsigned int minchits = minClusterHits_;
     auto removePred = [minchits](auto& cluster) {return cluster.hits().size() < minchits;};
@@ -59,30 +59,34 @@ namespace mu2e
 
 
   //----------------------------------------------------------------------------------------------------------------------
-  void TNTClusterer::initClustering(const ComboHitCollection& chcol, std::vector<BkgHit>& BkgHits)
+  void TNTClusterer::initClustering(const ComboHitSoAView& chv, std::vector<BkgHit>& BkgHits)
   {
+     const StrawHitFlag* flag  = chv.flag();
+     const float*        ctime = chv.correctedTime();
      float maxTime(0);
-     for (size_t ich=0;ich<chcol.size();++ich) {
-       if (testflag_ && (!chcol[ich].flag().hasAllProperties(sigmask_) || chcol[ich].flag().hasAnyProperty(bkgmask_))) continue;
+     for (size_t ich=0;ich<chv.size();++ich) {
+       if (testflag_ && (!flag[ich].hasAllProperties(sigmask_) || flag[ich].hasAnyProperty(bkgmask_))) continue;
        BkgHits.emplace_back(BkgHit(ich));
-       maxTime = std::max(maxTime,chcol[ich].correctedTime());
+       maxTime = std::max(maxTime,ctime[ich]);
      }
      tbin_ = (maxTime+1.0)/float(numBuckets_);
 
-     auto resPred = [&chcol](const BkgHit& x, const BkgHit& y) {return chcol[x.chidx_].wireRes() < chcol[y.chidx_].wireRes();};
+     // ordering by wire variance is the same as ordering by wire resolution
+     const float* wvar = chv.wireVar();
+     auto resPred = [wvar](const BkgHit& x, const BkgHit& y) {return wvar[x.chidx_] < wvar[y.chidx_];};
      if (comboInit_) std::sort(BkgHits.begin(),BkgHits.end(),resPred);
   }
 
 
   //----------------------------------------------------------------------------------------------------------------------
-  void TNTClusterer::doClustering(const ComboHitCollection& chcol, std::vector<BkgCluster>& clusters, std::vector<BkgHit>& BkgHits)
+  void TNTClusterer::doClustering(const ComboHitSoAView& chv, std::vector<BkgCluster>& clusters, std::vector<BkgHit>& BkgHits)
   {
     unsigned niter(0);
     float odist(2.0f*maxDistSum_);
     float tdist(0.0f);
     while ( std::abs(odist - tdist) > maxDistSum_ && niter < maxNiter_ ) {
       ++niter;
-      formClusters(chcol, clusters, BkgHits);
+      formClusters(chv, clusters, BkgHits);
 
       odist = tdist;
       tdist = 0.0f;
@@ -98,8 +102,9 @@ namespace mu2e
   // candidate clusters to check if they could be added. If not, make a new cluster.
   // speed up: don't update clusters who haven't changed + cache cluster id in a given time window in clusterIndex (array if vectors)
   //
-  unsigned TNTClusterer::formClusters(const ComboHitCollection& chcol, std::vector<BkgCluster>& clusters, std::vector<BkgHit>& BkgHits)
+  unsigned TNTClusterer::formClusters(const ComboHitSoAView& chv, std::vector<BkgCluster>& clusters, std::vector<BkgHit>& BkgHits)
   {
+    const float* ctime = chv.correctedTime();
     std::array<std::vector<int>, numBuckets_> clusterIndices;
     for (size_t ic=0;ic<clusters.size();++ic) {
       int itime  = int(clusters[ic].time()/tbin_);
@@ -112,7 +117,7 @@ namespace mu2e
     for (size_t ihit=0;ihit<BkgHits.size();++ihit) {
 
       auto& hit  = BkgHits[ihit];
-      const auto& chit = chcol[hit.chidx_];
+      size_t ich = hit.chidx_;
 
       // -- if hit is ok, reassign it right away
       if (hit.distance_ < dhit_) {
@@ -123,13 +128,13 @@ namespace mu2e
       // -- find closest cluster. restrict search to clusters close in time using the clusterIndices structure
       int minc(-1);
       float mindist(dseed_ + 1.0f);
-      int itime = int(chit.correctedTime()/tbin_);
+      int itime = int(ctime[ich]/tbin_);
       int imin = std::max(0,itime-ditime);
       int imax = std::min(numBuckets_,itime+ditime+1);
 
       for (int i=imin;i<imax;++i) {
         for (const auto& ic : clusterIndices[i]) {
-          float dist = distance(clusters[ic],chcol[hit.chidx_]);
+          float dist = distance(clusters[ic],chv,ich);
           if (dist < mindist) {mindist = dist;minc = ic;}
         }
       }
@@ -140,9 +145,9 @@ namespace mu2e
       }
       else if (mindist > dseed_) {
         minc = clusters.size();
-        clusters.emplace_back(chit.pos(),chit.correctedTime(),distMethodFlag_);
+        clusters.emplace_back(XYZVectorF(chv.x()[ich],chv.y()[ich],chv.z()[ich]),ctime[ich],distMethodFlag_);
         clusters[minc].addHit(ihit);
-        int itime = int(chit.correctedTime()/tbin_);
+        int itime = int(ctime[ich]/tbin_);
         clusterIndices[itime].emplace_back(minc);
       }
       else{
@@ -172,10 +177,10 @@ namespace mu2e
     for (auto& cluster : clusters) {
       if (cluster._flag == BkgClusterFlag::update) {
         cluster._flag = BkgClusterFlag::unchanged;
-        updateCluster(cluster, chcol, BkgHits);
+        updateCluster(cluster, chv, BkgHits);
         if (cluster.hits().size()==1) {BkgHits[cluster.hits().at(0)].distance_ = 0.0f;}
         else {
-          for (auto& hit : cluster.hits()) BkgHits[hit].distance_ = distance(cluster,chcol[BkgHits[hit].chidx_]);
+          for (auto& hit : cluster.hits()) BkgHits[hit].distance_ = distance(cluster,chv,BkgHits[hit].chidx_);
         }
       }
     }
@@ -185,7 +190,7 @@ namespace mu2e
 
 
   //-----------------------------------------------------------------------------------------------
-  void TNTClusterer::mergeClusters(std::vector<BkgCluster>& clusters, const ComboHitCollection& chcol,
+  void TNTClusterer::mergeClusters(std::vector<BkgCluster>& clusters, const ComboHitSoAView& chv,
                                    std::vector<BkgHit>& BkgHits, float dt, float dd2)
   {
     unsigned niter(0);
@@ -207,7 +212,7 @@ namespace mu2e
       if (nchanged==0) break;
 
       std::remove_if(clusters.begin(),clusters.end(),[](auto& cluster) {return cluster.hits().empty();});
-      for (auto& cluster : clusters ) updateCluster(cluster, chcol, BkgHits);
+      for (auto& cluster : clusters ) updateCluster(cluster, chv, BkgHits);
     }
     return;
   }
@@ -223,15 +228,27 @@ namespace mu2e
   //---------------------------------------------------------------------------------------
   // only count differences if they are above the natural hit size (drift time, straw size)
   float TNTClusterer::distance(const BkgCluster& cluster, const ComboHit& hit) const
+  {
+    return distance(cluster,hit.pos().x(),hit.pos().y(),hit.correctedTime(),
+                    hit.uDir2D().x(),hit.uDir2D().y(),hit.posRes(ComboHit::wire));
+  }
+
+  float TNTClusterer::distance(const BkgCluster& cluster, const ComboHitSoAView& chv, size_t ich) const
+  {
+    return distance(cluster,chv.x()[ich],chv.y()[ich],chv.correctedTime()[ich],
+                    chv.uDirX()[ich],chv.uDirY()[ich],sqrtf(chv.wireVar()[ich]));
+  }
+
+  float TNTClusterer::distance(const BkgCluster& cluster, float hx, float hy, float htime, float hwx, float hwy, float hwres) const
   {
     float retval(0.0f);
-    float psep_x = hit.pos().x()-cluster.pos().x();
-    float psep_y = hit.pos().y()-cluster.pos().y();
+    float psep_x = hx-cluster.pos().x();
+    float psep_y = hy-cluster.pos().y();
     float d2     = psep_x*psep_x+psep_y*psep_y;
 
     if (d2 > md2_) {return dseed_+1.0f;}
 
-    float dt = std::abs(hit.correctedTime()-cluster.time());
+    float dt = std::abs(htime-cluster.time());
     if (dt > maxHitdt_) {return dseed_+1.0f;}
 
 
@@ -241,24 +258,26 @@ namespace mu2e
       //XYZVectorF that(-hit.uDir2D().y(),hit.uDir2D().x(),0.0);
       //float dw = std::max(0.0f,hit.uDir2D().Dot(psep)-dd_)/hit.posRes(ComboHit::wire);
       //float dp = std::max(0.0f,that.Dot(psep)-dd_)*maxwt_;//maxwt = 1/minerr
-      float hwx = hit.uDir2D().x();
-      float hwy = hit.uDir2D().y();
-      float dw  = std::max(0.0f,(psep_x*hwx+psep_y*hwy-dd_)/hit.posRes(ComboHit::wire));
+      float dw  = std::max(0.0f,(psep_x*hwx+psep_y*hwy-dd_)/hwres);
       float dp  = std::max(0.0f,(hwx*psep_y-hwy*psep_x-dd_)*maxwt_);
       retval += dw*dw + dp*dp;
     }
     return retval;
   }
 
-  void TNTClusterer::updateCluster(BkgCluster& cluster, const ComboHitCollection& chcol, std::vector<BkgHit>& BkgHits)
+  void TNTClusterer::updateCluster(BkgCluster& cluster, const ComboHitSoAView& chv, std::vector<BkgHit>& BkgHits)
   {
+    const float*    x     = chv.x();
+    const float*    y     = chv.y();
+    const float*    htime = chv.correctedTime();
+    const uint16_t* nsh   = chv.nStrawHits();
 
     if (cluster.hits().empty()) {cluster.time(0.0f);cluster.pos(XYZVectorF(0.0f,0.0f,0.0f));return;}
 
     if (cluster.hits().size()==1) {
       int idx = BkgHits[cluster.hits().at(0)].chidx_;
-      cluster.time(chcol[idx].correctedTime());
-      cluster.pos(XYZVectorF(chcol[idx].pos().x(),chcol[idx].pos().y(),0.0f));
+      cluster.time(htime[idx]);
+      cluster.pos(XYZVectorF(x[idx],y[idx],0.0f));
       return;
     }
 
@@ -270,14 +289,14 @@ namespace mu2e
       std::vector<float> racc,pacc,tacc;
       for (auto& hit : cluster.hits()) {
         int idx  = BkgHits[hit].chidx_;
-        float dt = chcol[idx].correctedTime() - ctime;
-        float dr = sqrtf(chcol[idx].pos().perp2()) - crho;
-        float dp = chcol[idx].phi() - cphi;
+        float dt = htime[idx] - ctime;
+        float dr = sqrtf(x[idx]*x[idx]+y[idx]*y[idx]) - crho;
+        float dp = atan2f(y[idx],x[idx]) - cphi;
         if (dp > M_PI)  dp -= 2*M_PI;
         if (dp < -M_PI) dp += 2*M_PI;
 
         // weight according to the # of hits
-        for (int i=0;i<chcol[idx].nStrawHits();++i) {
+        for (int i=0;i<nsh[idx];++i) {
           racc.emplace_back(dr);
           pacc.emplace_back(dp);
           tacc.emplace_back(dt);
@@ -298,11 +317,11 @@ namespace mu2e
       float sumWeight(0), deltaT(0), deltaP(0), deltaR(0);
       for (auto& hit : cluster.hits()) {
         int   idx    = BkgHits[hit].chidx_;
-        float weight = chcol[idx].nStrawHits();
-        float dt     = chcol[idx].correctedTime()-ctime;
-        float dr     = sqrtf(chcol[idx].pos().perp2()) - crho;
+        float weight = nsh[idx];
+        float dt     = htime[idx]-ctime;
+        float dr     = sqrtf(x[idx]*x[idx]+y[idx]*y[idx]) - crho;
 
-        float dp     = chcol[idx].phi()-cphi;
+        float dp     = atan2f(y[idx],x[idx])-cphi;
         if (dp > M_PI)  dp -= 2*M_PI;
         if (dp < -M_PI) dp += 2*M_PI;
 
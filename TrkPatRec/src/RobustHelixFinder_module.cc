@@ -97,6 +97,14 @@ namespace {
     HelixHitMVA() : _pars(7,0.0),_pars2(2,0.0),_dtrans(_pars[0]),_dwire(_pars[1]),_chisq(_pars[2]),_dt(_pars[3]),
     _drho(_pars[4]),_dphi(_pars[5]),_rwdot(_pars[6]),_hrho(_pars[0]),_hhrho(_pars2[1]) {}
   };
+  // MVA inputs of a set of hits, evaluated together
+  struct HelixHitMVABatch
+  {
+    std::vector<unsigned> _hits;  // index of the hits in _chHitsToProcess
+    std::vector<float> _inputs;   // their input variables, one row per hit
+    std::vector<float> _outputs;  // MVA output per hit
+    void clear() { _hits.clear(); _inputs.clear(); _outputs.clear(); }
+  };
 
 }
 
@@ -196,6 +204,7 @@ namespace mu2e {
 
       MVATools _stmva, _nsmva;
       HelixHitMVA _vmva; // input variables to TMVA for filtering hits
+      HelixHitMVABatch _stbatch, _nsbatch; // stereo and non-stereo hits to evaluate
 
       TH1F* _niter, *_niterxy, *_niterfz, *_nitermva;
 
@@ -568,6 +577,8 @@ namespace mu2e {
     static XYZVectorF  zaxis(0.0,0.0,1.0); // unit in z direction
     ComboHit*      hhit(0);
 
+    _stbatch.clear();
+    _nsbatch.clear();
     for (unsigned f=0; f<helixData._chHitsToProcess.size(); ++f){
       hhit = &helixData._chHitsToProcess[f];
 
@@ -604,12 +615,17 @@ namespace mu2e {
       _vmva._chisq = sqrtf( _vmva._dwire*_vmva._dwire/wres2 + _vmva._dtrans*_vmva._dtrans/wtres2 );
       _vmva._dt = hhit->time() - helixData._hseed._t0.t0();
 
-      if (hhit->_flag.hasAnyProperty(StrawHitFlag::stereo))
-      {
-        hhit->_qual = _stmva.evalMVA(_vmva._pars);
-      } else {
-        hhit->_qual = _nsmva.evalMVA(_vmva._pars);
-      }
+      // collect the inputs, and evaluate all the hits of each kind at once below
+      auto& batch = hhit->_flag.hasAnyProperty(StrawHitFlag::stereo) ? _stbatch : _nsbatch;
+      batch._hits.push_back(f);
+      batch._inputs.insert(batch._inputs.end(),_vmva._pars.begin(),_vmva._pars.end());
+    }
+
+    _stmva.evalBatch(_stbatch._inputs,_vmva._pars.size(),_stbatch._outputs);
+    _nsmva.evalBatch(_nsbatch._inputs,_vmva._pars.size(),_nsbatch._outputs);
+    for (auto const* batch : {&_stbatch, &_nsbatch}){
+      for (size_t ihit=0; ihit < batch->_hits.size(); ++ihit)
+        helixData._chHitsToProcess[batch->_hits[ihit]]._qual = batch->_outputs[ihit];
     }
   }
 
@@ -9,14 +9,16 @@
 #include "fhiclcpp/ParameterSet.h"
 #include "fhiclcpp/types/Sequence.h"
 #include "art/Framework/Principal/Handle.h"
-#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Core/SharedProducer.h"
 #include "art_root_io/TFileService.h"
 // Mu2e
 #include "Offline/GeneralUtilities/inc/Angles.hh"
+#include "Offline/GeneralUtilities/inc/ObjectPool.hh"
 #include "Offline/Mu2eUtilities/inc/MVATools.hh"
 #include "Offline/Mu2eUtilities/inc/polyAtan2.hh"
 // data
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitSoAView.hh"
 #include "Offline/RecoDataProducts/inc/TimeCluster.hh"
 #include "Offline/RecoDataProducts/inc/CaloCluster.hh"
 // tracking
@@ -64,7 +66,7 @@ namespace {
 
 namespace mu2e {
 
-  class TimeClusterFinder : public art::EDProducer
+  class TimeClusterFinder : public art::SharedProducer
   {
     public:
 
@@ -103,21 +105,33 @@ namespace mu2e {
         fhicl::Atom<int>                        debugLevel             {Name("debugLevel"),             Comment("Debut Level"), 0 };
       };
 
-      explicit TimeClusterFinder(const art::EDProducer::Table<Config>& config);
+      explicit TimeClusterFinder(const art::SharedProducer::Table<Config>& config, art::ProcessingFrame const&);
 
-      void beginJob() override;
-      void produce(art::Event& e) override;
+      void beginJob(art::ProcessingFrame const&) override;
+      void produce(art::Event& e, art::ProcessingFrame const&) override;
 
 
     private:
       typedef std::pair<Float_t,int> BinContent;
       typedef std::vector<StrawHitIndex>::iterator ISH;
 
-      int                                             _iev;
+      // the working state of one event; events processed concurrently each get their own
+      struct EventData {
+        int                           _iev;
+        const ComboHitCollection*     _chcol;
+        const ComboHitSoAView*        _chsoa;   // the view written with _chcol, or _chsoaLocal
+        ComboHitSoAView               _chsoaLocal; // filled only for inputs written without a view
+        std::vector<uint8_t>          _goodhit; // per hit: passes the flag selection
+        std::vector<float>            _chtime;  // per hit: time from the T0 calculator
+        const CaloClusterCollection*  _cccol;
+        TH1F                          _timespec;
+        TimeCluMVA                    _pmva; // input variables to TMVA for cluster cleaning
+        explicit EventData(TH1F const& timespec) : _timespec(timespec) {}
+      };
+
       const art::ProductToken<ComboHitCollection>     _chToken;
+      const art::ProductToken<ComboHitSoAView>        _chsoaToken;
       const art::ProductToken<CaloClusterCollection>  _ccToken;
-      const ComboHitCollection*     _chcol;
-      const CaloClusterCollection*  _cccol;
       StrawHitFlag                  _hsel;
       StrawHitFlag                  _hbkg;
       MVATools                      _tcMVA;
@@ -139,29 +153,30 @@ namespace mu2e {
       int                           _npeak;
       int                           _printfreq;
       int                           _debug;
-      TH1F                          _timespec;
-      TimeCluMVA                    _pmva; // input variables to TMVA for cluster cleaning
-
-
-      void findClusters(TimeClusterCollection& tccol);
-      void findCaloSeeds(TimeClusterCollection& tccol, art::Handle<CaloClusterCollection> const& ccH);
-      void fillTimeSpectrum();
-      void initCluster(TimeCluster& tc);
-      void prefilterCluster(TimeCluster& tc);
-      void recoverHits(TimeCluster& tc);
-      ISH  removeHit(TimeCluster& tc, ISH);
-      void addHit(TimeCluster& tc,size_t iadd);
-      void clusterMean(TimeCluster& tc);
-      void refineCluster(TimeCluster& tc);
-      void findPeaks(TimeClusterCollection& seeds);
-      void assignHits(TimeClusterCollection& tccol );
-      bool goodHit(const StrawHitFlag& flag) const;
+      TH1F                          _timespec; // template for the per-event time spectra
+      ObjectPool<EventData>         _eventData;
+
+
+      void findClusters(EventData& ed, TimeClusterCollection& tccol) const;
+      void findCaloSeeds(EventData& ed, TimeClusterCollection& tccol, art::Handle<CaloClusterCollection> const& ccH) const;
+      void fillTimeSpectrum(EventData& ed) const;
+      void initCluster(EventData& ed, TimeCluster& tc) const;
+      void prefilterCluster(EventData& ed, TimeCluster& tc) const;
+      void recoverHits(EventData& ed, TimeCluster& tc) const;
+      ISH  removeHit(EventData& ed, TimeCluster& tc, ISH) const;
+      void addHit(EventData& ed, TimeCluster& tc,size_t iadd) const;
+      void clusterMean(EventData& ed, TimeCluster& tc) const;
+      void refineCluster(EventData& ed, TimeCluster& tc) const;
+      void findPeaks(EventData& ed, TimeClusterCollection& seeds) const;
+      void assignHits(EventData& ed, TimeClusterCollection& tccol ) const;
+      void fillHitInfo(EventData& ed) const;
   };
 
 
-  TimeClusterFinder::TimeClusterFinder(const art::EDProducer::Table<Config>& config) :
-    art::EDProducer{config},
+  TimeClusterFinder::TimeClusterFinder(const art::SharedProducer::Table<Config>& config, art::ProcessingFrame const&) :
+    art::SharedProducer{config},
     _chToken      { consumes<ComboHitCollection>(      config().comboHitCollection()) },
+    _chsoaToken   { mayConsume<ComboHitSoAView>(       config().comboHitCollection()) },
     _ccToken      { mayConsume<CaloClusterCollection>( config().caloClusterCollection()) },
     _hsel         ( config().hsel()),
     _hbkg         ( config().hbkg()),
@@ -188,14 +203,21 @@ namespace mu2e {
     _recover      ( config().recover()),
     _npeak        ( config().npeak()),
     _printfreq    ( config().printfreq()),
-    _debug        ( config().debugLevel())
+    _debug        ( config().debugLevel()),
+    _eventData    ( [this](){ return std::make_unique<EventData>(_timespec); })
     {
       unsigned nbins = (unsigned)rint((_tmax-_tmin)/_tbin);
       _timespec = TH1F("timespec","time spectrum",nbins,_tmin,_tmax);
+      _timespec.SetDirectory(nullptr);
       produces<TimeClusterCollection>();
+      // the debug time spectra are saved with the TFileService
+      if (_debug > 2)
+        serialize<art::InEvent>(art::TFileService::resource_name());
+      else
+        async<art::InEvent>();
     }
 
-  void TimeClusterFinder::beginJob() {
+  void TimeClusterFinder::beginJob(art::ProcessingFrame const&) {
     _tcMVA.initMVA();
     _tcCaloMVA.initMVA();
     if (_debug > 0)
@@ -209,25 +231,30 @@ namespace mu2e {
 
 
   //--------------------------------------------------------------------------------------------------------------
-  void TimeClusterFinder::produce(art::Event & event ){
-    _iev = event.id().event();
+  void TimeClusterFinder::produce(art::Event & event, art::ProcessingFrame const&){
+    auto edh = _eventData.get();
+    EventData& ed = *edh;
+    ed._iev = event.id().event();
 
-    if (_debug > 0 && (_iev%_printfreq)==0) std::cout<<"TimeClusterFinder: event="<<_iev<<std::endl;
+    if (_debug > 0 && (ed._iev%_printfreq)==0) std::cout<<"TimeClusterFinder: event="<<ed._iev<<std::endl;
 
     auto const& chH = event.getValidHandle(_chToken);
-    _chcol = chH.product();
+    ed._chcol = chH.product();
+    auto chsoaH = event.getHandle<ComboHitSoAView>(_chsoaToken);
+    ed._chsoa = &ComboHitSoAView::get(chsoaH.isValid() ? chsoaH.product() : nullptr, *ed._chcol, ed._chsoaLocal);
+    fillHitInfo(ed);
 
     art::Handle<CaloClusterCollection> ccH{}; // need to cache for later Ptr creation
     if(_usecc){
       ccH = event.getHandle<CaloClusterCollection>(_ccToken);
-      _cccol = ccH.product();
+      ed._cccol = ccH.product();
     }
 
     std::unique_ptr<TimeClusterCollection> tccol(new TimeClusterCollection);
     // If requested, use calo clusters to for time cluster seeds
-    if (_usecc) findCaloSeeds(*tccol,ccH);
+    if (_usecc) findCaloSeeds(ed,*tccol,ccH);
     // find all the hit clusters
-    findClusters(*tccol);
+    findClusters(ed,*tccol);
 
     if (_debug > 0) std::cout << "Found " << tccol->size() << " Time Clusters " << std::endl;
 
@@ -249,22 +276,22 @@ namespace mu2e {
 
 
   //--------------------------------------------------------------------------------------------------------------
-  void TimeClusterFinder::findClusters(TimeClusterCollection& tccol) {
+  void TimeClusterFinder::findClusters(EventData& ed, TimeClusterCollection& tccol) const {
     // find seed from hits
-    fillTimeSpectrum();
-    findPeaks(tccol);
+    fillTimeSpectrum(ed);
+    findPeaks(ed, tccol);
     // associate hits to seeds
-    assignHits(tccol);
+    assignHits(ed, tccol);
     // loop over seeds and fill/refine information
     auto itc = tccol.begin();
     while(itc != tccol.end()){
       TimeCluster& tc = *itc;
-      initCluster(tc);
-      if (_preFilter) prefilterCluster(tc);
+      initCluster(ed, tc);
+      if (_preFilter) prefilterCluster(ed, tc);
       if( tc.nStrawHits() >= _minnhits) {
-        clusterMean(tc);
-        if (_refine) refineCluster(tc);
-        if (_recover && tc._nsh > 0) recoverHits(tc);
+        clusterMean(ed, tc);
+        if (_refine) refineCluster(ed, tc);
+        if (_recover && tc._nsh > 0) recoverHits(ed, tc);
       }
       if (tc.nStrawHits() < _minnhits) {
         itc = tccol.erase(itc);
@@ -275,18 +302,18 @@ namespace mu2e {
     // debug test of histogram
     if (_debug > 2) {
       art::ServiceHandle<art::TFileService> tfs;
-      TH1F* tspec = tfs->make<TH1F>(_timespec);
+      TH1F* tspec = tfs->make<TH1F>(ed._timespec);
       char name[40];
       char title[100];
-      snprintf(name,40,"tspec_%i",_iev);
-      snprintf(title,100,"time spectrum event %i;nsec",_iev);
+      snprintf(name,40,"tspec_%i",ed._iev);
+      snprintf(title,100,"time spectrum event %i;nsec",ed._iev);
       tspec->SetNameTitle(name,title);
     }
   }
 
-  void TimeClusterFinder::findCaloSeeds(TimeClusterCollection& tccol, art::Handle<CaloClusterCollection>const& ccH) {
-    for(size_t icalo=0; icalo < _cccol->size(); ++icalo){
-      auto const& calo = (*_cccol)[icalo];
+  void TimeClusterFinder::findCaloSeeds(EventData& ed, TimeClusterCollection& tccol, art::Handle<CaloClusterCollection>const& ccH) const {
+    for(size_t icalo=0; icalo < ed._cccol->size(); ++icalo){
+      auto const& calo = (*ed._cccol)[icalo];
       if (calo.energyDep() > _ccmine){
         TimeCluster tc;
         tc._t0 = TrkT0(_ttcalc.caloClusterTime(calo,_pitch), _ttcalc.caloClusterTimeErr());
@@ -297,22 +324,31 @@ namespace mu2e {
   }
 
   //--------------------------------------------------------------------------------------------------------------
-  void TimeClusterFinder::fillTimeSpectrum() {
-    _timespec.Reset();
-    for (unsigned istr=0; istr<_chcol->size();++istr) {
-      if (_testflag && !goodHit((*_chcol)[istr].flag())) continue;
-      ComboHit const& ch = (*_chcol)[istr];
-      float time = _ttcalc.comboHitTime((*_chcol)[istr],_pitch);
-      _timespec.Fill(time,ch.nStrawHits());
+  // the flag selection and the time of every hit are used by several loops over all the
+  // hits: compute them once per event, from the structure-of-arrays view of the hits
+  void TimeClusterFinder::fillHitInfo(EventData& ed) const {
+    if (_testflag)
+      ed._chsoa->select(_hsel,_hbkg,ed._goodhit);
+    else
+      ed._goodhit.assign(ed._chcol->size(),1);
+    ed._chtime.resize(ed._chcol->size());
+    for (size_t istr=0; istr<ed._chcol->size(); ++istr)
+      ed._chtime[istr] = _ttcalc.comboHitTime((*ed._chcol)[istr],_pitch);
+  }
+
+  void TimeClusterFinder::fillTimeSpectrum(EventData& ed) const {
+    ed._timespec.Reset();
+    auto const* nsh = ed._chsoa->nStrawHits();
+    for (unsigned istr=0; istr<ed._chcol->size();++istr) {
+      if (ed._goodhit[istr]) ed._timespec.Fill(ed._chtime[istr],nsh[istr]);
     }
   }
 
-  void TimeClusterFinder::assignHits(TimeClusterCollection& tccol ) {
+  void TimeClusterFinder::assignHits(EventData& ed, TimeClusterCollection& tccol ) const {
     // assign hits to the closest time peak
-    for(size_t istr=0; istr<_chcol->size(); ++istr) {
-      if ((!_testflag) || goodHit((*_chcol)[istr].flag())) {
-        ComboHit const& ch =(*_chcol)[istr];
-        float time = _ttcalc.comboHitTime(ch,_pitch);
+    for(size_t istr=0; istr<ed._chcol->size(); ++istr) {
+      if (ed._goodhit[istr]) {
+        float time = ed._chtime[istr];
         float mindt(1e5);
         auto besttc = tccol.end();
         // find the closest seed (if any)
@@ -331,19 +367,19 @@ namespace mu2e {
   }
 
   //--------------------------------------------------------------------------------------------------------------
-  void TimeClusterFinder::findPeaks(TimeClusterCollection& tccol) {
-    int nbins = _timespec.GetNbinsX()+1;
+  void TimeClusterFinder::findPeaks(EventData& ed, TimeClusterCollection& tccol) const {
+    int nbins = ed._timespec.GetNbinsX()+1;
     std::vector<bool> alreadyUsed(nbins,false);
     // blank out bins around input times (from calo clusters)
     for(auto const& tc : tccol ){
-      int ibin = _timespec.FindBin(tc._t0._t0);
+      int ibin = ed._timespec.FindBin(tc._t0._t0);
       for(int jbin = std::max(1,ibin-_npeak);jbin < std::min(nbins,ibin+_npeak+1); ++jbin)
         alreadyUsed[jbin] = true;
     }
     // loop over spectrum to find peaks
     std::vector<BinContent> bcv;
     for (int ibin=1;ibin < nbins; ++ibin)
-      if (_timespec.GetBinContent(ibin) >= _ymin) bcv.push_back(make_pair(_timespec.GetBinContent(ibin),ibin));
+      if (ed._timespec.GetBinContent(ibin) >= _ymin) bcv.push_back(make_pair(ed._timespec.GetBinContent(ibin),ibin));
     std::sort(bcv.begin(),bcv.end(),[](const BinContent& x, const BinContent& y){return x.first > y.first;});
 
     for (const auto& bc : bcv) {
@@ -351,8 +387,8 @@ namespace mu2e {
       float nsh(0.0);
       float t0(0.0);
       for (int ibin = std::max(1,bc.second-_npeak);ibin < std::min(nbins,bc.second+_npeak+1); ++ibin) {
-        nsh += _timespec.GetBinContent(ibin);
-        t0 += _timespec.GetBinCenter(ibin)*_timespec.GetBinContent(ibin);
+        nsh += ed._timespec.GetBinContent(ibin);
+        t0 += ed._timespec.GetBinCenter(ibin)*ed._timespec.GetBinContent(ibin);
         alreadyUsed[ibin] = true;
       }
       t0 /= nsh;
@@ -367,7 +403,7 @@ namespace mu2e {
   }
 
   //--------------------------------------------------------------------------------------------------------------
-  void TimeClusterFinder::initCluster(TimeCluster& tc) {
+  void TimeClusterFinder::initCluster(EventData& ed, TimeCluster& tc) const {
     // use medians to initialize robustly
     accumulator_set<float, stats<tag::min > > tmin;
     accumulator_set<float, stats<tag::max > > tmax;
@@ -375,20 +411,22 @@ namespace mu2e {
 
     unsigned nstrs = tc._strawHitIdxs.size();
     tc._nsh = 0;
+    auto const* x = ed._chsoa->x();
+    auto const* y = ed._chsoa->y();
+    auto const* z = ed._chsoa->z();
+    auto const* nshs = ed._chsoa->nStrawHits();
     for(auto ish :tc._strawHitIdxs) {
-      if (_testflag && !goodHit((*_chcol)[ish].flag())) continue;
-      ComboHit const& ch = (*_chcol)[ish];
-      unsigned nsh = ch.nStrawHits();
+      if (!ed._goodhit[ish]) continue;
+      unsigned nsh = nshs[ish];
       tc._nsh += nsh;
-      const XYZVectorF& pos = ch.pos();
-      float htime = _ttcalc.comboHitTime(ch,_pitch);
-      float hwt = ch.nStrawHits();
+      float htime = ed._chtime[ish];
+      float hwt = nsh;
       tmin(htime);
       tmax(htime);
       tacc(htime,weight=hwt);
-      xacc(pos.x(),weight=hwt);
-      yacc(pos.y(),weight=hwt);
-      zacc(pos.z(),weight=hwt);
+      xacc(x[ish],weight=hwt);
+      yacc(y[ish],weight=hwt);
+      zacc(z[ish],weight=hwt);
     }
 
     if (tc.hasCaloCluster()) {
@@ -411,16 +449,17 @@ namespace mu2e {
   }
 
   // prefilter based on a rough hemisphere cut and the initial robust position
-  void TimeClusterFinder::prefilterCluster(TimeCluster& tc){
+  void TimeClusterFinder::prefilterCluster(EventData& ed, TimeCluster& tc) const {
     bool changed(true);
     while (changed && tc._nsh > 0) {
       changed = false;
       float pphi = polyAtan2( tc._pos.y(), tc._pos.x());
       auto iworst = tc._strawHitIdxs.end();
       float maxadPhi(_maxdPhi);
+      auto const* x = ed._chsoa->x();
+      auto const* y = ed._chsoa->y();
       for( auto ips = tc._strawHitIdxs.begin(); ips != tc._strawHitIdxs.end(); ++ips){
-        ComboHit const& ch = (*_chcol)[*ips];
-        float phi   = polyAtan2(ch.pos().y(), ch.pos().x());
+        float phi   = polyAtan2(y[*ips], x[*ips]);
         float dphi  = Angles::deltaPhi(phi,pphi);
         float adphi = std::abs(dphi);
         if(adphi > maxadPhi ){
@@ -430,40 +469,42 @@ namespace mu2e {
       }
       if( iworst != tc._strawHitIdxs.end()){
         changed = true;
-        removeHit(tc,iworst);
+        removeHit(ed, tc,iworst);
       }
     }
   }
 
-  void TimeClusterFinder::recoverHits(TimeCluster& tc){
+  void TimeClusterFinder::recoverHits(EventData& ed, TimeCluster& tc) const {
     bool changed(true);
     while (changed) {
       changed = false;
       float pphi = polyAtan2(tc._pos.y(), tc._pos.x());
-      for(size_t ich=0;ich < _chcol->size(); ++ich){
-        if ((!_testflag) || goodHit((*_chcol)[ich].flag())) {
+      auto const* x = ed._chsoa->x();
+      auto const* y = ed._chsoa->y();
+      for(size_t ich=0;ich < ed._chcol->size(); ++ich){
+        if (ed._goodhit[ich]) {
           if(std::find(tc._strawHitIdxs.begin(),tc._strawHitIdxs.end(),ich) == tc._strawHitIdxs.end()){
-            ComboHit const& ch = (*_chcol)[ich];
-            float cht = _ttcalc.comboHitTime(ch,_pitch);
-            _pmva._dt = fabs(cht - tc._t0._t0);
-            if(_pmva._dt < _maxdt+tc._t0._t0err){
-              float phi = polyAtan2(ch.pos().y(), ch.pos().x());//ch.phi();
+            float cht = ed._chtime[ich];
+            ed._pmva._dt = fabs(cht - tc._t0._t0);
+            if(ed._pmva._dt < _maxdt+tc._t0._t0err){
+              ComboHit const& ch = (*ed._chcol)[ich];
+              float phi = polyAtan2(y[ich], x[ich]);//ch.phi();
               float dphi = fabs(Angles::deltaPhi(phi,pphi));
               if(dphi < _maxdPhi){
-                _pmva._dphi = dphi;
-                _pmva._rho = ch.pos().Perp2();
-                _pmva._nsh = ch.nStrawHits();
-                _pmva._plane = ch.strawId().plane();
-                _pmva._werr = ch.wireRes();
-                _pmva._wdist = fabs(ch.wireDist());
+                ed._pmva._dphi = dphi;
+                ed._pmva._rho = ch.pos().Perp2();
+                ed._pmva._nsh = ch.nStrawHits();
+                ed._pmva._plane = ch.strawId().plane();
+                ed._pmva._werr = ch.wireRes();
+                ed._pmva._wdist = fabs(ch.wireDist());
 
                 float mvaout(-1.0);
                 if (tc.hasCaloCluster())
-                  mvaout = _tcCaloMVA.evalMVA(_pmva._pars);
+                  mvaout = _tcCaloMVA.evalMVA(ed._pmva._pars);
                 else
-                  mvaout = _tcMVA.evalMVA(_pmva._pars);
+                  mvaout = _tcMVA.evalMVA(ed._pmva._pars);
                 if (mvaout > _minaddmva) {
-                  addHit(tc,ich);
+                  addHit(ed, tc,ich);
                   changed = true;
                 }
               }
@@ -474,14 +515,14 @@ namespace mu2e {
     }
   }
 
-  std::vector<StrawHitIndex>::iterator TimeClusterFinder::removeHit(TimeCluster& tc, ISH iworst) {
-    ComboHit const& ch = (*_chcol)[*iworst];
+  std::vector<StrawHitIndex>::iterator TimeClusterFinder::removeHit(EventData& ed, TimeCluster& tc, ISH iworst) const {
+    ComboHit const& ch = (*ed._chcol)[*iworst];
     unsigned nsh = ch.nStrawHits();
     float denom = float(tc._nsh - nsh);
     if(denom > 0){
       // update time cluster properties
       if(!tc.hasCaloCluster()){
-        float cht = _ttcalc.comboHitTime(ch,_pitch);
+        float cht = ed._chtime[*iworst];
         float newt0  = (tc._t0._t0*tc._nsh - cht*nsh)/denom;
         double var = tc._t0._t0err*tc._t0._t0err*tc._nsh - (cht-newt0)*(cht-tc._t0._t0)*nsh;
         if(var > 0.0)tc._t0._t0err = sqrt(var/denom);
@@ -493,13 +534,13 @@ namespace mu2e {
     return tc._strawHitIdxs.erase(iworst);
   }
 
-  void TimeClusterFinder::addHit(TimeCluster& tc,size_t iadd) {
-    ComboHit const& ch = (*_chcol)[iadd];
+  void TimeClusterFinder::addHit(EventData& ed, TimeCluster& tc,size_t iadd) const {
+    ComboHit const& ch = (*ed._chcol)[iadd];
     unsigned nsh = ch.nStrawHits();
     float denom = float(tc._nsh + nsh);
     // update time cluster properties
     if(!tc.hasCaloCluster()){
-      float cht = _ttcalc.comboHitTime(ch,_pitch);
+      float cht = ed._chtime[iadd];
       float newt0  = (tc._t0._t0*tc._nsh + cht*nsh)/denom;
       tc._t0._t0err = sqrt((tc._t0._t0err*tc._t0._t0err*tc._nsh + (cht-newt0)*(cht-tc._t0._t0)*nsh )/denom);
       tc._t0._t0 = newt0;
@@ -509,18 +550,21 @@ namespace mu2e {
     tc._strawHitIdxs.push_back(iadd);
   }
 
-  void TimeClusterFinder::clusterMean(TimeCluster& tc) {
+  void TimeClusterFinder::clusterMean(EventData& ed, TimeCluster& tc) const {
     // compute properties using weighted mean
     accumulator_set<float, stats<tag::weighted_variance(lazy)>, float > terr;
     accumulator_set<float, stats<tag::weighted_mean >,float > xacc, yacc, zacc;
+    auto const* x = ed._chsoa->x();
+    auto const* y = ed._chsoa->y();
+    auto const* z = ed._chsoa->z();
+    auto const* nshs = ed._chsoa->nStrawHits();
     for(StrawHitIndex ish : tc._strawHitIdxs) {
-      ComboHit const& ch = (*_chcol)[ish];
-      float hwt = ch.nStrawHits();
-      float cht = _ttcalc.comboHitTime(ch,_pitch);
+      float hwt = nshs[ish];
+      float cht = ed._chtime[ish];
       terr(cht,weight=hwt);
-      xacc(ch.pos().x(),weight=hwt);
-      yacc(ch.pos().y(),weight=hwt);
-      zacc(ch.pos().z(),weight=hwt);
+      xacc(x[ish],weight=hwt);
+      yacc(y[ish],weight=hwt);
+      zacc(z[ish],weight=hwt);
     }
     if (tc.hasCaloCluster()) {
       if(_useccpos){
@@ -537,7 +581,7 @@ namespace mu2e {
         extract_result<tag::weighted_mean>(zacc));
   }
 
-  void TimeClusterFinder::refineCluster(TimeCluster& tc) {
+  void TimeClusterFinder::refineCluster(EventData& ed, TimeCluster& tc) const {
     // mva filtering; remove worst hit iteratively
     bool changed = true;
     while (changed && tc._nsh > 0) {
@@ -546,24 +590,24 @@ namespace mu2e {
       float worstmva(100.0);
       float pphi = polyAtan2(tc._pos.y(), tc._pos.x());
       for (auto ips=tc._strawHitIdxs.begin();ips != tc._strawHitIdxs.end();++ips) {
-        ComboHit const& ch = (*_chcol)[*ips];
-        float cht = _ttcalc.comboHitTime(ch,_pitch);
+        ComboHit const& ch = (*ed._chcol)[*ips];
+        float cht = ed._chtime[*ips];
 
-        _pmva._dt = fabs(cht - tc._t0._t0);
+        ed._pmva._dt = fabs(cht - tc._t0._t0);
         float phi = polyAtan2(ch.pos().y(), ch.pos().x());//ch.phi();
         float dphi = Angles::deltaPhi(phi,pphi);
-        _pmva._dphi = fabs(dphi);
-        _pmva._rho = ch.pos().Perp2();
-        _pmva._nsh = ch.nStrawHits();
-        _pmva._plane = ch.strawId().plane();
-        _pmva._werr = ch.wireRes();
-        _pmva._wdist = fabs(ch.wireDist());
+        ed._pmva._dphi = fabs(dphi);
+        ed._pmva._rho = ch.pos().Perp2();
+        ed._pmva._nsh = ch.nStrawHits();
+        ed._pmva._plane = ch.strawId().plane();
+        ed._pmva._werr = ch.wireRes();
+        ed._pmva._wdist = fabs(ch.wireDist());
 
         float mvaout(-1.0);
         if (tc.hasCaloCluster())
-          mvaout = _tcCaloMVA.evalMVA(_pmva._pars);
+          mvaout = _tcCaloMVA.evalMVA(ed._pmva._pars);
         else
-          mvaout = _tcMVA.evalMVA(_pmva._pars);
+          mvaout = _tcMVA.evalMVA(ed._pmva._pars);
         if (mvaout < worstmva) {
           worstmva = mvaout;
           iworst = ips;
@@ -572,16 +616,11 @@ namespace mu2e {
 
       if (worstmva < _minkeepmva) {
         changed = true;
-        removeHit(tc,iworst);
+        removeHit(ed, tc,iworst);
       }
     }
   }
 
-  bool TimeClusterFinder::goodHit(const StrawHitFlag& flag) const
-  {
-    return flag.hasAllProperties(_hsel) && !flag.hasAnyProperty(_hbkg);
-  }
-
 }
 
 using mu2e::TimeClusterFinder;
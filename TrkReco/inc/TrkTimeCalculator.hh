@@ -55,7 +55,7 @@ namespace mu2e
       double trkToCaloTimeOffset() const { return _caloTimeOffset; }
       double caloClusterTimeErr() const { return _caloTimeErr; }
       // same for a ComboHit
-      double comboHitTime(ComboHit const& ch,double pitch);
+      double comboHitTime(ComboHit const& ch,double pitch) const;
       // calculate the t0 for a calo cluster.
       double caloClusterTime(CaloCluster const& cc,double pitch) const;
 
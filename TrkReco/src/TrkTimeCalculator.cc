@@ -39,7 +39,7 @@ namespace mu2e
     return hitz/(pitch*_beta*CLHEP::c_light);
   }
 
-  double TrkTimeCalculator::comboHitTime(ComboHit const& ch,double pitch)
+  double TrkTimeCalculator::comboHitTime(ComboHit const& ch,double pitch) const
   {
     double tflt = timeOfFlightTimeOffset(ch.pos().z(),pitch);
     if (_useTOTdrift)